@@ -12,4 +12,19 @@ call build.bat
 popd
 REM if %ERRORLEVEL% neq 0 (echo Error:%ERRORLEVEL% && exit)
 
+pushd tests
+call build.bat
+popd
+REM if %ERRORLEVEL% neq 0 (echo Error:%ERRORLEVEL% && exit)
+
+pushd tools\log_decoder
+call build.bat
+popd
+REM if %ERRORLEVEL% neq 0 (echo Error:%ERRORLEVEL% && exit)
+
+pushd tools\mesh_cooker
+call build.bat
+popd
+REM if %ERRORLEVEL% neq 0 (echo Error:%ERRORLEVEL% && exit)
+
 echo "All assemblies build successfully."
@@ -0,0 +1,639 @@
+#include "aabb_tree.h"
+
+#include "core/vmemory.h"
+#include "core/logger.h"
+#include "math/vmath.h"
+
+// NOTE: Traversal stacks live on the C stack, a balanced tree of 2^32 leaves stays far below this
+#define AABB_TREE_STACK_SIZE 256
+#define AABB_TREE_SAH_BINS 16
+
+static b8 IsLeaf(aabb_tree_node* Node)
+{
+    return Node->Child[0] == INVALID_ID;
+}
+
+static u32 AllocateNode(aabb_tree* Tree)
+{
+    if(Tree->FreeList == INVALID_ID)
+    {
+        u32 OldCapacity = Tree->Capacity;
+        Tree->Capacity = OldCapacity ? OldCapacity * 2 : 16;
+        Tree->Nodes = Reallocate(Tree->Nodes, sizeof(aabb_tree_node) * OldCapacity, 
+                                 sizeof(aabb_tree_node) * Tree->Capacity, MEMORY_TAG_SCENE);
+
+        for(u32 Index = OldCapacity;
+            Index < Tree->Capacity;
+            ++Index)
+        {
+            Tree->Nodes[Index].Parent = Index + 1 < Tree->Capacity ? Index + 1 : INVALID_ID;
+            Tree->Nodes[Index].Height = -1;
+        }
+        Tree->FreeList = OldCapacity;
+    }
+
+    u32 NodeIndex = Tree->FreeList;
+    aabb_tree_node* Node = &Tree->Nodes[NodeIndex];
+    Tree->FreeList = Node->Parent;
+
+    Node->Parent   = INVALID_ID;
+    Node->Child[0] = INVALID_ID;
+    Node->Child[1] = INVALID_ID;
+    Node->Height   = 0;
+    Node->UserData = 0;
+    Tree->NodeCount++;
+    return NodeIndex;
+}
+
+static void FreeNode(aabb_tree* Tree, u32 NodeIndex)
+{
+    Tree->Nodes[NodeIndex].Parent = Tree->FreeList;
+    Tree->Nodes[NodeIndex].Height = -1;
+    Tree->FreeList = NodeIndex;
+    Tree->NodeCount--;
+}
+
+static void UpdateFromChildren(aabb_tree* Tree, u32 NodeIndex)
+{
+    aabb_tree_node* Node = &Tree->Nodes[NodeIndex];
+    aabb_tree_node* A = &Tree->Nodes[Node->Child[0]];
+    aabb_tree_node* B = &Tree->Nodes[Node->Child[1]];
+    Node->Box    = ExtentsUnion(A->Box, B->Box);
+    Node->Height = 1 + (A->Height > B->Height ? A->Height : B->Height);
+}
+
+// NOTE: If one child of A is two levels taller than the other, the taller grandchild takes A's place.
+// Returns the node now at A's position.
+static u32 Balance(aabb_tree* Tree, u32 IndexA)
+{
+    aabb_tree_node* A = &Tree->Nodes[IndexA];
+    if(IsLeaf(A))
+    {
+        return IndexA;
+    }
+
+    u32 IndexB = A->Child[0];
+    u32 IndexC = A->Child[1];
+    s32 Difference = Tree->Nodes[IndexC].Height - Tree->Nodes[IndexB].Height;
+    if(Difference >= -1 && Difference <= 1)
+    {
+        return IndexA;
+    }
+
+    // NOTE: Raise the taller child, Slot is its position in A
+    u32 Slot        = Difference > 1 ? 1 : 0;
+    u32 IndexUp     = A->Child[Slot];
+    u32 IndexOther  = A->Child[1 - Slot];
+    aabb_tree_node* Up = &Tree->Nodes[IndexUp];
+
+    u32 IndexF = Up->Child[0];
+    u32 IndexG = Up->Child[1];
+
+    Up->Child[0] = IndexA;
+    Up->Parent   = A->Parent;
+    A->Parent    = IndexUp;
+
+    if(Up->Parent != INVALID_ID)
+    {
+        aabb_tree_node* Parent = &Tree->Nodes[Up->Parent];
+        Parent->Child[Parent->Child[0] == IndexA ? 0 : 1] = IndexUp;
+    }
+    else
+    {
+        Tree->Root = IndexUp;
+    }
+
+    // NOTE: The taller grandchild stays under Up, the shorter one replaces Up under A
+    u32 Keep = Tree->Nodes[IndexF].Height > Tree->Nodes[IndexG].Height ? IndexF : IndexG;
+    u32 Move = Keep == IndexF ? IndexG : IndexF;
+
+    Up->Child[1] = Keep;
+    A->Child[Slot] = Move;
+    A->Child[1 - Slot] = IndexOther;
+    Tree->Nodes[Move].Parent = IndexA;
+
+    UpdateFromChildren(Tree, IndexA);
+    UpdateFromChildren(Tree, IndexUp);
+    return IndexUp;
+}
+
+static void FixUpwards(aabb_tree* Tree, u32 NodeIndex)
+{
+    while(NodeIndex != INVALID_ID)
+    {
+        NodeIndex = Balance(Tree, NodeIndex);
+        UpdateFromChildren(Tree, NodeIndex);
+        NodeIndex = Tree->Nodes[NodeIndex].Parent;
+    }
+}
+
+static void InsertLeaf(aabb_tree* Tree, u32 Leaf)
+{
+    if(Tree->Root == INVALID_ID)
+    {
+        Tree->Root = Leaf;
+        Tree->Nodes[Leaf].Parent = INVALID_ID;
+        return;
+    }
+
+    // NOTE: Walks down towards the sibling with the lowest surface area cost: the new parent's area plus
+    // the area every ancestor grows by
+    extents_3d LeafBox = Tree->Nodes[Leaf].Box;
+    u32 Index = Tree->Root;
+    while(!IsLeaf(&Tree->Nodes[Index]))
+    {
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        r32 Area = ExtentsSurfaceArea(Node->Box);
+        r32 CombinedArea = ExtentsSurfaceArea(ExtentsUnion(Node->Box, LeafBox));
+
+        r32 Cost = 2.0f * CombinedArea;
+        r32 InheritanceCost = 2.0f * (CombinedArea - Area);
+
+        r32 ChildCost[2];
+        for(u32 Slot = 0; Slot < 2; ++Slot)
+        {
+            aabb_tree_node* Child = &Tree->Nodes[Node->Child[Slot]];
+            r32 Combined = ExtentsSurfaceArea(ExtentsUnion(Child->Box, LeafBox));
+            ChildCost[Slot] = InheritanceCost + (IsLeaf(Child) ? Combined : Combined - ExtentsSurfaceArea(Child->Box));
+        }
+
+        if(Cost < ChildCost[0] && Cost < ChildCost[1])
+        {
+            break;
+        }
+
+        Index = Node->Child[ChildCost[0] < ChildCost[1] ? 0 : 1];
+    }
+
+    u32 Sibling = Index;
+    u32 OldParent = Tree->Nodes[Sibling].Parent;
+    u32 NewParent = AllocateNode(Tree);
+    aabb_tree_node* Parent = &Tree->Nodes[NewParent];
+    Parent->Parent   = OldParent;
+    Parent->Child[0] = Sibling;
+    Parent->Child[1] = Leaf;
+    Parent->Box      = ExtentsUnion(LeafBox, Tree->Nodes[Sibling].Box);
+    Parent->Height   = Tree->Nodes[Sibling].Height + 1;
+    Tree->Nodes[Sibling].Parent = NewParent;
+    Tree->Nodes[Leaf].Parent    = NewParent;
+
+    if(OldParent != INVALID_ID)
+    {
+        aabb_tree_node* Grand = &Tree->Nodes[OldParent];
+        Grand->Child[Grand->Child[0] == Sibling ? 0 : 1] = NewParent;
+    }
+    else
+    {
+        Tree->Root = NewParent;
+    }
+
+    FixUpwards(Tree, OldParent);
+}
+
+static void RemoveLeaf(aabb_tree* Tree, u32 Leaf)
+{
+    if(Leaf == Tree->Root)
+    {
+        Tree->Root = INVALID_ID;
+        return;
+    }
+
+    u32 ParentIndex = Tree->Nodes[Leaf].Parent;
+    aabb_tree_node* Parent = &Tree->Nodes[ParentIndex];
+    u32 GrandIndex = Parent->Parent;
+    u32 Sibling = Parent->Child[Parent->Child[0] == Leaf ? 1 : 0];
+
+    if(GrandIndex != INVALID_ID)
+    {
+        aabb_tree_node* Grand = &Tree->Nodes[GrandIndex];
+        Grand->Child[Grand->Child[0] == ParentIndex ? 0 : 1] = Sibling;
+        Tree->Nodes[Sibling].Parent = GrandIndex;
+        FreeNode(Tree, ParentIndex);
+        FixUpwards(Tree, GrandIndex);
+    }
+    else
+    {
+        Tree->Root = Sibling;
+        Tree->Nodes[Sibling].Parent = INVALID_ID;
+        FreeNode(Tree, ParentIndex);
+    }
+}
+
+static extents_3d FattenBox(aabb_tree* Tree, extents_3d Box)
+{
+    v3 Margin = V3(Tree->Margin, Tree->Margin, Tree->Margin);
+    Box.Min = SubV3(Box.Min, Margin);
+    Box.Max = AddV3(Box.Max, Margin);
+    return Box;
+}
+
+void AABBTreeCreate(u32 InitialCapacity, r32 Margin, aabb_tree* OutTree)
+{
+    if(!OutTree)
+    {
+        VENG_ERROR("AABBTreeCreate - requires a valid pointer to a tree.");
+        return;
+    }
+
+    ZeroMemory(OutTree, sizeof(aabb_tree));
+    OutTree->Root     = INVALID_ID;
+    OutTree->FreeList = INVALID_ID;
+    OutTree->Margin   = Margin;
+
+    if(InitialCapacity)
+    {
+        OutTree->Nodes    = Allocate(sizeof(aabb_tree_node) * InitialCapacity, MEMORY_TAG_SCENE);
+        OutTree->Capacity = InitialCapacity;
+        for(u32 Index = 0;
+            Index < InitialCapacity;
+            ++Index)
+        {
+            OutTree->Nodes[Index].Parent = Index + 1 < InitialCapacity ? Index + 1 : INVALID_ID;
+            OutTree->Nodes[Index].Height = -1;
+        }
+        OutTree->FreeList = 0;
+    }
+}
+
+void AABBTreeDestroy(aabb_tree* Tree)
+{
+    if(Tree && Tree->Nodes)
+    {
+        Free(Tree->Nodes, sizeof(aabb_tree_node) * Tree->Capacity, MEMORY_TAG_SCENE);
+    }
+
+    if(Tree)
+    {
+        ZeroMemory(Tree, sizeof(aabb_tree));
+        Tree->Root     = INVALID_ID;
+        Tree->FreeList = INVALID_ID;
+    }
+}
+
+u32 AABBTreeInsert(aabb_tree* Tree, extents_3d Box, void* UserData)
+{
+    u32 Leaf = AllocateNode(Tree);
+    Tree->Nodes[Leaf].Box      = FattenBox(Tree, Box);
+    Tree->Nodes[Leaf].UserData = UserData;
+    InsertLeaf(Tree, Leaf);
+    return Leaf;
+}
+
+void AABBTreeRemove(aabb_tree* Tree, u32 Proxy)
+{
+    if(Proxy >= Tree->Capacity || Tree->Nodes[Proxy].Height != 0)
+    {
+        VENG_WARN("AABBTreeRemove - %u is not a leaf of the tree.", Proxy);
+        return;
+    }
+
+    RemoveLeaf(Tree, Proxy);
+    FreeNode(Tree, Proxy);
+}
+
+b8 AABBTreeMove(aabb_tree* Tree, u32 Proxy, extents_3d Box)
+{
+    if(ExtentsContains(Tree->Nodes[Proxy].Box, Box))
+    {
+        return false;
+    }
+
+    RemoveLeaf(Tree, Proxy);
+    Tree->Nodes[Proxy].Box = FattenBox(Tree, Box);
+    InsertLeaf(Tree, Proxy);
+    return true;
+}
+
+void AABBTreeRefit(aabb_tree* Tree, u32 Proxy, extents_3d Box)
+{
+    Tree->Nodes[Proxy].Box = Box;
+
+    // NOTE: Stops as soon as an ancestor box comes out unchanged, everything above it still fits
+    u32 Index = Tree->Nodes[Proxy].Parent;
+    while(Index != INVALID_ID)
+    {
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        extents_3d Old = Node->Box;
+        Node->Box = ExtentsUnion(Tree->Nodes[Node->Child[0]].Box, Tree->Nodes[Node->Child[1]].Box);
+        if(ExtentsContains(Old, Node->Box) && ExtentsContains(Node->Box, Old))
+        {
+            break;
+        }
+        Index = Node->Parent;
+    }
+}
+
+// NOTE: Top down build over Leaves[0..Count). Splits at the cheapest of AABB_TREE_SAH_BINS - 1 planes along the
+// longest axis of the leaf centers, by the surface area heuristic. Returns the subtree root.
+static u32 BuildSAH(aabb_tree* Tree, u32* Leaves, u32 Count, u32 Parent)
+{
+    if(Count == 1)
+    {
+        Tree->Nodes[Leaves[0]].Parent = Parent;
+        return Leaves[0];
+    }
+
+    extents_3d CenterBounds = {{{INFINITY, INFINITY, INFINITY}}, {{-INFINITY, -INFINITY, -INFINITY}}};
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        extents_3d Box = Tree->Nodes[Leaves[Index]].Box;
+        v3 Center = MulV3(AddV3(Box.Min, Box.Max), V3(0.5f, 0.5f, 0.5f));
+        extents_3d Point = {Center, Center};
+        CenterBounds = ExtentsUnion(CenterBounds, Point);
+    }
+
+    v3 Size = SubV3(CenterBounds.Max, CenterBounds.Min);
+    u32 Axis = Size.x > Size.y ? (Size.x > Size.z ? 0 : 2) : (Size.y > Size.z ? 1 : 2);
+    r32 Extent = Size.E[Axis];
+
+    u32 Split = Count / 2;
+    if(Extent > 0.0f)
+    {
+        u32 BinCount[AABB_TREE_SAH_BINS] = {0};
+        extents_3d BinBox[AABB_TREE_SAH_BINS];
+        for(u32 Bin = 0; Bin < AABB_TREE_SAH_BINS; ++Bin)
+        {
+            BinBox[Bin] = (extents_3d){{{INFINITY, INFINITY, INFINITY}}, {{-INFINITY, -INFINITY, -INFINITY}}};
+        }
+
+        r32 BinScale = AABB_TREE_SAH_BINS / Extent * 0.9999f;
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            extents_3d Box = Tree->Nodes[Leaves[Index]].Box;
+            r32 Center = 0.5f * (Box.Min.E[Axis] + Box.Max.E[Axis]);
+            u32 Bin = (u32)((Center - CenterBounds.Min.E[Axis]) * BinScale);
+            BinCount[Bin]++;
+            BinBox[Bin] = ExtentsUnion(BinBox[Bin], Box);
+        }
+
+        // NOTE: Cost of a split after bin b is area(left) * count(left) + area(right) * count(right)
+        r32 RightCost[AABB_TREE_SAH_BINS];
+        extents_3d Right = BinBox[AABB_TREE_SAH_BINS - 1];
+        u32 RightCount = 0;
+        for(u32 Bin = AABB_TREE_SAH_BINS - 1; Bin > 0; --Bin)
+        {
+            Right = ExtentsUnion(Right, BinBox[Bin]);
+            RightCount += BinCount[Bin];
+            RightCost[Bin] = RightCount ? ExtentsSurfaceArea(Right) * RightCount : 0.0f;
+        }
+
+        r32 BestCost = INFINITY;
+        u32 BestBin = 0;
+        extents_3d Left = BinBox[0];
+        u32 LeftCount = 0;
+        for(u32 Bin = 0; Bin < AABB_TREE_SAH_BINS - 1; ++Bin)
+        {
+            Left = ExtentsUnion(Left, BinBox[Bin]);
+            LeftCount += BinCount[Bin];
+            r32 Cost = (LeftCount ? ExtentsSurfaceArea(Left) * LeftCount : 0.0f) + RightCost[Bin + 1];
+            if(LeftCount && LeftCount < Count && Cost < BestCost)
+            {
+                BestCost = Cost;
+                BestBin  = Bin;
+            }
+        }
+
+        if(BestCost < INFINITY)
+        {
+            // NOTE: Partition in place, leaves in bins up to BestBin go first
+            u32 Front = 0;
+            for(u32 Index = 0;
+                Index < Count;
+                ++Index)
+            {
+                extents_3d Box = Tree->Nodes[Leaves[Index]].Box;
+                r32 Center = 0.5f * (Box.Min.E[Axis] + Box.Max.E[Axis]);
+                if((u32)((Center - CenterBounds.Min.E[Axis]) * BinScale) <= BestBin)
+                {
+                    u32 Swap = Leaves[Front];
+                    Leaves[Front++] = Leaves[Index];
+                    Leaves[Index] = Swap;
+                }
+            }
+            Split = Front;
+        }
+    }
+
+    u32 NodeIndex = AllocateNode(Tree);
+    u32 Child0 = BuildSAH(Tree, Leaves, Split, NodeIndex);
+    u32 Child1 = BuildSAH(Tree, Leaves + Split, Count - Split, NodeIndex);
+
+    aabb_tree_node* Node = &Tree->Nodes[NodeIndex];
+    Node->Parent   = Parent;
+    Node->Child[0] = Child0;
+    Node->Child[1] = Child1;
+    UpdateFromChildren(Tree, NodeIndex);
+    return NodeIndex;
+}
+
+void AABBTreeRebuild(aabb_tree* Tree)
+{
+    if(Tree->Root == INVALID_ID)
+    {
+        return;
+    }
+
+    // NOTE: Leaves keep their node index so proxies stay valid, only the internal nodes are rebuilt
+    u32 LeafCount = 0;
+    u32* Leaves = Allocate(sizeof(u32) * Tree->Capacity, MEMORY_TAG_SCENE);
+    for(u32 Index = 0;
+        Index < Tree->Capacity;
+        ++Index)
+    {
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        if(Node->Height < 0)
+        {
+            continue;
+        }
+
+        if(IsLeaf(Node))
+        {
+            Leaves[LeafCount++] = Index;
+        }
+        else
+        {
+            FreeNode(Tree, Index);
+        }
+    }
+
+    Tree->Root = BuildSAH(Tree, Leaves, LeafCount, INVALID_ID);
+    Free(Leaves, sizeof(u32) * Tree->Capacity, MEMORY_TAG_SCENE);
+}
+
+void* AABBTreeGetUserData(aabb_tree* Tree, u32 Proxy)
+{
+    return Tree->Nodes[Proxy].UserData;
+}
+
+extents_3d AABBTreeGetBox(aabb_tree* Tree, u32 Proxy)
+{
+    return Tree->Nodes[Proxy].Box;
+}
+
+u32 AABBTreeGetHeight(aabb_tree* Tree)
+{
+    return Tree->Root == INVALID_ID ? 0 : (u32)Tree->Nodes[Tree->Root].Height;
+}
+
+void AABBTreeQueryBox(aabb_tree* Tree, extents_3d Box, PFN_AABBTreeQuery Callback, void* Context)
+{
+    if(Tree->Root == INVALID_ID)
+    {
+        return;
+    }
+
+    u32 Stack[AABB_TREE_STACK_SIZE];
+    u32 StackCount = 0;
+    Stack[StackCount++] = Tree->Root;
+    while(StackCount)
+    {
+        aabb_tree_node* Node = &Tree->Nodes[Stack[--StackCount]];
+        if(!ExtentsOverlap(Node->Box, Box))
+        {
+            continue;
+        }
+
+        if(IsLeaf(Node))
+        {
+            if(!Callback(Context, (u32)(Node - Tree->Nodes), Node->UserData))
+            {
+                return;
+            }
+        }
+        else
+        {
+            Stack[StackCount++] = Node->Child[0];
+            Stack[StackCount++] = Node->Child[1];
+        }
+    }
+}
+
+// NOTE: Reports every leaf below Root, returns false when the callback stopped the query
+static b8 ReportSubtree(aabb_tree* Tree, u32 Root, PFN_AABBTreeQuery Callback, void* Context)
+{
+    u32 Stack[AABB_TREE_STACK_SIZE];
+    u32 StackCount = 0;
+    Stack[StackCount++] = Root;
+    while(StackCount)
+    {
+        u32 Index = Stack[--StackCount];
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        if(IsLeaf(Node))
+        {
+            if(!Callback(Context, Index, Node->UserData))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            Stack[StackCount++] = Node->Child[0];
+            Stack[StackCount++] = Node->Child[1];
+        }
+    }
+
+    return true;
+}
+
+void AABBTreeQueryFrustum(aabb_tree* Tree, const frustum* Frustum, PFN_AABBTreeQuery Callback, void* Context)
+{
+    if(Tree->Root == INVALID_ID)
+    {
+        return;
+    }
+
+    u32 Stack[AABB_TREE_STACK_SIZE];
+    u32 StackCount = 0;
+    Stack[StackCount++] = Tree->Root;
+    while(StackCount)
+    {
+        u32 Index = Stack[--StackCount];
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        frustum_test_result Test = FrustumTestExtents(Frustum, Node->Box);
+        if(Test == FRUSTUM_OUTSIDE)
+        {
+            continue;
+        }
+
+        if(Test == FRUSTUM_INSIDE || IsLeaf(Node))
+        {
+            if(!ReportSubtree(Tree, Index, Callback, Context))
+            {
+                return;
+            }
+        }
+        else
+        {
+            Stack[StackCount++] = Node->Child[0];
+            Stack[StackCount++] = Node->Child[1];
+        }
+    }
+}
+
+void AABBTreeRayCast(aabb_tree* Tree, v3 Origin, v3 Direction, r32 MaxDistance, PFN_AABBTreeRayCast Callback, void* Context)
+{
+    if(Tree->Root == INVALID_ID)
+    {
+        return;
+    }
+
+    v3 InvDirection = V3(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+
+    u32 Stack[AABB_TREE_STACK_SIZE];
+    r32 Entry[AABB_TREE_STACK_SIZE];
+    u32 StackCount = 0;
+
+    r32 RootDistance;
+    if(!RayIntersectsExtents(Origin, InvDirection, MaxDistance, Tree->Nodes[Tree->Root].Box, &RootDistance))
+    {
+        return;
+    }
+    Stack[StackCount] = Tree->Root;
+    Entry[StackCount++] = RootDistance;
+
+    while(StackCount)
+    {
+        --StackCount;
+        u32 Index = Stack[StackCount];
+        if(Entry[StackCount] > MaxDistance)
+        {
+            continue;
+        }
+
+        aabb_tree_node* Node = &Tree->Nodes[Index];
+        if(IsLeaf(Node))
+        {
+            r32 Result = Callback(Context, Index, Node->UserData, Origin, Direction, MaxDistance);
+            if(Result == 0.0f)
+            {
+                return;
+            }
+            MaxDistance = Result < MaxDistance ? Result : MaxDistance;
+            continue;
+        }
+
+        // NOTE: The nearer child goes on top so it is visited first and can shorten the ray for the other
+        r32 Distance[2];
+        b8 Hit[2];
+        for(u32 Slot = 0; Slot < 2; ++Slot)
+        {
+            Hit[Slot] = RayIntersectsExtents(Origin, InvDirection, MaxDistance, Tree->Nodes[Node->Child[Slot]].Box, &Distance[Slot]);
+        }
+
+        u32 Near = Distance[0] <= Distance[1] ? 0 : 1;
+        if(Hit[1 - Near])
+        {
+            Stack[StackCount] = Node->Child[1 - Near];
+            Entry[StackCount++] = Distance[1 - Near];
+        }
+        if(Hit[Near])
+        {
+            Stack[StackCount] = Node->Child[Near];
+            Entry[StackCount++] = Distance[Near];
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+
+// NOTE: Dynamic AABB tree over user boxes. Leaves store a box padded by Margin, so small moves leave the
+// tree untouched. Inserts pick the sibling with the lowest surface area cost and keep the tree balanced with
+// rotations; AABBTreeRebuild rebuilds everything top down with a binned SAH for static content.
+// Proxy IDs stay valid until removed, rebuilds included.
+typedef struct aabb_tree_node
+{
+    extents_3d Box;
+    void* UserData;
+    // NOTE: Next free node while the node is on the free list
+    u32 Parent;
+    u32 Child[2];
+    // NOTE: 0 for leaves, -1 for free nodes
+    s32 Height;
+} aabb_tree_node;
+
+typedef struct aabb_tree
+{
+    aabb_tree_node* Nodes;
+    u32 Capacity;
+    u32 NodeCount;
+    u32 Root;
+    u32 FreeList;
+    r32 Margin;
+} aabb_tree;
+
+// NOTE: Return false to stop the query
+typedef b8 (*PFN_AABBTreeQuery)(void* Context, u32 Proxy, void* UserData);
+
+// NOTE: Called for leaves whose box the ray hits, in roughly front to back order. Return the distance of the
+// actual hit to shorten the ray, MaxDistance to keep going, or 0 to stop.
+typedef r32 (*PFN_AABBTreeRayCast)(void* Context, u32 Proxy, void* UserData, v3 Origin, v3 Direction, r32 MaxDistance);
+
+VENG_API void AABBTreeCreate(u32 InitialCapacity, r32 Margin, aabb_tree* OutTree);
+VENG_API void AABBTreeDestroy(aabb_tree* Tree);
+
+VENG_API u32  AABBTreeInsert(aabb_tree* Tree, extents_3d Box, void* UserData);
+VENG_API void AABBTreeRemove(aabb_tree* Tree, u32 Proxy);
+// NOTE: Reinserts the leaf only when Box left its padded box, returns true when it did
+VENG_API b8   AABBTreeMove(aabb_tree* Tree, u32 Proxy, extents_3d Box);
+// NOTE: Sets the exact box and refits the ancestors in place without restructuring. Cheaper than a move
+// for small changes every frame, the tree quality drifts until the next rebuild.
+VENG_API void AABBTreeRefit(aabb_tree* Tree, u32 Proxy, extents_3d Box);
+VENG_API void AABBTreeRebuild(aabb_tree* Tree);
+
+VENG_API void* AABBTreeGetUserData(aabb_tree* Tree, u32 Proxy);
+VENG_API extents_3d AABBTreeGetBox(aabb_tree* Tree, u32 Proxy);
+VENG_API u32 AABBTreeGetHeight(aabb_tree* Tree);
+
+VENG_API void AABBTreeQueryBox(aabb_tree* Tree, extents_3d Box, PFN_AABBTreeQuery Callback, void* Context);
+// NOTE: Subtrees fully inside the frustum are reported without testing their leaves
+VENG_API void AABBTreeQueryFrustum(aabb_tree* Tree, const frustum* Frustum, PFN_AABBTreeQuery Callback, void* Context);
+// NOTE: Direction needs no normalization, distances are in multiples of it
+VENG_API void AABBTreeRayCast(aabb_tree* Tree, v3 Origin, v3 Direction, r32 MaxDistance, PFN_AABBTreeRayCast Callback, void* Context);
@@ -4,51 +4,270 @@
 #include "core/vmemory.h"
 #include "core/logger.h"
 
+#define DARRAY_HEADER_SIZE (DARRAY_FIELD_LENGTH * sizeof(u64))
+
+static u64* DArrayHeader(void* Array)
+{
+    return (u64*)Array - DARRAY_FIELD_LENGTH;
+}
+
+// NOTE: Size of the whole block, including the worst case padding needed to align the element storage
+static u64 DArrayBlockSize(u64 Capacity, u64 Stride, u64 Alignment)
+{
+    u64 Padding = Alignment ? Alignment - 1 : 0;
+    return Padding + DARRAY_HEADER_SIZE + Capacity * Stride;
+}
+
+static u64 DArrayPaddingFor(u8* Base, u64 Alignment)
+{
+    if(Alignment == 0)
+    {
+        return 0;
+    }
+
+    u64 Data = ((u64)Base + DARRAY_HEADER_SIZE + Alignment - 1) & ~(Alignment - 1);
+    return Data - DARRAY_HEADER_SIZE - (u64)Base;
+}
+
+static u8* DArrayBase(u64* Header)
+{
+    return (u8*)Header - Header[DARRAY_PADDING];
+}
 
 void* _darray_create(u64 Length, u64 Stride)
 {
-    u64 HeaderSize = DARRAY_FIELD_LENGTH * sizeof(u64);
-    u64 ArraySize  = Length * Stride;
+    return _darray_create_aligned(Length, Stride, 0, 0);
+}
+
+void* _darray_create_with_allocator(u64 Length, u64 Stride, allocator* Allocator)
+{
+    return _darray_create_aligned(Length, Stride, 0, Allocator);
+}
+
+void* _darray_create_aligned(u64 Length, u64 Stride, u64 Alignment, allocator* Allocator)
+{
+    if(Alignment & (Alignment - 1))
+    {
+        VENG_ERROR("_darray_create - alignment %llu is not a power of two.", Alignment);
+        return 0;
+    }
+
+    u64 BlockSize = DArrayBlockSize(Length, Stride, Alignment);
+
+    u8* Base = 0;
+    if(Allocator)
+    {
+        Base = (u8*)Allocator->AllocateBlock(Allocator->Instance, BlockSize);
+        if(!Base)
+        {
+            VENG_ERROR("_darray_create - allocator failed to provide %lluB.", BlockSize);
+            return 0;
+        }
+    }
+    else
+    {
+        // NOTE: Allocate hands out zeroed memory already
+        Base = (u8*)Allocate(BlockSize, MEMORY_TAG_DARRAY);
+    }
 
-    u64* NewArray = (u64*)Allocate(HeaderSize + ArraySize, MEMORY_TAG_DARRAY);
-    SetMemory(NewArray, 0, HeaderSize + ArraySize);
+    u64 Padding = DArrayPaddingFor(Base, Alignment);
+    u64* NewArray = (u64*)(Base + Padding);
+    ZeroMemory(NewArray, DARRAY_HEADER_SIZE);
 
-    NewArray[DARRAY_CAPACITY] = Length;
-    NewArray[DARRAY_LENGTH]   = 0;
-    NewArray[DARRAY_STRIDE]   = Stride;
+    NewArray[DARRAY_CAPACITY]  = Length;
+    NewArray[DARRAY_LENGTH]    = 0;
+    NewArray[DARRAY_STRIDE]    = Stride;
+    NewArray[DARRAY_GROWTH]    = DARRAY_RESIZE_FACTOR * 100;
+    NewArray[DARRAY_ALLOCATOR] = (u64)Allocator;
+    NewArray[DARRAY_ALIGNMENT] = Alignment;
+    NewArray[DARRAY_PADDING]   = Padding;
 
     return (void*)(NewArray + DARRAY_FIELD_LENGTH);
 }
 void  _darray_destroy(void* Array)
 {
-    u64* Header = (u64*)Array - DARRAY_FIELD_LENGTH;
-    u64 HeaderSize = DARRAY_FIELD_LENGTH * sizeof(u64);
-    u64 TotalSize = HeaderSize + Header[DARRAY_CAPACITY] * Header[DARRAY_STRIDE];
-    Free(Header, TotalSize, MEMORY_TAG_DARRAY);
+    u64* Header = DArrayHeader(Array);
+    u64 TotalSize = DArrayBlockSize(Header[DARRAY_CAPACITY], Header[DARRAY_STRIDE], Header[DARRAY_ALIGNMENT]);
+    allocator* Allocator = (allocator*)Header[DARRAY_ALLOCATOR];
+    if(Allocator)
+    {
+        Allocator->FreeBlock(Allocator->Instance, DArrayBase(Header), TotalSize);
+    }
+    else
+    {
+        Free(DArrayBase(Header), TotalSize, MEMORY_TAG_DARRAY);
+    }
 }
 
 u64  _darray_field_get(void* Array, u64 Field)
 {
-    u64* Header = (u64*)Array - DARRAY_FIELD_LENGTH;
+    u64* Header = DArrayHeader(Array);
     return Header[Field];
 }
 void _darray_field_set(void* Array, u64 Field, u64 Value)
 {
-    u64* Header = (u64*)Array - DARRAY_FIELD_LENGTH;
+    u64* Header = DArrayHeader(Array);
     Header[Field] = Value;
 }
 
+// NOTE: Moves the array to a block of NewCapacity elements. Tries to grow in place first 
+// (allocator ResizeBlockInPlace or heap realloc), falls back to allocate + copy + free.
+static void* DArrayReallocate(void* Array, u64 NewCapacity)
+{
+    u64* Header = DArrayHeader(Array);
+    u64 Stride    = Header[DARRAY_STRIDE];
+    u64 Alignment = Header[DARRAY_ALIGNMENT];
+    u64 OldPadding = Header[DARRAY_PADDING];
+    u64 UsedSize = DARRAY_HEADER_SIZE + Header[DARRAY_LENGTH] * Stride;
+    u64 OldSize  = DArrayBlockSize(Header[DARRAY_CAPACITY], Stride, Alignment);
+    u64 NewSize  = DArrayBlockSize(NewCapacity, Stride, Alignment);
+
+    u8* OldBase = DArrayBase(Header);
+    u8* NewBase = 0;
+    allocator* Allocator = (allocator*)Header[DARRAY_ALLOCATOR];
+    if(Allocator)
+    {
+        if(Allocator->ResizeBlockInPlace && Allocator->ResizeBlockInPlace(Allocator->Instance, OldBase, OldSize, NewSize))
+        {
+            NewBase = OldBase;
+        }
+        else
+        {
+            NewBase = (u8*)Allocator->AllocateBlock(Allocator->Instance, NewSize);
+            if(NewBase)
+            {
+                u64 NewPadding = DArrayPaddingFor(NewBase, Alignment);
+                CopyMemory(NewBase + NewPadding, Header, UsedSize);
+                Allocator->FreeBlock(Allocator->Instance, OldBase, OldSize);
+                OldPadding = NewPadding;
+            }
+        }
+    }
+    else
+    {
+        // NOTE: Everything past the length is written before it is read, no need to zero the new tail
+        NewBase = (u8*)ReallocateUninitialized(OldBase, OldSize, NewSize, MEMORY_TAG_DARRAY);
+    }
+
+    if(!NewBase)
+    {
+        VENG_ERROR("_darray_resize - failed to grow array to %llu elements.", NewCapacity);
+        return Array;
+    }
+
+    // NOTE: A moved block may need a different padding to keep the storage aligned
+    u64 Padding = DArrayPaddingFor(NewBase, Alignment);
+    if(Padding != OldPadding)
+    {
+        MoveMemory(NewBase + Padding, NewBase + OldPadding, UsedSize);
+    }
+
+    u64* NewHeader = (u64*)(NewBase + Padding);
+    NewHeader[DARRAY_CAPACITY] = NewCapacity;
+    NewHeader[DARRAY_PADDING]  = Padding;
+    return (void*)(NewHeader + DARRAY_FIELD_LENGTH);
+}
+
+static void* DArrayGrow(void* Array, u64 Required)
+{
+    u64 Capacity = DArrayCapacity(Array);
+    u64 NewCapacity = Capacity * _darray_field_get(Array, DARRAY_GROWTH) / 100;
+    if(NewCapacity <= Capacity)
+    {
+        NewCapacity = Capacity + 1;
+    }
+    if(NewCapacity < DARRAY_MIN_GROW_CAPACITY)
+    {
+        NewCapacity = DARRAY_MIN_GROW_CAPACITY;
+    }
+    if(NewCapacity < Required)
+    {
+        NewCapacity = Required;
+    }
+
+    return DArrayReallocate(Array, NewCapacity);
+}
+
 void* _darray_resize(void* Array)
+{
+    return DArrayGrow(Array, DArrayLength(Array) + 1);
+}
+
+void* _darray_reserve(void* Array, u64 Capacity)
+{
+    if(Capacity <= DArrayCapacity(Array))
+    {
+        return Array;
+    }
+
+    return DArrayReallocate(Array, Capacity);
+}
+
+void* _darray_push_range(void* Array, const void* Values, u64 Count)
 {
     u64 Length = DArrayLength(Array);
     u64 Stride = DArrayStride(Array);
-    void* Temp = _darray_create((DARRAY_RESIZE_FACTOR * DArrayCapacity(Array)), Stride);
+    if(Length + Count > DArrayCapacity(Array))
+    {
+        Array = DArrayGrow(Array, Length + Count);
+        if(Length + Count > DArrayCapacity(Array))
+        {
+            return Array;
+        }
+    }
 
-    CopyMemory(Temp, Array, Length * Stride);
+    CopyMemory((u8*)Array + Length * Stride, Values, Count * Stride);
+    _darray_field_set(Array, DARRAY_LENGTH, Length + Count);
+    return Array;
+}
 
-    _darray_field_set(Temp, DARRAY_LENGTH, Length);
-    _darray_destroy(Array);
-    return Temp;
+void* _darray_push_n(void* Array, const void* ValuePtr, u64 Count)
+{
+    u64 Length = DArrayLength(Array);
+    u64 Stride = DArrayStride(Array);
+    if(Count == 0)
+    {
+        return Array;
+    }
+
+    if(Length + Count > DArrayCapacity(Array))
+    {
+        Array = DArrayGrow(Array, Length + Count);
+        if(Length + Count > DArrayCapacity(Array))
+        {
+            return Array;
+        }
+    }
+
+    // NOTE: Fill by doubling the already written range, so large counts become a few big copies
+    u8* Dest = (u8*)Array + Length * Stride;
+    CopyMemory(Dest, ValuePtr, Stride);
+    u64 Written = 1;
+    while(Written < Count)
+    {
+        u64 Chunk = (Written < Count - Written) ? Written : Count - Written;
+        CopyMemory(Dest + Written * Stride, Dest, Chunk * Stride);
+        Written += Chunk;
+    }
+
+    _darray_field_set(Array, DARRAY_LENGTH, Length + Count);
+    return Array;
+}
+
+// NOTE: Grows like a push does, so resizing one element at a time stays amortized O(1)
+void* _darray_set_length(void* Array, u64 Length)
+{
+    if(Length > DArrayCapacity(Array))
+    {
+        Array = DArrayGrow(Array, Length);
+        if(Length > DArrayCapacity(Array))
+        {
+            return Array;
+        }
+    }
+
+    _darray_field_set(Array, DARRAY_LENGTH, Length);
+    return Array;
 }
 
 void* _darray_push(void* Array, const void* ValuePtr)
@@ -58,6 +277,10 @@ void* _darray_push(void* Array, const void* ValuePtr)
     if(Length >= DArrayCapacity(Array))
     {
         Array = _darray_resize(Array);
+        if(Length >= DArrayCapacity(Array))
+        {
+            return Array;
+        }
     }
 
     u64 Addr = (u64)Array;
@@ -91,9 +314,9 @@ void* _darray_pop_at(void* Array, u64 Index, void* Dest)
 
     if(Index != Length - 1)
     {
-        CopyMemory((void*)(Addr +  (Index * Stride)), 
-                   (void*)(Addr + ((Index - 1) * Stride)), 
-                   Stride);
+        MoveMemory((void*)(Addr +  (Index * Stride)), 
+                   (void*)(Addr + ((Index + 1) * Stride)), 
+                   Stride * (Length - Index - 1));
     }
 
     _darray_field_set(Array, DARRAY_LENGTH, Length - 1);
@@ -103,7 +326,7 @@ void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr)
 {
     u64 Length = DArrayLength(Array);
     u64 Stride = DArrayStride(Array);
-    if(Index >= Length)
+    if(Index > Length)
     {
         VENG_ERROR("Index is outside of the array! Length: %i, index: %i", Length, Index);
         return Array;
@@ -112,13 +335,17 @@ void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr)
     if(Length >= DArrayCapacity(Array))
     {
         Array = _darray_resize(Array);
+        if(Length >= DArrayCapacity(Array))
+        {
+            return Array;
+        }
     }
 
     u64 Addr = (u64)Array;
 
-    if(Index != Length - 1)
+    if(Index != Length)
     {
-        CopyMemory((void*)(Addr + ((Index - 1) * Stride)), 
+        MoveMemory((void*)(Addr + ((Index + 1) * Stride)), 
                    (void*)(Addr +  (Index * Stride)), 
                    Stride * (Length - Index));
     }
@@ -128,3 +355,27 @@ void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr)
     return Array;
 }
 
+void* _darray_swap_remove(void* Array, u64 Index, void* Dest)
+{
+    u64 Length = DArrayLength(Array);
+    u64 Stride = DArrayStride(Array);
+    if(Index >= Length)
+    {
+        VENG_ERROR("Index is outside of the array! Length: %i, index: %i", Length, Index);
+        return Array;
+    }
+
+    u8* Element = (u8*)Array + Index * Stride;
+    if(Dest)
+    {
+        CopyMemory(Dest, Element, Stride);
+    }
+
+    if(Index != Length - 1)
+    {
+        CopyMemory(Element, (u8*)Array + (Length - 1) * Stride, Stride);
+    }
+
+    _darray_field_set(Array, DARRAY_LENGTH, Length - 1);
+    return Array;
+}
@@ -1,36 +1,61 @@
 #pragma once
 
 #include "defines.h"
+#include "memory/allocator.h"
 
 enum 
 {
     DARRAY_CAPACITY,
     DARRAY_LENGTH,
     DARRAY_STRIDE,
+    DARRAY_GROWTH,
+    DARRAY_ALLOCATOR,
+    DARRAY_ALIGNMENT,
+    DARRAY_PADDING,
     DARRAY_FIELD_LENGTH 
 };
 
-#define DARRAY_DEFAULT_CAPACITY 1
+#define DARRAY_DEFAULT_CAPACITY 4
 #define DARRAY_RESIZE_FACTOR 2
+// NOTE: Growth never goes below this many elements, so tiny arrays do not reallocate on every push
+#define DARRAY_MIN_GROW_CAPACITY 8
 
+// NOTE: Allocator is optional, 0 means the tagged heap. The allocator struct must outlive the array.
 VENG_API void* _darray_create(u64 Length, u64 Stride);
+VENG_API void* _darray_create_with_allocator(u64 Length, u64 Stride, allocator* Allocator);
+// NOTE: Alignment of the element storage, power of two. 0 keeps the default header-packed layout.
+VENG_API void* _darray_create_aligned(u64 Length, u64 Stride, u64 Alignment, allocator* Allocator);
 VENG_API void  _darray_destroy(void* Array);
 
 VENG_API u64  _darray_field_get(void* Array, u64 Field);
 VENG_API void _darray_field_set(void* Array, u64 Field, u64 Value);
 
 VENG_API void* _darray_resize(void* Array);
+VENG_API void* _darray_reserve(void* Array, u64 Capacity);
+
+VENG_API void* _darray_push_range(void* Array, const void* Values, u64 Count);
+VENG_API void* _darray_push_n(void* Array, const void* ValuePtr, u64 Count);
+VENG_API void* _darray_set_length(void* Array, u64 Length);
 
 VENG_API void* _darray_push(void* Array, const void* ValuePtr);
 VENG_API void  _darray_pop(void* Array, void* Dest);
 
 VENG_API void* _darray_pop_at(void* Array, u64 Index, void* Dest);
 VENG_API void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr);
+VENG_API void* _darray_swap_remove(void* Array, u64 Index, void* Dest);
 
 #define DArrayCreate(Type) _darray_create(DARRAY_DEFAULT_CAPACITY, sizeof(Type))
 
 #define DArrayReserve(Type, Capacity) _darray_create(Capacity, sizeof(Type))
 
+#define DArrayCreateWithAllocator(Type, Allocator) _darray_create_with_allocator(DARRAY_DEFAULT_CAPACITY, sizeof(Type), Allocator)
+
+#define DArrayReserveWithAllocator(Type, Capacity, Allocator) _darray_create_with_allocator(Capacity, sizeof(Type), Allocator)
+
+#define DArrayCreateAligned(Type, Alignment) _darray_create_aligned(DARRAY_DEFAULT_CAPACITY, sizeof(Type), Alignment, 0)
+
+#define DArrayReserveAligned(Type, Capacity, Alignment) _darray_create_aligned(Capacity, sizeof(Type), Alignment, 0)
+
 #define DArrayDestroy(Array) _darray_destroy(Array)
 
 #define DArrayPush(Array, Value)                \
@@ -39,6 +64,29 @@ VENG_API void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr);
         Array = _darray_push(Array, &Temp);     \
     }
 
+#define DArrayAppendRange(Array, Values, Count)             \
+    {                                                       \
+        Array = _darray_push_range(Array, Values, Count);   \
+    }
+
+// NOTE: Appends Count copies of *ValuePtr
+#define DArrayPushN(Array, ValuePtr, Count)                 \
+    {                                                       \
+        Array = _darray_push_n(Array, ValuePtr, Count);     \
+    }
+
+// NOTE: Sets the length, growing storage if needed. New elements are not initialized, heap growth skips the
+// zeroing Reallocate does.
+#define DArrayResize(Array, Length)                         \
+    {                                                       \
+        Array = _darray_set_length(Array, Length);          \
+    }
+
+#define DArrayEnsureCapacity(Array, Capacity)               \
+    {                                                       \
+        Array = _darray_reserve(Array, Capacity);           \
+    }
+
 #define DArrayPop(Array, ValuePtr) _darray_pop(Array, ValuePtr);
 
 #define DArrayInsertAt(Array, Index, Value)                 \
@@ -49,6 +97,9 @@ VENG_API void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr);
 
 #define DArrayPopAt(Array, Index, ValuePtr) _darray_pop_at(Array, Index, ValuePtr)
 
+// NOTE: O(1) removal, the last element takes the place of the removed one
+#define DArraySwapRemove(Array, Index, ValuePtr) _darray_swap_remove(Array, Index, ValuePtr)
+
 #define DArrayClear(Array)                  _darray_field_set(Array, DARRAY_LENGTH, 0)
 
 #define DArrayCapacity(Array)               _darray_field_get(Array, DARRAY_CAPACITY)
@@ -59,3 +110,6 @@ VENG_API void* _darray_insert_at(void* Array, u64 Index, void* ValuePtr);
 
 #define DArrayLengthSet(Array, Value)       _darray_field_set(Array, DARRAY_LENGTH, Value)
 
+// NOTE: Growth factor in percent of the current capacity, 150 grows by 1.5x
+#define DArraySetGrowthFactor(Array, Percent) _darray_field_set(Array, DARRAY_GROWTH, Percent)
+
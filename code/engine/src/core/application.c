@@ -19,6 +19,7 @@
 #include "systems/texture_system.h"
 #include "systems/material_system.h"
 #include "systems/geometry_system.h"
+#include "systems/transform_system.h"
 #include "systems/resource_system.h"
 
 typedef struct application_state
@@ -59,6 +60,9 @@ typedef struct application_state
     u64 GeometrySystemMemoryRequirement;
     void* GeometrySystem;
 
+    u64 TransformSystemMemoryRequirement;
+    void* TransformSystem;
+
     u64 ResourceSystemMemoryRequirement;
     void* ResourceSystem;
 
@@ -114,8 +118,14 @@ b8 ApplicationCreate(game* GameInst)
     AppState->IsRunning   = false;
     AppState->IsSuspended = false;
 
-    u64 SystemsAllocatorTotalSize = 128*1024*1024;
-    LinearAllocatorCreate(SystemsAllocatorTotalSize, 0, &AppState->SystemsAllocator);
+    // NOTE: Only address space is reserved here, pages are committed as the systems below ask for them. Large
+    // pages stay off, they would commit the whole reservation at once.
+    u64 SystemsAllocatorReserveSize = 1024*1024*1024;
+    b8 SystemsAllocatorLargePages = false;
+    if(!LinearAllocatorCreateVirtual(SystemsAllocatorReserveSize, SystemsAllocatorLargePages, &AppState->SystemsAllocator))
+    {
+        return false;
+    }
 
     EventInitialize(&AppState->EventSystemMemoryRequirement, 0);
     AppState->EventSystem = LinearAllocatorAllocate(&AppState->SystemsAllocator, AppState->EventSystemMemoryRequirement);
@@ -153,6 +163,9 @@ b8 ApplicationCreate(game* GameInst)
         return false;
     }
 
+    // NOTE: Deliver the initial resize so the renderer sees the real framebuffer size
+    EventDispatchQueued();
+
     resource_system_config ResourceSysConfig;
     ResourceSysConfig.MaxLoaderCount = 32;
     ResourceSysConfig.AssetBasePath = "../assets";
@@ -185,7 +198,7 @@ b8 ApplicationCreate(game* GameInst)
     material_system_config MaterialSysConfig;
     MaterialSysConfig.MaxMaterialCount = 4096;
     MaterialSystemInitialize(&AppState->MaterialSystemMemoryRequirement, 0, MaterialSysConfig);
-    AppState->MaterialSystem = LinearAllocatorAllocate(&AppState->SystemsAllocator, AppState->TextureSystemMemoryRequirement);
+    AppState->MaterialSystem = LinearAllocatorAllocate(&AppState->SystemsAllocator, AppState->MaterialSystemMemoryRequirement);
     if(!MaterialSystemInitialize(&AppState->MaterialSystemMemoryRequirement, AppState->MaterialSystem, MaterialSysConfig))
     {
         VENG_FATAL("Failed to initialize material system. Aborting application");
@@ -202,17 +215,31 @@ b8 ApplicationCreate(game* GameInst)
         return false;
     }
 
+    transform_system_config TransformSysConfig;
+    TransformSysConfig.MaxTransformCount = 4096;
+    TransformSystemInitialize(&AppState->TransformSystemMemoryRequirement, 0, TransformSysConfig);
+    AppState->TransformSystem = LinearAllocatorAllocate(&AppState->SystemsAllocator, AppState->TransformSystemMemoryRequirement);
+    if(!TransformSystemInitialize(&AppState->TransformSystemMemoryRequirement, AppState->TransformSystem, TransformSysConfig))
+    {
+        VENG_FATAL("Failed to initialize transform system. Aborting application");
+        return false;
+    }
+
     geometry_config Config = GeometrySystemGeneratePlaneConfig(10.0f, 5.0f, 5, 5, 5.0f, 2.0f, "test geometry", "test_material");
+    GeometrySystemOptimizeConfig(&Config);
+    GeometrySystemPackConfig(&Config);
     AppState->TestGeometry = GeometrySystemAcquireFromConfig(Config, true);
 
-    Free(Config.Vertices, sizeof(vertex_3d) * Config.VertexCount, MEMORY_TAG_ARRAY);
+    Free(Config.Vertices, (u64)Config.VertexSize * Config.VertexCount, MEMORY_TAG_ARRAY);
     Free(Config.Indices, sizeof(u32) * Config.IndexCount, MEMORY_TAG_ARRAY);
 
     geometry_config UiConfig;
+    UiConfig.VertexFormat = VERTEX_FORMAT_2D;
     UiConfig.VertexSize  = sizeof(vertex_2d);
     UiConfig.VertexCount = 4;
     UiConfig.IndexSize  = sizeof(u32);
     UiConfig.IndexCount = 6;
+    UiConfig.LodCount   = 0;
     StringCopyN(UiConfig.MaterialName, "test_ui", MATERIAL_NAME_MAX_LENGTH);
     StringCopyN(UiConfig.Name, "test_ui_geometry", GEOMETRY_NAME_MAX_LENGTH);
 
@@ -274,8 +301,14 @@ b8 ApplicationRun()
             AppState->IsRunning = false;
         }
 
+        // NOTE: Input, window and worker events posted since the last frame are delivered here
+        EventDispatchQueued();
+
         if(!AppState->IsSuspended)
         {
+            MemoryBeginFrame();
+            EventTraceBeginFrame();
+
             ClockUpdate(&AppState->Clock);
             r64 CurrentTime = AppState->Clock.Elapsed;
             r64 Delta = (CurrentTime - AppState->LastTime);
@@ -288,6 +321,9 @@ b8 ApplicationRun()
                 break;
             }
 
+            // NOTE: World matrices of everything the game moved this frame
+            TransformSystemUpdate();
+
             if(!AppState->GameInst->Render(AppState->GameInst, (r32)Delta))
             {
                 VENG_FATAL("Game render failed.");
@@ -298,13 +334,15 @@ b8 ApplicationRun()
             render_packet Packet;
             Packet.DeltaTime = Delta;
 
-            geometry_render_data TestRender;
+            geometry_render_data TestRender = {};
             TestRender.Geometry = AppState->TestGeometry;
             TestRender.Model = Identity();
             Packet.GeometryCount = 1;
             Packet.Geometries = &TestRender;
+            Packet.OccluderCount = 0;
+            Packet.Occluders = 0;
 
-            geometry_render_data TestUiRender;
+            geometry_render_data TestUiRender = {};
             TestUiRender.Geometry = AppState->TestUiGeometry;
             TestUiRender.Model = Translation(V3(0, 0, 0));
             Packet.UiGeometryCount = 1;
@@ -346,13 +384,16 @@ b8 ApplicationRun()
 
     InputShutdown(AppState->InputSystem);
     ResourceSystemShutdown(AppState->ResourceSystem);
+    TransformSystemShutdown(AppState->TransformSystem);
     GeometrySystemShutdown(AppState->GeometrySystem);
     MaterialSystemShutdown(AppState->MaterialSystem);
     TextureSystemShutdown(AppState->TextureSystem);
     EventShutdown(AppState->EventSystem);
     RendererShutdown(AppState->RendererSystem);
     PlatformShutdown(AppState->PlatformSystem);
+    // NOTE: Memory goes first so its leak report still reaches the log
     ShutdownMemory(AppState->MemorySystem);
+    ShutdownLogging(AppState->LoggingSystem);
 
     return true;
 }
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: All operations are sequentially consistent. Fetch-style functions return the value before the operation.
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+INLINE u64
+AtomicLoadU64(volatile u64* Dest)
+{
+    return (u64)_InterlockedOr64((volatile long long*)Dest, 0);
+}
+
+INLINE void
+AtomicStoreU64(volatile u64* Dest, u64 Value)
+{
+    _InterlockedExchange64((volatile long long*)Dest, (long long)Value);
+}
+
+INLINE u64
+AtomicFetchAddU64(volatile u64* Dest, u64 Value)
+{
+    return (u64)_InterlockedExchangeAdd64((volatile long long*)Dest, (long long)Value);
+}
+
+INLINE u64
+AtomicFetchSubU64(volatile u64* Dest, u64 Value)
+{
+    return (u64)_InterlockedExchangeAdd64((volatile long long*)Dest, -(long long)Value);
+}
+
+INLINE b8
+AtomicCompareExchangeU64(volatile u64* Dest, u64 Expected, u64 Desired)
+{
+    return (u64)_InterlockedCompareExchange64((volatile long long*)Dest, (long long)Desired, (long long)Expected) == Expected;
+}
+
+INLINE u32
+AtomicLoadU32(volatile u32* Dest)
+{
+    return (u32)_InterlockedOr((volatile long*)Dest, 0);
+}
+
+INLINE void
+AtomicStoreU32(volatile u32* Dest, u32 Value)
+{
+    _InterlockedExchange((volatile long*)Dest, (long)Value);
+}
+
+INLINE u32
+AtomicFetchAddU32(volatile u32* Dest, u32 Value)
+{
+    return (u32)_InterlockedExchangeAdd((volatile long*)Dest, (long)Value);
+}
+
+INLINE b8
+AtomicCompareExchangeU32(volatile u32* Dest, u32 Expected, u32 Desired)
+{
+    return (u32)_InterlockedCompareExchange((volatile long*)Dest, (long)Desired, (long)Expected) == Expected;
+}
+#else
+
+INLINE u64
+AtomicLoadU64(volatile u64* Dest)
+{
+    return __atomic_load_n(Dest, __ATOMIC_SEQ_CST);
+}
+
+INLINE void
+AtomicStoreU64(volatile u64* Dest, u64 Value)
+{
+    __atomic_store_n(Dest, Value, __ATOMIC_SEQ_CST);
+}
+
+INLINE u64
+AtomicFetchAddU64(volatile u64* Dest, u64 Value)
+{
+    return __atomic_fetch_add(Dest, Value, __ATOMIC_SEQ_CST);
+}
+
+INLINE u64
+AtomicFetchSubU64(volatile u64* Dest, u64 Value)
+{
+    return __atomic_fetch_sub(Dest, Value, __ATOMIC_SEQ_CST);
+}
+
+INLINE b8
+AtomicCompareExchangeU64(volatile u64* Dest, u64 Expected, u64 Desired)
+{
+    return __atomic_compare_exchange_n(Dest, &Expected, Desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+INLINE u32
+AtomicLoadU32(volatile u32* Dest)
+{
+    return __atomic_load_n(Dest, __ATOMIC_SEQ_CST);
+}
+
+INLINE void
+AtomicStoreU32(volatile u32* Dest, u32 Value)
+{
+    __atomic_store_n(Dest, Value, __ATOMIC_SEQ_CST);
+}
+
+INLINE u32
+AtomicFetchAddU32(volatile u32* Dest, u32 Value)
+{
+    return __atomic_fetch_add(Dest, Value, __ATOMIC_SEQ_CST);
+}
+
+INLINE b8
+AtomicCompareExchangeU32(volatile u32* Dest, u32 Expected, u32 Desired)
+{
+    return __atomic_compare_exchange_n(Dest, &Expected, Desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
+
+// NOTE: Raises Dest to Value if Value is greater. Used for high-water marks.
+INLINE void
+AtomicMaxU64(volatile u64* Dest, u64 Value)
+{
+    u64 Current = AtomicLoadU64(Dest);
+    while(Value > Current)
+    {
+        if(AtomicCompareExchangeU64(Dest, Current, Value))
+        {
+            break;
+        }
+        Current = AtomicLoadU64(Dest);
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: console.bin layout, shared with code/tools/log_decoder. The file starts with a binary_log_file_header,
+// followed by records. Every record is a binary_log_record_header and Size payload bytes.
+//   BINARY_LOG_RECORD_FORMAT:  u8 ArgCount, u8 ArgTypes[ArgCount], the zero terminated format string
+//   BINARY_LOG_RECORD_MESSAGE: the arguments packed in ArgTypes order, strings as u16 length + bytes
+// A format record can land after the first message using it when several threads log, decoders read all formats first.
+#define BINARY_LOG_MAGIC 0x474F4C56
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_MAX_ARGS 16
+
+typedef struct binary_log_file_header
+{
+    u32 Magic;
+    u32 Version;
+} binary_log_file_header;
+
+typedef enum binary_log_record_type
+{
+    BINARY_LOG_RECORD_FORMAT  = 1,
+    BINARY_LOG_RECORD_MESSAGE = 2,
+} binary_log_record_type;
+
+typedef struct binary_log_record_header
+{
+    u8 Type;
+    u8 Level;
+    u16 Size;
+    u32 FormatID;
+} binary_log_record_header;
+
+typedef enum binary_log_arg_type
+{
+    BINARY_LOG_ARG_I32,
+    BINARY_LOG_ARG_U32,
+    BINARY_LOG_ARG_I64,
+    BINARY_LOG_ARG_U64,
+    BINARY_LOG_ARG_R64,
+    BINARY_LOG_ARG_POINTER,
+    BINARY_LOG_ARG_STRING,
+} binary_log_arg_type;
+
+// NOTE: One printf conversion. ArgTypes holds the '*' width and precision arguments followed by the value,
+// ArgCount is 0 for "%%".
+typedef struct binary_log_spec
+{
+    u32 Start;
+    u32 Length;
+    u32 ArgCount;
+    u8 ArgTypes[3];
+    char Conversion;
+} binary_log_spec;
+
+// NOTE: Finds the next conversion at or after *Cursor and moves the cursor past it. Returns false at the end of the format.
+INLINE b8
+BinaryLogNextSpec(const char* Format, u32* Cursor, binary_log_spec* OutSpec)
+{
+    u32 At = *Cursor;
+    while(Format[At] && Format[At] != '%')
+    {
+        At++;
+    }
+
+    if(!Format[At])
+    {
+        *Cursor = At;
+        return false;
+    }
+
+    OutSpec->Start    = At++;
+    OutSpec->ArgCount = 0;
+
+    while(Format[At] == '-' || Format[At] == '+' || Format[At] == ' ' || Format[At] == '#' || Format[At] == '0')
+    {
+        At++;
+    }
+
+    if(Format[At] == '*')
+    {
+        OutSpec->ArgTypes[OutSpec->ArgCount++] = BINARY_LOG_ARG_I32;
+        At++;
+    }
+    while(Format[At] >= '0' && Format[At] <= '9')
+    {
+        At++;
+    }
+
+    if(Format[At] == '.')
+    {
+        At++;
+        if(Format[At] == '*')
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = BINARY_LOG_ARG_I32;
+            At++;
+        }
+        while(Format[At] >= '0' && Format[At] <= '9')
+        {
+            At++;
+        }
+    }
+
+    b8 Wide = false;
+    if(Format[At] == 'h')
+    {
+        At += Format[At + 1] == 'h' ? 2 : 1;
+    }
+    else if(Format[At] == 'l')
+    {
+        Wide = Format[At + 1] == 'l' || sizeof(long) == 8;
+        At += Format[At + 1] == 'l' ? 2 : 1;
+    }
+    else if(Format[At] == 'z' || Format[At] == 'j' || Format[At] == 't')
+    {
+        Wide = sizeof(void*) == 8 || Format[At] == 'j';
+        At++;
+    }
+    else if(Format[At] == 'L')
+    {
+        At++;
+    }
+    else if(Format[At] == 'I' && Format[At + 1] == '6' && Format[At + 2] == '4')
+    {
+        Wide = true;
+        At += 3;
+    }
+    else if(Format[At] == 'I' && Format[At + 1] == '3' && Format[At + 2] == '2')
+    {
+        At += 3;
+    }
+
+    OutSpec->Conversion = Format[At];
+    switch(Format[At])
+    {
+        case 'd': case 'i': case 'c':
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = Wide ? BINARY_LOG_ARG_I64 : BINARY_LOG_ARG_I32;
+        } break;
+        case 'u': case 'x': case 'X': case 'o':
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = Wide ? BINARY_LOG_ARG_U64 : BINARY_LOG_ARG_U32;
+        } break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = BINARY_LOG_ARG_R64;
+        } break;
+        case 'p':
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = BINARY_LOG_ARG_POINTER;
+        } break;
+        case 's':
+        {
+            OutSpec->ArgTypes[OutSpec->ArgCount++] = BINARY_LOG_ARG_STRING;
+        } break;
+        case '%':
+        {
+            OutSpec->ArgCount = 0;
+        } break;
+        default:
+        {
+            // NOTE: Unknown or truncated conversion, consumes nothing
+            OutSpec->ArgCount = 0;
+            if(!Format[At])
+            {
+                At--;
+            }
+        } break;
+    }
+
+    At++;
+    OutSpec->Length = At - OutSpec->Start;
+    *Cursor = At;
+    return true;
+}
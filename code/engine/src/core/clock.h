@@ -8,6 +8,6 @@ typedef struct clock
     r64 Elapsed;
 } clock;
 
-void ClockUpdate(clock* Clock);
-void ClockStart(clock* Clock);
-void ClockStop(clock* Clock);
+VENG_API void ClockUpdate(clock* Clock);
+VENG_API void ClockStart(clock* Clock);
+VENG_API void ClockStop(clock* Clock);
@@ -1,27 +1,261 @@
 #include "event.h"
 #include "core/vmemory.h"
+#include "core/logger.h"
+#include "core/atomic.h"
 #include "containers/darray.h"
+#include "core/vstring.h"
+#include "platform/platform.h"
+#include "platform/file_system.h"
 
 typedef struct registered_event
 {
     void* Listener;
     PFN_OnEvent Callback;
+    u32 Slot;
 } registered_event;
 
-typedef struct event_code_entry
+// NOTE: Handle indirection, so listeners keep their handle while the dense table is compacted
+typedef struct listener_slot
 {
-    registered_event* Events;
-} event_code_entry;
+    u32 DenseIndex;
+    u32 Generation;
+} listener_slot;
 
-#define MAX_MESSAGE_CODES 16384
+#define EVENT_CODE_COUNT (MAX_EVENT_CODE + 1)
+
+#define EVENT_QUEUE_CAPACITY 1024
+#define EVENT_THREADED_QUEUE_CAPACITY 1024
+
+typedef struct queued_event
+{
+    u16 Code;
+    void* Sender;
+    event_context Context;
+#if VENG_EVENT_TRACING
+    r64 PostTime;
+#endif
+} queued_event;
+
+// NOTE: Bounded multi-producer queue, every slot carries a sequence number telling 
+// producers and the consumer whose turn it is. Producers only CAS the enqueue position.
+typedef struct threaded_event_slot
+{
+    volatile u64 Sequence;
+    queued_event Event;
+} threaded_event_slot;
+
+#define EVENT_TRACE_MAX_THREADS 8
+#define EVENT_TRACE_BUFFER_CAPACITY 2048
+#define EVENT_TRACE_LATENCY_BASE 0.00005
+
+#ifdef _MSC_VER
+#define EVENT_THREAD_LOCAL __declspec(thread)
+#else
+#define EVENT_THREAD_LOCAL __thread
+#endif
+
+// NOTE: Callback == 0 marks the record of the whole EventFire, the others are single listener calls
+typedef struct event_trace_record
+{
+    r64 Begin;
+    r64 End;
+    r64 PostTime;
+    PFN_OnEvent Callback;
+    void* Listener;
+    u16 Code;
+    u16 Thread;
+} event_trace_record;
+
+// NOTE: Single producer (the owning thread), single consumer (EventTraceBeginFrame)
+typedef struct event_trace_buffer
+{
+    volatile u32 Write;
+    volatile u32 Read;
+    event_trace_record Records[EVENT_TRACE_BUFFER_CAPACITY];
+} event_trace_buffer;
+
+typedef struct event_trace_state
+{
+    event_trace_buffer Buffers[EVENT_TRACE_MAX_THREADS];
+    volatile u32 ThreadCount;
+    volatile u32 Dropped;
+    u32 DroppedCollected;
+
+    event_frame_summary Summary;
+    u64 Frame;
+
+    b8 Capturing;
+    r64 CaptureStart;
+    event_trace_record* Captured;
+} event_trace_state;
 
 typedef struct event_system_state
 {
-    event_code_entry Registered[MAX_MESSAGE_CODES];
+    // NOTE: Listeners of every code in one array grouped by code, listeners of Code live in 
+    // [CodeStart[Code], CodeStart[Code + 1]). Unregistered entries stay as tombstones (Callback == 0)
+    // until the next compaction, so removing a listener never shifts the table.
+    registered_event* Listeners;
+    u32 CodeStart[EVENT_CODE_COUNT + 1];
+    u32 TombstoneCount;
+    u32 DispatchDepth;
+
+    listener_slot* Slots;
+    u32* FreeSlots;
+
+    queued_event Queue[EVENT_QUEUE_CAPACITY];
+    u64 QueueHead;
+    u64 QueueTail;
+
+    // NOTE: Queue position + 1 of the pending event per code, 0 if there is none
+    u64 CoalescedSlot[EVENT_CODE_COUNT];
+    b8 Coalesce[EVENT_CODE_COUNT];
+
+    threaded_event_slot ThreadedQueue[EVENT_THREADED_QUEUE_CAPACITY];
+    volatile u64 ThreadedEnqueuePos;
+    u64 ThreadedDequeuePos;
+
+#if VENG_EVENT_TRACING
+    event_trace_state Trace;
+#endif
 } event_system_state;
 
 static event_system_state* EventState;
 
+#if VENG_EVENT_TRACING
+// NOTE: Trace buffer index + 1 of the calling thread, 0 until its first record
+static EVENT_THREAD_LOCAL u32 TraceThreadIndex;
+
+static void TraceRecord(u16 Code, PFN_OnEvent Callback, void* Listener, r64 Begin, r64 End, r64 PostTime)
+{
+    event_trace_state* Trace = &EventState->Trace;
+    if(TraceThreadIndex == 0)
+    {
+        TraceThreadIndex = AtomicFetchAddU32(&Trace->ThreadCount, 1) + 1;
+    }
+
+    if(TraceThreadIndex > EVENT_TRACE_MAX_THREADS)
+    {
+        AtomicFetchAddU32(&Trace->Dropped, 1);
+        return;
+    }
+
+    event_trace_buffer* Buffer = &Trace->Buffers[TraceThreadIndex - 1];
+    u32 Write = Buffer->Write;
+    if(Write - AtomicLoadU32(&Buffer->Read) >= EVENT_TRACE_BUFFER_CAPACITY)
+    {
+        AtomicFetchAddU32(&Trace->Dropped, 1);
+        return;
+    }
+
+    event_trace_record* Record = &Buffer->Records[Write & (EVENT_TRACE_BUFFER_CAPACITY - 1)];
+    Record->Begin    = Begin;
+    Record->End      = End;
+    Record->PostTime = PostTime;
+    Record->Callback = Callback;
+    Record->Listener = Listener;
+    Record->Code     = Code;
+    Record->Thread   = (u16)(TraceThreadIndex - 1);
+    AtomicStoreU32(&Buffer->Write, Write + 1);
+}
+
+static u32 GetLatencyBucket(r64 Latency)
+{
+    u32 Bucket = 0;
+    r64 Limit  = EVENT_TRACE_LATENCY_BASE;
+    while(Latency > Limit && Bucket < EVENT_TRACE_LATENCY_BUCKET_COUNT - 1)
+    {
+        Limit *= 2.0;
+        Bucket++;
+    }
+
+    return Bucket;
+}
+
+static void SummarizeRecord(event_frame_summary* Summary, event_trace_record* Record)
+{
+    event_code_trace* CodeTrace = &Summary->Codes[Record->Code];
+    r64 Duration = Record->End - Record->Begin;
+    if(Record->Callback == 0)
+    {
+        Summary->FireCount++;
+        CodeTrace->FireCount++;
+        if(Record->PostTime > 0.0)
+        {
+            r64 Latency = Record->Begin - Record->PostTime;
+            CodeTrace->QueuedCount++;
+            CodeTrace->LatencyHistogram[GetLatencyBucket(Latency)]++;
+            CodeTrace->MaxLatency = Latency > CodeTrace->MaxLatency ? Latency : CodeTrace->MaxLatency;
+        }
+        return;
+    }
+
+    Summary->ListenerTime += Duration;
+    CodeTrace->ListenerCalls++;
+    CodeTrace->ListenerTime += Duration;
+    CodeTrace->MaxListenerTime = Duration > CodeTrace->MaxListenerTime ? Duration : CodeTrace->MaxListenerTime;
+
+    event_listener_trace* ListenerTrace = 0;
+    for(u32 ListenerIndex = 0;
+        ListenerIndex < Summary->ListenerCount;
+        ++ListenerIndex)
+    {
+        event_listener_trace* Candidate = &Summary->Listeners[ListenerIndex];
+        if(Candidate->Code == Record->Code && Candidate->Callback == Record->Callback && Candidate->Listener == Record->Listener)
+        {
+            ListenerTrace = Candidate;
+            break;
+        }
+    }
+
+    if(!ListenerTrace)
+    {
+        if(Summary->ListenerCount == EVENT_TRACE_MAX_LISTENERS)
+        {
+            return;
+        }
+
+        ListenerTrace = &Summary->Listeners[Summary->ListenerCount++];
+        ListenerTrace->Callback = Record->Callback;
+        ListenerTrace->Listener = Record->Listener;
+        ListenerTrace->Code     = Record->Code;
+    }
+
+    ListenerTrace->Calls++;
+    ListenerTrace->Time += Duration;
+    ListenerTrace->MaxTime = Duration > ListenerTrace->MaxTime ? Duration : ListenerTrace->MaxTime;
+}
+
+static void CollectTraceRecords()
+{
+    event_trace_state* Trace = &EventState->Trace;
+    u32 ThreadCount = AtomicLoadU32(&Trace->ThreadCount);
+    ThreadCount = ThreadCount < EVENT_TRACE_MAX_THREADS ? ThreadCount : EVENT_TRACE_MAX_THREADS;
+    for(u32 ThreadIndex = 0;
+        ThreadIndex < ThreadCount;
+        ++ThreadIndex)
+    {
+        event_trace_buffer* Buffer = &Trace->Buffers[ThreadIndex];
+        u32 Write = AtomicLoadU32(&Buffer->Write);
+        for(u32 Read = Buffer->Read;
+            Read != Write;
+            ++Read)
+        {
+            event_trace_record* Record = &Buffer->Records[Read & (EVENT_TRACE_BUFFER_CAPACITY - 1)];
+            SummarizeRecord(&Trace->Summary, Record);
+            if(Trace->Capturing)
+            {
+                DArrayPush(Trace->Captured, *Record);
+            }
+        }
+        AtomicStoreU32(&Buffer->Read, Write);
+    }
+
+    u32 Dropped = AtomicLoadU32(&Trace->Dropped);
+    Trace->Summary.DroppedRecords += Dropped - Trace->DroppedCollected;
+    Trace->DroppedCollected = Dropped;
+}
+#endif
+
 
 void EventInitialize(u64* MemoryRequirement, void* State)
 {
@@ -33,110 +267,533 @@ void EventInitialize(u64* MemoryRequirement, void* State)
 
     ZeroMemory(State, sizeof(event_system_state));
     EventState = State;
+
+    for(u64 SlotIndex = 0;
+        SlotIndex < EVENT_THREADED_QUEUE_CAPACITY;
+        ++SlotIndex)
+    {
+        EventState->ThreadedQueue[SlotIndex].Sequence = SlotIndex;
+    }
+
+    EventState->Coalesce[EVENT_CODE_MOUSE_MOVED] = true;
+    EventState->Coalesce[EVENT_CODE_RESIZED] = true;
 }
 
 void EventShutdown(void* State)
 {
     if(EventState)
     {
-        for(s16 EventIndex = 0;
-            EventIndex < MAX_MESSAGE_CODES;
-            ++EventIndex)
+#if VENG_EVENT_TRACING
+        if(EventState->Trace.Captured)
         {
-            if(EventState->Registered[EventIndex].Events != 0)
+            DArrayDestroy(EventState->Trace.Captured);
+            EventState->Trace.Captured = 0;
+        }
+#endif
+
+        if(EventState->Listeners)
+        {
+            DArrayDestroy(EventState->Listeners);
+            DArrayDestroy(EventState->Slots);
+            DArrayDestroy(EventState->FreeSlots);
+            EventState->Listeners = 0;
+            EventState->Slots = 0;
+            EventState->FreeSlots = 0;
+        }
+    }
+
+    EventState = 0;
+}
+
+static void CompactListeners()
+{
+    if(EventState->TombstoneCount == 0 || EventState->DispatchDepth > 0)
+    {
+        return;
+    }
+
+    u32 Write = 0;
+    for(u32 Code = 0;
+        Code < EVENT_CODE_COUNT;
+        ++Code)
+    {
+        u32 Begin = EventState->CodeStart[Code];
+        u32 End   = EventState->CodeStart[Code + 1];
+        EventState->CodeStart[Code] = Write;
+        for(u32 Read = Begin;
+            Read < End;
+            ++Read)
+        {
+            registered_event Event = EventState->Listeners[Read];
+            if(Event.Callback)
             {
-                DArrayDestroy(EventState->Registered[EventIndex].Events);
-                EventState->Registered[EventIndex].Events = 0;
+                EventState->Listeners[Write] = Event;
+                EventState->Slots[Event.Slot].DenseIndex = Write;
+                Write++;
             }
         }
     }
 
-    EventState = 0;
+    EventState->CodeStart[EVENT_CODE_COUNT] = Write;
+    DArrayLengthSet(EventState->Listeners, Write);
+    EventState->TombstoneCount = 0;
 }
 
-b8 EventRegister(u16 Code, void* Listener, PFN_OnEvent OnEvent)
+b8 EventRegisterHandle(u16 Code, void* Listener, PFN_OnEvent OnEvent, event_handle* OutHandle)
 {
     if(!EventState)
     {
         return false;
     }
 
-    if(EventState->Registered[Code].Events == 0)
+    if(Code > MAX_EVENT_CODE)
     {
-        EventState->Registered[Code].Events = (registered_event*)DArrayCreate(registered_event);
+        VENG_ERROR("EventRegister - code %u is above MAX_EVENT_CODE.", Code);
+        return false;
     }
 
-    u64 RegisteredCount = DArrayLength(EventState->Registered[Code].Events);
-    for(u32 EventIndex = 0;
-        EventIndex < RegisteredCount;
+    if(!EventState->Listeners)
+    {
+        EventState->Listeners = DArrayCreate(registered_event);
+        EventState->Slots     = DArrayCreate(listener_slot);
+        EventState->FreeSlots = DArrayCreate(u32);
+    }
+
+    for(u32 EventIndex = EventState->CodeStart[Code];
+        EventIndex < EventState->CodeStart[Code + 1];
         ++EventIndex)
     {
-        if(EventState->Registered[Code].Events[EventIndex].Listener == Listener)
+        registered_event* Event = &EventState->Listeners[EventIndex];
+        if(Event->Callback && Event->Listener == Listener)
         {
             return false;
         }
     }
 
+    CompactListeners();
+
+    u32 SlotIndex = 0;
+    if(DArrayLength(EventState->FreeSlots) > 0)
+    {
+        DArrayPop(EventState->FreeSlots, &SlotIndex);
+    }
+    else
+    {
+        SlotIndex = (u32)DArrayLength(EventState->Slots);
+        listener_slot NewSlot = {};
+        NewSlot.Generation = 1;
+        DArrayPush(EventState->Slots, NewSlot);
+    }
+
+    // NOTE: New listeners go to the end of their code range, everything after it moves by one
+    u32 InsertIndex = EventState->CodeStart[Code + 1];
     registered_event Event;
     Event.Listener = Listener;
     Event.Callback = OnEvent;
-    DArrayPush(EventState->Registered[Code].Events, Event);
+    Event.Slot     = SlotIndex;
+    DArrayInsertAt(EventState->Listeners, InsertIndex, Event);
+
+    for(u32 NextCode = Code + 1;
+        NextCode <= EVENT_CODE_COUNT;
+        ++NextCode)
+    {
+        EventState->CodeStart[NextCode]++;
+    }
+
+    u32 ListenerCount = (u32)DArrayLength(EventState->Listeners);
+    for(u32 Moved = InsertIndex + 1;
+        Moved < ListenerCount;
+        ++Moved)
+    {
+        if(EventState->Listeners[Moved].Callback)
+        {
+            EventState->Slots[EventState->Listeners[Moved].Slot].DenseIndex = Moved;
+        }
+    }
+
+    EventState->Slots[SlotIndex].DenseIndex = InsertIndex;
+
+    if(OutHandle)
+    {
+        *OutHandle = ((u64)EventState->Slots[SlotIndex].Generation << 32) | SlotIndex;
+    }
 
     return true;
 }
 
-b8 EventUnregister(u16 Code, void* Listener, PFN_OnEvent OnEvent)
+b8 EventRegister(u16 Code, void* Listener, PFN_OnEvent OnEvent)
 {
-    if(!EventState)
+    return EventRegisterHandle(Code, Listener, OnEvent, 0);
+}
+
+b8 EventUnregisterHandle(event_handle Handle)
+{
+    if(!EventState || !EventState->Slots)
+    {
+        return false;
+    }
+
+    u32 SlotIndex  = (u32)(Handle & 0xFFFFFFFF);
+    u32 Generation = (u32)(Handle >> 32);
+    if(SlotIndex >= DArrayLength(EventState->Slots) || EventState->Slots[SlotIndex].Generation != Generation)
     {
         return false;
     }
 
-    if(EventState->Registered[Code].Events == 0)
+    listener_slot* Slot = &EventState->Slots[SlotIndex];
+    registered_event* Event = &EventState->Listeners[Slot->DenseIndex];
+    Event->Callback = 0;
+    Event->Listener = 0;
+    Event->Slot = INVALID_ID;
+
+    Slot->Generation++;
+    DArrayPush(EventState->FreeSlots, SlotIndex);
+    EventState->TombstoneCount++;
+
+    return true;
+}
+
+b8 EventUnregister(u16 Code, void* Listener, PFN_OnEvent OnEvent)
+{
+    if(!EventState || !EventState->Listeners || Code > MAX_EVENT_CODE)
     {
         return false;
     }
 
-    u64 RegisteredCount = DArrayLength(EventState->Registered[Code].Events);
-    for(u32 EventIndex = 0;
-        EventIndex < RegisteredCount;
+    for(u32 EventIndex = EventState->CodeStart[Code];
+        EventIndex < EventState->CodeStart[Code + 1];
         ++EventIndex)
     {
-        registered_event Event = EventState->Registered[Code].Events[EventIndex];
-        if(Event.Listener == Listener && Event.Callback == OnEvent)
+        registered_event Event = EventState->Listeners[EventIndex];
+        if(Event.Callback == OnEvent && Event.Listener == Listener)
         {
-            registered_event PopedEvent;
-            DArrayPopAt(EventState->Registered[Code].Events, EventIndex, &PopedEvent);
-            return true;
+            u64 Handle = ((u64)EventState->Slots[Event.Slot].Generation << 32) | Event.Slot;
+            return EventUnregisterHandle(Handle);
         }
     }
 
     return false;
 }
+
+static b8 FireEvent(u16 Code, void* Sender, event_context Context, r64 PostTime)
+{
+    if(!EventState || !EventState->Listeners || Code > MAX_EVENT_CODE)
+    {
+        return false;
+    }
+
+#if VENG_EVENT_TRACING
+    r64 FireBegin = PlatformGetAbsoluteTime();
+#endif
+
+    // NOTE: Listeners may (un)register from inside a callback. Compaction is held off while dispatching
+    // and the range is re-read every step, insertions for lower codes shift the whole range together.
+    b8 Handled = false;
+    EventState->DispatchDepth++;
+    for(u32 Offset = 0;
+        EventState->CodeStart[Code] + Offset < EventState->CodeStart[Code + 1];
+        ++Offset)
+    {
+        registered_event Event = EventState->Listeners[EventState->CodeStart[Code] + Offset];
+        if(!Event.Callback)
+        {
+            continue;
+        }
+
+#if VENG_EVENT_TRACING
+        r64 CallBegin = PlatformGetAbsoluteTime();
+        b8 CallHandled = Event.Callback(Code, Sender, Event.Listener, Context);
+        TraceRecord(Code, Event.Callback, Event.Listener, CallBegin, PlatformGetAbsoluteTime(), 0.0);
+#else
+        b8 CallHandled = Event.Callback(Code, Sender, Event.Listener, Context);
+#endif
+        if(CallHandled)
+        {
+            Handled = true;
+            break;
+        }
+    }
+    EventState->DispatchDepth--;
+
+#if VENG_EVENT_TRACING
+    TraceRecord(Code, 0, 0, FireBegin, PlatformGetAbsoluteTime(), PostTime);
+#endif
+
+    return Handled;
+}
+
 b8 EventFire(u16 Code, void* Sender, event_context Context)
+{
+    return FireEvent(Code, Sender, Context, 0.0);
+}
+
+void EventSetCoalesce(u16 Code, b8 Coalesce)
+{
+    if(EventState && Code <= MAX_EVENT_CODE)
+    {
+        EventState->Coalesce[Code] = Coalesce;
+    }
+}
+
+b8 EventPost(u16 Code, void* Sender, event_context Context)
 {
     if(!EventState)
     {
         return false;
     }
 
-    if(EventState->Registered[Code].Events == 0)
+    // NOTE: Only the last queued event is rewritten, merging into an older one would deliver the newest context
+    // ahead of the events posted after it
+    b8 CanCoalesce = Code <= MAX_EVENT_CODE && EventState->Coalesce[Code];
+    if(CanCoalesce)
+    {
+        u64 Slot = EventState->CoalescedSlot[Code];
+        if(Slot > EventState->QueueHead && Slot == EventState->QueueTail)
+        {
+            queued_event* Pending = &EventState->Queue[(Slot - 1) & (EVENT_QUEUE_CAPACITY - 1)];
+            if(Pending->Code == Code && Pending->Sender == Sender)
+            {
+                Pending->Context = Context;
+                return true;
+            }
+        }
+    }
+
+    if(EventState->QueueTail - EventState->QueueHead >= EVENT_QUEUE_CAPACITY)
+    {
+        VENG_WARN("Event queue is full, firing event %u immediately.", Code);
+        return EventFire(Code, Sender, Context);
+    }
+
+    queued_event* Event = &EventState->Queue[EventState->QueueTail & (EVENT_QUEUE_CAPACITY - 1)];
+    Event->Code    = Code;
+    Event->Sender  = Sender;
+    Event->Context = Context;
+#if VENG_EVENT_TRACING
+    Event->PostTime = PlatformGetAbsoluteTime();
+#endif
+    EventState->QueueTail++;
+
+    if(CanCoalesce)
+    {
+        EventState->CoalescedSlot[Code] = EventState->QueueTail;
+    }
+
+    return true;
+}
+
+b8 EventPostThreaded(u16 Code, void* Sender, event_context Context)
+{
+    if(!EventState)
     {
         return false;
     }
 
-    u64 RegisteredCount = DArrayLength(EventState->Registered[Code].Events);
-    for(u32 EventIndex = 0;
-        EventIndex < RegisteredCount;
-        ++EventIndex)
+    u64 Pos = AtomicLoadU64(&EventState->ThreadedEnqueuePos);
+    for(;;)
     {
-        registered_event Event = EventState->Registered[Code].Events[EventIndex];
-        if(Event.Callback(Code, Sender, Event.Listener, Context))
+        threaded_event_slot* Slot = &EventState->ThreadedQueue[Pos & (EVENT_THREADED_QUEUE_CAPACITY - 1)];
+        u64 Sequence = AtomicLoadU64(&Slot->Sequence);
+        s64 Diff = (s64)Sequence - (s64)Pos;
+        if(Diff == 0)
+        {
+            if(AtomicCompareExchangeU64(&EventState->ThreadedEnqueuePos, Pos, Pos + 1))
+            {
+                Slot->Event.Code    = Code;
+                Slot->Event.Sender  = Sender;
+                Slot->Event.Context = Context;
+#if VENG_EVENT_TRACING
+                Slot->Event.PostTime = PlatformGetAbsoluteTime();
+#endif
+                AtomicStoreU64(&Slot->Sequence, Pos + 1);
+                return true;
+            }
+        }
+        else if(Diff < 0)
         {
-            return true;
+            return false;
         }
+
+        Pos = AtomicLoadU64(&EventState->ThreadedEnqueuePos);
     }
+}
 
-    return false;
+void EventDispatchQueued()
+{
+    if(!EventState)
+    {
+        return;
+    }
+
+    if(EventState->Listeners)
+    {
+        CompactListeners();
+    }
+
+    // NOTE: Events posted by listeners while draining are delivered on the next call
+    u64 Tail = EventState->QueueTail;
+    while(EventState->QueueHead < Tail)
+    {
+        queued_event Event = EventState->Queue[EventState->QueueHead & (EVENT_QUEUE_CAPACITY - 1)];
+        EventState->QueueHead++;
+        if(Event.Code <= MAX_EVENT_CODE && EventState->CoalescedSlot[Event.Code] == EventState->QueueHead)
+        {
+            EventState->CoalescedSlot[Event.Code] = 0;
+        }
+
+#if VENG_EVENT_TRACING
+        FireEvent(Event.Code, Event.Sender, Event.Context, Event.PostTime);
+#else
+        EventFire(Event.Code, Event.Sender, Event.Context);
+#endif
+    }
+
+    for(u32 Drained = 0;
+        Drained < EVENT_THREADED_QUEUE_CAPACITY;
+        ++Drained)
+    {
+        u64 Pos = EventState->ThreadedDequeuePos;
+        threaded_event_slot* Slot = &EventState->ThreadedQueue[Pos & (EVENT_THREADED_QUEUE_CAPACITY - 1)];
+        if(AtomicLoadU64(&Slot->Sequence) != Pos + 1)
+        {
+            break;
+        }
+
+        queued_event Event = Slot->Event;
+        AtomicStoreU64(&Slot->Sequence, Pos + EVENT_THREADED_QUEUE_CAPACITY);
+        EventState->ThreadedDequeuePos = Pos + 1;
+
+#if VENG_EVENT_TRACING
+        FireEvent(Event.Code, Event.Sender, Event.Context, Event.PostTime);
+#else
+        EventFire(Event.Code, Event.Sender, Event.Context);
+#endif
+    }
 }
 
+void EventTraceBeginFrame()
+{
+#if VENG_EVENT_TRACING
+    if(!EventState)
+    {
+        return;
+    }
+
+    event_trace_state* Trace = &EventState->Trace;
+    ZeroMemory(&Trace->Summary, sizeof(event_frame_summary));
+    Trace->Summary.Frame = Trace->Frame++;
+    CollectTraceRecords();
+#endif
+}
+
+const event_frame_summary* EventTraceGetFrameSummary()
+{
+#if VENG_EVENT_TRACING
+    return EventState ? &EventState->Trace.Summary : 0;
+#else
+    return 0;
+#endif
+}
+
+r64 EventTraceGetLatencyBucketLimit(u32 Bucket)
+{
+    r64 Limit = EVENT_TRACE_LATENCY_BASE;
+    for(u32 Step = 0;
+        Step < Bucket && Step < EVENT_TRACE_LATENCY_BUCKET_COUNT - 1;
+        ++Step)
+    {
+        Limit *= 2.0;
+    }
+
+    return Limit;
+}
+
+void EventTraceBeginCapture()
+{
+#if VENG_EVENT_TRACING
+    if(!EventState || EventState->Trace.Capturing)
+    {
+        return;
+    }
+
+    event_trace_state* Trace = &EventState->Trace;
+    if(!Trace->Captured)
+    {
+        Trace->Captured = DArrayCreate(event_trace_record);
+    }
+
+    DArrayClear(Trace->Captured);
+    Trace->Capturing = true;
+    Trace->CaptureStart = PlatformGetAbsoluteTime();
+#else
+    VENG_WARN("EventTraceBeginCapture - engine was built without VENG_EVENT_TRACING.");
+#endif
+}
+
+b8 EventTraceEndCapture(const char* Path)
+{
+#if VENG_EVENT_TRACING
+    if(!EventState || !EventState->Trace.Capturing)
+    {
+        return false;
+    }
+
+    event_trace_state* Trace = &EventState->Trace;
+    CollectTraceRecords();
+    Trace->Capturing = false;
+
+    file_handle File;
+    if(!FileOpen(Path, FILE_MODE_WRITE, false, &File))
+    {
+        VENG_ERROR("EventTraceEndCapture - unable to open '%s' for writing.", Path);
+        return false;
+    }
+
+    // NOTE: Timestamps are microseconds from the start of the capture. Whole fires are named after the code, 
+    // listener calls nest inside them and queued fires carry their post to dispatch latency.
+    char Line[512];
+    u64 Written = 0;
+    const char* Header = "{\"traceEvents\":[\n";
+    FileWrite(&File, StringLength(Header), Header, &Written);
+
+    u64 RecordCount = DArrayLength(Trace->Captured);
+    for(u64 RecordIndex = 0;
+        RecordIndex < RecordCount;
+        ++RecordIndex)
+    {
+        event_trace_record* Record = &Trace->Captured[RecordIndex];
+        r64 Begin    = (Record->Begin - Trace->CaptureStart) * 1000000.0;
+        r64 Duration = (Record->End - Record->Begin) * 1000000.0;
+        const char* Separator = RecordIndex + 1 < RecordCount ? "," : "";
+        s32 Length = 0;
+        if(Record->Callback == 0)
+        {
+            r64 Latency = Record->PostTime > 0.0 ? (Record->Begin - Record->PostTime) * 1000000.0 : 0.0;
+            Length = StringFormat(Line, "{\"name\":\"event 0x%02x\",\"cat\":\"event\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                                        "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queued\":%s,\"latency_us\":%.3f}}%s\n",
+                                  Record->Code, Record->Thread, Begin, Duration, 
+                                  Record->PostTime > 0.0 ? "true" : "false", Latency, Separator);
+        }
+        else
+        {
+            Length = StringFormat(Line, "{\"name\":\"listener 0x%llx\",\"cat\":\"listener\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,"
+                                        "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"code\":%u,\"instance\":\"0x%llx\"}}%s\n",
+                                  (u64)Record->Callback, Record->Thread, Begin, Duration, 
+                                  Record->Code, (u64)Record->Listener, Separator);
+        }
+
+        FileWrite(&File, (u64)Length, Line, &Written);
+    }
+
+    const char* Footer = "]}\n";
+    FileWrite(&File, StringLength(Footer), Footer, &Written);
+    FileClose(&File);
+
+    VENG_INFO("Event trace with %llu records written to '%s'.", RecordCount, Path);
+    DArrayClear(Trace->Captured);
+    return true;
+#else
+    VENG_WARN("EventTraceEndCapture - engine was built without VENG_EVENT_TRACING.");
+    return false;
+#endif
+}
@@ -2,6 +2,11 @@
 
 #include "defines.h"
 
+// NOTE: Set to 1 to record every EventFire and listener callback into per-thread trace buffers.
+#ifndef VENG_EVENT_TRACING
+#define VENG_EVENT_TRACING 0
+#endif
+
 typedef struct event_context
 {
     union
@@ -26,13 +31,27 @@ typedef struct event_context
 
 typedef b8 (*PFN_OnEvent)(u16 Code, void* Sender, void* ListenerInst, event_context Data);
 
-void EventInitialize(u64* MemoryRequirement, void* State);
-void EventShutdown(void* State);
+// NOTE: Generation in the high 32 bits, slot in the low 32 bits. 0 is never a valid handle.
+typedef u64 event_handle;
+
+VENG_API void EventInitialize(u64* MemoryRequirement, void* State);
+VENG_API void EventShutdown(void* State);
 
 VENG_API b8 EventRegister(u16 Code, void* Listener, PFN_OnEvent OnEvent);
 VENG_API b8 EventUnregister(u16 Code, void* Listener, PFN_OnEvent OnEvent);
+VENG_API b8 EventRegisterHandle(u16 Code, void* Listener, PFN_OnEvent OnEvent, event_handle* OutHandle);
+VENG_API b8 EventUnregisterHandle(event_handle Handle);
 VENG_API b8 EventFire(u16 Code, void* Sender, event_context Context);
 
+// NOTE: Deferred events. EventPost queues for the main thread and coalesces codes marked with 
+// EventSetCoalesce: a post replaces the context of a pending one while it is still the last queued event, so
+// runs of the same event collapse but never move past other events. EventPostThreaded is safe 
+// to call from any thread, it returns false if the queue is full. Both are delivered by EventDispatchQueued.
+VENG_API b8 EventPost(u16 Code, void* Sender, event_context Context);
+VENG_API b8 EventPostThreaded(u16 Code, void* Sender, event_context Context);
+VENG_API void EventSetCoalesce(u16 Code, b8 Coalesce);
+void EventDispatchQueued();
+
 typedef enum system_event_code
 {
     EVENT_CODE_APPLICATION_QUIT = 0x01,
@@ -57,3 +76,47 @@ typedef enum system_event_code
     MAX_EVENT_CODE = 0xFF
 } system_event_code;
 
+#define EVENT_TRACE_LATENCY_BUCKET_COUNT 16
+#define EVENT_TRACE_MAX_LISTENERS 64
+
+typedef struct event_code_trace
+{
+    u32 FireCount;
+    u32 QueuedCount;
+    u32 ListenerCalls;
+    r64 ListenerTime;
+    r64 MaxListenerTime;
+    // NOTE: Post to dispatch latency of queued events, see EventTraceGetLatencyBucketLimit
+    u32 LatencyHistogram[EVENT_TRACE_LATENCY_BUCKET_COUNT];
+    r64 MaxLatency;
+} event_code_trace;
+
+typedef struct event_listener_trace
+{
+    PFN_OnEvent Callback;
+    void* Listener;
+    u16 Code;
+    u32 Calls;
+    r64 Time;
+    r64 MaxTime;
+} event_listener_trace;
+
+typedef struct event_frame_summary
+{
+    u64 Frame;
+    u32 FireCount;
+    u32 DroppedRecords;
+    r64 ListenerTime;
+    u32 ListenerCount;
+    event_listener_trace Listeners[EVENT_TRACE_MAX_LISTENERS];
+    event_code_trace Codes[MAX_EVENT_CODE + 1];
+} event_frame_summary;
+
+// NOTE: Collects the trace records of the previous frame into the summary. Called by the application once per frame.
+VENG_API void EventTraceBeginFrame();
+VENG_API const event_frame_summary* EventTraceGetFrameSummary();
+VENG_API r64 EventTraceGetLatencyBucketLimit(u32 Bucket);
+
+// NOTE: Keeps every record between the two calls and writes them as Chrome trace JSON (chrome://tracing, Perfetto)
+VENG_API void EventTraceBeginCapture();
+VENG_API b8 EventTraceEndCapture(const char* Path);
@@ -99,7 +99,7 @@ void ProcessKey(keys Key, b8 Pressed)
 
         event_context Context;
         Context.data.Unsigned16[0] = Key;
-        EventFire(Pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, Context);
+        EventPost(Pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, Context);
     }
 }
 
@@ -172,7 +172,7 @@ void ProcessButton(buttons Button, b8 Pressed)
 
         event_context Context;
         Context.data.Unsigned16[0] = Button;
-        EventFire(Pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, Context);
+        EventPost(Pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, Context);
     }
 }
 void ProcessMouseMove(s16 X, s16 Y)
@@ -185,14 +185,14 @@ void ProcessMouseMove(s16 X, s16 Y)
         event_context Context;
         Context.data.Unsigned16[0] = X;
         Context.data.Unsigned16[1] = Y;
-        EventFire(EVENT_CODE_MOUSE_MOVED, 0, Context);
+        EventPost(EVENT_CODE_MOUSE_MOVED, 0, Context);
     }
 }
 void ProcessMouseWheel(s8 DeltaZ)
 {
     event_context Context;
     Context.data.Unsigned8[0] = DeltaZ;
-    EventFire(EVENT_CODE_MOUSE_WHEEL, 0, Context);
+    EventPost(EVENT_CODE_MOUSE_WHEEL, 0, Context);
 }
 
 
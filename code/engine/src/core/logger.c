@@ -6,26 +6,222 @@
 
 #include "vstring.h"
 #include "vmemory.h"
+#include "atomic.h"
+#include "binary_log.h"
 
 #include <stdarg.h>
+#include <stdio.h>
+
+// NOTE: Messages up to LOG_ENTRY_SIZE live in the ring, longer ones spill to a heap block the writer frees, up to
+// LOG_MAX_MESSAGE_SIZE. Anything longer is cut and ends with LOG_TRUNCATED_MARKER.
+#define LOG_ENTRY_SIZE 512
+#define LOG_MAX_MESSAGE_SIZE 32000
+#define LOG_TRUNCATED_MARKER "... [truncated]"
+#define LOG_RING_CAPACITY 1024
+#define LOG_WRITE_BATCH_SIZE (64 * 1024)
+#define LOG_WRITER_IDLE_MILLIS 100
+#define BINARY_LOG_MAX_FORMATS 4096
+
+static const char* LevelStrings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
+
+// NOTE: Same sequence scheme as the threaded event queue: producers CAS the enqueue position,
+// Sequence == Pos + 1 tells the writer the message is complete.
+typedef struct log_entry
+{
+    volatile u64 Sequence;
+    u16 Level;
+    b8 Binary;
+    u32 Length;
+    char* LongMessage;
+    char Message[LOG_ENTRY_SIZE];
+} log_entry;
+
+typedef struct log_batch
+{
+    u64 Length;
+    char Data[LOG_WRITE_BATCH_SIZE];
+} log_batch;
+
+typedef struct binary_log_format
+{
+    u8 ArgCount;
+    u8 ArgTypes[BINARY_LOG_MAX_ARGS];
+} binary_log_format;
 
 typedef struct logger__system_state
 {
     file_handle LogFile;
+
+    log_entry Ring[LOG_RING_CAPACITY];
+    volatile u64 EnqueuePos;
+    u64 DequeuePos;
+    // NOTE: Dequeue position published after the messages before it reached the file
+    volatile u64 FlushedPos;
+
+    volatile u32 Dropped;
+    u32 DroppedReported;
+    log_overflow_policy Policy;
+
+    platform_thread Writer;
+    platform_semaphore WriterWake;
+    volatile u32 WriterSleeping;
+    volatile u32 Running;
+
+    log_batch Batch;
+
+    // NOTE: console.bin is opened by the writer when the first binary record arrives
+    file_handle BinaryFile;
+    log_batch BinaryBatch;
+    volatile u32 NextFormatID;
+    binary_log_format Formats[BINARY_LOG_MAX_FORMATS];
 } logger_system_state;
 
 static logger_system_state* LoggerState;
 
-void AppendToLogFile(const char* Message)
+static void WriteToConsole(const char* Message, log_level Level)
+{
+    if(Level < LOG_LEVEL_WARN)
+    {
+        PlatformConsoleWrite(Message, Level);
+    }
+    else
+    {
+        PlatformConsoleWriteError(Message, Level);
+    }
+}
+
+static void FlushBatch(file_handle* File, log_batch* Batch)
+{
+    if(Batch->Length > 0 && File->IsValid)
+    {
+        u64 Written = 0;
+        if(!FileWrite(File, Batch->Length, Batch->Data, &Written))
+        {
+            PlatformConsoleWriteError("ERROR. Unable to write to console log.", LOG_LEVEL_ERROR);
+        }
+    }
+
+    Batch->Length = 0;
+}
+
+static void AppendToBatch(file_handle* File, log_batch* Batch, const void* Data, u64 Length)
 {
-    if(LoggerState && LoggerState->LogFile.IsValid)
+    if(Batch->Length + Length > LOG_WRITE_BATCH_SIZE)
+    {
+        FlushBatch(File, Batch);
+    }
+
+    // NOTE: Spilled messages can be bigger than a whole batch, those go straight to the file
+    if(Length > LOG_WRITE_BATCH_SIZE)
     {
-        u64 Length = StringLength(Message);
         u64 Written = 0;
-        if(!FileWrite(&LoggerState->LogFile, Length, Message, &Written))
+        if(File->IsValid && !FileWrite(File, Length, Data, &Written))
         {
             PlatformConsoleWriteError("ERROR. Unable to write to console log.", LOG_LEVEL_ERROR);
         }
+        return;
+    }
+
+    CopyMemory(Batch->Data + Batch->Length, Data, Length);
+    Batch->Length += Length;
+}
+
+static void AppendBinaryRecord(const void* Record, u64 Length)
+{
+    if(!LoggerState->BinaryFile.IsValid)
+    {
+        if(!FileOpen("console.bin", FILE_MODE_WRITE, true, &LoggerState->BinaryFile))
+        {
+            return;
+        }
+
+        binary_log_file_header Header;
+        Header.Magic   = BINARY_LOG_MAGIC;
+        Header.Version = BINARY_LOG_VERSION;
+        AppendToBatch(&LoggerState->BinaryFile, &LoggerState->BinaryBatch, &Header, sizeof(Header));
+    }
+
+    AppendToBatch(&LoggerState->BinaryFile, &LoggerState->BinaryBatch, Record, Length);
+}
+
+static b8 DrainRing()
+{
+    b8 DrainedAny = false;
+    for(;;)
+    {
+        u64 Pos = LoggerState->DequeuePos;
+        log_entry* Entry = &LoggerState->Ring[Pos & (LOG_RING_CAPACITY - 1)];
+        if(AtomicLoadU64(&Entry->Sequence) != Pos + 1)
+        {
+            break;
+        }
+
+        if(Entry->Binary)
+        {
+            AppendBinaryRecord(Entry->Message, Entry->Length);
+        }
+        else
+        {
+            const char* Text = Entry->LongMessage ? Entry->LongMessage : Entry->Message;
+            WriteToConsole(Text, (log_level)Entry->Level);
+            AppendToBatch(&LoggerState->LogFile, &LoggerState->Batch, Text, Entry->Length);
+            if(Entry->LongMessage)
+            {
+                PlatformFree(Entry->LongMessage, false);
+                Entry->LongMessage = 0;
+            }
+        }
+
+        AtomicStoreU64(&Entry->Sequence, Pos + LOG_RING_CAPACITY);
+        LoggerState->DequeuePos = Pos + 1;
+        DrainedAny = true;
+    }
+
+    u32 Dropped = AtomicLoadU32(&LoggerState->Dropped);
+    if(Dropped != LoggerState->DroppedReported)
+    {
+        char Notice[128];
+        s32 Length = StringFormat(Notice, "%s%u log messages dropped, the log ring was full.\n", 
+                                  LevelStrings[LOG_LEVEL_WARN], Dropped - LoggerState->DroppedReported);
+        WriteToConsole(Notice, LOG_LEVEL_WARN);
+        AppendToBatch(&LoggerState->LogFile, &LoggerState->Batch, Notice, (u64)Length);
+        LoggerState->DroppedReported = Dropped;
+    }
+
+    FlushBatch(&LoggerState->LogFile, &LoggerState->Batch);
+    FlushBatch(&LoggerState->BinaryFile, &LoggerState->BinaryBatch);
+    AtomicStoreU64(&LoggerState->FlushedPos, LoggerState->DequeuePos);
+    return DrainedAny;
+}
+
+static u32 LogWriterThread(void* Param)
+{
+    for(;;)
+    {
+        DrainRing();
+        if(!AtomicLoadU32(&LoggerState->Running))
+        {
+            break;
+        }
+
+        // NOTE: Announce the sleep before the last check, a producer seeing the flag wakes us up
+        AtomicStoreU32(&LoggerState->WriterSleeping, 1);
+        if(!DrainRing())
+        {
+            PlatformSemaphoreWait(&LoggerState->WriterWake, LOG_WRITER_IDLE_MILLIS);
+        }
+        AtomicStoreU32(&LoggerState->WriterSleeping, 0);
+    }
+
+    DrainRing();
+    return 0;
+}
+
+static void WakeWriter()
+{
+    if(AtomicCompareExchangeU32(&LoggerState->WriterSleeping, 1, 0))
+    {
+        PlatformSemaphoreSignal(&LoggerState->WriterWake);
     }
 }
 
@@ -37,46 +233,380 @@ b8 InitializeLogging(u64* MemoryRequirement, void* State)
         return true;
     }
 
-    LoggerState = State;
-    if(!FileOpen("console.log", FILE_MODE_WRITE, false, &LoggerState->LogFile))
+    ZeroMemory(State, sizeof(logger_system_state));
+    logger_system_state* NewState = State;
+    for(u64 EntryIndex = 0;
+        EntryIndex < LOG_RING_CAPACITY;
+        ++EntryIndex)
+    {
+        NewState->Ring[EntryIndex].Sequence = EntryIndex;
+    }
+
+    if(!FileOpen("console.log", FILE_MODE_WRITE, false, &NewState->LogFile))
     {
         PlatformConsoleWriteError("ERROR. Unable to openg console.log for writing.", LOG_LEVEL_ERROR);
         return false;
     }
 
+    if(!PlatformSemaphoreCreate(0, 1, &NewState->WriterWake))
+    {
+        PlatformConsoleWriteError("ERROR. Unable to create the log writer semaphore.", LOG_LEVEL_ERROR);
+        return false;
+    }
+
+    NewState->Running = 1;
+    LoggerState = NewState;
+    if(!PlatformThreadCreate(LogWriterThread, 0, &NewState->Writer))
+    {
+        PlatformConsoleWriteError("ERROR. Unable to start the log writer thread.", LOG_LEVEL_ERROR);
+        LoggerState = 0;
+        return false;
+    }
+
     return true;
 }
 
 void ShutdownLogging(void* State)
 {
-    State = 0;
+    if(LoggerState)
+    {
+        AtomicStoreU32(&LoggerState->Running, 0);
+        PlatformSemaphoreSignal(&LoggerState->WriterWake);
+        PlatformThreadJoin(&LoggerState->Writer);
+        PlatformSemaphoreDestroy(&LoggerState->WriterWake);
+        FileClose(&LoggerState->LogFile);
+        if(LoggerState->BinaryFile.IsValid)
+        {
+            FileClose(&LoggerState->BinaryFile);
+        }
+    }
+
+    LoggerState = 0;
+}
+
+// NOTE: Bytes the formatted message takes with its level prefix, newline and terminator
+static u64 MeasureMessage(log_level Level, const char* Message, va_list Arguments)
+{
+    va_list Copy;
+    va_copy(Copy, Arguments);
+    s32 Written = vsnprintf(0, 0, Message, Copy);
+    va_end(Copy);
+
+    return StringLength(LevelStrings[Level]) + (Written > 0 ? (u64)Written : 0) + 2;
 }
 
-void OutputLog(log_level Level, const char* Message, ...)
+static u32 FormatMessage(char* Dest, u64 Size, log_level Level, const char* Message, va_list Arguments)
+{
+    u64 Length = StringLength(LevelStrings[Level]);
+    CopyMemory(Dest, LevelStrings[Level], Length);
+
+    // NOTE: Size - 1 leaves room for the newline
+    u64 Space = Size - Length - 2;
+    s32 Written = vsnprintf(Dest + Length, Size - Length - 1, Message, Arguments);
+    if(Written < 0)
+    {
+        Written = 0;
+    }
+
+    if((u64)Written > Space)
+    {
+        Length += Space;
+        u64 MarkerLength = sizeof(LOG_TRUNCATED_MARKER) - 1;
+        CopyMemory(Dest + Length - MarkerLength, LOG_TRUNCATED_MARKER, MarkerLength);
+    }
+    else
+    {
+        Length += (u64)Written;
+    }
+    Dest[Length++] = '\n';
+    Dest[Length] = 0;
+
+    return (u32)Length;
+}
+
+// NOTE: Returns 0 when the message was dropped
+static log_entry* ClaimEntry(log_level Level, u64* OutPos)
+{
+    u64 Pos = AtomicLoadU64(&LoggerState->EnqueuePos);
+    for(;;)
+    {
+        log_entry* Candidate = &LoggerState->Ring[Pos & (LOG_RING_CAPACITY - 1)];
+        s64 Diff = (s64)AtomicLoadU64(&Candidate->Sequence) - (s64)Pos;
+        if(Diff == 0)
+        {
+            if(AtomicCompareExchangeU64(&LoggerState->EnqueuePos, Pos, Pos + 1))
+            {
+                *OutPos = Pos;
+                return Candidate;
+            }
+        }
+        else if(Diff < 0)
+        {
+            if(Level > LOG_LEVEL_WARN && LoggerState->Policy == LOG_OVERFLOW_DROP)
+            {
+                AtomicFetchAddU32(&LoggerState->Dropped, 1);
+                return 0;
+            }
+
+            WakeWriter();
+            PlatformThreadYield();
+        }
+
+        Pos = AtomicLoadU64(&LoggerState->EnqueuePos);
+    }
+}
+
+static void PublishEntry(log_entry* Entry, u64 Pos, log_level Level)
+{
+    AtomicStoreU64(&Entry->Sequence, Pos + 1);
+
+    WakeWriter();
+    if(Level == LOG_LEVEL_FATAL)
+    {
+        LoggingFlush();
+    }
+}
+
+static void OutputLogV(log_level Level, const char* Message, va_list Arguments)
 {
-    const char* LevelString[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
-    b8 IsError = Level < LOG_LEVEL_WARN;
+    if(!LoggerState)
+    {
+        char OutMessage[LOG_MAX_MESSAGE_SIZE];
+        FormatMessage(OutMessage, LOG_MAX_MESSAGE_SIZE, Level, Message, Arguments);
+        WriteToConsole(OutMessage, Level);
+        return;
+    }
 
-    char OutMessage[32000];
-    ZeroMemory(OutMessage, sizeof(OutMessage));
+    u64 Pos = 0;
+    log_entry* Entry = ClaimEntry(Level, &Pos);
+    if(!Entry)
+    {
+        return;
+    }
+
+    Entry->Level  = Level;
+    Entry->Binary = false;
+    Entry->LongMessage = 0;
+
+    u64 Size = MeasureMessage(Level, Message, Arguments);
+    if(Size > LOG_ENTRY_SIZE)
+    {
+        Size = Size < LOG_MAX_MESSAGE_SIZE ? Size : LOG_MAX_MESSAGE_SIZE;
+        Entry->LongMessage = PlatformAllocate(Size, false);
+    }
 
+    if(Entry->LongMessage)
+    {
+        Entry->Length = FormatMessage(Entry->LongMessage, Size, Level, Message, Arguments);
+    }
+    else
+    {
+        Entry->Length = FormatMessage(Entry->Message, LOG_ENTRY_SIZE, Level, Message, Arguments);
+    }
+    PublishEntry(Entry, Pos, Level);
+}
+
+void OutputLog(log_level Level, const char* Message, ...)
+{
     va_list ArgumentPointer;
     va_start(ArgumentPointer, Message);
-    StringFormatV(OutMessage, Message, ArgumentPointer);
+    OutputLogV(Level, Message, ArgumentPointer);
     va_end(ArgumentPointer);
+}
 
-    StringFormat(OutMessage, "%s%s\n", LevelString[Level], OutMessage);
+static u32 RegisterBinaryFormat(log_level Level, volatile u32* FormatID, const char* Format)
+{
+    u32 NewID = AtomicFetchAddU32(&LoggerState->NextFormatID, 1) + 1;
+    if(NewID >= BINARY_LOG_MAX_FORMATS)
+    {
+        return 0;
+    }
 
-    if(IsError)
+    binary_log_format* Entry = &LoggerState->Formats[NewID];
+    Entry->ArgCount = 0;
+
+    u32 Cursor = 0;
+    binary_log_spec Spec;
+    while(BinaryLogNextSpec(Format, &Cursor, &Spec))
     {
-        PlatformConsoleWrite(OutMessage, Level);
+        for(u32 ArgIndex = 0;
+            ArgIndex < Spec.ArgCount && Entry->ArgCount < BINARY_LOG_MAX_ARGS;
+            ++ArgIndex)
+        {
+            Entry->ArgTypes[Entry->ArgCount++] = Spec.ArgTypes[ArgIndex];
+        }
     }
-    else
+
+    // NOTE: Another thread may have registered the same callsite first, its ID wins and ours is left unused
+    if(!AtomicCompareExchangeU32(FormatID, 0, NewID))
     {
-        PlatformConsoleWriteError(OutMessage, Level);
+        return AtomicLoadU32(FormatID);
     }
 
-    AppendToLogFile(OutMessage);
+    u64 Pos = 0;
+    log_entry* Record = ClaimEntry(LOG_LEVEL_ERROR, &Pos);
+    binary_log_record_header* Header = (binary_log_record_header*)Record->Message;
+    u64 FormatLength = StringLength(Format);
+    u64 MaxFormatLength = LOG_ENTRY_SIZE - sizeof(binary_log_record_header) - 1 - Entry->ArgCount - 1;
+    FormatLength = FormatLength < MaxFormatLength ? FormatLength : MaxFormatLength;
+
+    u8* Payload = (u8*)(Header + 1);
+    Payload[0] = Entry->ArgCount;
+    CopyMemory(Payload + 1, Entry->ArgTypes, Entry->ArgCount);
+    CopyMemory(Payload + 1 + Entry->ArgCount, Format, FormatLength);
+    Payload[1 + Entry->ArgCount + FormatLength] = 0;
+
+    Header->Type     = BINARY_LOG_RECORD_FORMAT;
+    Header->Level    = (u8)Level;
+    Header->Size     = (u16)(1 + Entry->ArgCount + FormatLength + 1);
+    Header->FormatID = NewID;
+
+    Record->Level  = LOG_LEVEL_ERROR;
+    Record->Binary = true;
+    Record->LongMessage = 0;
+    Record->Length = sizeof(binary_log_record_header) + Header->Size;
+    PublishEntry(Record, Pos, LOG_LEVEL_ERROR);
+
+    return NewID;
+}
+
+void OutputLogBinary(log_level Level, volatile u32* FormatID, const char* Format, ...)
+{
+    va_list ArgumentPointer;
+    va_start(ArgumentPointer, Format);
+
+    u32 ID = LoggerState ? AtomicLoadU32(FormatID) : 0;
+    if(LoggerState && ID == 0)
+    {
+        ID = RegisterBinaryFormat(Level, FormatID, Format);
+    }
+
+    // NOTE: Without a logger or with the format table full the message goes out as text
+    if(ID == 0)
+    {
+        OutputLogV(Level, Format, ArgumentPointer);
+        va_end(ArgumentPointer);
+        return;
+    }
+
+    u64 Pos = 0;
+    log_entry* Entry = ClaimEntry(Level, &Pos);
+    if(!Entry)
+    {
+        va_end(ArgumentPointer);
+        return;
+    }
+
+    binary_log_format* Types = &LoggerState->Formats[ID];
+    u8* Payload = (u8*)Entry->Message + sizeof(binary_log_record_header);
+    u8* PayloadEnd = (u8*)Entry->Message + LOG_ENTRY_SIZE;
+    u8* At = Payload;
+    for(u32 ArgIndex = 0;
+        ArgIndex < Types->ArgCount;
+        ++ArgIndex)
+    {
+        switch(Types->ArgTypes[ArgIndex])
+        {
+            case BINARY_LOG_ARG_I32:
+            case BINARY_LOG_ARG_U32:
+            {
+                u32 Value = va_arg(ArgumentPointer, u32);
+                if(At + sizeof(Value) <= PayloadEnd)
+                {
+                    CopyMemory(At, &Value, sizeof(Value));
+                    At += sizeof(Value);
+                }
+            } break;
+            case BINARY_LOG_ARG_I64:
+            case BINARY_LOG_ARG_U64:
+            {
+                u64 Value = va_arg(ArgumentPointer, u64);
+                if(At + sizeof(Value) <= PayloadEnd)
+                {
+                    CopyMemory(At, &Value, sizeof(Value));
+                    At += sizeof(Value);
+                }
+            } break;
+            case BINARY_LOG_ARG_R64:
+            {
+                r64 Value = va_arg(ArgumentPointer, r64);
+                if(At + sizeof(Value) <= PayloadEnd)
+                {
+                    CopyMemory(At, &Value, sizeof(Value));
+                    At += sizeof(Value);
+                }
+            } break;
+            case BINARY_LOG_ARG_POINTER:
+            {
+                u64 Value = (u64)va_arg(ArgumentPointer, void*);
+                if(At + sizeof(Value) <= PayloadEnd)
+                {
+                    CopyMemory(At, &Value, sizeof(Value));
+                    At += sizeof(Value);
+                }
+            } break;
+            case BINARY_LOG_ARG_STRING:
+            {
+                const char* Value = va_arg(ArgumentPointer, const char*);
+                Value = Value ? Value : "(null)";
+                u64 Length = StringLength(Value);
+                if(At + sizeof(u16) <= PayloadEnd)
+                {
+                    u64 Space = (u64)(PayloadEnd - At) - sizeof(u16);
+                    u16 Stored = (u16)(Length < Space ? Length : Space);
+                    CopyMemory(At, &Stored, sizeof(Stored));
+                    CopyMemory(At + sizeof(u16), Value, Stored);
+                    At += sizeof(u16) + Stored;
+                }
+            } break;
+        }
+    }
+    va_end(ArgumentPointer);
+
+    binary_log_record_header* Header = (binary_log_record_header*)Entry->Message;
+    Entry->LongMessage = 0;
+    Header->Type     = BINARY_LOG_RECORD_MESSAGE;
+    Header->Level    = (u8)Level;
+    Header->Size     = (u16)(At - Payload);
+    Header->FormatID = ID;
+
+    Entry->Level  = Level;
+    Entry->Binary = true;
+    Entry->Length = (u32)(At - (u8*)Entry->Message);
+    PublishEntry(Entry, Pos, Level);
+}
+
+void LoggingFlush()
+{
+    if(!LoggerState)
+    {
+        return;
+    }
+
+    u64 Target = AtomicLoadU64(&LoggerState->EnqueuePos);
+    while(AtomicLoadU64(&LoggerState->FlushedPos) < Target && AtomicLoadU32(&LoggerState->Running))
+    {
+        WakeWriter();
+        PlatformThreadYield();
+    }
+}
+
+void LoggingSetOverflowPolicy(log_overflow_policy Policy)
+{
+    if(LoggerState)
+    {
+        LoggerState->Policy = Policy;
+    }
+}
+
+log_overflow_policy LoggingGetOverflowPolicy()
+{
+    return LoggerState ? LoggerState->Policy : LOG_OVERFLOW_DROP;
+}
+
+u32 LoggingGetDroppedCount()
+{
+    return LoggerState ? AtomicLoadU32(&LoggerState->Dropped) : 0;
 }
 
 void ReportAssertationFailure(const char* Expression, const char* Message, const char* File, s32 Line)
@@ -2,15 +2,19 @@
 
 #include "defines.h"
 
-#define LOG_WARN_ENABLED  1
-#define LOG_INFO_ENABLED  1
-#define LOG_DEBUG_ENABLED 1
-#define LOG_TRACE_ENABLED 1
-
+// NOTE: Highest log_level compiled in, calls above it are stripped together with their arguments
+#ifndef VENG_LOG_LEVEL
 #if VENG_RELEASE == 1
-#define LOG_DEBUG_ENABLED 0
-#define LOG_TRACE_ENABLED 0
+#define VENG_LOG_LEVEL 3
+#else
+#define VENG_LOG_LEVEL 5
 #endif
+#endif
+
+#define LOG_WARN_ENABLED  (VENG_LOG_LEVEL >= 2)
+#define LOG_INFO_ENABLED  (VENG_LOG_LEVEL >= 3)
+#define LOG_DEBUG_ENABLED (VENG_LOG_LEVEL >= 4)
+#define LOG_TRACE_ENABLED (VENG_LOG_LEVEL >= 5)
 
 typedef enum log_level
 {
@@ -22,10 +26,29 @@ typedef enum log_level
     LOG_LEVEL_TRACE = 5,
 } log_level;
 
+// NOTE: What OutputLog does when the log ring is full. Fatal, error and warning messages always wait for space.
+typedef enum log_overflow_policy
+{
+    LOG_OVERFLOW_DROP,
+    LOG_OVERFLOW_BLOCK,
+} log_overflow_policy;
+
 b8 InitializeLogging(u64* MemoryRequirement, void* State);
 void ShutdownLogging(void* State);
 
+// NOTE: Messages are formatted on the calling thread and written to the console and console.log by a 
+// background thread. Fatal messages flush before OutputLog returns.
 VENG_API void OutputLog(log_level Level, const char* Message, ...);
+VENG_API void LoggingFlush();
+VENG_API void LoggingSetOverflowPolicy(log_overflow_policy Policy);
+VENG_API log_overflow_policy LoggingGetOverflowPolicy();
+VENG_API u32 LoggingGetDroppedCount();
+
+// NOTE: Binary logging. Stores a per-callsite format ID and the raw arguments in console.bin instead of 
+// formatting, code/tools/log_decoder turns the file back into text. Format strings must be literals.
+VENG_API void OutputLogBinary(log_level Level, volatile u32* FormatID, const char* Format, ...);
+
+#define VENG_LOG_BINARY(Level, Message, ...) { static u32 BinaryFormatID; OutputLogBinary(Level, &BinaryFormatID, Message, ##__VA_ARGS__); }
 
 #define VENG_FATAL(Message, ...) OutputLog(LOG_LEVEL_FATAL, Message, ##__VA_ARGS__);
 
@@ -57,3 +80,14 @@ VENG_API void OutputLog(log_level Level, const char* Message, ...);
 #define VENG_TRACE(Message, ...)
 #endif
 
+#if LOG_DEBUG_ENABLED == 1
+#define VENG_DEBUG_BINARY(Message, ...) VENG_LOG_BINARY(LOG_LEVEL_DEBUG, Message, ##__VA_ARGS__)
+#else
+#define VENG_DEBUG_BINARY(Message, ...)
+#endif
+
+#if LOG_TRACE_ENABLED == 1
+#define VENG_TRACE_BINARY(Message, ...) VENG_LOG_BINARY(LOG_LEVEL_TRACE, Message, ##__VA_ARGS__)
+#else
+#define VENG_TRACE_BINARY(Message, ...)
+#endif
@@ -1,16 +1,21 @@
 
+#define VENG_MEMORY_IMPLEMENTATION
 #include "vmemory.h"
 
 #include "core/logger.h"
+#include "core/atomic.h"
 #include "platform/platform.h"
 
 #include <string.h>
 #include <stdio.h>
 
+// NOTE: Every counter is touched only through atomics so Allocate/Free can be called from any thread.
 typedef struct memory_stats
 {
     u64 TotalAllocated;
-    u64 TaggedAllocation[MEMORY_TAG_MAX_TAGS];
+    u64 TotalPeak;
+    u64 FreeCount;
+    memory_tag_usage Tagged[MEMORY_TAG_MAX_TAGS];
 } memory_stats;
 
 static const char* MemoryTagStrings[MEMORY_TAG_MAX_TAGS] = 
@@ -35,14 +40,279 @@ static const char* MemoryTagStrings[MEMORY_TAG_MAX_TAGS] =
     "SCENE"
 };
 
+#if VENG_MEMORY_TRACKING
+typedef enum allocation_record_state
+{
+    ALLOCATION_RECORD_EMPTY,
+    ALLOCATION_RECORD_LIVE,
+    ALLOCATION_RECORD_FREED,
+} allocation_record_state;
+
+typedef struct allocation_record
+{
+    void* Block;
+    u64 Size;
+    u64 Frame;
+    const char* File;
+    s32 Line;
+    memory_tag Tag;
+    allocation_record_state State;
+} allocation_record;
+
+typedef struct allocation_callsite
+{
+    const char* File;
+    s32 Line;
+    memory_tag Tag;
+    u64 TotalCount;
+    u64 TotalBytes;
+    u64 LiveCount;
+    u64 LiveBytes;
+} allocation_callsite;
+
+// NOTE: Open addressing tables living outside of the tracked heap. 
+// Freed records are kept as tombstones so a second Free of the same address can be detected. Inserts reuse them,
+// and once they pass MEMORY_TRACKING_TOMBSTONE_LIMIT the table is rebuilt from the live records, so lookups of
+// absent blocks do not end up probing the whole table.
+#define MEMORY_TRACKING_TOMBSTONE_LIMIT (MEMORY_TRACKING_MAX_ALLOCATIONS / 4)
+typedef struct memory_tracking_state
+{
+    volatile u32 Lock;
+    u32 LiveCount;
+    u32 TombstoneCount;
+    allocation_record* Records;
+    allocation_callsite* Callsites;
+    u32 CallsiteCount;
+} memory_tracking_state;
+#endif
+
 typedef struct memory_system_state
 {
     memory_stats Stats;
     u64 AllocCount;
+    volatile u64 FrameNumber;
+#if VENG_MEMORY_TRACKING
+    memory_tracking_state Tracking;
+#endif
 } memory_system_state;
 
 static memory_system_state* MemoryState;
 
+#if VENG_MEMORY_TRACKING
+static void TrackingLock(memory_tracking_state* Tracking)
+{
+    while(!AtomicCompareExchangeU32(&Tracking->Lock, 0, 1))
+    {
+    }
+}
+
+static void TrackingUnlock(memory_tracking_state* Tracking)
+{
+    AtomicStoreU32(&Tracking->Lock, 0);
+}
+
+static u64 HashPointer(const void* Ptr)
+{
+    u64 Key = (u64)Ptr;
+    Key ^= Key >> 33;
+    Key *= 0xff51afd7ed558ccdull;
+    Key ^= Key >> 33;
+    return Key;
+}
+
+static allocation_callsite* FindCallsite(memory_tracking_state* Tracking, const char* File, s32 Line, memory_tag Tag)
+{
+    u64 Hash = HashPointer(File) ^ ((u64)Line * 0x9e3779b97f4a7c15ull) ^ Tag;
+    for(u32 Probe = 0;
+        Probe < MEMORY_TRACKING_MAX_CALLSITES;
+        ++Probe)
+    {
+        allocation_callsite* Callsite = &Tracking->Callsites[(Hash + Probe) & (MEMORY_TRACKING_MAX_CALLSITES - 1)];
+        if(Callsite->TotalCount == 0)
+        {
+            Callsite->File = File;
+            Callsite->Line = Line;
+            Callsite->Tag  = Tag;
+            Tracking->CallsiteCount++;
+            return Callsite;
+        }
+
+        if(Callsite->File == File && Callsite->Line == Line && Callsite->Tag == Tag)
+        {
+            return Callsite;
+        }
+    }
+
+    return 0;
+}
+
+static allocation_record* FindRecord(memory_tracking_state* Tracking, void* Block, b8 ForInsert)
+{
+    u64 Hash = HashPointer(Block);
+    allocation_record* FirstFreed = 0;
+    for(u32 Probe = 0;
+        Probe < MEMORY_TRACKING_MAX_ALLOCATIONS;
+        ++Probe)
+    {
+        allocation_record* Record = &Tracking->Records[(Hash + Probe) & (MEMORY_TRACKING_MAX_ALLOCATIONS - 1)];
+        if(Record->State == ALLOCATION_RECORD_EMPTY)
+        {
+            if(ForInsert)
+            {
+                return FirstFreed ? FirstFreed : Record;
+            }
+            return 0;
+        }
+
+        if(Record->Block == Block)
+        {
+            return Record;
+        }
+
+        if(Record->State == ALLOCATION_RECORD_FREED && !FirstFreed)
+        {
+            FirstFreed = Record;
+        }
+    }
+
+    return ForInsert ? FirstFreed : 0;
+}
+
+// NOTE: Drops every tombstone, double frees of blocks freed before the rebuild are then reported as untracked.
+// Runs under the lock, the scratch copy comes from the platform so it is not tracked itself.
+static void RehashRecords(memory_tracking_state* Tracking)
+{
+    u64 TableSize = sizeof(allocation_record) * MEMORY_TRACKING_MAX_ALLOCATIONS;
+    allocation_record* Live = PlatformAllocate(sizeof(allocation_record) * (Tracking->LiveCount + 1), false);
+    u32 LiveCount = 0;
+    for(u32 RecordIndex = 0;
+        RecordIndex < MEMORY_TRACKING_MAX_ALLOCATIONS;
+        ++RecordIndex)
+    {
+        if(Tracking->Records[RecordIndex].State == ALLOCATION_RECORD_LIVE)
+        {
+            Live[LiveCount++] = Tracking->Records[RecordIndex];
+        }
+    }
+
+    PlatformZeroMemory(Tracking->Records, TableSize);
+    for(u32 LiveIndex = 0;
+        LiveIndex < LiveCount;
+        ++LiveIndex)
+    {
+        *FindRecord(Tracking, Live[LiveIndex].Block, true) = Live[LiveIndex];
+    }
+
+    PlatformFree(Live, false);
+    Tracking->LiveCount = LiveCount;
+    Tracking->TombstoneCount = 0;
+}
+
+static void TrackAllocation(void* Block, u64 Size, memory_tag Tag, const char* File, s32 Line)
+{
+    memory_tracking_state* Tracking = &MemoryState->Tracking;
+    TrackingLock(Tracking);
+
+    if(Tracking->TombstoneCount >= MEMORY_TRACKING_TOMBSTONE_LIMIT)
+    {
+        RehashRecords(Tracking);
+    }
+
+    allocation_record* Record = FindRecord(Tracking, Block, true);
+    if(Record)
+    {
+        if(Record->State == ALLOCATION_RECORD_FREED)
+        {
+            Tracking->TombstoneCount--;
+        }
+        if(Record->State != ALLOCATION_RECORD_LIVE)
+        {
+            Tracking->LiveCount++;
+        }
+
+        Record->Block = Block;
+        Record->Size  = Size;
+        Record->Tag   = Tag;
+        Record->File  = File;
+        Record->Line  = Line;
+        Record->Frame = MemoryState->FrameNumber;
+        Record->State = ALLOCATION_RECORD_LIVE;
+    }
+
+    allocation_callsite* Callsite = FindCallsite(Tracking, File, Line, Tag);
+    if(Callsite)
+    {
+        Callsite->TotalCount++;
+        Callsite->TotalBytes += Size;
+        Callsite->LiveCount++;
+        Callsite->LiveBytes += Size;
+    }
+
+    TrackingUnlock(Tracking);
+
+    if(!Record)
+    {
+        VENG_WARN("Memory tracking table is full. Block %p from %s:%d is not tracked.", Block, File ? File : "?", Line);
+    }
+}
+
+// NOTE: Returns false when the block must not be released (double free).
+static b8 TrackFree(void* Block, u64* Size, memory_tag* Tag, const char* File, s32 Line)
+{
+    memory_tracking_state* Tracking = &MemoryState->Tracking;
+    TrackingLock(Tracking);
+
+    allocation_record* Record = FindRecord(Tracking, Block, false);
+    allocation_record Found = {};
+    if(Record)
+    {
+        Found = *Record;
+        if(Record->State == ALLOCATION_RECORD_LIVE)
+        {
+            Record->State = ALLOCATION_RECORD_FREED;
+            Tracking->LiveCount--;
+            Tracking->TombstoneCount++;
+            Record->File  = File;
+            Record->Line  = Line;
+            Record->Frame = MemoryState->FrameNumber;
+
+            allocation_callsite* Callsite = FindCallsite(Tracking, Found.File, Found.Line, Found.Tag);
+            if(Callsite)
+            {
+                Callsite->LiveCount--;
+                Callsite->LiveBytes -= Found.Size;
+            }
+        }
+    }
+
+    TrackingUnlock(Tracking);
+
+    if(!Record)
+    {
+        VENG_WARN("Free of untracked block %p at %s:%d (allocated before memory init?).", Block, File ? File : "?", Line);
+        return true;
+    }
+
+    if(Found.State == ALLOCATION_RECORD_FREED)
+    {
+        VENG_ERROR("Double free of block %p at %s:%d. Already freed at %s:%d on frame %llu.", 
+                   Block, File ? File : "?", Line, Found.File ? Found.File : "?", Found.Line, Found.Frame);
+        return false;
+    }
+
+    if(Found.Size != *Size || Found.Tag != *Tag)
+    {
+        VENG_ERROR("Free mismatch for block %p at %s:%d: freed as %lluB/%s, allocated as %lluB/%s at %s:%d.",
+                   Block, File ? File : "?", Line, *Size, MemoryTagStrings[*Tag], 
+                   Found.Size, MemoryTagStrings[Found.Tag], Found.File ? Found.File : "?", Found.Line);
+        *Size = Found.Size;
+        *Tag  = Found.Tag;
+    }
+
+    return true;
+}
+#endif
+
 void InitializeMemory(u64* MemoryRequirement, void* State)
 {
     *MemoryRequirement = sizeof(memory_system_state);
@@ -53,15 +323,187 @@ void InitializeMemory(u64* MemoryRequirement, void* State)
 
     MemoryState = State;
     MemoryState->AllocCount = 0;
+    MemoryState->FrameNumber = 0;
     PlatformZeroMemory(&MemoryState->Stats, sizeof(memory_stats));
+
+#if VENG_MEMORY_TRACKING
+    u64 RecordsSize   = sizeof(allocation_record) * MEMORY_TRACKING_MAX_ALLOCATIONS;
+    u64 CallsitesSize = sizeof(allocation_callsite) * MEMORY_TRACKING_MAX_CALLSITES;
+    MemoryState->Tracking.Lock = 0;
+    MemoryState->Tracking.CallsiteCount = 0;
+    MemoryState->Tracking.LiveCount = 0;
+    MemoryState->Tracking.TombstoneCount = 0;
+    MemoryState->Tracking.Records   = PlatformAllocate(RecordsSize, false);
+    MemoryState->Tracking.Callsites = PlatformAllocate(CallsitesSize, false);
+    PlatformZeroMemory(MemoryState->Tracking.Records, RecordsSize);
+    PlatformZeroMemory(MemoryState->Tracking.Callsites, CallsitesSize);
+#endif
 }
 
 void ShutdownMemory(void* State)
 {
+#if VENG_MEMORY_TRACKING
+    if(MemoryState)
+    {
+        MemoryTrackingReport(true);
+        PlatformFree(MemoryState->Tracking.Records, false);
+        PlatformFree(MemoryState->Tracking.Callsites, false);
+        MemoryState->Tracking.Records   = 0;
+        MemoryState->Tracking.Callsites = 0;
+    }
+#endif
+
     MemoryState = 0;
 }
 
+void MemoryBeginFrame()
+{
+    if(MemoryState)
+    {
+        AtomicFetchAddU64(&MemoryState->FrameNumber, 1);
+    }
+}
+
+void MemoryTrackingReport(b8 LeaksOnly)
+{
+#if VENG_MEMORY_TRACKING
+    if(!MemoryState)
+    {
+        return;
+    }
+
+    // NOTE: Snapshot the tables under the lock and log afterwards, so allocating threads are not held up by the
+    // console and the logger never runs with the tracking lock taken
+    memory_tracking_state* Tracking = &MemoryState->Tracking;
+    TrackingLock(Tracking);
+
+    u32 LeakCapacity = LeaksOnly ? Tracking->LiveCount : 0;
+    u32 CallsiteCapacity = Tracking->CallsiteCount;
+    allocation_record* Leaks = LeakCapacity ? PlatformAllocate(sizeof(allocation_record) * LeakCapacity, false) : 0;
+    allocation_callsite* Callsites = CallsiteCapacity ? PlatformAllocate(sizeof(allocation_callsite) * CallsiteCapacity, false) : 0;
+
+    u64 LeakCount = 0;
+    u64 LeakBytes = 0;
+    u32 LeakRecordCount = 0;
+    for(u32 RecordIndex = 0;
+        RecordIndex < MEMORY_TRACKING_MAX_ALLOCATIONS;
+        ++RecordIndex)
+    {
+        allocation_record* Record = &Tracking->Records[RecordIndex];
+        if(Record->State == ALLOCATION_RECORD_LIVE)
+        {
+            LeakCount++;
+            LeakBytes += Record->Size;
+            if(LeakRecordCount < LeakCapacity)
+            {
+                Leaks[LeakRecordCount++] = *Record;
+            }
+        }
+    }
+
+    u32 CallsiteCount = 0;
+    for(u32 CallsiteIndex = 0;
+        CallsiteIndex < MEMORY_TRACKING_MAX_CALLSITES && CallsiteCount < CallsiteCapacity;
+        ++CallsiteIndex)
+    {
+        allocation_callsite* Callsite = &Tracking->Callsites[CallsiteIndex];
+        if(Callsite->TotalCount == 0 || (LeaksOnly && Callsite->LiveCount == 0))
+        {
+            continue;
+        }
+
+        Callsites[CallsiteCount++] = *Callsite;
+    }
+
+    u32 TotalCallsites = Tracking->CallsiteCount;
+    TrackingUnlock(Tracking);
+
+    // NOTE: A leak report longer than the log ring would lose its tail under LOG_OVERFLOW_DROP
+    log_overflow_policy Policy = LoggingGetOverflowPolicy();
+    LoggingSetOverflowPolicy(LOG_OVERFLOW_BLOCK);
+
+    for(u32 LeakIndex = 0;
+        LeakIndex < LeakRecordCount;
+        ++LeakIndex)
+    {
+        allocation_record* Record = &Leaks[LeakIndex];
+        VENG_WARN("  leak: %p %lluB %s from %s:%d on frame %llu", Record->Block, Record->Size, 
+                  MemoryTagStrings[Record->Tag], Record->File ? Record->File : "?", Record->Line, Record->Frame);
+    }
+
+    VENG_INFO("Memory tracking: %llu live allocations (%lluB), %u callsites, frame %llu.", 
+              LeakCount, LeakBytes, TotalCallsites, MemoryState->FrameNumber);
+
+    for(u32 CallsiteIndex = 0;
+        CallsiteIndex < CallsiteCount;
+        ++CallsiteIndex)
+    {
+        allocation_callsite* Callsite = &Callsites[CallsiteIndex];
+        VENG_INFO("  %s:%d [%s] total %llu allocs/%lluB, live %llu allocs/%lluB", 
+                  Callsite->File ? Callsite->File : "?", Callsite->Line, MemoryTagStrings[Callsite->Tag],
+                  Callsite->TotalCount, Callsite->TotalBytes, Callsite->LiveCount, Callsite->LiveBytes);
+    }
+
+    LoggingSetOverflowPolicy(Policy);
+    if(Leaks)
+    {
+        PlatformFree(Leaks, false);
+    }
+    if(Callsites)
+    {
+        PlatformFree(Callsites, false);
+    }
+#else
+    VENG_WARN("MemoryTrackingReport - engine was built without VENG_MEMORY_TRACKING.");
+#endif
+}
+
+static u32 GetSizeBucket(u64 Size)
+{
+    u32 Bucket = 0;
+    u64 Limit  = 16;
+    while(Size > Limit && Bucket < MEMORY_SIZE_BUCKET_COUNT - 1)
+    {
+        Limit <<= 1;
+        ++Bucket;
+    }
+
+    return Bucket;
+}
+
 void* Allocate(u64 Size, memory_tag Tag)
+{
+    return AllocateTracked(Size, Tag, 0, 0);
+}
+
+void Free(void* Block, u64 Size, memory_tag Tag)
+{
+    FreeTracked(Block, Size, Tag, 0, 0);
+}
+
+static void RecordAllocation(u64 Size, memory_tag Tag)
+{
+    memory_tag_usage* Usage = &MemoryState->Stats.Tagged[Tag];
+
+    u64 Total  = AtomicFetchAddU64(&MemoryState->Stats.TotalAllocated, Size) + Size;
+    u64 Tagged = AtomicFetchAddU64(&Usage->Allocated, Size) + Size;
+    AtomicMaxU64(&MemoryState->Stats.TotalPeak, Total);
+    AtomicMaxU64(&Usage->Peak, Tagged);
+
+    AtomicFetchAddU64(&Usage->AllocCount, 1);
+    AtomicFetchAddU64(&Usage->SizeHistogram[GetSizeBucket(Size)], 1);
+    AtomicFetchAddU64(&MemoryState->AllocCount, 1);
+}
+
+static void RecordFree(u64 Size, memory_tag Tag)
+{
+    AtomicFetchSubU64(&MemoryState->Stats.TotalAllocated, Size);
+    AtomicFetchSubU64(&MemoryState->Stats.Tagged[Tag].Allocated, Size);
+    AtomicFetchAddU64(&MemoryState->Stats.Tagged[Tag].FreeCount, 1);
+    AtomicFetchAddU64(&MemoryState->Stats.FreeCount, 1);
+}
+
+void* AllocateTracked(u64 Size, memory_tag Tag, const char* File, s32 Line)
 {
     if(Tag == MEMORY_TAG_UNKNOWN)
     {
@@ -70,32 +512,114 @@ void* Allocate(u64 Size, memory_tag Tag)
 
     if(MemoryState)
     {
-        MemoryState->Stats.TotalAllocated += Size;
-        MemoryState->Stats.TaggedAllocation[Tag] += Size;
-        MemoryState->AllocCount++;
+        RecordAllocation(Size, Tag);
     }
 
     void* Block = PlatformAllocate(Size, false);
     PlatformZeroMemory(Block, Size);
+
+#if VENG_MEMORY_TRACKING
+    if(MemoryState)
+    {
+        TrackAllocation(Block, Size, Tag, File, Line);
+    }
+#endif
+
     return Block;
 }
 
-void Free(void* Block, u64 Size, memory_tag Tag)
+void FreeTracked(void* Block, u64 Size, memory_tag Tag, const char* File, s32 Line)
 {
     if(Tag == MEMORY_TAG_UNKNOWN)
     {
         VENG_WARN("Free called using MEMORY_TAG_UNKNOWN. Re-class this allocation.");
     }
 
+#if VENG_MEMORY_TRACKING
+    if(MemoryState && !TrackFree(Block, &Size, &Tag, File, Line))
+    {
+        return;
+    }
+#endif
+
     if(MemoryState)
     {
-        MemoryState->Stats.TotalAllocated -= Size;
-        MemoryState->Stats.TaggedAllocation[Tag] -= Size;
+        RecordFree(Size, Tag);
     }
 
     PlatformFree(Block, false);
 }
 
+void* Reallocate(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag)
+{
+    return ReallocateTracked(Block, OldSize, NewSize, Tag, 0, 0);
+}
+
+void* ReallocateUninitialized(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag)
+{
+    return ReallocateUninitializedTracked(Block, OldSize, NewSize, Tag, 0, 0);
+}
+
+// NOTE: Lets the platform heap extend the block in place when it can. With Zero set, bytes past OldSize are zeroed
+// like in Allocate, otherwise they hold whatever the heap left there.
+static void* ReallocateBlock(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag, const char* File, s32 Line, b8 Zero)
+{
+    if(!Block)
+    {
+        return AllocateTracked(NewSize, Tag, File, Line);
+    }
+
+#if VENG_MEMORY_TRACKING
+    if(MemoryState && !TrackFree(Block, &OldSize, &Tag, File, Line))
+    {
+        return 0;
+    }
+#endif
+
+    void* NewBlock = PlatformReallocate(Block, NewSize, false);
+    if(!NewBlock)
+    {
+        VENG_ERROR("Reallocate - failed to grow block from %lluB to %lluB.", OldSize, NewSize);
+#if VENG_MEMORY_TRACKING
+        if(MemoryState)
+        {
+            TrackAllocation(Block, OldSize, Tag, File, Line);
+        }
+#endif
+        return 0;
+    }
+
+    if(Zero && NewSize > OldSize)
+    {
+        PlatformZeroMemory((u8*)NewBlock + OldSize, NewSize - OldSize);
+    }
+
+    if(MemoryState)
+    {
+        RecordFree(OldSize, Tag);
+        RecordAllocation(NewSize, Tag);
+    }
+
+#if VENG_MEMORY_TRACKING
+    if(MemoryState)
+    {
+        TrackAllocation(NewBlock, NewSize, Tag, File, Line);
+    }
+#endif
+
+    return NewBlock;
+}
+
+void* ReallocateTracked(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag, const char* File, s32 Line)
+{
+    return ReallocateBlock(Block, OldSize, NewSize, Tag, File, Line, true);
+}
+
+void* ReallocateUninitializedTracked(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag, const char* File, s32 Line)
+{
+    return ReallocateBlock(Block, OldSize, NewSize, Tag, File, Line, false);
+}
+
 void* ZeroMemory(void* Block, u64 Size)
 {
     return PlatformZeroMemory(Block, Size);
@@ -106,6 +630,11 @@ void* CopyMemory(void* Dest, const void* Source, u64 Size)
     return PlatformCopyMemory(Dest, Source, Size);
 }
 
+void* MoveMemory(void* Dest, const void* Source, u64 Size)
+{
+    return PlatformMoveMemory(Dest, Source, Size);
+}
+
 void* SetMemory(void* Dest, s32 Value, u64 Size)
 {
     return PlatformSetMemory(Dest, Value, Size);
@@ -117,6 +646,12 @@ char* GetMemoryUsageStr()
     const u64 Mb = 1024 * 1024;
     const u64 Kb = 1024;
 
+    memory_usage Usage;
+    if(!GetMemoryUsage(&Usage))
+    {
+        return 0;
+    }
+
     char Buffer[8000] = "System memory use (tagged):\n";
     u64 Offset = strlen(Buffer);
 
@@ -124,31 +659,39 @@ char* GetMemoryUsageStr()
         MemoryIndex < MEMORY_TAG_MAX_TAGS;
         ++MemoryIndex)
     {
+        u64 Allocated = Usage.Tags[MemoryIndex].Allocated;
+
         char Unit[4] = "XiB";
         r32 Ammount = 1.0f;
-        if(MemoryState->Stats.TaggedAllocation[MemoryIndex] >= Gb)
+        if(Allocated >= Gb)
         {
             Unit[0] = 'G';
-            Ammount = MemoryState->Stats.TaggedAllocation[MemoryIndex] / (float)Gb;
+            Ammount = Allocated / (float)Gb;
         }
-        else if(MemoryState->Stats.TaggedAllocation[MemoryIndex] >= Mb)
+        else if(Allocated >= Mb)
         {
             Unit[0] = 'M';
-            Ammount = MemoryState->Stats.TaggedAllocation[MemoryIndex] / (float)Mb;
+            Ammount = Allocated / (float)Mb;
         }
-        else if(MemoryState->Stats.TaggedAllocation[MemoryIndex] >= Kb)
+        else if(Allocated >= Kb)
         {
             Unit[0] = 'K';
-            Ammount = MemoryState->Stats.TaggedAllocation[MemoryIndex] / (float)Kb;
+            Ammount = Allocated / (float)Kb;
         }
         else
         {
             Unit[0] = 'B';
             Unit[1] = 0;
-            Ammount = (float)MemoryState->Stats.TaggedAllocation[MemoryIndex];
+            Ammount = (float)Allocated;
         }
 
-        s32 Length = snprintf(Buffer + Offset, 8000, "  %s: %.2f%s\n", MemoryTagStrings[MemoryIndex], Ammount, Unit);
+        s32 Length = snprintf(Buffer + Offset, sizeof(Buffer) - Offset, "  %s: %.2f%s (peak %lluB, %llu allocs)\n", 
+                              MemoryTagStrings[MemoryIndex], Ammount, Unit, 
+                              Usage.Tags[MemoryIndex].Peak, Usage.Tags[MemoryIndex].AllocCount);
+        if(Length < 0 || Offset + Length >= sizeof(Buffer))
+        {
+            break;
+        }
         Offset += Length;
     }
 
@@ -160,9 +703,79 @@ VENG_API u64 GetMemoryAllocCount()
 {
     if(MemoryState)
     {
-        return MemoryState->AllocCount;
+        return AtomicLoadU64(&MemoryState->AllocCount);
     }
 
     return 0;
 }
 
+// NOTE: Counters are read one by one, so the snapshot is not a single
+// consistent point in time when other threads are allocating.
+b8 GetMemoryUsage(memory_usage* OutUsage)
+{
+    if(!MemoryState || !OutUsage)
+    {
+        return false;
+    }
+
+    OutUsage->TotalAllocated = AtomicLoadU64(&MemoryState->Stats.TotalAllocated);
+    OutUsage->TotalPeak      = AtomicLoadU64(&MemoryState->Stats.TotalPeak);
+    OutUsage->AllocCount     = AtomicLoadU64(&MemoryState->AllocCount);
+    OutUsage->FreeCount      = AtomicLoadU64(&MemoryState->Stats.FreeCount);
+
+    for(u32 TagIndex = 0;
+        TagIndex < MEMORY_TAG_MAX_TAGS;
+        ++TagIndex)
+    {
+        memory_tag_usage* Src = &MemoryState->Stats.Tagged[TagIndex];
+        memory_tag_usage* Dst = &OutUsage->Tags[TagIndex];
+
+        Dst->Allocated  = AtomicLoadU64(&Src->Allocated);
+        Dst->Peak       = AtomicLoadU64(&Src->Peak);
+        Dst->AllocCount = AtomicLoadU64(&Src->AllocCount);
+        Dst->FreeCount  = AtomicLoadU64(&Src->FreeCount);
+        for(u32 Bucket = 0;
+            Bucket < MEMORY_SIZE_BUCKET_COUNT;
+            ++Bucket)
+        {
+            Dst->SizeHistogram[Bucket] = AtomicLoadU64(&Src->SizeHistogram[Bucket]);
+        }
+    }
+
+    return true;
+}
+
+const char* GetMemoryTagName(memory_tag Tag)
+{
+    if(Tag >= MEMORY_TAG_MAX_TAGS)
+    {
+        return "INVALID";
+    }
+
+    return MemoryTagStrings[Tag];
+}
+
+u64 GetMemorySizeBucketLimit(u32 Bucket)
+{
+    if(Bucket >= MEMORY_SIZE_BUCKET_COUNT - 1)
+    {
+        return (u64)-1;
+    }
+
+    return 16ull << Bucket;
+}
+
+void ResetMemoryPeaks()
+{
+    if(MemoryState)
+    {
+        AtomicStoreU64(&MemoryState->Stats.TotalPeak, AtomicLoadU64(&MemoryState->Stats.TotalAllocated));
+        for(u32 TagIndex = 0;
+            TagIndex < MEMORY_TAG_MAX_TAGS;
+            ++TagIndex)
+        {
+            memory_tag_usage* Usage = &MemoryState->Stats.Tagged[TagIndex];
+            AtomicStoreU64(&Usage->Peak, AtomicLoadU64(&Usage->Allocated));
+        }
+    }
+}
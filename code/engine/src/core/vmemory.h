@@ -2,6 +2,15 @@
 
 #include "defines.h"
 
+// NOTE: Set to 1 to record every live allocation with its callsite. Free then
+// validates size/tag, catches double frees and ShutdownMemory reports leaks.
+#ifndef VENG_MEMORY_TRACKING
+#define VENG_MEMORY_TRACKING 0
+#endif
+
+#define MEMORY_TRACKING_MAX_ALLOCATIONS 131072
+#define MEMORY_TRACKING_MAX_CALLSITES   4096
+
 typedef enum memory_tag
 {
     MEMORY_TAG_UNKNOWN,
@@ -26,16 +35,61 @@ typedef enum memory_tag
     MEMORY_TAG_MAX_TAGS
 } memory_tag;
 
+// NOTE: Allocation sizes are bucketed by power of two, starting at 16 bytes.
+// The last bucket collects everything bigger.
+#define MEMORY_SIZE_BUCKET_COUNT 16
+
+typedef struct memory_tag_usage
+{
+    u64 Allocated;
+    u64 Peak;
+    u64 AllocCount;
+    u64 FreeCount;
+    u64 SizeHistogram[MEMORY_SIZE_BUCKET_COUNT];
+} memory_tag_usage;
+
+typedef struct memory_usage
+{
+    u64 TotalAllocated;
+    u64 TotalPeak;
+    u64 AllocCount;
+    u64 FreeCount;
+    memory_tag_usage Tags[MEMORY_TAG_MAX_TAGS];
+} memory_usage;
+
 VENG_API void InitializeMemory(u64* MemoryRequirement, void* State);
 VENG_API void ShutdownMemory(void* State);
 
 VENG_API void* Allocate(u64 Size, memory_tag Tag);
 VENG_API void  Free(void* Block, u64 Size, memory_tag Tag);
+VENG_API void* AllocateTracked(u64 Size, memory_tag Tag, const char* File, s32 Line);
+VENG_API void  FreeTracked(void* Block, u64 Size, memory_tag Tag, const char* File, s32 Line);
+VENG_API void* Reallocate(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag);
+VENG_API void* ReallocateTracked(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag, const char* File, s32 Line);
+// NOTE: Reallocate without zeroing the grown tail, for callers that overwrite it anyway
+VENG_API void* ReallocateUninitialized(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag);
+VENG_API void* ReallocateUninitializedTracked(void* Block, u64 OldSize, u64 NewSize, memory_tag Tag, const char* File, s32 Line);
 VENG_API void* ZeroMemory(void* Block, u64 Size);
 VENG_API void* CopyMemory(void* Dest, const void* Source, u64 Size);
+VENG_API void* MoveMemory(void* Dest, const void* Source, u64 Size);
 VENG_API void* SetMemory(void* Dest, s32 Value, u64 Size);
 
 VENG_API char* GetMemoryUsageStr();
 
 VENG_API u64 GetMemoryAllocCount();
 
+VENG_API b8 GetMemoryUsage(memory_usage* OutUsage);
+VENG_API const char* GetMemoryTagName(memory_tag Tag);
+VENG_API u64 GetMemorySizeBucketLimit(u32 Bucket);
+VENG_API void ResetMemoryPeaks();
+
+VENG_API void MemoryBeginFrame();
+VENG_API void MemoryTrackingReport(b8 LeaksOnly);
+
+#if VENG_MEMORY_TRACKING && !defined(VENG_MEMORY_IMPLEMENTATION)
+#define Allocate(Size, Tag)       AllocateTracked(Size, Tag, __FILE__, __LINE__)
+#define Free(Block, Size, Tag)    FreeTracked(Block, Size, Tag, __FILE__, __LINE__)
+#define Reallocate(Block, OldSize, NewSize, Tag) ReallocateTracked(Block, OldSize, NewSize, Tag, __FILE__, __LINE__)
+#define ReallocateUninitialized(Block, OldSize, NewSize, Tag) ReallocateUninitializedTracked(Block, OldSize, NewSize, Tag, __FILE__, __LINE__)
+#endif
+
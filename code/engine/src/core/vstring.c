@@ -72,6 +72,21 @@ VENG_API s32 StringFormatV(char* Dest, const char* Format, void* va_listp)
     return -1;
 }
 
+VENG_API s32 StringFormatVN(char* Dest, u64 Size, const char* Format, void* va_listp)
+{
+    if(Dest && Size > 0)
+    {
+        s32 Written = vsnprintf(Dest, Size, Format, va_listp);
+        if(Written < 0)
+        {
+            Dest[0] = 0;
+            return 0;
+        }
+        return Written < (s32)Size ? Written : (s32)(Size - 1);
+    }
+    return -1;
+}
+
 VENG_API char* StringCopy(char* Dest, const char* Source)
 {
     return strcpy(Dest, Source);
@@ -13,6 +13,8 @@ b8 IsStringsEquali(const char* A, const char* B);
 
 VENG_API s32 StringFormat(char* Dest, const char* Format, ...);
 VENG_API s32 StringFormatV(char* Dest, const char* Format, void* va_listp);
+// NOTE: Formats straight into Dest, truncating to Size - 1 characters. Returns the written length.
+VENG_API s32 StringFormatVN(char* Dest, u64 Size, const char* Format, void* va_listp);
 
 VENG_API char* StringCopy(char* Dest, const char* Source);
 VENG_API char* StringCopyN(char* Dest, const char* Source, s64 Length);
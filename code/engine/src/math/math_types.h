@@ -59,16 +59,36 @@ typedef union v4
             r32 w, a, q;
         };
     };
-    r32 E[4];
+    // NOTE: 16 byte aligned so the SIMD paths in vmath.h can use aligned loads
+    alignas(16) r32 E[4];
 } v4;
 
 typedef v4 quat;
 
 typedef union mat4
 {
-    r32 E[16];
+    alignas(16) r32 E[16];
 } mat4;
 
+typedef struct extents_3d
+{
+    v3 Min;
+    v3 Max;
+} extents_3d;
+
+// NOTE: Points with InnerV3(Normal, P) + Distance >= 0 are on the inside
+typedef struct plane_3d
+{
+    v3 Normal;
+    r32 Distance;
+} plane_3d;
+
+// NOTE: Left, right, bottom, top, near, far
+typedef struct frustum
+{
+    plane_3d Planes[6];
+} frustum;
+
 typedef struct vertex_2d
 {
     v2 Position;
@@ -81,3 +101,21 @@ typedef struct vertex_3d
     v2 TexCoord;
 } vertex_3d;
 
+// NOTE: Quantized vertex_3d, 12 bytes instead of 20. Positions are unorm16 across the geometry's extents,
+// texture coordinates are half floats. The padding fills the position out to a 4 component format.
+typedef struct vertex_3d_packed
+{
+    u16 Position[3];
+    u16 Padding;
+    u16 TexCoord[2];
+} vertex_3d_packed;
+
+// NOTE: Which of the vertex structs above a geometry's vertices are. Sizes alone do not tell them apart, any other
+// 12 byte layout would pass for vertex_3d_packed.
+typedef enum vertex_format
+{
+    VERTEX_FORMAT_3D,
+    VERTEX_FORMAT_3D_PACKED,
+    VERTEX_FORMAT_2D,
+} vertex_format;
+
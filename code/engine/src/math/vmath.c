@@ -1,10 +1,8 @@
+#define VENG_MATH_IMPLEMENTATION
 #include "vmath.h"
-#include "platform/platform.h"
+#include "vrandom.h"
 
 #include <math.h>
-#include <stdlib.h>
-
-static b8 RandSeeded = false;
 
 VENG_API r32 Sin(r32 X)
 {
@@ -41,35 +39,23 @@ VENG_API r32 Abs(r32 X)
     return fabsf(X);
 }
 
+// NOTE: The old rand() style helpers, now drawing from the calling thread's generator in vrandom.h
 VENG_API s32 Random()
 {
-    if(!RandSeeded)
-    {
-        srand((u32)PlatformGetAbsoluteTime());
-        RandSeeded;
-    }
-
-    return rand();
+    return (s32)(RandomXoshiroNext(RandomThreadState()) >> 33);
 }
 
 VENG_API s32 RanfomInRange(s32 Min, s32 Max)
 {
-    if(!RandSeeded)
-    {
-        srand((u32)PlatformGetAbsoluteTime());
-        RandSeeded;
-    }
-
-    return (rand() % (Max - Min + 1)) + Min;
+    return RandomXoshiroS32InRange(RandomThreadState(), Min, Max);
 }
 
 VENG_API r32 FloatRandom()
 {
-    return (r32)Random() / (r32)RAND_MAX;
+    return RandomXoshiroR32(RandomThreadState());
 }
 
 VENG_API r32 FloatRandomInRange(s32 Min, s32 Max)
 {
-    return Min + ((r32)Random() / ((r32)RAND_MAX / (Max - Min)));
+    return RandomXoshiroR32InRange(RandomThreadState(), (r32)Min, (r32)Max);
 }
-
@@ -3,6 +3,33 @@
 #include "defines.h"
 #include "math_types.h"
 
+// NOTE: The SIMD path is chosen at compile time from the target flags. Define VENG_SIMD_SCALAR to force 
+// the scalar code, all paths produce the same results up to float rounding.
+#if !defined(VENG_SIMD_SCALAR)
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define VENG_SIMD_AVX2 1
+#define VENG_SIMD_SSE  1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define VENG_SIMD_SSE  1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define VENG_SIMD_NEON 1
+#endif
+#endif
+
+#if VENG_SIMD_AVX2
+#include <immintrin.h>
+#elif VENG_SIMD_SSE
+#include <emmintrin.h>
+#elif VENG_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if VENG_SIMD_SSE
+#define SIMD_SHUFFLE_MASK(X, Y, Z, W) ((X) | ((Y) << 2) | ((Z) << 4) | ((W) << 6))
+#define SIMD_SWIZZLE(V, X, Y, Z, W) _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(V), SIMD_SHUFFLE_MASK(X, Y, Z, W)))
+#define SIMD_SHUFFLE(A, B, X, Y, Z, W) _mm_shuffle_ps(A, B, SIMD_SHUFFLE_MASK(X, Y, Z, W))
+#endif
+
 #define PI32                    3.14159265358979323846f
 #define TWO_PI32                2.0f * PI32
 #define HALF_PI                 0.5f * PI32
@@ -28,6 +55,151 @@ VENG_API r32 Atan(r32 X);
 VENG_API r32 SquareRoot(r32 X);
 VENG_API r32 Abs(r32 X);
 
+// NOTE: Inline polynomial approximations of the functions above. They are branch free apart from the
+// quadrant selects, so loops over them vectorize. Max errors measured against double precision libm:
+//   FastSin, FastCos, FastSinCos  1e-7 absolute for |X| <= 8192, 1e-6 up to 65536, worse past that
+//   FastTan                       4 ulp relative on (-pi / 2, pi / 2)
+//   FastAtan                      3 ulp relative
+//   FastArcCos                    3e-7 absolute on [-1, 1]
+//   FastSquareRoot                exact, the hardware instruction
+//   FastInverseSquareRoot         3e-7 relative, estimate refined with Newton steps
+// Define VENG_FAST_MATH to 1 to send Sin, Cos, Tan, Atan, ArcCos and SquareRoot, including the calls inside
+// this header, to these versions. The exported functions stay precise and callable as (Sin)(X).
+#ifndef VENG_FAST_MATH
+#define VENG_FAST_MATH 0
+#endif
+
+// NOTE: pi / 2 split in three parts for the range reduction X - Quadrant * pi / 2, the product with the
+// high part has only 8 significant bits and stays exact for |Quadrant| < 2^16
+#define FAST_MATH_PIO2_HI  1.5703125f
+#define FAST_MATH_PIO2_MID 4.837512969970703125e-4f
+#define FAST_MATH_PIO2_LO  7.54978995489188216e-8f
+
+// NOTE: Minimax polynomials for sin and cos on [-pi / 4, pi / 4]
+#define FAST_MATH_SIN_C1 -1.6666654611e-1f
+#define FAST_MATH_SIN_C2  8.3321608736e-3f
+#define FAST_MATH_SIN_C3 -1.9515295891e-4f
+#define FAST_MATH_COS_C1  4.166664568298827e-2f
+#define FAST_MATH_COS_C2 -1.388731625493765e-3f
+#define FAST_MATH_COS_C3  2.443315711809948e-5f
+
+INLINE void
+FastSinCos(r32 X, r32* OutSin, r32* OutCos)
+{
+    r32 QuadrantReal = X * 0.63661977236758134308f;
+    s32 Quadrant = (s32)(QuadrantReal + (QuadrantReal >= 0.0f ? 0.5f : -0.5f));
+    r32 q = (r32)Quadrant;
+
+    r32 r = ((X - q * FAST_MATH_PIO2_HI) - q * FAST_MATH_PIO2_MID) - q * FAST_MATH_PIO2_LO;
+    r32 z = r * r;
+
+    r32 s = r + r * z * (FAST_MATH_SIN_C1 + z * (FAST_MATH_SIN_C2 + z * FAST_MATH_SIN_C3));
+    r32 c = 1.0f - 0.5f * z + z * z * (FAST_MATH_COS_C1 + z * (FAST_MATH_COS_C2 + z * FAST_MATH_COS_C3));
+
+    // NOTE: Odd quadrants swap sin and cos, quadrants 2 and 3 negate sin, 1 and 2 negate cos
+    r32 SinValue = (Quadrant & 1) ? c : s;
+    r32 CosValue = (Quadrant & 1) ? s : c;
+    *OutSin = (Quadrant & 2) ? -SinValue : SinValue;
+    *OutCos = ((Quadrant + 1) & 2) ? -CosValue : CosValue;
+}
+
+INLINE r32
+FastSin(r32 X)
+{
+    r32 s, c;
+    FastSinCos(X, &s, &c);
+    return s;
+}
+
+INLINE r32
+FastCos(r32 X)
+{
+    r32 s, c;
+    FastSinCos(X, &s, &c);
+    return c;
+}
+
+INLINE r32
+FastTan(r32 X)
+{
+    r32 s, c;
+    FastSinCos(X, &s, &c);
+    return s / c;
+}
+
+// NOTE: Reduces to [0, tan(pi / 8)] with atan(x) = pi / 2 - atan(1 / x) and atan(x) = pi / 4 + atan((x - 1) / (x + 1))
+INLINE r32
+FastAtan(r32 X)
+{
+    r32 a = X < 0.0f ? -X : X;
+    b8 Large  = a > 2.414213562373095f;
+    b8 Medium = a > 0.4142135623730950f;
+
+    r32 Offset = Large ? 0.5f * PI32 : (Medium ? 0.25f * PI32 : 0.0f);
+    r32 x = Large ? -1.0f / a : (Medium ? (a - 1.0f) / (a + 1.0f) : a);
+    r32 z = x * x;
+
+    r32 Result = Offset + ((((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x);
+    return X < 0.0f ? -Result : Result;
+}
+
+INLINE r32
+FastSquareRoot(r32 X)
+{
+#if VENG_SIMD_SSE
+    return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(X)));
+#else
+    return SquareRoot(X);
+#endif
+}
+
+INLINE r32
+FastInverseSquareRoot(r32 X)
+{
+#if VENG_SIMD_SSE
+    r32 y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(X)));
+#elif VENG_SIMD_NEON
+    r32 y = vget_lane_f32(vrsqrte_f32(vdup_n_f32(X)), 0);
+    y = y * (1.5f - 0.5f * X * y * y);
+#else
+    union { r32 Real; u32 Bits; } Convert;
+    Convert.Real = X;
+    Convert.Bits = 0x5F375A86 - (Convert.Bits >> 1);
+    r32 y = Convert.Real;
+    y = y * (1.5f - 0.5f * X * y * y);
+    y = y * (1.5f - 0.5f * X * y * y);
+#endif
+    return y * (1.5f - 0.5f * X * y * y);
+}
+
+// NOTE: acos(x) = 2 * asin(sqrt((1 - |x|) / 2)) near +-1, pi / 2 - asin(x) in the middle
+INLINE r32
+FastArcCos(r32 X)
+{
+    r32 a = X < 0.0f ? -X : X;
+    b8 Middle = a <= 0.5f;
+
+    r32 z = Middle ? a * a : 0.5f * (1.0f - a);
+    r32 x = Middle ? a : FastSquareRoot(z);
+    r32 Asin = x + x * z * ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z + 7.4953002686e-2f) * z + 1.6666752422e-1f);
+
+    if(Middle)
+    {
+        return 0.5f * PI32 - (X < 0.0f ? -Asin : Asin);
+    }
+
+    return X < 0.0f ? PI32 - 2.0f * Asin : 2.0f * Asin;
+}
+
+#if VENG_FAST_MATH && !defined(VENG_MATH_IMPLEMENTATION)
+#define Sin(X)        FastSin(X)
+#define Cos(X)        FastCos(X)
+#define Tan(X)        FastTan(X)
+#define Atan(X)       FastAtan(X)
+#define ArcCos(X)     FastArcCos(X)
+#define SquareRoot(X) FastSquareRoot(X)
+#endif
+
 INLINE b8
 IsPowerOfTwo(u64 Value)
 {
@@ -350,9 +522,9 @@ INLINE v3
 CrossV3(v3 A, v3 B)
 {
     v3 Result;
-    Result.x =  (A.y * B.z + A.z * B.y);
-    Result.y = -(A.z * B.x + A.x * B.z);
-    Result.z =  (A.x * B.y + A.y + B.x);
+    Result.x = A.y * B.z - A.z * B.y;
+    Result.y = A.z * B.x - A.x * B.z;
+    Result.z = A.x * B.y - A.y * B.x;
     return Result;
 }
 
@@ -384,10 +556,16 @@ INLINE v4
 AddV4(v4 A, v4 B)
 {
     v4 Result;
+#if VENG_SIMD_SSE
+    _mm_store_ps(Result.E, _mm_add_ps(_mm_load_ps(A.E), _mm_load_ps(B.E)));
+#elif VENG_SIMD_NEON
+    vst1q_f32(Result.E, vaddq_f32(vld1q_f32(A.E), vld1q_f32(B.E)));
+#else
     Result.x = A.x + B.x;
     Result.y = A.y + B.y;
     Result.z = A.z + B.z;
-    Result.w = A.w / B.w;
+    Result.w = A.w + B.w;
+#endif
     return Result;
 }
 
@@ -395,10 +573,16 @@ INLINE v4
 SubV4(v4 A, v4 B)
 {
     v4 Result;
+#if VENG_SIMD_SSE
+    _mm_store_ps(Result.E, _mm_sub_ps(_mm_load_ps(A.E), _mm_load_ps(B.E)));
+#elif VENG_SIMD_NEON
+    vst1q_f32(Result.E, vsubq_f32(vld1q_f32(A.E), vld1q_f32(B.E)));
+#else
     Result.x = A.x - B.x;
     Result.y = A.y - B.y;
     Result.z = A.z - B.z;
-    Result.w = A.w / B.w;
+    Result.w = A.w - B.w;
+#endif
     return Result;
 }
 
@@ -406,10 +590,16 @@ INLINE v4
 MulV4(v4 A, v4 B)
 {
     v4 Result;
+#if VENG_SIMD_SSE
+    _mm_store_ps(Result.E, _mm_mul_ps(_mm_load_ps(A.E), _mm_load_ps(B.E)));
+#elif VENG_SIMD_NEON
+    vst1q_f32(Result.E, vmulq_f32(vld1q_f32(A.E), vld1q_f32(B.E)));
+#else
     Result.x = A.x * B.x;
     Result.y = A.y * B.y;
     Result.z = A.z * B.z;
-    Result.w = A.w / B.w;
+    Result.w = A.w * B.w;
+#endif
     return Result;
 }
 
@@ -417,18 +607,33 @@ INLINE v4
 DivV4(v4 A, v4 B)
 {
     v4 Result;
+#if VENG_SIMD_SSE
+    _mm_store_ps(Result.E, _mm_div_ps(_mm_load_ps(A.E), _mm_load_ps(B.E)));
+#elif VENG_SIMD_NEON
+    vst1q_f32(Result.E, vdivq_f32(vld1q_f32(A.E), vld1q_f32(B.E)));
+#else
     Result.x = A.x / B.x;
     Result.y = A.y / B.y;
     Result.z = A.z / B.z;
     Result.w = A.w / B.w;
+#endif
     return Result;
 }
 
 INLINE r32
 InnerV4(v4 A, v4 B)
 {
+#if VENG_SIMD_SSE
+    __m128 Product = _mm_mul_ps(_mm_load_ps(A.E), _mm_load_ps(B.E));
+    __m128 Sum     = _mm_add_ps(Product, _mm_movehl_ps(Product, Product));
+    Sum = _mm_add_ss(Sum, SIMD_SWIZZLE(Sum, 1, 1, 1, 1));
+    return _mm_cvtss_f32(Sum);
+#elif VENG_SIMD_NEON
+    return vaddvq_f32(vmulq_f32(vld1q_f32(A.E), vld1q_f32(B.E)));
+#else
     r32 Result = A.x * B.x + A.y * B.y + A.z * B.z + A.w * B.w;
     return Result;
+#endif
 }
 
 INLINE r32
@@ -509,9 +714,58 @@ Identity()
     return Result;
 }
 
+// NOTE: Result row r is the sum of B's rows weighted by A's row r, every SIMD path works row by row.
 INLINE mat4
 MulMat4(mat4 A, mat4 B)
 {
+#if VENG_SIMD_AVX2
+    mat4 Result;
+    __m256 B0 = _mm256_broadcast_ps((const __m128*)&B.E[0]);
+    __m256 B1 = _mm256_broadcast_ps((const __m128*)&B.E[4]);
+    __m256 B2 = _mm256_broadcast_ps((const __m128*)&B.E[8]);
+    __m256 B3 = _mm256_broadcast_ps((const __m128*)&B.E[12]);
+    for(u32 r = 0; r < 4; r += 2)
+    {
+        __m256 Rows = _mm256_loadu_ps(&A.E[r * 4]);
+        __m256 Sum  = _mm256_mul_ps(_mm256_permute_ps(Rows, 0x00), B0);
+        Sum = _mm256_fmadd_ps(_mm256_permute_ps(Rows, 0x55), B1, Sum);
+        Sum = _mm256_fmadd_ps(_mm256_permute_ps(Rows, 0xAA), B2, Sum);
+        Sum = _mm256_fmadd_ps(_mm256_permute_ps(Rows, 0xFF), B3, Sum);
+        _mm256_storeu_ps(&Result.E[r * 4], Sum);
+    }
+    return Result;
+#elif VENG_SIMD_SSE
+    mat4 Result;
+    __m128 B0 = _mm_load_ps(&B.E[0]);
+    __m128 B1 = _mm_load_ps(&B.E[4]);
+    __m128 B2 = _mm_load_ps(&B.E[8]);
+    __m128 B3 = _mm_load_ps(&B.E[12]);
+    for(u32 r = 0; r < 4; ++r)
+    {
+        __m128 Row = _mm_load_ps(&A.E[r * 4]);
+        __m128 Sum = _mm_mul_ps(SIMD_SWIZZLE(Row, 0, 0, 0, 0), B0);
+        Sum = _mm_add_ps(Sum, _mm_mul_ps(SIMD_SWIZZLE(Row, 1, 1, 1, 1), B1));
+        Sum = _mm_add_ps(Sum, _mm_mul_ps(SIMD_SWIZZLE(Row, 2, 2, 2, 2), B2));
+        Sum = _mm_add_ps(Sum, _mm_mul_ps(SIMD_SWIZZLE(Row, 3, 3, 3, 3), B3));
+        _mm_store_ps(&Result.E[r * 4], Sum);
+    }
+    return Result;
+#elif VENG_SIMD_NEON
+    mat4 Result;
+    float32x4_t B0 = vld1q_f32(&B.E[0]);
+    float32x4_t B1 = vld1q_f32(&B.E[4]);
+    float32x4_t B2 = vld1q_f32(&B.E[8]);
+    float32x4_t B3 = vld1q_f32(&B.E[12]);
+    for(u32 r = 0; r < 4; ++r)
+    {
+        float32x4_t Sum = vmulq_n_f32(B0, A.E[r * 4 + 0]);
+        Sum = vmlaq_n_f32(Sum, B1, A.E[r * 4 + 1]);
+        Sum = vmlaq_n_f32(Sum, B2, A.E[r * 4 + 2]);
+        Sum = vmlaq_n_f32(Sum, B3, A.E[r * 4 + 3]);
+        vst1q_f32(&Result.E[r * 4], Sum);
+    }
+    return Result;
+#else
     mat4 Result = Identity();
 
     const r32* m1 = A.E;
@@ -531,6 +785,33 @@ MulMat4(mat4 A, mat4 B)
         m1 += 4;
     }
 
+    return Result;
+#endif
+}
+
+// NOTE: Transforms a column vector, the inverse order of MulMat4: MulMat4V4(MulMat4(A, B), V) applies A first.
+INLINE v4
+MulMat4V4(mat4 M, v4 V)
+{
+    v4 Result;
+#if VENG_SIMD_SSE
+    __m128 Sum = _mm_mul_ps(_mm_load_ps(&M.E[0]), _mm_set1_ps(V.x));
+    Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_load_ps(&M.E[4]),  _mm_set1_ps(V.y)));
+    Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_load_ps(&M.E[8]),  _mm_set1_ps(V.z)));
+    Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_load_ps(&M.E[12]), _mm_set1_ps(V.w)));
+    _mm_store_ps(Result.E, Sum);
+#elif VENG_SIMD_NEON
+    float32x4_t Sum = vmulq_n_f32(vld1q_f32(&M.E[0]), V.x);
+    Sum = vmlaq_n_f32(Sum, vld1q_f32(&M.E[4]),  V.y);
+    Sum = vmlaq_n_f32(Sum, vld1q_f32(&M.E[8]),  V.z);
+    Sum = vmlaq_n_f32(Sum, vld1q_f32(&M.E[12]), V.w);
+    vst1q_f32(Result.E, Sum);
+#else
+    for(u32 Row = 0; Row < 4; ++Row)
+    {
+        Result.E[Row] = M.E[Row] * V.x + M.E[4 + Row] * V.y + M.E[8 + Row] * V.z + M.E[12 + Row] * V.w;
+    }
+#endif
     return Result;
 }
 
@@ -590,7 +871,7 @@ LookAt(v3 Pos, v3 Target, v3 Up)
     Result.E[7]  = 0;
     Result.E[8]  = X.z;
     Result.E[9]  = Y.z;
-    Result.E[10] = Z.z;
+    Result.E[10] = -Z.z;
     Result.E[11] = 0;
     Result.E[12] = -InnerV3(X, Pos);
     Result.E[13] = -InnerV3(Y, Pos);
@@ -600,7 +881,7 @@ LookAt(v3 Pos, v3 Target, v3 Up)
     return Result;
 }
 
-inline mat4
+INLINE mat4
 Transpose(mat4 A)
 {
     mat4 Result  = {};
@@ -623,9 +904,70 @@ Transpose(mat4 A)
     return Result;
 }
 
+// NOTE: The SSE path inverts through 2x2 sub-matrix adjugates instead of 24 cofactor products
 INLINE mat4
 Inverse(mat4 A)
 {
+#if VENG_SIMD_SSE
+    __m128 Row0 = _mm_load_ps(&A.E[0]);
+    __m128 Row1 = _mm_load_ps(&A.E[4]);
+    __m128 Row2 = _mm_load_ps(&A.E[8]);
+    __m128 Row3 = _mm_load_ps(&A.E[12]);
+
+    // NOTE: 2x2 blocks stored row major in one register
+    __m128 BlockA = _mm_movelh_ps(Row0, Row1);
+    __m128 BlockB = _mm_movehl_ps(Row1, Row0);
+    __m128 BlockC = _mm_movelh_ps(Row2, Row3);
+    __m128 BlockD = _mm_movehl_ps(Row3, Row2);
+
+    __m128 DetSub = _mm_sub_ps(_mm_mul_ps(SIMD_SHUFFLE(Row0, Row2, 0, 2, 0, 2), SIMD_SHUFFLE(Row1, Row3, 1, 3, 1, 3)),
+                               _mm_mul_ps(SIMD_SHUFFLE(Row0, Row2, 1, 3, 1, 3), SIMD_SHUFFLE(Row1, Row3, 0, 2, 0, 2)));
+    __m128 DetA = SIMD_SWIZZLE(DetSub, 0, 0, 0, 0);
+    __m128 DetB = SIMD_SWIZZLE(DetSub, 1, 1, 1, 1);
+    __m128 DetC = SIMD_SWIZZLE(DetSub, 2, 2, 2, 2);
+    __m128 DetD = SIMD_SWIZZLE(DetSub, 3, 3, 3, 3);
+
+    // NOTE: adj(D) * C and adj(A) * B
+    __m128 DC = _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(BlockD, 3, 3, 0, 0), BlockC), 
+                           _mm_mul_ps(SIMD_SWIZZLE(BlockD, 1, 1, 2, 2), SIMD_SWIZZLE(BlockC, 2, 3, 0, 1)));
+    __m128 AB = _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(BlockA, 3, 3, 0, 0), BlockB), 
+                           _mm_mul_ps(SIMD_SWIZZLE(BlockA, 1, 1, 2, 2), SIMD_SWIZZLE(BlockB, 2, 3, 0, 1)));
+
+    // NOTE: X = DetD * A - B * DC, W = DetA * D - C * AB
+    __m128 X = _mm_sub_ps(_mm_mul_ps(DetD, BlockA), 
+                          _mm_add_ps(_mm_mul_ps(BlockB, SIMD_SWIZZLE(DC, 0, 3, 0, 3)), 
+                                     _mm_mul_ps(SIMD_SWIZZLE(BlockB, 1, 0, 3, 2), SIMD_SWIZZLE(DC, 2, 1, 2, 1))));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(DetA, BlockD), 
+                          _mm_add_ps(_mm_mul_ps(BlockC, SIMD_SWIZZLE(AB, 0, 3, 0, 3)), 
+                                     _mm_mul_ps(SIMD_SWIZZLE(BlockC, 1, 0, 3, 2), SIMD_SWIZZLE(AB, 2, 1, 2, 1))));
+
+    // NOTE: Y = DetB * C - D * adj(AB), Z = DetC * B - A * adj(DC)
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(DetB, BlockC), 
+                          _mm_sub_ps(_mm_mul_ps(BlockD, SIMD_SWIZZLE(AB, 3, 0, 3, 0)), 
+                                     _mm_mul_ps(SIMD_SWIZZLE(BlockD, 1, 0, 3, 2), SIMD_SWIZZLE(AB, 2, 1, 2, 1))));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(DetC, BlockB), 
+                          _mm_sub_ps(_mm_mul_ps(BlockA, SIMD_SWIZZLE(DC, 3, 0, 3, 0)), 
+                                     _mm_mul_ps(SIMD_SWIZZLE(BlockA, 1, 0, 3, 2), SIMD_SWIZZLE(DC, 2, 1, 2, 1))));
+
+    __m128 Det   = _mm_add_ps(_mm_mul_ps(DetA, DetD), _mm_mul_ps(DetB, DetC));
+    __m128 Trace = _mm_mul_ps(AB, SIMD_SWIZZLE(DC, 0, 2, 1, 3));
+    Trace = _mm_add_ps(Trace, _mm_movehl_ps(Trace, Trace));
+    Trace = _mm_add_ps(Trace, SIMD_SWIZZLE(Trace, 1, 0, 0, 0));
+    Det   = _mm_sub_ps(Det, SIMD_SWIZZLE(Trace, 0, 0, 0, 0));
+
+    __m128 InvDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), Det);
+    X = _mm_mul_ps(X, InvDet);
+    Y = _mm_mul_ps(Y, InvDet);
+    Z = _mm_mul_ps(Z, InvDet);
+    W = _mm_mul_ps(W, InvDet);
+
+    mat4 Result;
+    _mm_store_ps(&Result.E[0],  SIMD_SHUFFLE(X, Y, 3, 1, 3, 1));
+    _mm_store_ps(&Result.E[4],  SIMD_SHUFFLE(X, Y, 2, 0, 2, 0));
+    _mm_store_ps(&Result.E[8],  SIMD_SHUFFLE(Z, W, 3, 1, 3, 1));
+    _mm_store_ps(&Result.E[12], SIMD_SHUFFLE(Z, W, 2, 0, 2, 0));
+    return Result;
+#else
     const r32* m = A.E;
 
     r32 t0  = m[10] * m[15];
@@ -659,7 +1001,7 @@ Inverse(mat4 A)
     o[0] = (t0 * m[5] + t3 * m[9] + t4  * m[13]) - (t1 * m[5] + t2 * m[9] + t5  * m[13]);
     o[1] = (t1 * m[1] + t6 * m[9] + t9  * m[13]) - (t0 * m[1] + t7 * m[9] + t8  * m[13]);
     o[2] = (t2 * m[1] + t7 * m[5] + t10 * m[13]) - (t3 * m[1] + t6 * m[5] + t11 * m[13]);
-    o[3] = (t5 * m[1] + t8 * m[5] + t11 * m[13]) - (t4 * m[1] + t9 * m[5] + t10 * m[9] );
+    o[3] = (t5 * m[1] + t8 * m[5] + t11 * m[9] ) - (t4 * m[1] + t9 * m[5] + t10 * m[9] );
 
     r32 d = 1.0f / (m[0] * o[0] + m[4] * o[1] + m[8] * o[2] + m[12] * o[3]);
 
@@ -681,6 +1023,137 @@ Inverse(mat4 A)
     o[15] = d * ((t22 * m[10] + t16 * m[2]  + t21 * m[6])  - (t20 * m[6]  + t23 * m[10] + t17 * m[2]));
 
     return Result;
+#endif
+}
+
+#if VENG_SIMD_SSE
+// NOTE: Inverts [R 0; T 1] given the rows of R^-1, the translation row becomes -T * R^-1.
+// Lane 3 of InvRow2 ends up in every row's w, it has to be zero.
+INLINE mat4
+InverseAffineRowsSSE(__m128 InvRow0, __m128 InvRow1, __m128 InvRow2, const r32* Offset)
+{
+    mat4 Result;
+    __m128 Sum = _mm_mul_ps(InvRow0, _mm_set1_ps(Offset[0]));
+    Sum = _mm_add_ps(Sum, _mm_mul_ps(InvRow1, _mm_set1_ps(Offset[1])));
+    Sum = _mm_add_ps(Sum, _mm_mul_ps(InvRow2, _mm_set1_ps(Offset[2])));
+
+    _mm_store_ps(&Result.E[0],  InvRow0);
+    _mm_store_ps(&Result.E[4],  InvRow1);
+    _mm_store_ps(&Result.E[8],  InvRow2);
+    _mm_store_ps(&Result.E[12], _mm_sub_ps(_mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f), Sum));
+    return Result;
+}
+
+// NOTE: Transposes the 3x3 held in the xyz lanes of A, B, C, w of the results comes from C.w
+#define SIMD_TRANSPOSE3(A, B, C, Out0, Out1, Out2)                  \
+    {                                                                \
+        __m128 Low  = _mm_movelh_ps(A, B);                           \
+        __m128 High = _mm_movehl_ps(B, A);                           \
+        Out0 = SIMD_SHUFFLE(Low,  C, 0, 2, 0, 3);                    \
+        Out1 = SIMD_SHUFFLE(Low,  C, 1, 3, 1, 3);                    \
+        Out2 = SIMD_SHUFFLE(High, C, 0, 2, 2, 3);                    \
+    }
+#endif
+
+// NOTE: Inverse of a rotation and translation only matrix: the rotation is transposed and the translation
+// rotated back and negated. Scale, shear or a projection give wrong results, use InverseAffine or Inverse.
+// E[3], E[7] and E[11] must be zero.
+INLINE mat4
+InverseRigid(mat4 A)
+{
+#if VENG_SIMD_SSE
+    __m128 Row0 = _mm_load_ps(&A.E[0]);
+    __m128 Row1 = _mm_load_ps(&A.E[4]);
+    __m128 Row2 = _mm_load_ps(&A.E[8]);
+
+    __m128 Inv0, Inv1, Inv2;
+    SIMD_TRANSPOSE3(Row0, Row1, Row2, Inv0, Inv1, Inv2);
+    return InverseAffineRowsSSE(Inv0, Inv1, Inv2, &A.E[12]);
+#else
+    const r32* m = A.E;
+
+    mat4 Result;
+    r32* o = Result.E;
+
+    o[0]  = m[0];
+    o[1]  = m[4];
+    o[2]  = m[8];
+    o[3]  = 0.0f;
+    o[4]  = m[1];
+    o[5]  = m[5];
+    o[6]  = m[9];
+    o[7]  = 0.0f;
+    o[8]  = m[2];
+    o[9]  = m[6];
+    o[10] = m[10];
+    o[11] = 0.0f;
+    o[12] = -(m[12] * o[0] + m[13] * o[4] + m[14] * o[8]);
+    o[13] = -(m[12] * o[1] + m[13] * o[5] + m[14] * o[9]);
+    o[14] = -(m[12] * o[2] + m[13] * o[6] + m[14] * o[10]);
+    o[15] = 1.0f;
+
+    return Result;
+#endif
+}
+
+// NOTE: Inverse of any matrix whose last column is (0, 0, 0, 1): rotation, scale, shear and translation.
+// The 3x3 part is inverted through the cross products of its rows, about a third of the work of Inverse.
+INLINE mat4
+InverseAffine(mat4 A)
+{
+#if VENG_SIMD_SSE
+    __m128 Row0 = _mm_load_ps(&A.E[0]);
+    __m128 Row1 = _mm_load_ps(&A.E[4]);
+    __m128 Row2 = _mm_load_ps(&A.E[8]);
+
+    // NOTE: w of every cross product is w * w - w * w = 0
+    __m128 Cross0 = _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(Row1, 1, 2, 0, 3), SIMD_SWIZZLE(Row2, 2, 0, 1, 3)),
+                               _mm_mul_ps(SIMD_SWIZZLE(Row1, 2, 0, 1, 3), SIMD_SWIZZLE(Row2, 1, 2, 0, 3)));
+    __m128 Cross1 = _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(Row2, 1, 2, 0, 3), SIMD_SWIZZLE(Row0, 2, 0, 1, 3)),
+                               _mm_mul_ps(SIMD_SWIZZLE(Row2, 2, 0, 1, 3), SIMD_SWIZZLE(Row0, 1, 2, 0, 3)));
+    __m128 Cross2 = _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(Row0, 1, 2, 0, 3), SIMD_SWIZZLE(Row1, 2, 0, 1, 3)),
+                               _mm_mul_ps(SIMD_SWIZZLE(Row0, 2, 0, 1, 3), SIMD_SWIZZLE(Row1, 1, 2, 0, 3)));
+
+    __m128 Det = _mm_mul_ps(_mm_and_ps(Row0, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1))), Cross0);
+    Det = _mm_add_ps(Det, SIMD_SWIZZLE(Det, 1, 0, 3, 2));
+    Det = _mm_add_ps(Det, SIMD_SWIZZLE(Det, 2, 3, 0, 1));
+    __m128 InvDet = _mm_div_ps(_mm_set1_ps(1.0f), Det);
+
+    __m128 Inv0, Inv1, Inv2;
+    SIMD_TRANSPOSE3(_mm_mul_ps(Cross0, InvDet), _mm_mul_ps(Cross1, InvDet), _mm_mul_ps(Cross2, InvDet), Inv0, Inv1, Inv2);
+    return InverseAffineRowsSSE(Inv0, Inv1, Inv2, &A.E[12]);
+#else
+    const r32* m = A.E;
+
+    mat4 Result;
+    r32* o = Result.E;
+
+    // NOTE: Column c of the 3x3 inverse is the cross product of the two other rows over the determinant
+    o[0]  = m[5] * m[10] - m[6] * m[9];
+    o[4]  = m[6] * m[8]  - m[4] * m[10];
+    o[8]  = m[4] * m[9]  - m[5] * m[8];
+    o[1]  = m[9] * m[2]  - m[10] * m[1];
+    o[5]  = m[10] * m[0] - m[8] * m[2];
+    o[9]  = m[8] * m[1]  - m[9] * m[0];
+    o[2]  = m[1] * m[6]  - m[2] * m[5];
+    o[6]  = m[2] * m[4]  - m[0] * m[6];
+    o[10] = m[0] * m[5]  - m[1] * m[4];
+
+    r32 d = 1.0f / (m[0] * o[0] + m[1] * o[4] + m[2] * o[8]);
+    o[0] *= d; o[1] *= d; o[2]  *= d;
+    o[4] *= d; o[5] *= d; o[6]  *= d;
+    o[8] *= d; o[9] *= d; o[10] *= d;
+
+    o[3]  = 0.0f;
+    o[7]  = 0.0f;
+    o[11] = 0.0f;
+    o[12] = -(m[12] * o[0] + m[13] * o[4] + m[14] * o[8]);
+    o[13] = -(m[12] * o[1] + m[13] * o[5] + m[14] * o[9]);
+    o[14] = -(m[12] * o[2] + m[13] * o[6] + m[14] * o[10]);
+    o[15] = 1.0f;
+
+    return Result;
+#endif
 }
 
 INLINE mat4
@@ -745,14 +1218,27 @@ EulerZ(r32 Angle)
     return Result;
 }
 
+// NOTE: Same matrix as MulMat4(MulMat4(EulerX, EulerY), EulerZ), written out to skip the two products
 INLINE mat4
 EulerXYZ(v3 Angle)
 {
-    mat4 rx = EulerX(Angle.x);
-    mat4 ry = EulerY(Angle.y);
-    mat4 rz = EulerZ(Angle.z);
-    mat4 Result = MulMat4(rx, ry);
-    Result = MulMat4(Result, rz);
+    r32 cx = Cos(Angle.x);
+    r32 sx = Sin(Angle.x);
+    r32 cy = Cos(Angle.y);
+    r32 sy = Sin(Angle.y);
+    r32 cz = Cos(Angle.z);
+    r32 sz = Sin(Angle.z);
+
+    mat4 Result = Identity();
+    Result.E[0]  = cx * cz - sx * sy * sz;
+    Result.E[1]  = cx * sz + sx * sy * cz;
+    Result.E[2]  = sx * cy;
+    Result.E[4]  = -cy * sz;
+    Result.E[5]  = cy * cz;
+    Result.E[6]  = -sy;
+    Result.E[8]  = -sx * cz - cx * sy * sz;
+    Result.E[9]  = -sx * sz + cx * sy * cz;
+    Result.E[10] = cx * cy;
     return Result;
 }
 
@@ -831,7 +1317,7 @@ IdentityQuat()
 INLINE r32
 NormalQuat(quat Q)
 {
-    r32 Result = Q.x * Q.x + Q.y * Q.y + Q.z * Q.z + Q.w * Q.w;
+    r32 Result = SquareRoot(Q.x * Q.x + Q.y * Q.y + Q.z * Q.z + Q.w * Q.w);
     return Result;
 }
 
@@ -892,6 +1378,34 @@ QuatToMat4(quat Q)
     return Result;
 }
 
+// NOTE: View matrix of a camera placed with position, rotation and scale, the inverse of its TRS world matrix
+// built directly: rotation transposed, columns divided by the scale, translation rotated back and negated.
+INLINE mat4
+ViewFromTRS(v3 Position, quat Rotation, v3 Scale)
+{
+    mat4 R = QuatToMat4(Rotation);
+    v3 InvScale = V3(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
+
+    mat4 Result;
+    r32* o = Result.E;
+    for(u32 Row = 0;
+        Row < 3;
+        ++Row)
+    {
+        o[Row * 4 + 0] = R.E[0 + Row] * InvScale.x;
+        o[Row * 4 + 1] = R.E[4 + Row] * InvScale.y;
+        o[Row * 4 + 2] = R.E[8 + Row] * InvScale.z;
+        o[Row * 4 + 3] = 0.0f;
+    }
+
+    o[12] = -(Position.x * o[0] + Position.y * o[4] + Position.z * o[8]);
+    o[13] = -(Position.x * o[1] + Position.y * o[5] + Position.z * o[9]);
+    o[14] = -(Position.x * o[2] + Position.y * o[6] + Position.z * o[10]);
+    o[15] = 1.0f;
+
+    return Result;
+}
+
 INLINE mat4
 QuatToRot(quat Q, v3 Center)
 {
@@ -993,3 +1507,184 @@ RadToDeg(r32 Rad)
 {
     return Rad * RAD_TO_DEG;
 }
+
+INLINE plane_3d
+NormalizePlane(r32 a, r32 b, r32 c, r32 d)
+{
+    r32 InvLength = 1.0f / SquareRoot(a * a + b * b + c * c);
+
+    plane_3d Result;
+    Result.Normal   = V3(a * InvLength, b * InvLength, c * InvLength);
+    Result.Distance = d * InvLength;
+    return Result;
+}
+
+// NOTE: Gribb-Hartmann extraction, the planes are sums and differences of the rows of the clip matrix.
+// Pass MulMat4(View, Projection) for world space planes or the projection alone for view space ones.
+// Depth is -w..w like Perspective and Orthographic produce.
+INLINE frustum
+FrustumFromMatrix(mat4 ViewProjection)
+{
+    const r32* m = ViewProjection.E;
+
+    frustum Result;
+    Result.Planes[0] = NormalizePlane(m[3] + m[0], m[7] + m[4], m[11] + m[8],  m[15] + m[12]);
+    Result.Planes[1] = NormalizePlane(m[3] - m[0], m[7] - m[4], m[11] - m[8],  m[15] - m[12]);
+    Result.Planes[2] = NormalizePlane(m[3] + m[1], m[7] + m[5], m[11] + m[9],  m[15] + m[13]);
+    Result.Planes[3] = NormalizePlane(m[3] - m[1], m[7] - m[5], m[11] - m[9],  m[15] - m[13]);
+    Result.Planes[4] = NormalizePlane(m[3] + m[2], m[7] + m[6], m[11] + m[10], m[15] + m[14]);
+    Result.Planes[5] = NormalizePlane(m[3] - m[2], m[7] - m[6], m[11] - m[10], m[15] - m[14]);
+    return Result;
+}
+
+// NOTE: Conservative, spheres near a frustum corner can pass while being outside
+INLINE b8
+FrustumIntersectsSphere(const frustum* Frustum, v3 Center, r32 Radius)
+{
+    for(u32 PlaneIndex = 0;
+        PlaneIndex < 6;
+        ++PlaneIndex)
+    {
+        const plane_3d* Plane = &Frustum->Planes[PlaneIndex];
+        if(InnerV3(Plane->Normal, Center) + Plane->Distance < -Radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Moves a local bounding sphere by Model, the radius grows by the largest axis scale
+INLINE void
+TransformBoundingSphere(mat4 Model, v3 Center, r32 Radius, v3* OutCenter, r32* OutRadius)
+{
+    const r32* m = Model.E;
+    *OutCenter = V3(m[0] * Center.x + m[4] * Center.y + m[8]  * Center.z + m[12],
+                    m[1] * Center.x + m[5] * Center.y + m[9]  * Center.z + m[13],
+                    m[2] * Center.x + m[6] * Center.y + m[10] * Center.z + m[14]);
+
+    r32 ScaleX = m[0] * m[0] + m[1] * m[1] + m[2]  * m[2];
+    r32 ScaleY = m[4] * m[4] + m[5] * m[5] + m[6]  * m[6];
+    r32 ScaleZ = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+    r32 MaxScale = ScaleX > ScaleY ? ScaleX : ScaleY;
+    MaxScale = MaxScale > ScaleZ ? MaxScale : ScaleZ;
+    *OutRadius = Radius * SquareRoot(MaxScale);
+}
+
+INLINE extents_3d
+ExtentsUnion(extents_3d A, extents_3d B)
+{
+    extents_3d Result;
+    Result.Min = V3(A.Min.x < B.Min.x ? A.Min.x : B.Min.x, A.Min.y < B.Min.y ? A.Min.y : B.Min.y, A.Min.z < B.Min.z ? A.Min.z : B.Min.z);
+    Result.Max = V3(A.Max.x > B.Max.x ? A.Max.x : B.Max.x, A.Max.y > B.Max.y ? A.Max.y : B.Max.y, A.Max.z > B.Max.z ? A.Max.z : B.Max.z);
+    return Result;
+}
+
+INLINE b8
+ExtentsContains(extents_3d Outer, extents_3d Inner)
+{
+    return Outer.Min.x <= Inner.Min.x && Outer.Min.y <= Inner.Min.y && Outer.Min.z <= Inner.Min.z &&
+           Outer.Max.x >= Inner.Max.x && Outer.Max.y >= Inner.Max.y && Outer.Max.z >= Inner.Max.z;
+}
+
+INLINE b8
+ExtentsOverlap(extents_3d A, extents_3d B)
+{
+    return A.Min.x <= B.Max.x && A.Max.x >= B.Min.x &&
+           A.Min.y <= B.Max.y && A.Max.y >= B.Min.y &&
+           A.Min.z <= B.Max.z && A.Max.z >= B.Min.z;
+}
+
+INLINE r32
+ExtentsSurfaceArea(extents_3d A)
+{
+    v3 d = SubV3(A.Max, A.Min);
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// NOTE: Model applied to the 8 corners, the result bounds them all
+INLINE extents_3d
+TransformExtents(mat4 Model, extents_3d Local)
+{
+    const r32* m = Model.E;
+    extents_3d Result;
+    Result.Min = V3(m[12], m[13], m[14]);
+    Result.Max = Result.Min;
+
+    // NOTE: Arvo's method, each matrix entry adds its smaller product to Min and its larger one to Max
+    for(u32 Axis = 0;
+        Axis < 3;
+        ++Axis)
+    {
+        for(u32 Row = 0;
+            Row < 3;
+            ++Row)
+        {
+            r32 a = m[Row * 4 + Axis] * Local.Min.E[Row];
+            r32 b = m[Row * 4 + Axis] * Local.Max.E[Row];
+            Result.Min.E[Axis] += a < b ? a : b;
+            Result.Max.E[Axis] += a < b ? b : a;
+        }
+    }
+
+    return Result;
+}
+
+typedef enum frustum_test_result
+{
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECTS,
+    FRUSTUM_INSIDE,
+} frustum_test_result;
+
+// NOTE: Checks the box corner farthest along each plane normal, then the nearest one to tell inside from intersecting
+INLINE frustum_test_result
+FrustumTestExtents(const frustum* Frustum, extents_3d Box)
+{
+    frustum_test_result Result = FRUSTUM_INSIDE;
+    for(u32 PlaneIndex = 0;
+        PlaneIndex < 6;
+        ++PlaneIndex)
+    {
+        const plane_3d* Plane = &Frustum->Planes[PlaneIndex];
+        v3 Far  = V3(Plane->Normal.x >= 0.0f ? Box.Max.x : Box.Min.x,
+                     Plane->Normal.y >= 0.0f ? Box.Max.y : Box.Min.y,
+                     Plane->Normal.z >= 0.0f ? Box.Max.z : Box.Min.z);
+        if(InnerV3(Plane->Normal, Far) + Plane->Distance < 0.0f)
+        {
+            return FRUSTUM_OUTSIDE;
+        }
+
+        v3 Near = V3(Plane->Normal.x >= 0.0f ? Box.Min.x : Box.Max.x,
+                     Plane->Normal.y >= 0.0f ? Box.Min.y : Box.Max.y,
+                     Plane->Normal.z >= 0.0f ? Box.Min.z : Box.Max.z);
+        if(InnerV3(Plane->Normal, Near) + Plane->Distance < 0.0f)
+        {
+            Result = FRUSTUM_INTERSECTS;
+        }
+    }
+
+    return Result;
+}
+
+// NOTE: Slab test, InvDirection is 1 / Direction per axis (infinity for 0 is fine). On a hit *OutDistance
+// is where the ray enters the box, 0 when it starts inside.
+INLINE b8
+RayIntersectsExtents(v3 Origin, v3 InvDirection, r32 MaxDistance, extents_3d Box, r32* OutDistance)
+{
+    r32 Enter = 0.0f;
+    r32 Exit  = MaxDistance;
+    for(u32 Axis = 0;
+        Axis < 3;
+        ++Axis)
+    {
+        r32 t0 = (Box.Min.E[Axis] - Origin.E[Axis]) * InvDirection.E[Axis];
+        r32 t1 = (Box.Max.E[Axis] - Origin.E[Axis]) * InvDirection.E[Axis];
+        Enter = (t0 < t1 ? t0 : t1) > Enter ? (t0 < t1 ? t0 : t1) : Enter;
+        Exit  = (t0 < t1 ? t1 : t0) < Exit  ? (t0 < t1 ? t1 : t0) : Exit;
+    }
+
+    *OutDistance = Enter;
+    return Enter <= Exit;
+}
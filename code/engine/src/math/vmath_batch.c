@@ -0,0 +1,516 @@
+#include "vmath_batch.h"
+#include "vmath.h"
+
+#if VENG_SIMD_AVX2 && defined(__AVX512F__)
+#define BATCH_AVX512 1
+#endif
+
+static void TransformPointsScalar(const r32* m, const r32* X, const r32* Y, const r32* Z, 
+                                  r32* OutX, r32* OutY, r32* OutZ, u64 Begin, u64 End)
+{
+    for(u64 Index = Begin;
+        Index < End;
+        ++Index)
+    {
+        r32 x = X[Index];
+        r32 y = Y[Index];
+        r32 z = Z[Index];
+        OutX[Index] = m[0] * x + m[4] * y + m[8]  * z + m[12];
+        OutY[Index] = m[1] * x + m[5] * y + m[9]  * z + m[13];
+        OutZ[Index] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    }
+}
+
+void BatchTransformPoints(mat4 M, const r32* X, const r32* Y, const r32* Z, 
+                          r32* OutX, r32* OutY, r32* OutZ, u64 Count)
+{
+    const r32* m = M.E;
+    u64 Index = 0;
+
+#if BATCH_AVX512
+    for(;
+        Index + 16 <= Count;
+        Index += 16)
+    {
+        __m512 x = _mm512_loadu_ps(X + Index);
+        __m512 y = _mm512_loadu_ps(Y + Index);
+        __m512 z = _mm512_loadu_ps(Z + Index);
+        for(u32 Row = 0; Row < 3; ++Row)
+        {
+            __m512 Sum = _mm512_fmadd_ps(_mm512_set1_ps(m[Row]), x, _mm512_set1_ps(m[12 + Row]));
+            Sum = _mm512_fmadd_ps(_mm512_set1_ps(m[4 + Row]), y, Sum);
+            Sum = _mm512_fmadd_ps(_mm512_set1_ps(m[8 + Row]), z, Sum);
+            _mm512_storeu_ps((Row == 0 ? OutX : Row == 1 ? OutY : OutZ) + Index, Sum);
+        }
+    }
+#endif
+
+#if VENG_SIMD_AVX2
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        __m256 x = _mm256_loadu_ps(X + Index);
+        __m256 y = _mm256_loadu_ps(Y + Index);
+        __m256 z = _mm256_loadu_ps(Z + Index);
+        for(u32 Row = 0; Row < 3; ++Row)
+        {
+            __m256 Sum = _mm256_fmadd_ps(_mm256_set1_ps(m[Row]), x, _mm256_set1_ps(m[12 + Row]));
+            Sum = _mm256_fmadd_ps(_mm256_set1_ps(m[4 + Row]), y, Sum);
+            Sum = _mm256_fmadd_ps(_mm256_set1_ps(m[8 + Row]), z, Sum);
+            _mm256_storeu_ps((Row == 0 ? OutX : Row == 1 ? OutY : OutZ) + Index, Sum);
+        }
+    }
+#elif VENG_SIMD_SSE
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        __m128 x = _mm_loadu_ps(X + Index);
+        __m128 y = _mm_loadu_ps(Y + Index);
+        __m128 z = _mm_loadu_ps(Z + Index);
+        for(u32 Row = 0; Row < 3; ++Row)
+        {
+            __m128 Sum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[Row]), x), _mm_set1_ps(m[12 + Row]));
+            Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_set1_ps(m[4 + Row]), y));
+            Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_set1_ps(m[8 + Row]), z));
+            _mm_storeu_ps((Row == 0 ? OutX : Row == 1 ? OutY : OutZ) + Index, Sum);
+        }
+    }
+#elif VENG_SIMD_NEON
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        float32x4_t x = vld1q_f32(X + Index);
+        float32x4_t y = vld1q_f32(Y + Index);
+        float32x4_t z = vld1q_f32(Z + Index);
+        for(u32 Row = 0; Row < 3; ++Row)
+        {
+            float32x4_t Sum = vmlaq_n_f32(vdupq_n_f32(m[12 + Row]), x, m[Row]);
+            Sum = vmlaq_n_f32(Sum, y, m[4 + Row]);
+            Sum = vmlaq_n_f32(Sum, z, m[8 + Row]);
+            vst1q_f32((Row == 0 ? OutX : Row == 1 ? OutY : OutZ) + Index, Sum);
+        }
+    }
+#endif
+
+    TransformPointsScalar(m, X, Y, Z, OutX, OutY, OutZ, Index, Count);
+}
+
+void BatchMulMat4(const mat4* Locals, mat4 Parent, mat4* Out, u64 Count)
+{
+    u64 Index = 0;
+
+#if BATCH_AVX512
+    // NOTE: One matrix per register, each 128 bit lane holds a row
+    __m512 P0 = _mm512_broadcast_f32x4(_mm_load_ps(&Parent.E[0]));
+    __m512 P1 = _mm512_broadcast_f32x4(_mm_load_ps(&Parent.E[4]));
+    __m512 P2 = _mm512_broadcast_f32x4(_mm_load_ps(&Parent.E[8]));
+    __m512 P3 = _mm512_broadcast_f32x4(_mm_load_ps(&Parent.E[12]));
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        __m512 Rows = _mm512_loadu_ps(Locals[Index].E);
+        __m512 Sum  = _mm512_mul_ps(_mm512_permute_ps(Rows, 0x00), P0);
+        Sum = _mm512_fmadd_ps(_mm512_permute_ps(Rows, 0x55), P1, Sum);
+        Sum = _mm512_fmadd_ps(_mm512_permute_ps(Rows, 0xAA), P2, Sum);
+        Sum = _mm512_fmadd_ps(_mm512_permute_ps(Rows, 0xFF), P3, Sum);
+        _mm512_storeu_ps(Out[Index].E, Sum);
+    }
+#endif
+
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        Out[Index] = MulMat4(Locals[Index], Parent);
+    }
+}
+
+static void ComposeTRSScalar(const trs_soa* In, mat4* Out, u64 Begin, u64 End)
+{
+    for(u64 Index = Begin;
+        Index < End;
+        ++Index)
+    {
+        r32 x = In->RotationX[Index];
+        r32 y = In->RotationY[Index];
+        r32 z = In->RotationZ[Index];
+        r32 w = In->RotationW[Index];
+        r32 InvLength = 1.0f / SquareRoot(x * x + y * y + z * z + w * w);
+        x *= InvLength;
+        y *= InvLength;
+        z *= InvLength;
+        w *= InvLength;
+
+        r32 sx = In->ScaleX[Index];
+        r32 sy = In->ScaleY[Index];
+        r32 sz = In->ScaleZ[Index];
+
+        r32* o = Out[Index].E;
+        o[0]  = sx * (1.0f - 2.0f * y * y - 2.0f * z * z);
+        o[1]  = sx * (2.0f * x * y - 2.0f * z * w);
+        o[2]  = sx * (2.0f * x * z + 2.0f * y * w);
+        o[3]  = 0.0f;
+        o[4]  = sy * (2.0f * x * y + 2.0f * z * w);
+        o[5]  = sy * (1.0f - 2.0f * x * x - 2.0f * z * z);
+        o[6]  = sy * (2.0f * y * z - 2.0f * x * w);
+        o[7]  = 0.0f;
+        o[8]  = sz * (2.0f * x * z - 2.0f * y * w);
+        o[9]  = sz * (2.0f * y * z + 2.0f * x * w);
+        o[10] = sz * (1.0f - 2.0f * x * x - 2.0f * y * y);
+        o[11] = 0.0f;
+        o[12] = In->PositionX[Index];
+        o[13] = In->PositionY[Index];
+        o[14] = In->PositionZ[Index];
+        o[15] = 1.0f;
+    }
+}
+
+#if VENG_SIMD_SSE
+// NOTE: Element Row * 4 + Column of 4 matrices in 4 lanes, transposed into one row store per matrix
+static void StoreRowsSSE(mat4* Out, u32 Row, __m128 C0, __m128 C1, __m128 C2, __m128 C3)
+{
+    _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+    _mm_storeu_ps(&Out[0].E[Row * 4], C0);
+    _mm_storeu_ps(&Out[1].E[Row * 4], C1);
+    _mm_storeu_ps(&Out[2].E[Row * 4], C2);
+    _mm_storeu_ps(&Out[3].E[Row * 4], C3);
+}
+
+static void ComposeTRSSSE(__m128 x, __m128 y, __m128 z, __m128 w, __m128 sx, __m128 sy, __m128 sz, 
+                          __m128 px, __m128 py, __m128 pz, mat4* Out)
+{
+    __m128 One  = _mm_set1_ps(1.0f);
+    __m128 Two  = _mm_set1_ps(2.0f);
+    __m128 Zero = _mm_setzero_ps();
+
+    __m128 InvLength = _mm_div_ps(One, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), 
+                                                             _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)))));
+    x = _mm_mul_ps(x, InvLength);
+    y = _mm_mul_ps(y, InvLength);
+    z = _mm_mul_ps(z, InvLength);
+    w = _mm_mul_ps(w, InvLength);
+
+    __m128 xx = _mm_mul_ps(Two, _mm_mul_ps(x, x));
+    __m128 yy = _mm_mul_ps(Two, _mm_mul_ps(y, y));
+    __m128 zz = _mm_mul_ps(Two, _mm_mul_ps(z, z));
+    __m128 xy = _mm_mul_ps(Two, _mm_mul_ps(x, y));
+    __m128 xz = _mm_mul_ps(Two, _mm_mul_ps(x, z));
+    __m128 yz = _mm_mul_ps(Two, _mm_mul_ps(y, z));
+    __m128 xw = _mm_mul_ps(Two, _mm_mul_ps(x, w));
+    __m128 yw = _mm_mul_ps(Two, _mm_mul_ps(y, w));
+    __m128 zw = _mm_mul_ps(Two, _mm_mul_ps(z, w));
+
+    StoreRowsSSE(Out, 0, 
+                 _mm_mul_ps(sx, _mm_sub_ps(_mm_sub_ps(One, yy), zz)),
+                 _mm_mul_ps(sx, _mm_sub_ps(xy, zw)),
+                 _mm_mul_ps(sx, _mm_add_ps(xz, yw)),
+                 Zero);
+    StoreRowsSSE(Out, 1, 
+                 _mm_mul_ps(sy, _mm_add_ps(xy, zw)),
+                 _mm_mul_ps(sy, _mm_sub_ps(_mm_sub_ps(One, xx), zz)),
+                 _mm_mul_ps(sy, _mm_sub_ps(yz, xw)),
+                 Zero);
+    StoreRowsSSE(Out, 2, 
+                 _mm_mul_ps(sz, _mm_sub_ps(xz, yw)),
+                 _mm_mul_ps(sz, _mm_add_ps(yz, xw)),
+                 _mm_mul_ps(sz, _mm_sub_ps(_mm_sub_ps(One, xx), yy)),
+                 Zero);
+    StoreRowsSSE(Out, 3, px, py, pz, One);
+}
+#endif
+
+void BatchComposeTRS(const trs_soa* In, mat4* Out, u64 Count)
+{
+    u64 Index = 0;
+
+#if VENG_SIMD_AVX2
+    // NOTE: The math runs 8 wide, the results are written out as two groups of 4 matrices
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        __m256 Values[10];
+        const r32* Sources[10] = {In->RotationX, In->RotationY, In->RotationZ, In->RotationW, 
+                                  In->ScaleX, In->ScaleY, In->ScaleZ, In->PositionX, In->PositionY, In->PositionZ};
+        for(u32 Source = 0; Source < 10; ++Source)
+        {
+            Values[Source] = _mm256_loadu_ps(Sources[Source] + Index);
+        }
+
+        for(u32 Half = 0; Half < 2; ++Half)
+        {
+            __m128 Lanes[10];
+            for(u32 Source = 0; Source < 10; ++Source)
+            {
+                Lanes[Source] = Half == 0 ? _mm256_castps256_ps128(Values[Source]) : _mm256_extractf128_ps(Values[Source], 1);
+            }
+
+            ComposeTRSSSE(Lanes[0], Lanes[1], Lanes[2], Lanes[3], Lanes[4], Lanes[5], Lanes[6], 
+                          Lanes[7], Lanes[8], Lanes[9], Out + Index + Half * 4);
+        }
+    }
+#endif
+
+#if VENG_SIMD_SSE
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        ComposeTRSSSE(_mm_loadu_ps(In->RotationX + Index), _mm_loadu_ps(In->RotationY + Index), 
+                      _mm_loadu_ps(In->RotationZ + Index), _mm_loadu_ps(In->RotationW + Index),
+                      _mm_loadu_ps(In->ScaleX + Index), _mm_loadu_ps(In->ScaleY + Index), _mm_loadu_ps(In->ScaleZ + Index),
+                      _mm_loadu_ps(In->PositionX + Index), _mm_loadu_ps(In->PositionY + Index), _mm_loadu_ps(In->PositionZ + Index),
+                      Out + Index);
+    }
+#endif
+
+    ComposeTRSScalar(In, Out, Index, Count);
+}
+
+#if VENG_SIMD_SSE
+INLINE __m128
+SelectSSE(__m128 Mask, __m128 IfTrue, __m128 IfFalse)
+{
+    return _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+}
+
+// NOTE: Lane for lane the same steps as FastSinCos, quadrant signs are flipped by xor-ing the sign bit
+static void SinCosSSE(__m128 x, __m128* OutSin, __m128* OutCos)
+{
+    __m128i Quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236758134308f)));
+    __m128 q = _mm_cvtepi32_ps(Quadrant);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(FAST_MATH_PIO2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(FAST_MATH_PIO2_MID)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(FAST_MATH_PIO2_LO)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(FAST_MATH_SIN_C3)), _mm_set1_ps(FAST_MATH_SIN_C2));
+    s = _mm_add_ps(_mm_mul_ps(z, s), _mm_set1_ps(FAST_MATH_SIN_C1));
+    s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), s));
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(FAST_MATH_COS_C3)), _mm_set1_ps(FAST_MATH_COS_C2));
+    c = _mm_add_ps(_mm_mul_ps(z, c), _mm_set1_ps(FAST_MATH_COS_C1));
+    c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), c));
+
+    __m128 Swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+    __m128 SinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(Quadrant, _mm_set1_epi32(2)), 30));
+    __m128 CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(Quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+    *OutSin = _mm_xor_ps(SelectSSE(Swap, c, s), SinSign);
+    *OutCos = _mm_xor_ps(SelectSSE(Swap, s, c), CosSign);
+}
+
+static __m128 AtanSSE(__m128 x)
+{
+    __m128 SignMask = _mm_set1_ps(-0.0f);
+    __m128 One = _mm_set1_ps(1.0f);
+    __m128 a = _mm_andnot_ps(SignMask, x);
+
+    __m128 Large  = _mm_cmpgt_ps(a, _mm_set1_ps(2.414213562373095f));
+    __m128 Medium = _mm_cmpgt_ps(a, _mm_set1_ps(0.4142135623730950f));
+
+    __m128 Offset = SelectSSE(Large, _mm_set1_ps(0.5f * PI32), _mm_and_ps(Medium, _mm_set1_ps(0.25f * PI32)));
+    __m128 Reduced = SelectSSE(Large, _mm_div_ps(_mm_set1_ps(-1.0f), a), 
+                               SelectSSE(Medium, _mm_div_ps(_mm_sub_ps(a, One), _mm_add_ps(a, One)), a));
+    __m128 z = _mm_mul_ps(Reduced, Reduced);
+
+    __m128 p = _mm_sub_ps(_mm_mul_ps(z, _mm_set1_ps(8.05374449538e-2f)), _mm_set1_ps(1.38776856032e-1f));
+    p = _mm_add_ps(_mm_mul_ps(z, p), _mm_set1_ps(1.99777106478e-1f));
+    p = _mm_sub_ps(_mm_mul_ps(z, p), _mm_set1_ps(3.33329491539e-1f));
+    p = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(z, p), Reduced), Reduced);
+
+    return _mm_xor_ps(_mm_add_ps(Offset, p), _mm_and_ps(x, SignMask));
+}
+#endif
+
+#if VENG_SIMD_AVX2
+static void SinCosAVX2(__m256 x, __m256* OutSin, __m256* OutCos)
+{
+    __m256i Quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(0.63661977236758134308f)));
+    __m256 q = _mm256_cvtepi32_ps(Quadrant);
+
+    __m256 r = _mm256_fnmadd_ps(q, _mm256_set1_ps(FAST_MATH_PIO2_HI), x);
+    r = _mm256_fnmadd_ps(q, _mm256_set1_ps(FAST_MATH_PIO2_MID), r);
+    r = _mm256_fnmadd_ps(q, _mm256_set1_ps(FAST_MATH_PIO2_LO), r);
+    __m256 z = _mm256_mul_ps(r, r);
+
+    __m256 s = _mm256_fmadd_ps(z, _mm256_set1_ps(FAST_MATH_SIN_C3), _mm256_set1_ps(FAST_MATH_SIN_C2));
+    s = _mm256_fmadd_ps(z, s, _mm256_set1_ps(FAST_MATH_SIN_C1));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(r, z), s, r);
+
+    __m256 c = _mm256_fmadd_ps(z, _mm256_set1_ps(FAST_MATH_COS_C3), _mm256_set1_ps(FAST_MATH_COS_C2));
+    c = _mm256_fmadd_ps(z, c, _mm256_set1_ps(FAST_MATH_COS_C1));
+    c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), c, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+    __m256 Swap = _mm256_castsi256_ps(_mm256_slli_epi32(Quadrant, 31));
+    __m256 SinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(Quadrant, _mm256_set1_epi32(2)), 30));
+    __m256 CosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(Quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+    *OutSin = _mm256_xor_ps(_mm256_blendv_ps(s, c, Swap), SinSign);
+    *OutCos = _mm256_xor_ps(_mm256_blendv_ps(c, s, Swap), CosSign);
+}
+#endif
+
+void BatchSinCos(const r32* X, r32* OutSin, r32* OutCos, u64 Count)
+{
+    u64 Index = 0;
+
+#if VENG_SIMD_AVX2
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        __m256 s, c;
+        SinCosAVX2(_mm256_loadu_ps(X + Index), &s, &c);
+        if(OutSin)
+        {
+            _mm256_storeu_ps(OutSin + Index, s);
+        }
+        if(OutCos)
+        {
+            _mm256_storeu_ps(OutCos + Index, c);
+        }
+    }
+#endif
+
+#if VENG_SIMD_SSE
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        __m128 s, c;
+        SinCosSSE(_mm_loadu_ps(X + Index), &s, &c);
+        if(OutSin)
+        {
+            _mm_storeu_ps(OutSin + Index, s);
+        }
+        if(OutCos)
+        {
+            _mm_storeu_ps(OutCos + Index, c);
+        }
+    }
+#endif
+
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        r32 s, c;
+        FastSinCos(X[Index], &s, &c);
+        if(OutSin)
+        {
+            OutSin[Index] = s;
+        }
+        if(OutCos)
+        {
+            OutCos[Index] = c;
+        }
+    }
+}
+
+void BatchSin(const r32* X, r32* Out, u64 Count)
+{
+    BatchSinCos(X, Out, 0, Count);
+}
+
+void BatchCos(const r32* X, r32* Out, u64 Count)
+{
+    BatchSinCos(X, 0, Out, Count);
+}
+
+void BatchAtan(const r32* X, r32* Out, u64 Count)
+{
+    u64 Index = 0;
+
+#if VENG_SIMD_SSE
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        _mm_storeu_ps(Out + Index, AtanSSE(_mm_loadu_ps(X + Index)));
+    }
+#endif
+
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        Out[Index] = FastAtan(X[Index]);
+    }
+}
+
+void BatchCullSpheres(const frustum* Frustum, const r32* X, const r32* Y, const r32* Z, const r32* Radius, 
+                      u8* OutVisible, u64 Count)
+{
+    u64 Index = 0;
+
+#if VENG_SIMD_AVX2 || VENG_SIMD_SSE
+    const plane_3d* p = Frustum->Planes;
+#endif
+
+#if VENG_SIMD_AVX2
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        __m256 x = _mm256_loadu_ps(X + Index);
+        __m256 y = _mm256_loadu_ps(Y + Index);
+        __m256 z = _mm256_loadu_ps(Z + Index);
+        __m256 NegativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(Radius + Index));
+
+        __m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for(u32 Plane = 0; Plane < 6; ++Plane)
+        {
+            __m256 Distance = _mm256_fmadd_ps(_mm256_set1_ps(p[Plane].Normal.x), x, _mm256_set1_ps(p[Plane].Distance));
+            Distance = _mm256_fmadd_ps(_mm256_set1_ps(p[Plane].Normal.y), y, Distance);
+            Distance = _mm256_fmadd_ps(_mm256_set1_ps(p[Plane].Normal.z), z, Distance);
+            Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(Distance, NegativeRadius, _CMP_GE_OQ));
+        }
+
+        u32 Mask = (u32)_mm256_movemask_ps(Inside);
+        for(u32 Lane = 0; Lane < 8; ++Lane)
+        {
+            OutVisible[Index + Lane] = (u8)((Mask >> Lane) & 1);
+        }
+    }
+#endif
+
+#if VENG_SIMD_SSE
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        __m128 x = _mm_loadu_ps(X + Index);
+        __m128 y = _mm_loadu_ps(Y + Index);
+        __m128 z = _mm_loadu_ps(Z + Index);
+        __m128 NegativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(Radius + Index));
+
+        __m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for(u32 Plane = 0; Plane < 6; ++Plane)
+        {
+            __m128 Distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[Plane].Normal.x), x), _mm_set1_ps(p[Plane].Distance));
+            Distance = _mm_add_ps(Distance, _mm_mul_ps(_mm_set1_ps(p[Plane].Normal.y), y));
+            Distance = _mm_add_ps(Distance, _mm_mul_ps(_mm_set1_ps(p[Plane].Normal.z), z));
+            Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Distance, NegativeRadius));
+        }
+
+        u32 Mask = (u32)_mm_movemask_ps(Inside);
+        for(u32 Lane = 0; Lane < 4; ++Lane)
+        {
+            OutVisible[Index + Lane] = (u8)((Mask >> Lane) & 1);
+        }
+    }
+#endif
+
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        OutVisible[Index] = (u8)FrustumIntersectsSphere(Frustum, V3(X[Index], Y[Index], Z[Index]), Radius[Index]);
+    }
+}
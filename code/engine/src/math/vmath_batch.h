@@ -0,0 +1,47 @@
+#pragma once
+
+#include "defines.h"
+#include "math_types.h"
+
+// NOTE: Batch kernels over structure-of-arrays input. r32 arrays need no alignment, the widest SIMD path 
+// the engine was compiled for (see vmath.h) handles full groups and the remainder runs scalar. mat4 arrays are
+// read and written with unaligned loads and stores, wider than the type's 16 bytes is never assumed, but the
+// scalar remainder still needs that much (DArrayCreateAligned for darray storage).
+
+typedef struct trs_soa
+{
+    const r32* PositionX;
+    const r32* PositionY;
+    const r32* PositionZ;
+
+    const r32* RotationX;
+    const r32* RotationY;
+    const r32* RotationZ;
+    const r32* RotationW;
+
+    const r32* ScaleX;
+    const r32* ScaleY;
+    const r32* ScaleZ;
+} trs_soa;
+
+// NOTE: Out = M * (x, y, z, 1) for every point, Out arrays may alias the input
+VENG_API void BatchTransformPoints(mat4 M, const r32* X, const r32* Y, const r32* Z, 
+                                   r32* OutX, r32* OutY, r32* OutZ, u64 Count);
+
+// NOTE: Out[i] = MulMat4(Locals[i], Parent), the local transform applied first
+VENG_API void BatchMulMat4(const mat4* Locals, mat4 Parent, mat4* Out, u64 Count);
+
+// NOTE: Same matrices as MulMat4(MulMat4(Scale(S), QuatToMat4(R)), Translation(T)), rotations are normalized
+VENG_API void BatchComposeTRS(const trs_soa* Input, mat4* Out, u64 Count);
+
+// NOTE: Batch versions of the FastSin, FastCos and FastAtan approximations in vmath.h with the same max error.
+// BatchSinCos accepts 0 for either output. Outputs may alias the input.
+VENG_API void BatchSinCos(const r32* X, r32* OutSin, r32* OutCos, u64 Count);
+VENG_API void BatchSin(const r32* X, r32* Out, u64 Count);
+VENG_API void BatchCos(const r32* X, r32* Out, u64 Count);
+VENG_API void BatchAtan(const r32* X, r32* Out, u64 Count);
+
+// NOTE: OutVisible[i] = 1 when sphere i touches the frustum, 0 otherwise, the same test as FrustumIntersectsSphere.
+// Works on any sub-range, threads can cull disjoint ranges of the same arrays.
+VENG_API void BatchCullSpheres(const frustum* Frustum, const r32* X, const r32* Y, const r32* Z, const r32* Radius, 
+                               u8* OutVisible, u64 Count);
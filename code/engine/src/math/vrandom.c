@@ -0,0 +1,316 @@
+#include "vrandom.h"
+
+#include "core/atomic.h"
+#include "core/vmemory.h"
+#include "platform/platform.h"
+#include "vmath.h"
+
+#ifdef _MSC_VER
+#define RANDOM_THREAD_LOCAL __declspec(thread)
+#else
+#define RANDOM_THREAD_LOCAL __thread
+#endif
+
+// NOTE: Generation 0 means no seed yet, it goes up with every RandomSetGlobalSeed so threads know to reseed
+static volatile u64 GlobalSeed;
+static volatile u32 GlobalGeneration;
+static volatile u32 ThreadCount;
+
+static RANDOM_THREAD_LOCAL random_xoshiro ThreadState;
+static RANDOM_THREAD_LOCAL u32 ThreadGeneration;
+static RANDOM_THREAD_LOCAL u32 ThreadIndex;
+
+void RandomXoshiroSeed(random_xoshiro* Random, u64 Seed)
+{
+    for(u32 Word = 0;
+        Word < 4;
+        ++Word)
+    {
+        Random->State[Word] = RandomSplitMix64(&Seed);
+    }
+}
+
+void RandomXoshiroJump(random_xoshiro* Random)
+{
+    static const u64 Jump[4] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull};
+
+    u64 s[4] = {0};
+    for(u32 Word = 0;
+        Word < 4;
+        ++Word)
+    {
+        for(u32 Bit = 0;
+            Bit < 64;
+            ++Bit)
+        {
+            if(Jump[Word] & (1ull << Bit))
+            {
+                s[0] ^= Random->State[0];
+                s[1] ^= Random->State[1];
+                s[2] ^= Random->State[2];
+                s[3] ^= Random->State[3];
+            }
+            RandomXoshiroNext(Random);
+        }
+    }
+
+    CopyMemory(Random->State, s, sizeof(s));
+}
+
+void RandomPCGSeed(random_pcg* Random, u64 Seed, u64 Stream)
+{
+    Random->State = 0;
+    Random->Increment = (Stream << 1) | 1;
+    RandomPCGNext(Random);
+    Random->State += Seed;
+    RandomPCGNext(Random);
+}
+
+void RandomStream4Seed(random_stream4* Random, u64 Seed)
+{
+    random_xoshiro Lane;
+    RandomXoshiroSeed(&Lane, Seed);
+    for(u32 LaneIndex = 0;
+        LaneIndex < 4;
+        ++LaneIndex)
+    {
+        for(u32 Word = 0;
+            Word < 4;
+            ++Word)
+        {
+            Random->State[Word][LaneIndex] = Lane.State[Word];
+        }
+        RandomXoshiroJump(&Lane);
+    }
+}
+
+// NOTE: One step of all four lanes, lane n gives Out[2n] (low half) and Out[2n + 1] (high half). 
+// The SIMD paths below produce the same layout straight from their registers.
+static void Stream4Step(random_stream4* Random, u32* Out)
+{
+    for(u32 Lane = 0;
+        Lane < 4;
+        ++Lane)
+    {
+        random_xoshiro State = {{Random->State[0][Lane], Random->State[1][Lane], Random->State[2][Lane], Random->State[3][Lane]}};
+        u64 Value = RandomXoshiroNext(&State);
+        Out[Lane * 2 + 0] = (u32)Value;
+        Out[Lane * 2 + 1] = (u32)(Value >> 32);
+        for(u32 Word = 0;
+            Word < 4;
+            ++Word)
+        {
+            Random->State[Word][Lane] = State.State[Word];
+        }
+    }
+}
+
+#if VENG_SIMD_AVX2
+INLINE __m256i
+RotateLeftAVX2(__m256i Value, s32 Shift)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(Value, Shift), _mm256_srli_epi64(Value, 64 - Shift));
+}
+
+// NOTE: The multiplies by 5 and 9 of the ** scrambler are shifts and adds, there is no 64 bit multiply before AVX-512
+INLINE __m256i
+Stream4StepAVX2(__m256i* s)
+{
+    __m256i Times5 = _mm256_add_epi64(_mm256_slli_epi64(s[1], 2), s[1]);
+    __m256i Rotated = RotateLeftAVX2(Times5, 7);
+    __m256i Result = _mm256_add_epi64(_mm256_slli_epi64(Rotated, 3), Rotated);
+    __m256i t = _mm256_slli_epi64(s[1], 17);
+
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = RotateLeftAVX2(s[3], 45);
+
+    return Result;
+}
+#elif VENG_SIMD_SSE
+INLINE __m128i
+RotateLeftSSE(__m128i Value, s32 Shift)
+{
+    return _mm_or_si128(_mm_slli_epi64(Value, Shift), _mm_srli_epi64(Value, 64 - Shift));
+}
+
+// NOTE: Two lanes per register, s holds the four state words of one lane pair
+INLINE __m128i
+Stream2StepSSE(__m128i* s)
+{
+    __m128i Times5 = _mm_add_epi64(_mm_slli_epi64(s[1], 2), s[1]);
+    __m128i Rotated = RotateLeftSSE(Times5, 7);
+    __m128i Result = _mm_add_epi64(_mm_slli_epi64(Rotated, 3), Rotated);
+    __m128i t = _mm_slli_epi64(s[1], 17);
+
+    s[2] = _mm_xor_si128(s[2], s[0]);
+    s[3] = _mm_xor_si128(s[3], s[1]);
+    s[1] = _mm_xor_si128(s[1], s[2]);
+    s[0] = _mm_xor_si128(s[0], s[3]);
+    s[2] = _mm_xor_si128(s[2], t);
+    s[3] = RotateLeftSSE(s[3], 45);
+
+    return Result;
+}
+#endif
+
+void RandomFillU32(random_stream4* Random, u32* Out, u64 Count)
+{
+    u64 Index = 0;
+
+#if VENG_SIMD_AVX2
+    __m256i s[4];
+    for(u32 Word = 0; Word < 4; ++Word)
+    {
+        s[Word] = _mm256_load_si256((const __m256i*)Random->State[Word]);
+    }
+
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        _mm256_storeu_si256((__m256i*)(Out + Index), Stream4StepAVX2(s));
+    }
+
+    for(u32 Word = 0; Word < 4; ++Word)
+    {
+        _mm256_store_si256((__m256i*)Random->State[Word], s[Word]);
+    }
+#elif VENG_SIMD_SSE
+    __m128i Low[4];
+    __m128i High[4];
+    for(u32 Word = 0; Word < 4; ++Word)
+    {
+        Low[Word]  = _mm_load_si128((const __m128i*)&Random->State[Word][0]);
+        High[Word] = _mm_load_si128((const __m128i*)&Random->State[Word][2]);
+    }
+
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        _mm_storeu_si128((__m128i*)(Out + Index), Stream2StepSSE(Low));
+        _mm_storeu_si128((__m128i*)(Out + Index + 4), Stream2StepSSE(High));
+    }
+
+    for(u32 Word = 0; Word < 4; ++Word)
+    {
+        _mm_store_si128((__m128i*)&Random->State[Word][0], Low[Word]);
+        _mm_store_si128((__m128i*)&Random->State[Word][2], High[Word]);
+    }
+#endif
+
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        Stream4Step(Random, Out + Index);
+    }
+
+    if(Index < Count)
+    {
+        u32 Last[8];
+        Stream4Step(Random, Last);
+        CopyMemory(Out + Index, Last, (Count - Index) * sizeof(u32));
+    }
+}
+
+// NOTE: The top 24 bits of every 32 bit value, scaled with a separate multiply and add on every path. The
+// values only differ between paths in the last bit, where a compiler fuses the scalar multiply and add.
+void RandomFillR32(random_stream4* Random, r32* Out, u64 Count, r32 Min, r32 Max)
+{
+    // NOTE: The bits are generated in place, the float of each value only needs the value itself
+    u32* Bits = (u32*)Out;
+    RandomFillU32(Random, Bits, Count);
+
+    r32 Range = Max - Min;
+    u64 Index = 0;
+
+#if VENG_SIMD_AVX2
+    __m256 Scale256 = _mm256_set1_ps(1.0f / 16777216.0f);
+    __m256 Range256 = _mm256_set1_ps(Range);
+    __m256 Min256   = _mm256_set1_ps(Min);
+    for(;
+        Index + 8 <= Count;
+        Index += 8)
+    {
+        __m256i Value = _mm256_srli_epi32(_mm256_loadu_si256((const __m256i*)(Bits + Index)), 8);
+        __m256 Unit = _mm256_mul_ps(_mm256_cvtepi32_ps(Value), Scale256);
+        _mm256_storeu_ps(Out + Index, _mm256_add_ps(Min256, _mm256_mul_ps(Unit, Range256)));
+    }
+#endif
+
+#if VENG_SIMD_SSE
+    __m128 Scale128 = _mm_set1_ps(1.0f / 16777216.0f);
+    __m128 Range128 = _mm_set1_ps(Range);
+    __m128 Min128   = _mm_set1_ps(Min);
+    for(;
+        Index + 4 <= Count;
+        Index += 4)
+    {
+        __m128i Value = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(Bits + Index)), 8);
+        __m128 Unit = _mm_mul_ps(_mm_cvtepi32_ps(Value), Scale128);
+        _mm_storeu_ps(Out + Index, _mm_add_ps(Min128, _mm_mul_ps(Unit, Range128)));
+    }
+#endif
+
+    for(;
+        Index < Count;
+        ++Index)
+    {
+        r32 Unit = (r32)(Bits[Index] >> 8) * (1.0f / 16777216.0f);
+        Out[Index] = Min + Unit * Range;
+    }
+}
+
+static void EnsureGlobalSeed()
+{
+    if(AtomicLoadU32(&GlobalGeneration) == 0)
+    {
+        union { r64 Time; u64 Bits; } Clock;
+        Clock.Time = PlatformGetAbsoluteTime();
+        u64 Mix = Clock.Bits;
+        AtomicCompareExchangeU64(&GlobalSeed, 0, RandomSplitMix64(&Mix));
+        AtomicCompareExchangeU32(&GlobalGeneration, 0, 1);
+    }
+}
+
+random_xoshiro* RandomThreadState()
+{
+    EnsureGlobalSeed();
+
+    u32 Generation = AtomicLoadU32(&GlobalGeneration);
+    if(ThreadGeneration != Generation)
+    {
+        if(ThreadIndex == 0)
+        {
+            ThreadIndex = AtomicFetchAddU32(&ThreadCount, 1) + 1;
+        }
+
+        RandomXoshiroSeed(&ThreadState, AtomicLoadU64(&GlobalSeed));
+        for(u32 Jump = 1;
+            Jump < ThreadIndex;
+            ++Jump)
+        {
+            RandomXoshiroJump(&ThreadState);
+        }
+        ThreadGeneration = Generation;
+    }
+
+    return &ThreadState;
+}
+
+void RandomSetGlobalSeed(u64 Seed)
+{
+    AtomicStoreU64(&GlobalSeed, Seed);
+    AtomicFetchAddU32(&GlobalGeneration, 1);
+}
+
+u64 RandomGetGlobalSeed()
+{
+    EnsureGlobalSeed();
+    return AtomicLoadU64(&GlobalSeed);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: Generators with explicit state, the same seed always gives the same sequence on every platform and SIMD path.
+// random_xoshiro is xoshiro256** (period 2^256 - 1), the general purpose generator. random_pcg is PCG32 
+// (XSH-RR, period 2^64), smaller state for when many independent generators are stored.
+typedef struct random_xoshiro
+{
+    u64 State[4];
+} random_xoshiro;
+
+typedef struct random_pcg
+{
+    u64 State;
+    u64 Increment;
+} random_pcg;
+
+// NOTE: Four interleaved xoshiro256** streams, State[Word][Lane], advanced together by the batch fill functions.
+// Lane n starts n jumps of 2^128 after lane 0, so the lanes never overlap.
+typedef struct random_stream4
+{
+    alignas(32) u64 State[4][4];
+} random_stream4;
+
+INLINE u64
+RandomRotateLeft(u64 Value, u32 Shift)
+{
+    return (Value << Shift) | (Value >> (64 - Shift));
+}
+
+// NOTE: Expands a 64 bit seed into well mixed state words, also a decent hash for combining seeds
+INLINE u64
+RandomSplitMix64(u64* Seed)
+{
+    u64 z = (*Seed += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+INLINE u64
+RandomXoshiroNext(random_xoshiro* Random)
+{
+    u64* s = Random->State;
+    u64 Result = RandomRotateLeft(s[1] * 5, 7) * 9;
+    u64 t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RandomRotateLeft(s[3], 45);
+
+    return Result;
+}
+
+// NOTE: Uniform in [0, 1), 24 random bits
+INLINE r32
+RandomXoshiroR32(random_xoshiro* Random)
+{
+    return (r32)(RandomXoshiroNext(Random) >> 40) * (1.0f / 16777216.0f);
+}
+
+// NOTE: Uniform in [Min, Max)
+INLINE r32
+RandomXoshiroR32InRange(random_xoshiro* Random, r32 Min, r32 Max)
+{
+    return Min + RandomXoshiroR32(Random) * (Max - Min);
+}
+
+// NOTE: Uniform in [Min, Max] through a 32x32 bit multiply, the bias is below 2^-32 for any range
+INLINE s32
+RandomXoshiroS32InRange(random_xoshiro* Random, s32 Min, s32 Max)
+{
+    u64 Range = (u64)((s64)Max - (s64)Min) + 1;
+    return (s32)((s64)Min + (s64)(((RandomXoshiroNext(Random) >> 32) * Range) >> 32));
+}
+
+INLINE u32
+RandomPCGNext(random_pcg* Random)
+{
+    u64 Old = Random->State;
+    Random->State = Old * 6364136223846793005ull + Random->Increment;
+    u32 XorShifted = (u32)(((Old >> 18) ^ Old) >> 27);
+    u32 Rotation = (u32)(Old >> 59);
+    return (XorShifted >> Rotation) | (XorShifted << ((32 - Rotation) & 31));
+}
+
+INLINE r32
+RandomPCGR32(random_pcg* Random)
+{
+    return (r32)(RandomPCGNext(Random) >> 8) * (1.0f / 16777216.0f);
+}
+
+INLINE r32
+RandomPCGR32InRange(random_pcg* Random, r32 Min, r32 Max)
+{
+    return Min + RandomPCGR32(Random) * (Max - Min);
+}
+
+VENG_API void RandomXoshiroSeed(random_xoshiro* Random, u64 Seed);
+// NOTE: Advances by 2^128 steps, gives non overlapping sequences for parallel users of one seed
+VENG_API void RandomXoshiroJump(random_xoshiro* Random);
+// NOTE: Stream picks one of 2^63 distinct sequences for the same seed
+VENG_API void RandomPCGSeed(random_pcg* Random, u64 Seed, u64 Stream);
+
+VENG_API void RandomStream4Seed(random_stream4* Random, u64 Seed);
+// NOTE: Count uniform floats in [Min, Max). Numbers are made 8 at a time, a partial last group is discarded,
+// so the output depends only on the seed and the sequence of calls.
+VENG_API void RandomFillR32(random_stream4* Random, r32* Out, u64 Count, r32 Min, r32 Max);
+VENG_API void RandomFillU32(random_stream4* Random, u32* Out, u64 Count);
+
+// NOTE: Per thread generator. Every thread seeds its own instance from the global seed the first time it asks
+// and again after RandomSetGlobalSeed. Threads are numbered in order of their first call and thread n 
+// uses the global seed jumped n times, replays are reproducible when threads start in the same order.
+VENG_API random_xoshiro* RandomThreadState();
+// NOTE: Until this is called the global seed comes from the clock
+VENG_API void RandomSetGlobalSeed(u64 Seed);
+VENG_API u64 RandomGetGlobalSeed();
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: Lets containers live in caller-owned memory (frame arena, pool) instead of the tagged heap.
+// ResizeBlockInPlace is optional, it returns true if Block was extended to NewSize without moving.
+typedef struct allocator
+{
+    void* Instance;
+    void* (*AllocateBlock)(void* Instance, u64 Size);
+    void  (*FreeBlock)(void* Instance, void* Block, u64 Size);
+    b8    (*ResizeBlockInPlace)(void* Instance, void* Block, u64 OldSize, u64 NewSize);
+} allocator;
@@ -2,11 +2,19 @@
 
 #include "core/vmemory.h"
 #include "core/logger.h"
+#include "platform/platform.h"
+
+#define LINEAR_ALLOCATOR_COMMIT_PAGES 16
+#define LINEAR_ALLOCATOR_ALIGNMENT 16
 
 void LinearAllocatorCreate(u64 TotalSize, void* Memory, linear_allocator* OutAllocator)
 {
     if(OutAllocator)
     {
+        OutAllocator->IsVirtual = false;
+        OutAllocator->LargePages = false;
+        OutAllocator->CommitGranularity = 0;
+        OutAllocator->Committed = TotalSize;
         OutAllocator->TotalSize = TotalSize;
         OutAllocator->Allocated = 0;
         OutAllocator->OwnsMemory = Memory == 0;
@@ -21,6 +29,52 @@ void LinearAllocatorCreate(u64 TotalSize, void* Memory, linear_allocator* OutAll
     }
 }
 
+b8 LinearAllocatorCreateVirtual(u64 ReserveSize, b8 LargePages, linear_allocator* OutAllocator)
+{
+    if(!OutAllocator)
+    {
+        return false;
+    }
+
+    OutAllocator->Memory = 0;
+    if(LargePages && ReserveSize > LINEAR_ALLOCATOR_MAX_LARGE_PAGE_RESERVE)
+    {
+        VENG_WARN("Linear allocator - large pages would commit all %lluB up front, using regular pages for this reservation.", ReserveSize);
+        LargePages = false;
+    }
+
+    if(LargePages)
+    {
+        OutAllocator->Memory = PlatformReserveMemory(ReserveSize, true);
+        if(!OutAllocator->Memory)
+        {
+            VENG_WARN("Linear allocator - large pages are unavailable, falling back to regular pages.");
+            LargePages = false;
+        }
+    }
+
+    if(!OutAllocator->Memory)
+    {
+        OutAllocator->Memory = PlatformReserveMemory(ReserveSize, false);
+    }
+
+    if(!OutAllocator->Memory)
+    {
+        VENG_ERROR("Linear allocator - failed to reserve %lluB of address space.", ReserveSize);
+        return false;
+    }
+
+    OutAllocator->TotalSize = ReserveSize;
+    OutAllocator->Allocated = 0;
+    OutAllocator->OwnsMemory = true;
+    OutAllocator->IsVirtual = true;
+    OutAllocator->LargePages = LargePages;
+    OutAllocator->CommitGranularity = PlatformGetPageSize(LargePages) * (LargePages ? 1 : LINEAR_ALLOCATOR_COMMIT_PAGES);
+    OutAllocator->Committed = LargePages ? ReserveSize : 0;
+
+    return true;
+}
+
 void LinearAllocatorDestroy(linear_allocator* Allocator)
 {
     if(Allocator)
@@ -28,28 +82,69 @@ void LinearAllocatorDestroy(linear_allocator* Allocator)
         Allocator->Allocated = 0;
         if(Allocator->OwnsMemory && Allocator->Memory)
         {
-            Free(Allocator->Memory, Allocator->TotalSize, MEMORY_TAG_LINEAR_ALLOCATOR);
+            if(Allocator->IsVirtual)
+            {
+                PlatformReleaseMemory(Allocator->Memory, Allocator->TotalSize);
+            }
+            else
+            {
+                Free(Allocator->Memory, Allocator->TotalSize, MEMORY_TAG_LINEAR_ALLOCATOR);
+            }
         }
 
         Allocator->Memory = 0;
         Allocator->TotalSize = 0;
+        Allocator->Committed = 0;
         Allocator->OwnsMemory = false;
+        Allocator->IsVirtual = false;
+    }
+}
+
+static b8 EnsureCommitted(linear_allocator* Allocator, u64 Required)
+{
+    if(Required <= Allocator->Committed)
+    {
+        return true;
+    }
+
+    u64 Granularity = Allocator->CommitGranularity;
+    u64 NewCommitted = (Required + Granularity - 1) / Granularity * Granularity;
+    if(NewCommitted > Allocator->TotalSize)
+    {
+        NewCommitted = Allocator->TotalSize;
+    }
+
+    u8* CommitStart = (u8*)Allocator->Memory + Allocator->Committed;
+    if(!PlatformCommitMemory(CommitStart, NewCommitted - Allocator->Committed))
+    {
+        VENG_ERROR("Linear allocator - failed to commit %lluB.", NewCommitted - Allocator->Committed);
+        return false;
     }
+
+    Allocator->Committed = NewCommitted;
+    return true;
 }
 
 void* LinearAllocatorAllocate(linear_allocator* Allocator, u64 Size)
 {
     if(Allocator && Allocator->Memory)
     {
-        if(Allocator->Allocated + Size > Allocator->TotalSize)
+        // NOTE: Blocks start 16 byte aligned, system states hold aligned math types
+        u64 Offset = (Allocator->Allocated + (LINEAR_ALLOCATOR_ALIGNMENT - 1)) & ~(u64)(LINEAR_ALLOCATOR_ALIGNMENT - 1);
+        if(Offset + Size > Allocator->TotalSize)
         {
             u64 Remaining = Allocator->TotalSize - Allocator->Allocated;
             VENG_ERROR("Linear allocator Allocate - tried to allocate %lluB with only %llu remaining.", Size, Remaining);
             return 0;
         }
 
-        void* Block = ((u8*)Allocator->Memory) + Allocator->Allocated;
-        Allocator->Allocated += Size;
+        if(!EnsureCommitted(Allocator, Offset + Size))
+        {
+            return 0;
+        }
+
+        void* Block = ((u8*)Allocator->Memory) + Offset;
+        Allocator->Allocated = Offset + Size;
         return Block;
     }
 
@@ -62,7 +157,58 @@ void  LinearAllocatorFreeAll(linear_allocator* Allocator)
     if(Allocator && Allocator->Memory)
     {
         Allocator->Allocated = 0;
-        ZeroMemory(Allocator->Memory, Allocator->TotalSize);
+        ZeroMemory(Allocator->Memory, Allocator->Committed);
+    }
+}
+
+// NOTE: Only the most recent allocation can be resized, anything else would overlap the next block.
+b8 LinearAllocatorResize(linear_allocator* Allocator, void* Block, u64 OldSize, u64 NewSize)
+{
+    if(!Allocator || !Allocator->Memory || !Block)
+    {
+        return false;
+    }
+
+    u8* Top = (u8*)Allocator->Memory + Allocator->Allocated;
+    if((u8*)Block + OldSize != Top)
+    {
+        return false;
+    }
+
+    u64 BlockOffset = (u8*)Block - (u8*)Allocator->Memory;
+    if(BlockOffset + NewSize > Allocator->TotalSize)
+    {
+        return false;
+    }
+
+    if(!EnsureCommitted(Allocator, BlockOffset + NewSize))
+    {
+        return false;
     }
+
+    Allocator->Allocated = BlockOffset + NewSize;
+    return true;
+}
+
+static void* LinearInterfaceAllocate(void* Instance, u64 Size)
+{
+    return LinearAllocatorAllocate((linear_allocator*)Instance, Size);
 }
 
+static void LinearInterfaceFree(void* Instance, void* Block, u64 Size)
+{
+    // NOTE: Linear allocations are only released all at once with LinearAllocatorFreeAll
+}
+
+static b8 LinearInterfaceResizeInPlace(void* Instance, void* Block, u64 OldSize, u64 NewSize)
+{
+    return LinearAllocatorResize((linear_allocator*)Instance, Block, OldSize, NewSize);
+}
+
+void LinearAllocatorGetInterface(linear_allocator* Allocator, allocator* OutInterface)
+{
+    OutInterface->Instance           = Allocator;
+    OutInterface->AllocateBlock      = LinearInterfaceAllocate;
+    OutInterface->FreeBlock          = LinearInterfaceFree;
+    OutInterface->ResizeBlockInPlace = LinearInterfaceResizeInPlace;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "defines.h"
+#include "memory/allocator.h"
+
+#define LINEAR_ALLOCATOR_MAX_LARGE_PAGE_RESERVE (64 * 1024 * 1024)
 
 typedef struct linear_allocator
 {
@@ -8,11 +11,23 @@ typedef struct linear_allocator
     u64 Allocated;
     void* Memory;
     b8 OwnsMemory;
+
+    // NOTE: Virtual allocators reserve TotalSize of address space and commit it in CommitGranularity steps. With
+    // large pages everything is committed at creation, so they are only taken for reservations of at most
+    // LINEAR_ALLOCATOR_MAX_LARGE_PAGE_RESERVE, bigger ones fall back to regular pages.
+    b8 IsVirtual;
+    b8 LargePages;
+    u64 Committed;
+    u64 CommitGranularity;
 } linear_allocator;
 
 
 VENG_API void LinearAllocatorCreate(u64 TotalSize, void* Memory, linear_allocator* OutAllocator);
+VENG_API b8   LinearAllocatorCreateVirtual(u64 ReserveSize, b8 LargePages, linear_allocator* OutAllocator);
 VENG_API void LinearAllocatorDestroy(linear_allocator* OutAllocator);
 
 VENG_API void* LinearAllocatorAllocate(linear_allocator* Allocator, u64 Size);
+VENG_API b8    LinearAllocatorResize(linear_allocator* Allocator, void* Block, u64 OldSize, u64 NewSize);
 VENG_API void  LinearAllocatorFreeAll(linear_allocator* Allocator);
+
+VENG_API void  LinearAllocatorGetInterface(linear_allocator* Allocator, allocator* OutInterface);
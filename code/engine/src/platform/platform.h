@@ -12,11 +12,22 @@ void PlatformShutdown(void* State);
 b8 PlatformPumpMessages();
 
 void* PlatformAllocate(u64 Size, b8 Aligned);
+void* PlatformReallocate(void* Block, u64 Size, b8 Aligned);
 void PlatformFree(void* Block, b8 Aligned);
 void* PlatformZeroMemory(void* Block, u64 Size);
 void* PlatformCopyMemory(void* Dest, const void* Source, u64 Size);
+void* PlatformMoveMemory(void* Dest, const void* Source, u64 Size);
 void* PlatformSetMemory(void* Dest, s32 Values, u32 Size);
 
+// NOTE: Virtual address space. Reserved ranges are inaccessible until committed. 
+// Large page ranges cannot be committed lazily, they come back already committed, so only ask for them with a
+// size that is meant to be used up front.
+void* PlatformReserveMemory(u64 Size, b8 LargePages);
+b8    PlatformCommitMemory(void* Block, u64 Size);
+void  PlatformDecommitMemory(void* Block, u64 Size);
+void  PlatformReleaseMemory(void* Block, u64 Size);
+u64   PlatformGetPageSize(b8 LargePages);
+
 void PlatformConsoleWrite(const char* Message, u8 Color);
 void PlatformConsoleWriteError(const char* Message, u8 Color);
 
@@ -24,3 +35,26 @@ r64 PlatformGetAbsoluteTime();
 
 void PlatformSleep(u64 Millis);
 
+typedef u32 (*PFN_ThreadStart)(void* Param);
+
+typedef struct platform_thread
+{
+    void* Handle;
+    u64 ID;
+} platform_thread;
+
+typedef struct platform_semaphore
+{
+    void* Handle;
+} platform_semaphore;
+
+b8   PlatformThreadCreate(PFN_ThreadStart Start, void* Param, platform_thread* OutThread);
+void PlatformThreadJoin(platform_thread* Thread);
+void PlatformThreadYield();
+
+b8   PlatformSemaphoreCreate(u32 InitialCount, u32 MaxCount, platform_semaphore* OutSemaphore);
+void PlatformSemaphoreDestroy(platform_semaphore* Semaphore);
+void PlatformSemaphoreSignal(platform_semaphore* Semaphore);
+// NOTE: Returns false when the timeout expired before the semaphore was signaled
+b8   PlatformSemaphoreWait(platform_semaphore* Semaphore, u64 TimeoutMillis);
+
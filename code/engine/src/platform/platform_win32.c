@@ -136,6 +136,10 @@ void* PlatformAllocate(u64 Size, b8 Aligned)
 {
     return malloc(Size);
 }
+void* PlatformReallocate(void* Block, u64 Size, b8 Aligned)
+{
+    return realloc(Block, Size);
+}
 void PlatformFree(void* Block, b8 Aligned)
 {
     free(Block);
@@ -148,11 +152,57 @@ void* PlatformCopyMemory(void* Dest, const void* Source, u64 Size)
 {
     return memcpy(Dest, Source, Size);
 }
+void* PlatformMoveMemory(void* Dest, const void* Source, u64 Size)
+{
+    return memmove(Dest, Source, Size);
+}
 void* PlatformSetMemory(void* Dest, s32 Values, u32 Size)
 {
     return memset(Dest, Values, Size);
 }
 
+void* PlatformReserveMemory(u64 Size, b8 LargePages)
+{
+    // NOTE: Large pages are locked in memory and cannot be reserved without committing, the whole rounded range
+    // is physical memory from here on
+    if(LargePages)
+    {
+        u64 LargePageSize = GetLargePageMinimum();
+        if(LargePageSize == 0)
+        {
+            return 0;
+        }
+
+        Size = (Size + LargePageSize - 1) & ~(LargePageSize - 1);
+        return VirtualAlloc(0, Size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+
+    return VirtualAlloc(0, Size, MEM_RESERVE, PAGE_NOACCESS);
+}
+b8 PlatformCommitMemory(void* Block, u64 Size)
+{
+    return VirtualAlloc(Block, Size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+void PlatformDecommitMemory(void* Block, u64 Size)
+{
+    VirtualFree(Block, Size, MEM_DECOMMIT);
+}
+void PlatformReleaseMemory(void* Block, u64 Size)
+{
+    VirtualFree(Block, 0, MEM_RELEASE);
+}
+u64 PlatformGetPageSize(b8 LargePages)
+{
+    if(LargePages)
+    {
+        return GetLargePageMinimum();
+    }
+
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return Info.dwPageSize;
+}
+
 void PlatformConsoleWrite(const char* Message, u8 Color)
 {
     static u8 Levels[6] = {64, 4, 6, 2, 1, 8};
@@ -188,6 +238,60 @@ void PlatformSleep(u64 Millis)
     Sleep(Millis);
 }
 
+b8 PlatformThreadCreate(PFN_ThreadStart Start, void* Param, platform_thread* OutThread)
+{
+    DWORD ThreadID = 0;
+    HANDLE Handle = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)Start, Param, 0, &ThreadID);
+    if(!Handle)
+    {
+        return false;
+    }
+
+    OutThread->Handle = Handle;
+    OutThread->ID     = ThreadID;
+    return true;
+}
+
+void PlatformThreadJoin(platform_thread* Thread)
+{
+    if(Thread->Handle)
+    {
+        WaitForSingleObject(Thread->Handle, INFINITE);
+        CloseHandle(Thread->Handle);
+        Thread->Handle = 0;
+    }
+}
+
+void PlatformThreadYield()
+{
+    SwitchToThread();
+}
+
+b8 PlatformSemaphoreCreate(u32 InitialCount, u32 MaxCount, platform_semaphore* OutSemaphore)
+{
+    OutSemaphore->Handle = CreateSemaphoreA(0, InitialCount, MaxCount, 0);
+    return OutSemaphore->Handle != 0;
+}
+
+void PlatformSemaphoreDestroy(platform_semaphore* Semaphore)
+{
+    if(Semaphore->Handle)
+    {
+        CloseHandle(Semaphore->Handle);
+        Semaphore->Handle = 0;
+    }
+}
+
+void PlatformSemaphoreSignal(platform_semaphore* Semaphore)
+{
+    ReleaseSemaphore(Semaphore->Handle, 1, 0);
+}
+
+b8 PlatformSemaphoreWait(platform_semaphore* Semaphore, u64 TimeoutMillis)
+{
+    return WaitForSingleObject(Semaphore->Handle, (DWORD)TimeoutMillis) == WAIT_OBJECT_0;
+}
+
 void PlatformGetRequiredExtensionNames(const char*** ExtensionNames)
 {
     DArrayPush(*ExtensionNames, &"VK_KHR_win32_surface");
@@ -228,7 +332,7 @@ Win32ProcessMessage(HWND Window, UINT Message, WPARAM wParam, LPARAM lParam)
         case WM_CLOSE:
         {
             event_context Data = {};
-            EventFire(EVENT_CODE_APPLICATION_QUIT, 0, Data);
+            EventPost(EVENT_CODE_APPLICATION_QUIT, 0, Data);
             return true;
         } break;
 
@@ -249,7 +353,7 @@ Win32ProcessMessage(HWND Window, UINT Message, WPARAM wParam, LPARAM lParam)
             event_context Context;
             Context.data.Unsigned16[0] = (u16)Width;
             Context.data.Unsigned16[1] = (u16)Height;
-            EventFire(EVENT_CODE_RESIZED, 0, Context);
+            EventPost(EVENT_CODE_RESIZED, 0, Context);
         } break;
         
         case WM_KEYDOWN:
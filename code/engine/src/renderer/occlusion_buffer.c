@@ -0,0 +1,300 @@
+#include "occlusion_buffer.h"
+
+#include "core/vmemory.h"
+#include "core/logger.h"
+#include "math/vmath.h"
+
+void OcclusionBufferCreate(u32 Width, u32 Height, occlusion_buffer* OutBuffer)
+{
+    ZeroMemory(OutBuffer, sizeof(occlusion_buffer));
+    OutBuffer->Width  = Width ? Width : 1;
+    OutBuffer->Height = Height ? Height : 1;
+
+    // NOTE: Each level halves rounding up, so a texel of level L covers 2^L x 2^L pixels of level 0
+    u32 LevelWidth  = OutBuffer->Width;
+    u32 LevelHeight = OutBuffer->Height;
+    u32 Offset = 0;
+    for(;;)
+    {
+        u32 Level = OutBuffer->LevelCount++;
+        OutBuffer->LevelWidth[Level]  = LevelWidth;
+        OutBuffer->LevelHeight[Level] = LevelHeight;
+        OutBuffer->LevelOffset[Level] = Offset;
+        Offset += LevelWidth * LevelHeight;
+
+        if((LevelWidth == 1 && LevelHeight == 1) || OutBuffer->LevelCount == OCCLUSION_BUFFER_MAX_LEVELS)
+        {
+            break;
+        }
+        LevelWidth  = (LevelWidth + 1) / 2;
+        LevelHeight = (LevelHeight + 1) / 2;
+    }
+
+    OutBuffer->DepthCount = Offset;
+    OutBuffer->Depth = Allocate(sizeof(r32) * Offset, MEMORY_TAG_RENDERER);
+    OutBuffer->ViewProjection = Identity();
+}
+
+void OcclusionBufferDestroy(occlusion_buffer* Buffer)
+{
+    if(Buffer->Depth)
+    {
+        Free(Buffer->Depth, sizeof(r32) * Buffer->DepthCount, MEMORY_TAG_RENDERER);
+    }
+    ZeroMemory(Buffer, sizeof(occlusion_buffer));
+}
+
+void OcclusionBufferBegin(occlusion_buffer* Buffer, mat4 ViewProjection)
+{
+    Buffer->ViewProjection = ViewProjection;
+    Buffer->OccluderTriangleCount = 0;
+
+    u32 Count = Buffer->Width * Buffer->Height;
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        Buffer->Depth[Index] = 1.0f;
+    }
+}
+
+static void RasterizeTriangle(occlusion_buffer* Buffer, v3 A, v3 B, v3 C)
+{
+    r32 Area = (B.x - A.x) * (C.y - A.y) - (C.x - A.x) * (B.y - A.y);
+    if(Area > -1e-8f && Area < 1e-8f)
+    {
+        return;
+    }
+
+    // NOTE: Occluders are two sided, the winding is made counter clockwise in pixel space
+    if(Area < 0.0f)
+    {
+        v3 Temp = B;
+        B = C;
+        C = Temp;
+        Area = -Area;
+    }
+
+    r32 MinX = A.x < B.x ? (A.x < C.x ? A.x : C.x) : (B.x < C.x ? B.x : C.x);
+    r32 MaxX = A.x > B.x ? (A.x > C.x ? A.x : C.x) : (B.x > C.x ? B.x : C.x);
+    r32 MinY = A.y < B.y ? (A.y < C.y ? A.y : C.y) : (B.y < C.y ? B.y : C.y);
+    r32 MaxY = A.y > B.y ? (A.y > C.y ? A.y : C.y) : (B.y > C.y ? B.y : C.y);
+    if(MaxX < 0.0f || MaxY < 0.0f || MinX > (r32)Buffer->Width || MinY > (r32)Buffer->Height)
+    {
+        return;
+    }
+
+    // NOTE: Pixel centers sit at +0.5, a center at MinX belongs to the pixel floor(MinX - 0.5)
+    s32 X0 = MinX - 0.5f > 0.0f ? (s32)(MinX - 0.5f) : 0;
+    s32 Y0 = MinY - 0.5f > 0.0f ? (s32)(MinY - 0.5f) : 0;
+    s32 X1 = MaxX < (r32)Buffer->Width  ? (s32)MaxX : (s32)Buffer->Width - 1;
+    s32 Y1 = MaxY < (r32)Buffer->Height ? (s32)MaxY : (s32)Buffer->Height - 1;
+    if(X1 >= (s32)Buffer->Width)  X1 = Buffer->Width - 1;
+    if(Y1 >= (s32)Buffer->Height) Y1 = Buffer->Height - 1;
+
+    // NOTE: Depth is a plane in screen space. The bias moves each sample to the farthest point of its pixel
+    // and the result never passes the farthest vertex, so the stored depth never claims more than the triangle covers.
+    r32 InvArea = 1.0f / Area;
+    r32 DepthDX = ((B.z - A.z) * (C.y - A.y) - (C.z - A.z) * (B.y - A.y)) * InvArea;
+    r32 DepthDY = ((C.z - A.z) * (B.x - A.x) - (B.z - A.z) * (C.x - A.x)) * InvArea;
+    r32 Bias = 0.5f * ((DepthDX < 0.0f ? -DepthDX : DepthDX) + (DepthDY < 0.0f ? -DepthDY : DepthDY));
+    r32 MaxDepth = A.z > B.z ? (A.z > C.z ? A.z : C.z) : (B.z > C.z ? B.z : C.z);
+
+    // NOTE: Edge functions at the first pixel center, stepped incrementally along rows and columns
+    r32 StartX = (r32)X0 + 0.5f;
+    r32 StartY = (r32)Y0 + 0.5f;
+    r32 EdgeA = (C.x - B.x) * (StartY - B.y) - (C.y - B.y) * (StartX - B.x);
+    r32 EdgeB = (A.x - C.x) * (StartY - C.y) - (A.y - C.y) * (StartX - C.x);
+    r32 EdgeC = (B.x - A.x) * (StartY - A.y) - (B.y - A.y) * (StartX - A.x);
+    r32 Depth = A.z + DepthDX * (StartX - A.x) + DepthDY * (StartY - A.y) + Bias;
+
+    for(s32 y = Y0;
+        y <= Y1;
+        ++y)
+    {
+        r32 RowA = EdgeA;
+        r32 RowB = EdgeB;
+        r32 RowC = EdgeC;
+        r32 RowDepth = Depth;
+        r32* Row = Buffer->Depth + (u32)y * Buffer->Width;
+        for(s32 x = X0;
+            x <= X1;
+            ++x)
+        {
+            if(RowA >= 0.0f && RowB >= 0.0f && RowC >= 0.0f)
+            {
+                r32 Sample = RowDepth < MaxDepth ? RowDepth : MaxDepth;
+                if(Sample < Row[x])
+                {
+                    Row[x] = Sample;
+                }
+            }
+
+            RowA -= C.y - B.y;
+            RowB -= A.y - C.y;
+            RowC -= B.y - A.y;
+            RowDepth += DepthDX;
+        }
+
+        EdgeA += C.x - B.x;
+        EdgeB += A.x - C.x;
+        EdgeC += B.x - A.x;
+        Depth += DepthDY;
+    }
+}
+
+void OcclusionBufferRasterize(occlusion_buffer* Buffer, mat4 Model, const void* Positions, u32 PositionStride,
+                              u32 VertexCount, const u32* Indices, u32 IndexCount)
+{
+    mat4 ModelViewProjection = MulMat4(Model, Buffer->ViewProjection);
+    r32 HalfWidth  = 0.5f * (r32)Buffer->Width;
+    r32 HalfHeight = 0.5f * (r32)Buffer->Height;
+
+    for(u32 Index = 0;
+        Index + 2 < IndexCount;
+        Index += 3)
+    {
+        v3 Screen[3];
+        b8 Clipped = false;
+        for(u32 Corner = 0;
+            Corner < 3;
+            ++Corner)
+        {
+            u32 VertexIndex = Indices[Index + Corner];
+            if(VertexIndex >= VertexCount)
+            {
+                Clipped = true;
+                break;
+            }
+
+            const r32* Position = (const r32*)((const u8*)Positions + (u64)VertexIndex * PositionStride);
+            v4 Clip = MulMat4V4(ModelViewProjection, V4(Position[0], Position[1], Position[2], 1.0f));
+
+            // NOTE: Dropping a triangle only loses occlusion, so near plane clipping is not worth doing here
+            if(Clip.w <= 1e-6f || Clip.z < -Clip.w)
+            {
+                Clipped = true;
+                break;
+            }
+
+            r32 InvW = 1.0f / Clip.w;
+            Screen[Corner] = V3((Clip.x * InvW + 1.0f) * HalfWidth, (Clip.y * InvW + 1.0f) * HalfHeight, Clip.z * InvW);
+        }
+
+        if(!Clipped)
+        {
+            RasterizeTriangle(Buffer, Screen[0], Screen[1], Screen[2]);
+            Buffer->OccluderTriangleCount++;
+        }
+    }
+}
+
+void OcclusionBufferBuildPyramid(occlusion_buffer* Buffer)
+{
+    for(u32 Level = 1;
+        Level < Buffer->LevelCount;
+        ++Level)
+    {
+        const r32* Source = Buffer->Depth + Buffer->LevelOffset[Level - 1];
+        r32* Dest = Buffer->Depth + Buffer->LevelOffset[Level];
+        u32 SourceWidth  = Buffer->LevelWidth[Level - 1];
+        u32 SourceHeight = Buffer->LevelHeight[Level - 1];
+
+        for(u32 y = 0;
+            y < Buffer->LevelHeight[Level];
+            ++y)
+        {
+            const r32* Row0 = Source + (y * 2) * SourceWidth;
+            const r32* Row1 = y * 2 + 1 < SourceHeight ? Row0 + SourceWidth : Row0;
+            for(u32 x = 0;
+                x < Buffer->LevelWidth[Level];
+                ++x)
+            {
+                u32 x0 = x * 2;
+                u32 x1 = x0 + 1 < SourceWidth ? x0 + 1 : x0;
+                r32 a = Row0[x0] > Row0[x1] ? Row0[x0] : Row0[x1];
+                r32 b = Row1[x0] > Row1[x1] ? Row1[x0] : Row1[x1];
+                Dest[y * Buffer->LevelWidth[Level] + x] = a > b ? a : b;
+            }
+        }
+    }
+}
+
+b8 OcclusionBufferTestExtents(occlusion_buffer* Buffer, extents_3d Box)
+{
+    if(Buffer->OccluderTriangleCount == 0)
+    {
+        return true;
+    }
+
+    r32 MinX = 1.0f, MinY = 1.0f, MaxX = -1.0f, MaxY = -1.0f;
+    r32 MinDepth = 1.0f;
+    for(u32 Corner = 0;
+        Corner < 8;
+        ++Corner)
+    {
+        v4 Point = V4((Corner & 1) ? Box.Max.x : Box.Min.x,
+                      (Corner & 2) ? Box.Max.y : Box.Min.y,
+                      (Corner & 4) ? Box.Max.z : Box.Min.z, 1.0f);
+        v4 Clip = MulMat4V4(Buffer->ViewProjection, Point);
+
+        // NOTE: Boxes reaching the near plane cover the camera, they are never occluded
+        if(Clip.w <= 1e-6f || Clip.z < -Clip.w)
+        {
+            return true;
+        }
+
+        r32 InvW = 1.0f / Clip.w;
+        r32 x = Clip.x * InvW;
+        r32 y = Clip.y * InvW;
+        r32 z = Clip.z * InvW;
+        MinX = x < MinX ? x : MinX;
+        MaxX = x > MaxX ? x : MaxX;
+        MinY = y < MinY ? y : MinY;
+        MaxY = y > MaxY ? y : MaxY;
+        MinDepth = z < MinDepth ? z : MinDepth;
+    }
+
+    // NOTE: Off screen boxes are left to the frustum test
+    if(MaxX < -1.0f || MaxY < -1.0f || MinX > 1.0f || MinY > 1.0f)
+    {
+        return true;
+    }
+
+    r32 PixelMinX = (MinX + 1.0f) * 0.5f * (r32)Buffer->Width;
+    r32 PixelMaxX = (MaxX + 1.0f) * 0.5f * (r32)Buffer->Width;
+    r32 PixelMinY = (MinY + 1.0f) * 0.5f * (r32)Buffer->Height;
+    r32 PixelMaxY = (MaxY + 1.0f) * 0.5f * (r32)Buffer->Height;
+    u32 X0 = PixelMinX > 0.0f ? (u32)PixelMinX : 0;
+    u32 Y0 = PixelMinY > 0.0f ? (u32)PixelMinY : 0;
+    u32 X1 = PixelMaxX < (r32)Buffer->Width  ? (u32)PixelMaxX : Buffer->Width - 1;
+    u32 Y1 = PixelMaxY < (r32)Buffer->Height ? (u32)PixelMaxY : Buffer->Height - 1;
+    if(X0 >= Buffer->Width)  X0 = Buffer->Width - 1;
+    if(Y0 >= Buffer->Height) Y0 = Buffer->Height - 1;
+    if(X1 >= Buffer->Width)  X1 = Buffer->Width - 1;
+    if(Y1 >= Buffer->Height) Y1 = Buffer->Height - 1;
+
+    u32 Level = 0;
+    while(Level + 1 < Buffer->LevelCount && ((X1 >> Level) - (X0 >> Level) > 1 || (Y1 >> Level) - (Y0 >> Level) > 1))
+    {
+        Level++;
+    }
+
+    const r32* Depth = Buffer->Depth + Buffer->LevelOffset[Level];
+    u32 LevelWidth = Buffer->LevelWidth[Level];
+    r32 OccluderDepth = 0.0f;
+    for(u32 y = Y0 >> Level;
+        y <= Y1 >> Level;
+        ++y)
+    {
+        for(u32 x = X0 >> Level;
+            x <= X1 >> Level;
+            ++x)
+        {
+            r32 Sample = Depth[y * LevelWidth + x];
+            OccluderDepth = Sample > OccluderDepth ? Sample : OccluderDepth;
+        }
+    }
+
+    return MinDepth <= OccluderDepth;
+}
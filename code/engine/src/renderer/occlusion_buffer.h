@@ -0,0 +1,43 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+
+#define OCCLUSION_BUFFER_MAX_LEVELS 16
+
+// NOTE: Low resolution software depth buffer for occlusion culling. Occluder triangles are rasterized into
+// level 0, OcclusionBufferBuildPyramid reduces it into a max depth (farthest occluder) mip chain and boxes are
+// tested against the smallest level where their screen rect covers at most 2x2 texels.
+// Depth is NDC z / w of the GL style projection, 1 is the far plane.
+typedef struct occlusion_buffer
+{
+    u32 Width;
+    u32 Height;
+    u32 LevelCount;
+    u32 LevelWidth[OCCLUSION_BUFFER_MAX_LEVELS];
+    u32 LevelHeight[OCCLUSION_BUFFER_MAX_LEVELS];
+    u32 LevelOffset[OCCLUSION_BUFFER_MAX_LEVELS];
+    // NOTE: Every level, level 0 first
+    r32* Depth;
+    u32 DepthCount;
+
+    mat4 ViewProjection;
+    u32 OccluderTriangleCount;
+} occlusion_buffer;
+
+VENG_API void OcclusionBufferCreate(u32 Width, u32 Height, occlusion_buffer* OutBuffer);
+VENG_API void OcclusionBufferDestroy(occlusion_buffer* Buffer);
+
+// NOTE: Clears level 0 to the far plane and sets the matrix used by the next rasterize and test calls
+VENG_API void OcclusionBufferBegin(occlusion_buffer* Buffer, mat4 ViewProjection);
+
+// NOTE: Positions are read as 3 floats every PositionStride bytes, so vertex_3d arrays can be passed directly.
+// Triangles crossing the near plane are dropped. Coverage is sampled at pixel centers, so occluders should sit
+// slightly inside the meshes they stand for.
+VENG_API void OcclusionBufferRasterize(occlusion_buffer* Buffer, mat4 Model, const void* Positions, u32 PositionStride,
+                                       u32 VertexCount, const u32* Indices, u32 IndexCount);
+
+VENG_API void OcclusionBufferBuildPyramid(occlusion_buffer* Buffer);
+
+// NOTE: Returns false only when the world space box is certainly behind the occluders. Needs a built pyramid.
+VENG_API b8 OcclusionBufferTestExtents(occlusion_buffer* Buffer, extents_3d Box);
@@ -25,6 +25,7 @@ b8 RendererBackendCreate(renderer_backend_type Type, renderer_backend* OutRender
         OutRendererBackend->DestroyMaterial   = VulkanRendererDestroyMaterial;
 
         OutRendererBackend->CreateGeometry    = VulkanRendererCreateGeometry;
+        OutRendererBackend->UpdateGeometry    = VulkanRendererUpdateGeometry;
         OutRendererBackend->DestroyGeometry   = VulkanRendererDestroyGeometry;
 
         OutRendererBackend->UpdateGlobalWorldState = VulkanRendererUpdateGlobalWorldState;
@@ -56,6 +57,7 @@ void RendererBackendDestroy(renderer_backend* RendererBackend)
     RendererBackend->DestroyMaterial    = 0;
 
     RendererBackend->CreateGeometry     = 0;
+    RendererBackend->UpdateGeometry     = 0;
     RendererBackend->DestroyGeometry    = 0;
 
     RendererBackend->UpdateGlobalWorldState = 0;
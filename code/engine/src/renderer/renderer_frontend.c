@@ -1,9 +1,11 @@
 #include "renderer_frontend.h"
 #include "renderer_backend.h"
+#include "occlusion_buffer.h"
 
 #include "core/logger.h"
 #include "core/vmemory.h"
 #include "math/vmath.h"
+#include "math/vmath_batch.h"
 
 #include "core/vstring.h"
 #include "core/event.h"
@@ -12,6 +14,12 @@
 #include "systems/texture_system.h"
 #include "systems/material_system.h"
 
+// NOTE: The occlusion buffer only has to resolve large occluders, its aspect does not need to match the window
+#define RENDERER_OCCLUSION_WIDTH 256
+#define RENDERER_OCCLUSION_HEIGHT 128
+// NOTE: Largest on screen error, in pixels, a coarser level of detail may cause
+#define RENDERER_LOD_PIXEL_ERROR 1.0f
+
 typedef struct renderer_state
 {
     renderer_backend Backend;
@@ -24,6 +32,16 @@ typedef struct renderer_state
 
     r32 NearClip;
     r32 FarClip;
+    r32 FramebufferHeight;
+
+    // NOTE: World space bounding spheres of the packet geometries as SoA for BatchCullSpheres, grown on demand
+    u32 CullCapacity;
+    r32* CullData;
+    u8* CullVisible;
+    // NOTE: Indices of the geometries that survived culling, in packet order
+    u32* CullDrawList;
+
+    occlusion_buffer Occlusion;
 } renderer_state;
 
 static renderer_state* RendererState;
@@ -49,12 +67,20 @@ b8 RendererInitialize(u64* MemoryRequirement, void* State, const char* Applicati
 
     RendererState->NearClip = 0.1f;
     RendererState->FarClip  = 1000.0f;
+    RendererState->FramebufferHeight = 720.0f;
     RendererState->Projection = Perspective(DegToRad(45.0f), 1280.0f/720.0f, RendererState->NearClip, RendererState->FarClip);
     RendererState->View = Translation(V3(0, 0, -30.0f));
-    RendererState->View = Inverse(RendererState->View);
+    RendererState->View = InverseRigid(RendererState->View);
 
     RendererState->UiProjection = Orthographic(0, 1280.0f, 720.0f, 0, -100.0f, 100.0f);
-    RendererState->UiView = Inverse(Identity());
+    RendererState->UiView = Identity();
+
+    RendererState->CullCapacity = 0;
+    RendererState->CullData     = 0;
+    RendererState->CullVisible  = 0;
+    RendererState->CullDrawList = 0;
+
+    OcclusionBufferCreate(RENDERER_OCCLUSION_WIDTH, RENDERER_OCCLUSION_HEIGHT, &RendererState->Occlusion);
 
     return true;
 }
@@ -63,6 +89,14 @@ void RendererShutdown(void* State)
 {
     if(RendererState)
     {
+        if(RendererState->CullCapacity)
+        {
+            Free(RendererState->CullData, sizeof(r32) * 4 * RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+            Free(RendererState->CullVisible, RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+            Free(RendererState->CullDrawList, sizeof(u32) * RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+        }
+        OcclusionBufferDestroy(&RendererState->Occlusion);
+
         RendererState->Backend.Shutdown(&RendererState->Backend);
     }
 
@@ -74,6 +108,7 @@ void RendererOnResize(u16 Width, u16 Height)
     if(RendererState)
     {
         RendererState->Projection = Perspective(DegToRad(45.0f), (r32)Width / (r32)Height, RendererState->NearClip, RendererState->FarClip);
+        RendererState->FramebufferHeight = (r32)Height;
         RendererState->UiProjection = Orthographic(0, (r32)Width, (r32)Height, 0, -100.0f, 100.0f);
         RendererState->Backend.Resized(&RendererState->Backend, Width, Height);
     }
@@ -83,6 +118,129 @@ void RendererOnResize(u16 Width, u16 Height)
     }
 }
 
+// NOTE: Coarsest level whose error, projected at the nearest point of the world space bounding sphere,
+// stays within RENDERER_LOD_PIXEL_ERROR
+static u32 SelectLod(geometry* Geometry, v3 Center, r32 Radius)
+{
+    if(Geometry->LodCount <= 1)
+    {
+        return 0;
+    }
+
+    v4 ViewCenter = MulMat4V4(RendererState->View, V4(Center.x, Center.y, Center.z, 1.0f));
+    r32 Distance = -ViewCenter.z - Radius;
+    if(Distance <= RendererState->NearClip)
+    {
+        return 0;
+    }
+
+    // NOTE: Level errors are in object space, the sphere radius tells how much the model matrix scales them
+    r32 Scale = Geometry->Radius > 0.0f ? Radius / Geometry->Radius : 1.0f;
+    r32 PixelsPerUnit = RendererState->Projection.E[5] * 0.5f * RendererState->FramebufferHeight / Distance;
+    for(u32 Lod = Geometry->LodCount - 1;
+        Lod > 0;
+        --Lod)
+    {
+        if(Geometry->Lods[Lod].Error * Scale * PixelsPerUnit <= RENDERER_LOD_PIXEL_ERROR)
+        {
+            return Lod;
+        }
+    }
+
+    return 0;
+}
+
+// NOTE: Fills CullDrawList with the world geometries of the packet that need drawing and returns their count.
+// Geometry bounds are in local space, the spheres are moved by each model matrix and tested against the planes
+// of View * Projection. When the packet has occluders, the survivors are also tested against the occlusion buffer.
+// The level of detail of every survivor is picked here too.
+static u32 CullGeometries(render_packet* Packet)
+{
+    u32 Count = Packet->GeometryCount;
+    if(Count > RendererState->CullCapacity)
+    {
+        u32 NewCapacity = RendererState->CullCapacity ? RendererState->CullCapacity : 256;
+        while(NewCapacity < Count)
+        {
+            NewCapacity *= 2;
+        }
+
+        if(RendererState->CullCapacity)
+        {
+            Free(RendererState->CullData, sizeof(r32) * 4 * RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+            Free(RendererState->CullVisible, RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+            Free(RendererState->CullDrawList, sizeof(u32) * RendererState->CullCapacity, MEMORY_TAG_RENDERER);
+        }
+
+        RendererState->CullData     = Allocate(sizeof(r32) * 4 * NewCapacity, MEMORY_TAG_RENDERER);
+        RendererState->CullVisible  = Allocate(NewCapacity, MEMORY_TAG_RENDERER);
+        RendererState->CullDrawList = Allocate(sizeof(u32) * NewCapacity, MEMORY_TAG_RENDERER);
+        RendererState->CullCapacity = NewCapacity;
+    }
+
+    r32* X      = RendererState->CullData;
+    r32* Y      = X + RendererState->CullCapacity;
+    r32* Z      = Y + RendererState->CullCapacity;
+    r32* Radius = Z + RendererState->CullCapacity;
+    for(u32 GeometryIndex = 0;
+        GeometryIndex < Count;
+        ++GeometryIndex)
+    {
+        geometry_render_data* Data = &Packet->Geometries[GeometryIndex];
+        v3 Center;
+        TransformBoundingSphere(Data->Model, Data->Geometry->Center, Data->Geometry->Radius, &Center, &Radius[GeometryIndex]);
+        X[GeometryIndex] = Center.x;
+        Y[GeometryIndex] = Center.y;
+        Z[GeometryIndex] = Center.z;
+    }
+
+    mat4 ViewProjection = MulMat4(RendererState->View, RendererState->Projection);
+    frustum Frustum = FrustumFromMatrix(ViewProjection);
+    BatchCullSpheres(&Frustum, X, Y, Z, Radius, RendererState->CullVisible, Count);
+
+    occlusion_buffer* Occlusion = &RendererState->Occlusion;
+    b8 TestOcclusion = Packet->OccluderCount > 0;
+    if(TestOcclusion)
+    {
+        OcclusionBufferBegin(Occlusion, ViewProjection);
+        for(u32 OccluderIndex = 0;
+            OccluderIndex < Packet->OccluderCount;
+            ++OccluderIndex)
+        {
+            occluder_render_data* Occluder = &Packet->Occluders[OccluderIndex];
+            OcclusionBufferRasterize(Occlusion, Occluder->Model, Occluder->Positions, Occluder->PositionStride,
+                                     Occluder->VertexCount, Occluder->Indices, Occluder->IndexCount);
+        }
+        OcclusionBufferBuildPyramid(Occlusion);
+    }
+
+    u32 DrawCount = 0;
+    for(u32 GeometryIndex = 0;
+        GeometryIndex < Count;
+        ++GeometryIndex)
+    {
+        if(!RendererState->CullVisible[GeometryIndex])
+        {
+            continue;
+        }
+
+        if(TestOcclusion)
+        {
+            geometry_render_data* Data = &Packet->Geometries[GeometryIndex];
+            if(!OcclusionBufferTestExtents(Occlusion, TransformExtents(Data->Model, Data->Geometry->Extents)))
+            {
+                continue;
+            }
+        }
+
+        geometry_render_data* Data = &Packet->Geometries[GeometryIndex];
+        Data->Lod = SelectLod(Data->Geometry, V3(X[GeometryIndex], Y[GeometryIndex], Z[GeometryIndex]), Radius[GeometryIndex]);
+        RendererState->CullDrawList[DrawCount++] = GeometryIndex;
+    }
+
+    return DrawCount;
+}
+
 b8 RendererDrawFrame(render_packet* Packet)
 {
     if(RendererState->Backend.BeginFrame(&RendererState->Backend, Packet->DeltaTime))
@@ -96,12 +254,12 @@ b8 RendererDrawFrame(render_packet* Packet)
 
         RendererState->Backend.UpdateGlobalWorldState(RendererState->Projection, RendererState->View, V3Zero(), V4One(), 0);
 
-        u32 Count = Packet->GeometryCount;
-        for(u32 GeometryIndex = 0;
-            GeometryIndex < Count;
-            ++GeometryIndex)
+        u32 DrawCount = CullGeometries(Packet);
+        for(u32 DrawIndex = 0;
+            DrawIndex < DrawCount;
+            ++DrawIndex)
         {
-            RendererState->Backend.DrawGeometry(Packet->Geometries[GeometryIndex]);
+            RendererState->Backend.DrawGeometry(Packet->Geometries[RendererState->CullDrawList[DrawIndex]]);
         }
 
         if(!RendererState->Backend.EndRenderpass(&RendererState->Backend, BUILTIN_RENDERPASS_WORLD))
@@ -125,7 +283,9 @@ b8 RendererDrawFrame(render_packet* Packet)
             GeometryIndex < UiCount;
             ++GeometryIndex)
         {
-            RendererState->Backend.DrawGeometry(Packet->UiGeometries[GeometryIndex]);
+            geometry_render_data Data = Packet->UiGeometries[GeometryIndex];
+            Data.Lod = 0;
+            RendererState->Backend.DrawGeometry(Data);
         }
 
         if(!RendererState->Backend.EndRenderpass(&RendererState->Backend, BUILTIN_RENDERPASS_UI))
@@ -173,9 +333,14 @@ void RendererDestroyMaterial(material* Material)
     RendererState->Backend.DestroyMaterial(Material);
 }
 
-b8 RendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
+b8 RendererCreateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
+{
+    return RendererState->Backend.CreateGeometry(Geometry, VertexFormat, VertexSize, VertexCount, Vertices, IndexSize, IndexCount, Indices);
+}
+
+b8 RendererUpdateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
 {
-    return RendererState->Backend.CreateGeometry(Geometry, VertexSize, VertexCount, Vertices, IndexSize, IndexCount, Indices);
+    return RendererState->Backend.UpdateGeometry(Geometry, VertexFormat, VertexSize, VertexCount, Vertices, IndexSize, IndexCount, Indices);
 }
 
 void RendererDestroyGeometry(geometry* Geometry)
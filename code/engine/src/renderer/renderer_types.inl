@@ -15,8 +15,22 @@ typedef struct geometry_render_data
 {
     mat4 Model;
     geometry* Geometry;
+    // NOTE: Level of detail to draw, picked by the frontend
+    u32 Lod;
 } geometry_render_data;
 
+// NOTE: Occluder triangles for the software occlusion buffer. Positions are read as 3 floats every
+// PositionStride bytes and are usually a simplified copy of the mesh kept on the CPU.
+typedef struct occluder_render_data
+{
+    mat4 Model;
+    const void* Positions;
+    u32 PositionStride;
+    u32 VertexCount;
+    const u32* Indices;
+    u32 IndexCount;
+} occluder_render_data;
+
 typedef enum builtin_renderpass
 {
     BUILTIN_RENDERPASS_WORLD = 0x01,
@@ -47,7 +61,9 @@ typedef struct renderer_backend
     b8 (*CreateMaterial)(material* Material);
     void (*DestroyMaterial)(material* Material);
 
-    b8 (*CreateGeometry)(geometry* Geometry, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
+    b8 (*CreateGeometry)(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
+    // NOTE: Same format, sizes and counts as the upload, Indices may be 0 to keep the current ones
+    b8 (*UpdateGeometry)(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
     void (*DestroyGeometry)(geometry* Geometry);
 } renderer_backend;
 
@@ -58,6 +74,10 @@ typedef struct render_packet
     u32 GeometryCount;
     geometry_render_data* Geometries;
 
+    // NOTE: Optional, world geometries hidden behind these are not drawn
+    u32 OccluderCount;
+    occluder_render_data* Occluders;
+
     u32 UiGeometryCount;
     geometry_render_data* UiGeometries;
 } render_packet;
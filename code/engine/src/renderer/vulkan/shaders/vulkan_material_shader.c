@@ -102,9 +102,9 @@ b8 VulkanMaterialShaderCreate(vulkan_context* Context, vulkan_material_shader* O
     Scissor.extent.width  = Context->FramebufferWidth;
     Scissor.extent.height = Context->FramebufferHeight;
 
-    u32 Offset = 0;
 #define AttributeCount 2
     VkVertexInputAttributeDescription AttributeDescriptions[AttributeCount];
+    VkVertexInputAttributeDescription PackedAttributeDescriptions[AttributeCount];
 
     VkFormat Formats[AttributeCount] = 
     {
@@ -118,6 +118,22 @@ b8 VulkanMaterialShaderCreate(vulkan_context* Context, vulkan_material_shader* O
         sizeof(v2),
     };
 
+    // NOTE: vertex_3d_packed feeds the same shader inputs, the position arrives in [0, 1] and the model matrix
+    // pushed for packed geometry scales it back out. The fourth position component is not read.
+    VkFormat PackedFormats[AttributeCount] = 
+    {
+        VK_FORMAT_R16G16B16A16_UNORM,
+        VK_FORMAT_R16G16_SFLOAT,
+    };
+
+    u64 PackedSizes[AttributeCount] = 
+    {
+        sizeof(u16) * 4,
+        sizeof(u16) * 2,
+    };
+
+    u32 Offset = 0;
+    u32 PackedOffset = 0;
     for(u32 AttributeIndex = 0;
         AttributeIndex < AttributeCount;
         ++AttributeIndex)
@@ -127,7 +143,13 @@ b8 VulkanMaterialShaderCreate(vulkan_context* Context, vulkan_material_shader* O
         AttributeDescriptions[AttributeIndex].format   = Formats[AttributeIndex];
         AttributeDescriptions[AttributeIndex].offset   = Offset;
 
+        PackedAttributeDescriptions[AttributeIndex].binding  = 0;
+        PackedAttributeDescriptions[AttributeIndex].location = AttributeIndex;
+        PackedAttributeDescriptions[AttributeIndex].format   = PackedFormats[AttributeIndex];
+        PackedAttributeDescriptions[AttributeIndex].offset   = PackedOffset;
+
         Offset += Sizes[AttributeIndex];
+        PackedOffset += PackedSizes[AttributeIndex];
     }
 
     const s32 DescriptorSetLayoutCount = 2;
@@ -158,6 +180,17 @@ b8 VulkanMaterialShaderCreate(vulkan_context* Context, vulkan_material_shader* O
         return false;
     }
 
+    if(!VulkanGraphicsPipelineCreate(Context, &Context->MainRenderpass, sizeof(vertex_3d_packed),
+                                     AttributeCount, PackedAttributeDescriptions, 
+                                     DescriptorSetLayoutCount, Layouts, 
+                                     MATERIAL_SHADER_STAGE_COUNT, StageCreateInfos, 
+                                     Viewport, Scissor, false, true,
+                                     &OutShader->PackedPipeline))
+    {
+        VENG_ERROR("Failed to load packed vertex graphics pipeline for object shader");
+        return false;
+    }
+
     u32 DeviceLocalBits = Context->Device.SupportsDeviceLocalHostVisible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : 0;
     if(!VulkanCreateBuffer(Context, sizeof(global_uniform_material_object), 
                            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
@@ -204,6 +237,7 @@ void VulkanMaterialShaderDestroy(vulkan_context* Context, vulkan_material_shader
     VulkanDestroyBuffer(Context, &Shader->GlobalUniformBuffer);
 
     VulkanGraphicsPipelineDestroy(Context, &Shader->Pipeline);
+    VulkanGraphicsPipelineDestroy(Context, &Shader->PackedPipeline);
 
     vkDestroyDescriptorPool(LogicalDevice, Shader->GlobalDescriptorPool, Context->Allocator);
     vkDestroyDescriptorSetLayout(LogicalDevice, Shader->GlobalDescriptorSetLayout, Context->Allocator);
@@ -223,6 +257,18 @@ void VulkanMaterialShaderUse(vulkan_context* Context, vulkan_material_shader* Sh
 {
     u32 ImageIndex = Context->ImageIndex;
     VulkanPipelineBind(&Context->GraphicsCommandBuffers[ImageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, &Shader->Pipeline);
+    Shader->PackedPipelineBound = false;
+}
+
+void VulkanMaterialShaderUseVertexFormat(vulkan_context* Context, vulkan_material_shader* Shader, b8 Packed)
+{
+    // NOTE: Both pipelines are made from the same layouts, so bound descriptor sets and push constants stay valid
+    if(Shader->PackedPipelineBound != Packed)
+    {
+        u32 ImageIndex = Context->ImageIndex;
+        VulkanPipelineBind(&Context->GraphicsCommandBuffers[ImageIndex], VK_PIPELINE_BIND_POINT_GRAPHICS, Packed ? &Shader->PackedPipeline : &Shader->Pipeline);
+        Shader->PackedPipelineBound = Packed;
+    }
 }
 
 void VulkanMaterialShaderUpdateGlobalState(vulkan_context* Context, vulkan_material_shader* Shader, r32 DeltaTime)
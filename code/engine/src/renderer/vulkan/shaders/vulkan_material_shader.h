@@ -6,6 +6,8 @@
 b8 VulkanMaterialShaderCreate(vulkan_context* Context, vulkan_material_shader* OutShader);
 void VulkanMaterialShaderDestroy(vulkan_context* Context, vulkan_material_shader* Shader);
 void VulkanMaterialShaderUse(vulkan_context* Context, vulkan_material_shader* Shader);
+// NOTE: Switches between the vertex_3d and vertex_3d_packed pipelines, Use binds the vertex_3d one
+void VulkanMaterialShaderUseVertexFormat(vulkan_context* Context, vulkan_material_shader* Shader, b8 Packed);
 
 void VulkanMaterialShaderUpdateGlobalState(vulkan_context* Context, vulkan_material_shader* Shader, r32 DeltaTime);
 
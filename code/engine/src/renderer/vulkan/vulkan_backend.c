@@ -53,8 +53,147 @@ void UploadDataRange(vulkan_context* Context, VkCommandPool Pool, VkFence Fence,
     VulkanDestroyBuffer(Context, &Staging);
 }
 
-void FreeDataRange(vulkan_buffer* Buffer, u64 Offset, u64 Size)
+static u64 AlignRangeSize(u64 Size)
 {
+    return (Size + (VULKAN_BUFFER_RANGE_ALIGNMENT - 1)) & ~(u64)(VULKAN_BUFFER_RANGE_ALIGNMENT - 1);
+}
+
+// NOTE: First fit over the free ranges, then the untouched tail of the buffer
+b8 AllocateDataRange(vulkan_range_list* List, vulkan_buffer* Buffer, u64 Size, u64* OutOffset)
+{
+    Size = AlignRangeSize(Size);
+
+    u64 FreeCount = DArrayLength(List->FreeRanges);
+    for(u64 RangeIndex = 0;
+        RangeIndex < FreeCount;
+        ++RangeIndex)
+    {
+        vulkan_buffer_range* Range = &List->FreeRanges[RangeIndex];
+        if(Range->Size >= Size)
+        {
+            *OutOffset = Range->Offset;
+            if(Range->Size == Size)
+            {
+                vulkan_buffer_range Removed;
+                DArrayPopAt(List->FreeRanges, RangeIndex, &Removed);
+            }
+            else
+            {
+                Range->Offset += Size;
+                Range->Size   -= Size;
+            }
+            return true;
+        }
+    }
+
+    if(List->Top + Size <= Buffer->TotalSize)
+    {
+        *OutOffset = List->Top;
+        List->Top += Size;
+        return true;
+    }
+
+    return false;
+}
+
+void FreeDataRange(vulkan_range_list* List, u64 Offset, u64 Size)
+{
+    Size = AlignRangeSize(Size);
+    if(!Size)
+    {
+        return;
+    }
+
+    u64 FreeCount = DArrayLength(List->FreeRanges);
+    u64 RangeIndex = 0;
+    while(RangeIndex < FreeCount && List->FreeRanges[RangeIndex].Offset < Offset)
+    {
+        ++RangeIndex;
+    }
+
+    vulkan_buffer_range* Previous = RangeIndex > 0 ? &List->FreeRanges[RangeIndex - 1] : 0;
+    vulkan_buffer_range* Next = RangeIndex < FreeCount ? &List->FreeRanges[RangeIndex] : 0;
+    b8 MergePrevious = Previous && Previous->Offset + Previous->Size == Offset;
+    b8 MergeNext = Next && Offset + Size == Next->Offset;
+
+    if(MergePrevious && MergeNext)
+    {
+        Previous->Size += Size + Next->Size;
+        vulkan_buffer_range Removed;
+        DArrayPopAt(List->FreeRanges, RangeIndex, &Removed);
+    }
+    else if(MergePrevious)
+    {
+        Previous->Size += Size;
+    }
+    else if(MergeNext)
+    {
+        Next->Offset = Offset;
+        Next->Size  += Size;
+    }
+    else
+    {
+        vulkan_buffer_range Range = {Offset, Size};
+        DArrayInsertAt(List->FreeRanges, RangeIndex, Range);
+    }
+
+    // NOTE: A free range that reaches the tail becomes part of the tail again
+    FreeCount = DArrayLength(List->FreeRanges);
+    vulkan_buffer_range* Last = &List->FreeRanges[FreeCount - 1];
+    if(Last->Offset + Last->Size == List->Top)
+    {
+        List->Top = Last->Offset;
+        DArrayLengthSet(List->FreeRanges, FreeCount - 1);
+    }
+}
+
+// NOTE: The submission that will carry the frame being recorded may still draw from the range, so it waits for that
+// one to retire rather than the last submitted one
+void DeferFreeDataRange(vulkan_range_list* List, u64 Offset, u64 Size)
+{
+    vulkan_pending_free Pending;
+    Pending.List = List;
+    Pending.Range.Offset = Offset;
+    Pending.Range.Size = Size;
+    Pending.Serial = Context.SubmitSerial + 1;
+    DArrayPush(Context.PendingFrees, Pending);
+}
+
+void ReleasePendingFrees(u64 RetiredSerial)
+{
+    u64 PendingIndex = 0;
+    while(PendingIndex < DArrayLength(Context.PendingFrees))
+    {
+        vulkan_pending_free* Pending = &Context.PendingFrees[PendingIndex];
+        if(Pending->Serial <= RetiredSerial)
+        {
+            FreeDataRange(Pending->List, Pending->Range.Offset, Pending->Range.Size);
+            DArraySwapRemove(Context.PendingFrees, PendingIndex, 0);
+        }
+        else
+        {
+            ++PendingIndex;
+        }
+    }
+}
+
+// NOTE: Out of space with frees still pending is the only case where a geometry allocation waits for the device.
+// Ranges dropped during the frame being recorded stay pending, its draws are not submitted yet.
+b8 AllocateGeometryRange(vulkan_range_list* List, vulkan_buffer* Buffer, u64 Size, u64* OutOffset)
+{
+    if(AllocateDataRange(List, Buffer, Size, OutOffset))
+    {
+        return true;
+    }
+
+    if(DArrayLength(Context.PendingFrees) > 0)
+    {
+        vkDeviceWaitIdle(Context.Device.LogicalDevice);
+        ReleasePendingFrees(Context.SubmitSerial);
+        return AllocateDataRange(List, Buffer, Size, OutOffset);
+    }
+
+    return false;
 }
 
 b8 VulkanRendererBackendInitialize(renderer_backend* Backend, const char* ApplicationName)
@@ -246,6 +385,13 @@ void VulkanRendererBackendShutdown(renderer_backend* Backend)
 {
     vkDeviceWaitIdle(Context.Device.LogicalDevice);
 
+    DArrayDestroy(Context.PendingFrees);
+    Context.PendingFrees = 0;
+    DArrayDestroy(Context.GeometryIndexRanges.FreeRanges);
+    Context.GeometryIndexRanges.FreeRanges = 0;
+    DArrayDestroy(Context.GeometryVertexRanges.FreeRanges);
+    Context.GeometryVertexRanges.FreeRanges = 0;
+
     VulkanDestroyBuffer(&Context, &Context.ObjectIndexBuffer);
     VulkanDestroyBuffer(&Context, &Context.ObjectVertexBuffer);
 
@@ -370,6 +516,8 @@ b8 VulkanRendererBackendBeginFrame(renderer_backend* Backend, r32 DeltaTime)
         return false;
     }
 
+    ReleasePendingFrees(Context.FrameSerials[Context.CurrentFrame]);
+
     if(!VulkanSwapchainAcquireNextImageIndex(&Context, &Context.Swapchain, UINT64_MAX, Context.ImageAvailableSemaphores[Context.CurrentFrame], 0, &Context.ImageIndex))
     {
         return false;
@@ -444,6 +592,7 @@ b8 VulkanRendererBackendEndFrame(renderer_backend* Backend, r32 DeltaTime)
 
     Context.ImagesInFlight[Context.ImageIndex] = &Context.InFlightFences[Context.CurrentFrame];
     VK_CHECK(vkResetFences(Context.Device.LogicalDevice, 1, &Context.InFlightFences[Context.CurrentFrame]));
+    Context.FrameSerials[Context.CurrentFrame] = ++Context.SubmitSerial;
 
     VkPipelineStageFlags Flags[1] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
 
@@ -575,7 +724,8 @@ b8 CreateBuffers(vulkan_context* Context)
         return false;
     }
 
-    Context->GeometryVertexOffset = 0;
+    Context->GeometryVertexRanges.Top = 0;
+    Context->GeometryVertexRanges.FreeRanges = DArrayCreate(vulkan_buffer_range);
 
     const u64 IndexBufferSize = sizeof(u32) * 1024 * 1024;
 
@@ -586,7 +736,12 @@ b8 CreateBuffers(vulkan_context* Context)
         return false;
     }
 
-    Context->GeometryIndexOffset = 0;
+    Context->GeometryIndexRanges.Top = 0;
+    Context->GeometryIndexRanges.FreeRanges = DArrayCreate(vulkan_buffer_range);
+
+    Context->SubmitSerial = 0;
+    ZeroMemory(Context->FrameSerials, sizeof(Context->FrameSerials));
+    Context->PendingFrees = DArrayCreate(vulkan_pending_free);
 
     return true;
 }
@@ -893,7 +1048,7 @@ void VulkanRendererDestroyMaterial(material* Material)
     }
 }
 
-b8 VulkanRendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
+b8 VulkanRendererCreateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
 {
     if(!VertexCount || !IndexCount)
     {
@@ -902,18 +1057,37 @@ b8 VulkanRendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCo
     }
 
     b8 IsReupload = Geometry->InternalID != INVALID_ID;
-    vulkan_geometry_data OldRange;
+    b8 HasIndices = IndexCount && Indices;
+    u64 VertexBufferTotalSize = (u64)VertexSize * VertexCount;
+    u64 IndexBufferTotalSize = HasIndices ? (u64)IndexSize * IndexCount : 0;
+
+    // NOTE: New ranges first, a reupload that does not fit leaves the old data drawable
+    u64 VertexBufferOffset = 0;
+    if(!AllocateGeometryRange(&Context.GeometryVertexRanges, &Context.ObjectVertexBuffer, VertexBufferTotalSize, &VertexBufferOffset))
+    {
+        VENG_ERROR("VulkanRendererCreateGeometry - vertex buffer is out of space for %llu bytes.", VertexBufferTotalSize);
+        return false;
+    }
+
+    u64 IndexBufferOffset = 0;
+    if(HasIndices && !AllocateGeometryRange(&Context.GeometryIndexRanges, &Context.ObjectIndexBuffer, IndexBufferTotalSize, &IndexBufferOffset))
+    {
+        VENG_ERROR("VulkanRendererCreateGeometry - index buffer is out of space for %llu bytes.", IndexBufferTotalSize);
+        FreeDataRange(&Context.GeometryVertexRanges, VertexBufferOffset, VertexBufferTotalSize);
+        return false;
+    }
 
     vulkan_geometry_data* InternalData = 0;
     if(IsReupload)
     {
         InternalData = &Context.Geometries[Geometry->InternalID];
-        OldRange.IndexBufferOffset  = InternalData->IndexBufferOffset;
-        OldRange.IndexCount         = InternalData->IndexCount;
-        OldRange.IndexSize          = InternalData->IndexSize;
-        OldRange.VertexBufferOffset = InternalData->VertexBufferOffset;
-        OldRange.VertexCount        = InternalData->VertexCount;
-        OldRange.VertexSize         = InternalData->VertexSize;
+
+        // NOTE: Frames in flight still draw the old ranges, they are recycled once those retire
+        DeferFreeDataRange(&Context.GeometryVertexRanges, InternalData->VertexBufferOffset, (u64)InternalData->VertexSize * InternalData->VertexCount);
+        if(InternalData->IndexSize > 0)
+        {
+            DeferFreeDataRange(&Context.GeometryIndexRanges, InternalData->IndexBufferOffset, (u64)InternalData->IndexSize * InternalData->IndexCount);
+        }
     }
     else
     {
@@ -934,27 +1108,32 @@ b8 VulkanRendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCo
     if(!InternalData)
     {
         VENG_FATAL("VulkanRendererCreateGeometry - failed to find a free index for a new geometry upload.");
+        FreeDataRange(&Context.GeometryVertexRanges, VertexBufferOffset, VertexBufferTotalSize);
+        if(HasIndices)
+        {
+            FreeDataRange(&Context.GeometryIndexRanges, IndexBufferOffset, IndexBufferTotalSize);
+        }
         return false;
     }
 
     VkCommandPool Pool = Context.Device.GraphicsCommandPool;
     VkQueue Queue = Context.Device.GraphicsQueue;
 
-    InternalData->VertexBufferOffset = Context.GeometryVertexOffset;
+    InternalData->VertexBufferOffset = (u32)VertexBufferOffset;
+    InternalData->VertexFormat = VertexFormat;
     InternalData->VertexCount = VertexCount;
     InternalData->VertexSize = VertexSize;
-    u32 VertexBufferTotalSize = VertexSize * VertexCount;
     UploadDataRange(&Context, Pool, 0, Queue, &Context.ObjectVertexBuffer, InternalData->VertexBufferOffset, VertexBufferTotalSize, Vertices);
-    Context.GeometryVertexOffset += VertexBufferTotalSize;
 
-    if(IndexCount && Indices)
+    InternalData->IndexBufferOffset = 0;
+    InternalData->IndexCount = 0;
+    InternalData->IndexSize = 0;
+    if(HasIndices)
     {
-        InternalData->IndexBufferOffset = Context.GeometryIndexOffset;
+        InternalData->IndexBufferOffset = (u32)IndexBufferOffset;
         InternalData->IndexCount = IndexCount;
         InternalData->IndexSize = IndexSize;
-        u32 IndexBufferTotalSize = IndexCount * IndexSize;
         UploadDataRange(&Context, Pool, 0, Queue, &Context.ObjectIndexBuffer, InternalData->IndexBufferOffset, IndexBufferTotalSize, Indices);
-        Context.GeometryIndexOffset += IndexBufferTotalSize;
     }
 
     if(InternalData->Generation == INVALID_ID)
@@ -966,17 +1145,38 @@ b8 VulkanRendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCo
         InternalData->Generation++;
     }
 
-    if(IsReupload)
+    VENG_TRACE("VulkanRendererCreateGeometry - geometry created");
+    return true;
+}
+
+b8 VulkanRendererUpdateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices)
+{
+    if(!Geometry || Geometry->InternalID == INVALID_ID || !Vertices)
     {
-        FreeDataRange(&Context.ObjectVertexBuffer, OldRange.VertexBufferOffset, OldRange.VertexSize * OldRange.VertexCount);
+        VENG_ERROR("VulkanRendererUpdateGeometry - requires an uploaded geometry and vertex data.");
+        return false;
+    }
 
-        if(OldRange.IndexSize > 0)
-        {
-            FreeDataRange(&Context.ObjectIndexBuffer, OldRange.IndexBufferOffset, OldRange.IndexSize * OldRange.IndexCount);
-        }
+    vulkan_geometry_data* InternalData = &Context.Geometries[Geometry->InternalID];
+    b8 SameVertices = InternalData->VertexFormat == VertexFormat && InternalData->VertexSize == VertexSize &&
+                      InternalData->VertexCount == VertexCount;
+    b8 SameIndices = !Indices || (InternalData->IndexSize == IndexSize && InternalData->IndexCount == IndexCount);
+    if(!SameVertices || !SameIndices)
+    {
+        VENG_ERROR("VulkanRendererUpdateGeometry - layout of '%s' changed, create the geometry again instead.", Geometry->Name);
+        return false;
+    }
+
+    // NOTE: Written over the live ranges. The staging copy waits for the graphics queue, so frames already submitted
+    // finish with the old data and everything submitted afterwards, this frame included, sees the new data.
+    VkCommandPool Pool = Context.Device.GraphicsCommandPool;
+    VkQueue Queue = Context.Device.GraphicsQueue;
+    UploadDataRange(&Context, Pool, 0, Queue, &Context.ObjectVertexBuffer, InternalData->VertexBufferOffset, (u64)VertexSize * VertexCount, Vertices);
+    if(Indices)
+    {
+        UploadDataRange(&Context, Pool, 0, Queue, &Context.ObjectIndexBuffer, InternalData->IndexBufferOffset, (u64)IndexSize * IndexCount, Indices);
     }
 
-    VENG_TRACE("VulkanRendererCreateGeometry - geometry created");
     return true;
 }
 
@@ -984,14 +1184,13 @@ void VulkanRendererDestroyGeometry(geometry* Geometry)
 {
     if(Geometry && Geometry->InternalID != INVALID_ID)
     {
-        vkDeviceWaitIdle(Context.Device.LogicalDevice);
         vulkan_geometry_data* InternalData = &Context.Geometries[Geometry->InternalID];
 
-        FreeDataRange(&Context.ObjectVertexBuffer, InternalData->VertexBufferOffset, InternalData->VertexSize * InternalData->VertexCount);
+        DeferFreeDataRange(&Context.GeometryVertexRanges, InternalData->VertexBufferOffset, (u64)InternalData->VertexSize * InternalData->VertexCount);
 
         if(InternalData->IndexSize > 0)
         {
-            FreeDataRange(&Context.ObjectIndexBuffer, InternalData->IndexBufferOffset, InternalData->IndexSize * InternalData->IndexCount);
+            DeferFreeDataRange(&Context.GeometryIndexRanges, InternalData->IndexBufferOffset, (u64)InternalData->IndexSize * InternalData->IndexCount);
         }
 
         ZeroMemory(InternalData, sizeof(vulkan_geometry_data));
@@ -1024,7 +1223,19 @@ void VulkanDrawGeometry(geometry_render_data RenderData)
     {
         case MATERIAL_TYPE_WORLD:
         {
-            VulkanMaterialShaderSetModel(&Context, &Context.MaterialShader, RenderData.Model);
+            // NOTE: Packed positions are unorm across the geometry extents, scaling and offsetting them first turns
+            // them back into local space
+            b8 Packed = BufferData->VertexFormat == VERTEX_FORMAT_3D_PACKED;
+            mat4 Model = RenderData.Model;
+            if(Packed)
+            {
+                extents_3d Extents = RenderData.Geometry->Extents;
+                mat4 Unpack = MulMat4(Scale(SubV3(Extents.Max, Extents.Min)), Translation(Extents.Min));
+                Model = MulMat4(Unpack, Model);
+            }
+
+            VulkanMaterialShaderUseVertexFormat(&Context, &Context.MaterialShader, Packed);
+            VulkanMaterialShaderSetModel(&Context, &Context.MaterialShader, Model);
             VulkanMaterialShaderApplyMaterial(&Context, &Context.MaterialShader, Mat);
         } break;
 
@@ -1046,8 +1257,20 @@ void VulkanDrawGeometry(geometry_render_data RenderData)
 
     if(BufferData->IndexCount > 0)
     {
-        vkCmdBindIndexBuffer(CommandBuffer->Handle, Context.ObjectIndexBuffer.Handle, BufferData->IndexBufferOffset, VK_INDEX_TYPE_UINT32);
-        vkCmdDrawIndexed(CommandBuffer->Handle, BufferData->IndexCount, 1, 0, 0, 0);
+        // NOTE: Every level of detail is a range of the same index upload
+        u32 FirstIndex = 0;
+        u32 IndexCount = BufferData->IndexCount;
+        geometry* Geometry = RenderData.Geometry;
+        if(Geometry->LodCount > 0)
+        {
+            u32 Lod = RenderData.Lod < Geometry->LodCount ? RenderData.Lod : Geometry->LodCount - 1;
+            FirstIndex = Geometry->Lods[Lod].FirstIndex;
+            IndexCount = Geometry->Lods[Lod].IndexCount;
+        }
+
+        VkIndexType IndexType = BufferData->IndexSize == sizeof(u16) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        vkCmdBindIndexBuffer(CommandBuffer->Handle, Context.ObjectIndexBuffer.Handle, BufferData->IndexBufferOffset, IndexType);
+        vkCmdDrawIndexed(CommandBuffer->Handle, IndexCount, 1, FirstIndex, 0, 0);
     }
     else
     {
@@ -24,5 +24,6 @@ b8 VulkanRendererEndRenderpass(renderer_backend* Backend, u8 RenderpassID);
 b8 VulkanRendererCreateMaterial(material* Material);
 void VulkanRendererDestroyMaterial(material* Material);
 
-b8 VulkanRendererCreateGeometry(geometry* Geometry, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
+b8 VulkanRendererCreateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
+b8 VulkanRendererUpdateGeometry(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices, u32 IndexSize, u32 IndexCount, const void* Indices);
 void VulkanRendererDestroyGeometry(geometry* Geometry);
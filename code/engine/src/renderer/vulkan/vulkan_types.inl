@@ -223,6 +223,8 @@ typedef struct vulkan_material_shader
     vulkan_object_shader_object_state ObjectStates[VULKAN_MAX_MATERIAL_COUNT];
 
     vulkan_pipeline Pipeline;
+    vulkan_pipeline PackedPipeline;
+    b8 PackedPipelineBound;
 } vulkan_material_shader;
 
 typedef struct vulkan_ui_shader
@@ -256,6 +258,7 @@ typedef struct vulkan_geometry_data
 {
     u32 ID;
     u32 Generation;
+    vertex_format VertexFormat;
     u32 VertexCount;
     u32 VertexSize;
     u32 VertexBufferOffset;
@@ -264,6 +267,30 @@ typedef struct vulkan_geometry_data
     u32 IndexBufferOffset;
 } vulkan_geometry_data;
 
+typedef struct vulkan_buffer_range
+{
+    u64 Offset;
+    u64 Size;
+} vulkan_buffer_range;
+
+// NOTE: Sub allocation of one of the shared geometry buffers. Ranges are VULKAN_BUFFER_RANGE_ALIGNMENT aligned, the
+// free ones are a darray sorted by offset with neighbours merged, Top is where the never used tail starts.
+#define VULKAN_BUFFER_RANGE_ALIGNMENT 4
+typedef struct vulkan_range_list
+{
+    u64 Top;
+    vulkan_buffer_range* FreeRanges;
+} vulkan_range_list;
+
+// NOTE: A range dropped while frames in flight may still read it. It goes back to its list once the submission
+// numbered Serial has retired.
+typedef struct vulkan_pending_free
+{
+    vulkan_range_list* List;
+    vulkan_buffer_range Range;
+    u64 Serial;
+} vulkan_pending_free;
+
 typedef struct vulkan_context
 {
     r32 DeltaTime;
@@ -309,8 +336,14 @@ typedef struct vulkan_context
     vulkan_material_shader MaterialShader;
     vulkan_ui_shader UiShader;
 
-    u64 GeometryVertexOffset;
-    u64 GeometryIndexOffset;
+    vulkan_range_list GeometryVertexRanges;
+    vulkan_range_list GeometryIndexRanges;
+
+    // NOTE: Every frame submission gets the next serial, FrameSerials holds the one last submitted with each
+    // InFlightFences entry, so waiting on that fence retires everything up to it
+    u64 SubmitSerial;
+    u64 FrameSerials[2];
+    vulkan_pending_free* PendingFrees;
 
     vulkan_geometry_data Geometries[VULKAN_MAX_GEOMETRY_COUNT];
 
@@ -0,0 +1,225 @@
+#include "mesh_loader.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "core/vstring.h"
+#include "resources/resource_types.h"
+#include "resources/mesh_format.h"
+#include "systems/resource_system.h"
+#include "platform/file_system.h"
+
+#include "resources/loaders/loader_utils.h"
+
+static b8 IsRangeInFile(u64 Offset, u64 Size, u64 FileSize)
+{
+    return Offset <= FileSize && Size <= FileSize - Offset;
+}
+
+// NOTE: The geometry's vertices are a slice of a shared buffer, an index past VertexCount would draw another
+// geometry's vertices or whatever lies past the end
+static b8 AreIndicesInRange(const void* Indices, u32 IndexSize, u32 IndexCount, u32 VertexCount)
+{
+    if(IndexSize == sizeof(u16))
+    {
+        const u16* Indices16 = Indices;
+        for(u32 Index = 0;
+            Index < IndexCount;
+            ++Index)
+        {
+            if(Indices16[Index] >= VertexCount)
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        const u32* Indices32 = Indices;
+        for(u32 Index = 0;
+            Index < IndexCount;
+            ++Index)
+        {
+            if(Indices32[Index] >= VertexCount)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// NOTE: The LOD ranges lie back to back inside the submesh's indices
+static b8 AreLodsInRange(const mesh_file_submesh* Submesh)
+{
+    if(Submesh->LodCount > GEOMETRY_MAX_LODS)
+    {
+        return false;
+    }
+
+    u64 LodIndexTotal = 0;
+    for(u32 Lod = 0;
+        Lod < Submesh->LodCount;
+        ++Lod)
+    {
+        LodIndexTotal += Submesh->LodIndexCounts[Lod];
+    }
+
+    return LodIndexTotal <= Submesh->IndexCount;
+}
+
+b8 MeshLoaderLoad(struct resource_loader* Self, const char* Name, resource* OutResource)
+{
+    if(!Self || !Name || !OutResource)
+    {
+        return false;
+    }
+
+    const char* FormatStr = "%s/%s/%s%s";
+    char FullFilePath[512];
+
+    StringFormat(FullFilePath, FormatStr, ResourceSystemBasePath(), Self->TypePath, Name, MESH_FILE_EXTENSION);
+
+    file_handle File;
+    if(!FileOpen(FullFilePath, FILE_MODE_READ, true, &File))
+    {
+        VENG_ERROR("MeshLoaderLoad - unable to open file '%s'", FullFilePath);
+        return false;
+    }
+
+    u64 FileTotalSize = 0;
+    FileSize(&File, &FileTotalSize);
+    if(FileTotalSize < sizeof(mesh_file_header))
+    {
+        VENG_ERROR("MeshLoaderLoad - '%s' is too small to be a mesh file", FullFilePath);
+        FileClose(&File);
+        return false;
+    }
+
+    // NOTE: The whole file in one read, the configs point straight into it
+    u8* FileData = Allocate(FileTotalSize, MEMORY_TAG_ARRAY);
+    u64 ReadSize = 0;
+    b8 Read = FileRead(&File, FileTotalSize, FileData, &ReadSize);
+    FileClose(&File);
+
+    mesh_file_header* Header = (mesh_file_header*)FileData;
+    if(!Read || ReadSize != FileTotalSize)
+    {
+        VENG_ERROR("MeshLoaderLoad - unable to read '%s'", FullFilePath);
+        Free(FileData, FileTotalSize, MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    if(Header->Magic != MESH_FILE_MAGIC || Header->Version != MESH_FILE_VERSION || Header->FileSize != FileTotalSize)
+    {
+        VENG_ERROR("MeshLoaderLoad - '%s' is not a version %u mesh file, recook it", FullFilePath, MESH_FILE_VERSION);
+        Free(FileData, FileTotalSize, MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    b8 KnownVertexFormat = (Header->VertexFormat == VERTEX_FORMAT_3D && Header->VertexSize == sizeof(vertex_3d)) ||
+                           (Header->VertexFormat == VERTEX_FORMAT_3D_PACKED && Header->VertexSize == sizeof(vertex_3d_packed));
+    if(!KnownVertexFormat ||
+       !IsRangeInFile(sizeof(mesh_file_header), (u64)Header->SubmeshCount * sizeof(mesh_file_submesh), FileTotalSize))
+    {
+        VENG_ERROR("MeshLoaderLoad - '%s' has an unsupported vertex format or a truncated submesh table", FullFilePath);
+        Free(FileData, FileTotalSize, MEMORY_TAG_ARRAY);
+        return false;
+    }
+
+    mesh_file_submesh* Submeshes = (mesh_file_submesh*)(FileData + sizeof(mesh_file_header));
+    for(u32 Index = 0;
+        Index < Header->SubmeshCount;
+        ++Index)
+    {
+        mesh_file_submesh* Submesh = Submeshes + Index;
+        b8 Valid = (Submesh->IndexSize == sizeof(u16) || Submesh->IndexSize == sizeof(u32)) &&
+                   Submesh->VertexOffset % MESH_FILE_ALIGNMENT == 0 &&
+                   Submesh->IndexOffset % MESH_FILE_ALIGNMENT == 0 &&
+                   IsRangeInFile(Submesh->VertexOffset, (u64)Submesh->VertexCount * Header->VertexSize, FileTotalSize) &&
+                   IsRangeInFile(Submesh->IndexOffset, (u64)Submesh->IndexCount * Submesh->IndexSize, FileTotalSize);
+        if(!Valid)
+        {
+            VENG_ERROR("MeshLoaderLoad - submesh %u of '%s' points outside the file", Index, FullFilePath);
+            Free(FileData, FileTotalSize, MEMORY_TAG_ARRAY);
+            return false;
+        }
+
+        if(!AreLodsInRange(Submesh) ||
+           !AreIndicesInRange(FileData + Submesh->IndexOffset, Submesh->IndexSize, Submesh->IndexCount, Submesh->VertexCount))
+        {
+            VENG_ERROR("MeshLoaderLoad - submesh %u of '%s' has LOD ranges or indices past its %u vertices", 
+                       Index, FullFilePath, Submesh->VertexCount);
+            Free(FileData, FileTotalSize, MEMORY_TAG_ARRAY);
+            return false;
+        }
+
+        Submesh->Name[GEOMETRY_NAME_MAX_LENGTH - 1] = 0;
+        Submesh->MaterialName[MATERIAL_NAME_MAX_LENGTH - 1] = 0;
+    }
+
+    u64 DataSize = sizeof(static_mesh_resource_data) + sizeof(geometry_config) * Header->SubmeshCount;
+    u8* Block = Allocate(DataSize, MEMORY_TAG_ARRAY);
+
+    static_mesh_resource_data* ResourceData = (static_mesh_resource_data*)Block;
+    ResourceData->Extents = Header->Extents;
+    ResourceData->GeometryCount = Header->SubmeshCount;
+    ResourceData->Configs = (geometry_config*)(Block + sizeof(static_mesh_resource_data));
+    ResourceData->FileData = FileData;
+    ResourceData->FileDataSize = FileTotalSize;
+    for(u32 Index = 0;
+        Index < Header->SubmeshCount;
+        ++Index)
+    {
+        mesh_file_submesh* Submesh = Submeshes + Index;
+        geometry_config* Config = ResourceData->Configs + Index;
+
+        Config->VertexFormat = (vertex_format)Header->VertexFormat;
+        Config->VertexSize = Header->VertexSize;
+        Config->VertexCount = Submesh->VertexCount;
+        Config->Vertices = FileData + Submesh->VertexOffset;
+        // NOTE: Packed submeshes are quantized against their own bounds
+        Config->PositionExtents = Submesh->Extents;
+
+        Config->IndexSize = Submesh->IndexSize;
+        Config->IndexCount = Submesh->IndexCount;
+        Config->Indices = FileData + Submesh->IndexOffset;
+
+        Config->LodCount = Submesh->LodCount;
+        CopyMemory(Config->LodIndexCounts, Submesh->LodIndexCounts, sizeof(Config->LodIndexCounts));
+        CopyMemory(Config->LodErrors, Submesh->LodErrors, sizeof(Config->LodErrors));
+
+        StringCopyN(Config->Name, Submesh->Name, GEOMETRY_NAME_MAX_LENGTH);
+        StringCopyN(Config->MaterialName, Submesh->MaterialName, MATERIAL_NAME_MAX_LENGTH);
+    }
+
+    OutResource->FullPath = StringDuplicate(FullFilePath);
+    OutResource->Data = ResourceData;
+    OutResource->DataSize = DataSize;
+    OutResource->Name = Name;
+
+    return true;
+}
+
+void MeshLoaderUnload(struct resource_loader* Self, resource* Resource)
+{
+    if(Resource && Resource->Data)
+    {
+        static_mesh_resource_data* ResourceData = Resource->Data;
+        Free(ResourceData->FileData, ResourceData->FileDataSize, MEMORY_TAG_ARRAY);
+    }
+
+    ResourceUnload(Self, Resource, MEMORY_TAG_ARRAY);
+}
+
+resource_loader StaticMeshResourceLoaderCreate()
+{
+    resource_loader Loader;
+    Loader.Type = RESOURCE_TYPE_STATIC_MESH;
+    Loader.CustomType = 0;
+    Loader.Load = MeshLoaderLoad;
+    Loader.Unload = MeshLoaderUnload;
+    Loader.TypePath = "models";
+
+    return Loader;
+}
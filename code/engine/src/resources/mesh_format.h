@@ -0,0 +1,52 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+#include "resources/resource_types.h"
+
+// NOTE: Cooked static mesh layout, written by code/tools/mesh_cooker and read by the static mesh loader in one read.
+// The file is a mesh_file_header, SubmeshCount mesh_file_submesh entries, every submesh's vertex_3d array and then
+// every submesh's indices, each array starting on a MESH_FILE_ALIGNMENT boundary. Offsets are from the start of the
+// file. Submeshes with at most 65536 vertices store u16 indices. The LOD levels of a submesh lie back to back in its
+// index range like geometry_config expects. VertexFormat is VERTEX_FORMAT_3D or VERTEX_FORMAT_3D_PACKED with the
+// matching VertexSize, packed positions span the submesh Extents.
+#define MESH_FILE_MAGIC 0x4853454D
+#define MESH_FILE_VERSION 2
+#define MESH_FILE_ALIGNMENT 16
+#define MESH_FILE_EXTENSION ".vsm"
+
+typedef struct mesh_file_header
+{
+    u32 Magic;
+    u32 Version;
+    u32 VertexSize;
+    u32 SubmeshCount;
+    u32 VertexFormat;
+    u32 Padding;
+    u64 FileSize;
+    extents_3d Extents;
+} mesh_file_header;
+
+typedef struct mesh_file_submesh
+{
+    char Name[GEOMETRY_NAME_MAX_LENGTH];
+    char MaterialName[MATERIAL_NAME_MAX_LENGTH];
+    extents_3d Extents;
+
+    u64 VertexOffset;
+    u32 VertexCount;
+
+    u32 IndexSize;
+    u64 IndexOffset;
+    u32 IndexCount;
+
+    u32 LodCount;
+    u32 LodIndexCounts[GEOMETRY_MAX_LODS];
+    r32 LodErrors[GEOMETRY_MAX_LODS];
+} mesh_file_submesh;
+
+INLINE u64
+MeshFileAlign(u64 Offset)
+{
+    return (Offset + (MESH_FILE_ALIGNMENT - 1)) & ~(u64)(MESH_FILE_ALIGNMENT - 1);
+}
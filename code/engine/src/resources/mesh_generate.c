@@ -0,0 +1,332 @@
+#include "mesh_generate.h"
+
+#include "math/vmath.h"
+#include "platform/platform.h"
+
+// NOTE: Quads of a grid RowStride vertices wide, the ones starting on vertex rows [FirstRow, FirstRow + RowCount).
+// Counter clockwise seen from U x V where U runs along the row and V across the rows, Flip turns it around.
+// OutIndices is where the grid's first quad goes.
+static void FillGridIndices(u32 BaseVertex, u32 RowStride, u32 QuadCountX, u32 FirstRow, u32 RowCount, b8 Flip, u32* OutIndices)
+{
+    // NOTE: Two quads side by side are 12 indices, three 4 wide vectors, the second quad is the first plus one
+    u32 A = 0, B = 1, C = RowStride, D = RowStride + 1;
+    u32 Quad[6] = {A, D, C, A, B, D};
+    if(Flip)
+    {
+        Quad[1] = C;
+        Quad[2] = D;
+        Quad[4] = D;
+        Quad[5] = B;
+    }
+
+#if VENG_SIMD_SSE || VENG_SIMD_NEON
+    u32 Pattern[12];
+    for(u32 Index = 0;
+        Index < 6;
+        ++Index)
+    {
+        Pattern[Index]     = Quad[Index];
+        Pattern[Index + 6] = Quad[Index] + 1;
+    }
+#endif
+
+    for(u32 Row = FirstRow;
+        Row < FirstRow + RowCount;
+        ++Row)
+    {
+        u32* Out = OutIndices + (u64)Row * QuadCountX * 6;
+        u32 Base = BaseVertex + Row * RowStride;
+        u32 Column = 0;
+
+#if VENG_SIMD_SSE
+        __m128i P0 = _mm_loadu_si128((const __m128i*)(Pattern + 0));
+        __m128i P1 = _mm_loadu_si128((const __m128i*)(Pattern + 4));
+        __m128i P2 = _mm_loadu_si128((const __m128i*)(Pattern + 8));
+        for(;
+            Column + 2 <= QuadCountX;
+            Column += 2)
+        {
+            __m128i Offset = _mm_set1_epi32((s32)(Base + Column));
+            _mm_storeu_si128((__m128i*)(Out + Column * 6 + 0), _mm_add_epi32(P0, Offset));
+            _mm_storeu_si128((__m128i*)(Out + Column * 6 + 4), _mm_add_epi32(P1, Offset));
+            _mm_storeu_si128((__m128i*)(Out + Column * 6 + 8), _mm_add_epi32(P2, Offset));
+        }
+#elif VENG_SIMD_NEON
+        uint32x4_t P0 = vld1q_u32(Pattern + 0);
+        uint32x4_t P1 = vld1q_u32(Pattern + 4);
+        uint32x4_t P2 = vld1q_u32(Pattern + 8);
+        for(;
+            Column + 2 <= QuadCountX;
+            Column += 2)
+        {
+            uint32x4_t Offset = vdupq_n_u32(Base + Column);
+            vst1q_u32(Out + Column * 6 + 0, vaddq_u32(P0, Offset));
+            vst1q_u32(Out + Column * 6 + 4, vaddq_u32(P1, Offset));
+            vst1q_u32(Out + Column * 6 + 8, vaddq_u32(P2, Offset));
+        }
+#endif
+
+        for(;
+            Column < QuadCountX;
+            ++Column)
+        {
+            for(u32 Index = 0;
+                Index < 6;
+                ++Index)
+            {
+                Out[Column * 6 + Index] = Base + Column + Quad[Index];
+            }
+        }
+    }
+}
+
+mesh_generate_size MeshPlaneSize(u32 SegmentCountX, u32 SegmentCountY)
+{
+    SegmentCountX = SegmentCountX ? SegmentCountX : 1;
+    SegmentCountY = SegmentCountY ? SegmentCountY : 1;
+
+    mesh_generate_size Size;
+    Size.VertexCount = (SegmentCountX + 1) * (SegmentCountY + 1);
+    Size.IndexCount  = SegmentCountX * SegmentCountY * 6;
+    return Size;
+}
+
+void MeshGeneratePlane(r32 Width, r32 Height, u32 SegmentCountX, u32 SegmentCountY, r32 TileX, r32 TileY,
+                       vertex_3d* OutVertices, u32* OutIndices)
+{
+    SegmentCountX = SegmentCountX ? SegmentCountX : 1;
+    SegmentCountY = SegmentCountY ? SegmentCountY : 1;
+
+    r32 StepX = Width / SegmentCountX;
+    r32 StepY = Height / SegmentCountY;
+    r32 StepU = TileX / SegmentCountX;
+    r32 StepV = TileY / SegmentCountY;
+    for(u32 y = 0;
+        y <= SegmentCountY;
+        ++y)
+    {
+        vertex_3d* Row = OutVertices + y * (SegmentCountX + 1);
+        r32 PositionY = y * StepY - 0.5f * Height;
+        r32 CoordY = y * StepV;
+        for(u32 x = 0;
+            x <= SegmentCountX;
+            ++x)
+        {
+            Row[x].Position = V3(x * StepX - 0.5f * Width, PositionY, 0.0f);
+            Row[x].TexCoord = V2(x * StepU, CoordY);
+        }
+    }
+
+    FillGridIndices(0, SegmentCountX + 1, SegmentCountX, 0, SegmentCountY, false, OutIndices);
+}
+
+mesh_generate_size MeshCubeSize()
+{
+    mesh_generate_size Size;
+    Size.VertexCount = 24;
+    Size.IndexCount  = 36;
+    return Size;
+}
+
+void MeshGenerateCube(v3 Size, r32 TileX, r32 TileY, vertex_3d* OutVertices, u32* OutIndices)
+{
+    // NOTE: Normal, then the U and V axes of the face with U x V = Normal
+    const r32 Faces[6][9] =
+    {
+        { 1,  0,  0,   0,  0, -1,   0,  1,  0},
+        {-1,  0,  0,   0,  0,  1,   0,  1,  0},
+        { 0,  1,  0,   1,  0,  0,   0,  0, -1},
+        { 0, -1,  0,   1,  0,  0,   0,  0,  1},
+        { 0,  0,  1,   1,  0,  0,   0,  1,  0},
+        { 0,  0, -1,  -1,  0,  0,   0,  1,  0},
+    };
+
+    for(u32 Face = 0;
+        Face < 6;
+        ++Face)
+    {
+        const r32* F = Faces[Face];
+        for(u32 Corner = 0;
+            Corner < 4;
+            ++Corner)
+        {
+            r32 s = (r32)(Corner & 1);
+            r32 t = (r32)(Corner >> 1);
+            vertex_3d* Vertex = OutVertices + Face * 4 + Corner;
+            Vertex->Position = V3((0.5f * F[0] + (s - 0.5f) * F[3] + (t - 0.5f) * F[6]) * Size.x,
+                                  (0.5f * F[1] + (s - 0.5f) * F[4] + (t - 0.5f) * F[7]) * Size.y,
+                                  (0.5f * F[2] + (s - 0.5f) * F[5] + (t - 0.5f) * F[8]) * Size.z);
+            Vertex->TexCoord = V2(s * TileX, t * TileY);
+        }
+
+        FillGridIndices(Face * 4, 2, 1, 0, 1, false, OutIndices + Face * 6);
+    }
+}
+
+mesh_generate_size MeshSphereSize(u32 RingCount, u32 SegmentCount)
+{
+    RingCount    = RingCount < 2 ? 2 : RingCount;
+    SegmentCount = SegmentCount < 3 ? 3 : SegmentCount;
+
+    mesh_generate_size Size;
+    Size.VertexCount = (RingCount + 1) * (SegmentCount + 1);
+    Size.IndexCount  = (RingCount - 1) * SegmentCount * 6;
+    return Size;
+}
+
+void MeshGenerateSphere(r32 Radius, u32 RingCount, u32 SegmentCount, vertex_3d* OutVertices, u32* OutIndices)
+{
+    RingCount    = RingCount < 2 ? 2 : RingCount;
+    SegmentCount = SegmentCount < 3 ? 3 : SegmentCount;
+
+    // NOTE: Rows run from the +y pole down, columns around y from +x towards +z
+    for(u32 Ring = 0;
+        Ring <= RingCount;
+        ++Ring)
+    {
+        r32 Theta = PI32 * Ring / RingCount;
+        r32 SinTheta = Ring == RingCount ? 0.0f : Sin(Theta);
+        r32 CosTheta = Cos(Theta);
+        vertex_3d* Row = OutVertices + Ring * (SegmentCount + 1);
+        for(u32 Segment = 0;
+            Segment <= SegmentCount;
+            ++Segment)
+        {
+            r32 Phi = TWO_PI32 * Segment / SegmentCount;
+            Row[Segment].Position = V3(Radius * SinTheta * Cos(Phi), Radius * CosTheta, Radius * SinTheta * Sin(Phi));
+            Row[Segment].TexCoord = V2((r32)Segment / SegmentCount, 1.0f - (r32)Ring / RingCount);
+        }
+    }
+
+    // NOTE: Pole rows keep the triangle that is not collapsed onto the pole, the rows between are whole quads
+    u32 RowStride = SegmentCount + 1;
+    u32* Top = OutIndices;
+    u32* Middle = Top + SegmentCount * 3;
+    u32* Bottom = Middle + (RingCount - 2) * SegmentCount * 6;
+    u32 BottomBase = (RingCount - 1) * RowStride;
+    for(u32 Segment = 0;
+        Segment < SegmentCount;
+        ++Segment)
+    {
+        Top[Segment * 3 + 0] = Segment;
+        Top[Segment * 3 + 1] = RowStride + Segment + 1;
+        Top[Segment * 3 + 2] = RowStride + Segment;
+
+        Bottom[Segment * 3 + 0] = BottomBase + Segment;
+        Bottom[Segment * 3 + 1] = BottomBase + Segment + 1;
+        Bottom[Segment * 3 + 2] = BottomBase + RowStride + Segment + 1;
+    }
+
+    FillGridIndices(RowStride, RowStride, SegmentCount, 0, RingCount - 2, false, Middle);
+}
+
+mesh_generate_size MeshTerrainSize(const mesh_terrain_desc* Desc)
+{
+    mesh_generate_size Size = {};
+    if(Desc->SampleCountX >= 2 && Desc->SampleCountY >= 2)
+    {
+        Size.VertexCount = Desc->SampleCountX * Desc->SampleCountY;
+        Size.IndexCount  = (Desc->SampleCountX - 1) * (Desc->SampleCountY - 1) * 6;
+    }
+    return Size;
+}
+
+void MeshGenerateTerrainRows(const mesh_terrain_desc* Desc, u32 FirstRow, u32 RowCount, vertex_3d* OutVertices, u32* OutIndices)
+{
+    u32 CountX = Desc->SampleCountX;
+    u32 CountY = Desc->SampleCountY;
+    if(CountX < 2 || CountY < 2 || FirstRow >= CountY)
+    {
+        return;
+    }
+    RowCount = FirstRow + RowCount > CountY ? CountY - FirstRow : RowCount;
+
+    r32 MinX = -0.5f * Desc->CellSize * (CountX - 1);
+    r32 MinZ = -0.5f * Desc->CellSize * (CountY - 1);
+    r32 StepU = Desc->TileX / (CountX - 1);
+    r32 StepV = Desc->TileY / (CountY - 1);
+    for(u32 y = FirstRow;
+        y < FirstRow + RowCount;
+        ++y)
+    {
+        const r32* Heights = Desc->Heights + (u64)y * CountX;
+        vertex_3d* Row = OutVertices + (u64)y * CountX;
+        r32 PositionZ = MinZ + y * Desc->CellSize;
+        r32 CoordY = y * StepV;
+        for(u32 x = 0;
+            x < CountX;
+            ++x)
+        {
+            Row[x].Position = V3(MinX + x * Desc->CellSize, Heights[x] * Desc->HeightScale, PositionZ);
+            Row[x].TexCoord = V2(x * StepU, CoordY);
+        }
+    }
+
+    // NOTE: The last sample row starts no quads. Rows go along +z, so x cross z points down and the winding is flipped
+    u32 QuadRowCount = FirstRow + RowCount == CountY ? RowCount - 1 : RowCount;
+    FillGridIndices(0, CountX, CountX - 1, FirstRow, QuadRowCount, true, OutIndices);
+}
+
+typedef struct terrain_band
+{
+    const mesh_terrain_desc* Desc;
+    u32 FirstRow;
+    u32 RowCount;
+    vertex_3d* OutVertices;
+    u32* OutIndices;
+} terrain_band;
+
+static u32 TerrainBandThread(void* Param)
+{
+    terrain_band* Band = (terrain_band*)Param;
+    MeshGenerateTerrainRows(Band->Desc, Band->FirstRow, Band->RowCount, Band->OutVertices, Band->OutIndices);
+    return 0;
+}
+
+void MeshGenerateTerrain(const mesh_terrain_desc* Desc, vertex_3d* OutVertices, u32* OutIndices)
+{
+    mesh_generate_size Size = MeshTerrainSize(Desc);
+    if(Size.VertexCount < MESH_GENERATE_PARALLEL_VERTEX_COUNT)
+    {
+        MeshGenerateTerrainRows(Desc, 0, Desc->SampleCountY, OutVertices, OutIndices);
+        return;
+    }
+
+    // NOTE: Bands write disjoint rows of both arrays. The calling thread takes the first band, a band whose thread
+    // fails to start runs here too.
+    u32 RowsPerBand = (Desc->SampleCountY + MESH_GENERATE_MAX_THREADS - 1) / MESH_GENERATE_MAX_THREADS;
+    terrain_band Bands[MESH_GENERATE_MAX_THREADS];
+    platform_thread Threads[MESH_GENERATE_MAX_THREADS];
+    b8 Started[MESH_GENERATE_MAX_THREADS];
+    for(u32 Band = 0;
+        Band < MESH_GENERATE_MAX_THREADS;
+        ++Band)
+    {
+        Bands[Band].Desc = Desc;
+        Bands[Band].FirstRow = Band * RowsPerBand;
+        Bands[Band].RowCount = RowsPerBand;
+        Bands[Band].OutVertices = OutVertices;
+        Bands[Band].OutIndices = OutIndices;
+        Started[Band] = Band > 0 && PlatformThreadCreate(TerrainBandThread, Bands + Band, Threads + Band);
+    }
+
+    for(u32 Band = 0;
+        Band < MESH_GENERATE_MAX_THREADS;
+        ++Band)
+    {
+        if(!Started[Band])
+        {
+            TerrainBandThread(Bands + Band);
+        }
+    }
+
+    for(u32 Band = 1;
+        Band < MESH_GENERATE_MAX_THREADS;
+        ++Band)
+    {
+        if(Started[Band])
+        {
+            PlatformThreadJoin(Threads + Band);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+
+// NOTE: Procedural meshes written straight into caller buffers, a frame arena or the mapped upload memory, so there is
+// no heap traffic. Ask for the size first, then fill. Indices are u32 and wind counter clockwise seen from outside.
+
+// NOTE: Terrains with at least this many vertices are filled on several threads, below it starting them costs more
+// than it saves
+#define MESH_GENERATE_PARALLEL_VERTEX_COUNT (256 * 1024)
+#define MESH_GENERATE_MAX_THREADS 4
+
+typedef struct mesh_generate_size
+{
+    u32 VertexCount;
+    u32 IndexCount;
+} mesh_generate_size;
+
+typedef struct mesh_terrain_desc
+{
+    // NOTE: SampleCountX * SampleCountY heights, row major, rows go along +z
+    const r32* Heights;
+    u32 SampleCountX;
+    u32 SampleCountY;
+    r32 CellSize;
+    r32 HeightScale;
+    // NOTE: Texture repeats across the whole terrain
+    r32 TileX;
+    r32 TileY;
+} mesh_terrain_desc;
+
+// NOTE: Width by Height in the xy plane facing +z, centered on the origin, with shared vertices
+VENG_API mesh_generate_size MeshPlaneSize(u32 SegmentCountX, u32 SegmentCountY);
+VENG_API void MeshGeneratePlane(r32 Width, r32 Height, u32 SegmentCountX, u32 SegmentCountY, r32 TileX, r32 TileY,
+                                vertex_3d* OutVertices, u32* OutIndices);
+
+// NOTE: Four vertices per face so every face gets the whole texture
+VENG_API mesh_generate_size MeshCubeSize();
+VENG_API void MeshGenerateCube(v3 Size, r32 TileX, r32 TileY, vertex_3d* OutVertices, u32* OutIndices);
+
+// NOTE: UV sphere, the seam column and the pole rows are duplicated for the texture coordinates. The quads touching a
+// pole have two corners on it, so those rows get one triangle per segment.
+VENG_API mesh_generate_size MeshSphereSize(u32 RingCount, u32 SegmentCount);
+VENG_API void MeshGenerateSphere(r32 Radius, u32 RingCount, u32 SegmentCount, vertex_3d* OutVertices, u32* OutIndices);
+
+// NOTE: Heightmap grid in the xz plane centered on the origin, heights go along +y
+VENG_API mesh_generate_size MeshTerrainSize(const mesh_terrain_desc* Desc);
+VENG_API void MeshGenerateTerrain(const mesh_terrain_desc* Desc, vertex_3d* OutVertices, u32* OutIndices);
+// NOTE: Rows [FirstRow, FirstRow + RowCount) of the samples and the quads starting on them, bands of rows can be
+// filled on different threads. Writes to the same places MeshGenerateTerrain does.
+VENG_API void MeshGenerateTerrainRows(const mesh_terrain_desc* Desc, u32 FirstRow, u32 RowCount, vertex_3d* OutVertices, u32* OutIndices);
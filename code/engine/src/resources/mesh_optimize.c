@@ -0,0 +1,491 @@
+#include "mesh_optimize.h"
+
+#include "core/vmemory.h"
+#include "math/vmath.h"
+
+static u32 HashBytes(const u8* Bytes, u32 Size)
+{
+    // NOTE: FNV-1a
+    u32 Hash = 2166136261u;
+    for(u32 Index = 0;
+        Index < Size;
+        ++Index)
+    {
+        Hash ^= Bytes[Index];
+        Hash *= 16777619u;
+    }
+    return Hash;
+}
+
+static b8 BytesEqual(const u8* A, const u8* B, u32 Size)
+{
+    for(u32 Index = 0;
+        Index < Size;
+        ++Index)
+    {
+        if(A[Index] != B[Index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+mesh_cache_stats MeshAnalyzeVertexCache(const u32* Indices, u32 IndexCount, u32 VertexCount, u32 CacheSize)
+{
+    mesh_cache_stats Stats = {};
+    Stats.TriangleCount = IndexCount / 3;
+
+    // NOTE: A vertex is in the FIFO while fewer than CacheSize misses happened since it was loaded
+    u32* LoadedAt = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    u8* Referenced = Allocate(VertexCount, MEMORY_TAG_ARRAY);
+    ZeroMemory(LoadedAt, sizeof(u32) * VertexCount);
+    ZeroMemory(Referenced, VertexCount);
+
+    u32 Time = CacheSize + 1;
+    for(u32 Index = 0;
+        Index < IndexCount;
+        ++Index)
+    {
+        u32 Vertex = Indices[Index];
+        if(Vertex >= VertexCount)
+        {
+            continue;
+        }
+
+        if(Time - LoadedAt[Vertex] > CacheSize)
+        {
+            LoadedAt[Vertex] = Time++;
+            Stats.VerticesTransformed++;
+        }
+
+        if(!Referenced[Vertex])
+        {
+            Referenced[Vertex] = true;
+            Stats.VertexCount++;
+        }
+    }
+
+    Free(LoadedAt, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Referenced, VertexCount, MEMORY_TAG_ARRAY);
+
+    Stats.ACMR = Stats.TriangleCount ? (r32)Stats.VerticesTransformed / (r32)Stats.TriangleCount : 0.0f;
+    Stats.ATVR = Stats.VertexCount ? (r32)Stats.VerticesTransformed / (r32)Stats.VertexCount : 0.0f;
+    return Stats;
+}
+
+u32 MeshRemoveDuplicateVertices(void* Vertices, u32 VertexSize, u32 VertexCount, u32* Indices, u32 IndexCount)
+{
+    u32 TableSize = 16;
+    while(TableSize < VertexCount * 2)
+    {
+        TableSize *= 2;
+    }
+
+    u32* Table = Allocate(sizeof(u32) * TableSize, MEMORY_TAG_ARRAY);
+    u32* Remap = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    SetMemory(Table, 0xFF, sizeof(u32) * TableSize);
+
+    // NOTE: The table holds compacted indices, every kept vertex is already at its new place when it is looked up
+    u8* Bytes = (u8*)Vertices;
+    u32 UniqueCount = 0;
+    for(u32 Vertex = 0;
+        Vertex < VertexCount;
+        ++Vertex)
+    {
+        const u8* Data = Bytes + (u64)Vertex * VertexSize;
+        u32 Slot = HashBytes(Data, VertexSize) & (TableSize - 1);
+        while(Table[Slot] != INVALID_ID && !BytesEqual(Bytes + (u64)Table[Slot] * VertexSize, Data, VertexSize))
+        {
+            Slot = (Slot + 1) & (TableSize - 1);
+        }
+
+        if(Table[Slot] == INVALID_ID)
+        {
+            if(UniqueCount != Vertex)
+            {
+                CopyMemory(Bytes + (u64)UniqueCount * VertexSize, Data, VertexSize);
+            }
+            Table[Slot] = UniqueCount++;
+        }
+        Remap[Vertex] = Table[Slot];
+    }
+
+    for(u32 Index = 0;
+        Index < IndexCount;
+        ++Index)
+    {
+        if(Indices[Index] < VertexCount)
+        {
+            Indices[Index] = Remap[Indices[Index]];
+        }
+    }
+
+    Free(Table, sizeof(u32) * TableSize, MEMORY_TAG_ARRAY);
+    Free(Remap, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    return UniqueCount;
+}
+
+void MeshOptimizeVertexCache(const u32* Indices, u32 IndexCount, u32 VertexCount, u32 CacheSize, u32* OutIndices)
+{
+    u32 TriangleCount = IndexCount / 3;
+
+    // NOTE: Triangles around each vertex, live counts drop as triangles are emitted
+    u32* Offsets  = Allocate(sizeof(u32) * (VertexCount + 1), MEMORY_TAG_ARRAY);
+    u32* Adjacency = Allocate(sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+    u32* Live     = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    u32* LoadedAt = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    u8* Emitted   = Allocate(TriangleCount, MEMORY_TAG_ARRAY);
+    u32* DeadEnds = Allocate(sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+    u32* Candidates = Allocate(sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+    ZeroMemory(Live, sizeof(u32) * VertexCount);
+    ZeroMemory(LoadedAt, sizeof(u32) * VertexCount);
+    ZeroMemory(Emitted, TriangleCount);
+
+    for(u32 Index = 0;
+        Index < TriangleCount * 3;
+        ++Index)
+    {
+        Live[Indices[Index]]++;
+    }
+
+    u32 Sum = 0;
+    for(u32 Vertex = 0;
+        Vertex < VertexCount;
+        ++Vertex)
+    {
+        Offsets[Vertex] = Sum;
+        Sum += Live[Vertex];
+    }
+    Offsets[VertexCount] = Sum;
+
+    for(u32 Index = 0;
+        Index < TriangleCount * 3;
+        ++Index)
+    {
+        Adjacency[Offsets[Indices[Index]]++] = Index / 3;
+    }
+    for(u32 Vertex = 0;
+        Vertex < VertexCount;
+        ++Vertex)
+    {
+        Offsets[Vertex] -= Live[Vertex];
+    }
+
+    u32 DeadEndCount = 0;
+    u32 Cursor = 0;
+    u32 Time = CacheSize + 1;
+    u32 OutCount = 0;
+    u32 Fan = TriangleCount ? Indices[0] : INVALID_ID;
+    while(Fan != INVALID_ID)
+    {
+        // NOTE: Emit every live triangle around the fanning vertex, their vertices become the next candidates
+        u32 CandidateCount = 0;
+        for(u32 At = Offsets[Fan];
+            At < Offsets[Fan + 1];
+            ++At)
+        {
+            u32 Triangle = Adjacency[At];
+            if(Emitted[Triangle])
+            {
+                continue;
+            }
+
+            for(u32 Corner = 0;
+                Corner < 3;
+                ++Corner)
+            {
+                u32 Vertex = Indices[Triangle * 3 + Corner];
+                OutIndices[OutCount++] = Vertex;
+                DeadEnds[DeadEndCount++] = Vertex;
+                Candidates[CandidateCount++] = Vertex;
+                Live[Vertex]--;
+                if(Time - LoadedAt[Vertex] > CacheSize)
+                {
+                    LoadedAt[Vertex] = Time++;
+                }
+            }
+            Emitted[Triangle] = true;
+        }
+
+        // NOTE: Pick the candidate that stays in the cache long enough to emit all its triangles,
+        // preferring the one loaded longest ago
+        u32 Next = INVALID_ID;
+        s32 BestPriority = -1;
+        for(u32 Index = 0;
+            Index < CandidateCount;
+            ++Index)
+        {
+            u32 Vertex = Candidates[Index];
+            if(Live[Vertex] == 0)
+            {
+                continue;
+            }
+
+            s32 Priority = 0;
+            if(Time - LoadedAt[Vertex] + 2 * Live[Vertex] <= CacheSize)
+            {
+                Priority = (s32)(Time - LoadedAt[Vertex]);
+            }
+            if(Priority > BestPriority)
+            {
+                BestPriority = Priority;
+                Next = Vertex;
+            }
+        }
+
+        // NOTE: Dead end, fall back to recently used vertices, then to the next vertex in input order
+        while(Next == INVALID_ID && DeadEndCount > 0)
+        {
+            u32 Vertex = DeadEnds[--DeadEndCount];
+            if(Live[Vertex] > 0)
+            {
+                Next = Vertex;
+            }
+        }
+        while(Next == INVALID_ID && Cursor < VertexCount)
+        {
+            if(Live[Cursor] > 0)
+            {
+                Next = Cursor;
+            }
+            Cursor++;
+        }
+
+        Fan = Next;
+    }
+
+    Free(Offsets, sizeof(u32) * (VertexCount + 1), MEMORY_TAG_ARRAY);
+    Free(Adjacency, sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+    Free(Live, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(LoadedAt, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Emitted, TriangleCount, MEMORY_TAG_ARRAY);
+    Free(DeadEnds, sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+    Free(Candidates, sizeof(u32) * TriangleCount * 3, MEMORY_TAG_ARRAY);
+}
+
+// NOTE: Splits [Start, End) into clusters, returns how many starts were written. A cluster ends where the next
+// triangle misses on all three vertices (hard boundary), or where the cluster so far is already at least
+// Threshold times as cache friendly as the whole hard cluster (soft boundary).
+static u32 FindClusters(const u32* Indices, u32 IndexCount, u32 VertexCount, u32 CacheSize, r32 Threshold, u32* OutClusterStarts)
+{
+    u32* LoadedAt = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    ZeroMemory(LoadedAt, sizeof(u32) * VertexCount);
+
+    u32 TriangleCount = IndexCount / 3;
+    u32 ClusterCount = 0;
+    u32 Time = CacheSize + 1;
+
+    u32 HardStart = 0;
+    while(HardStart < TriangleCount)
+    {
+        // NOTE: Find the end of the hard cluster and its cache efficiency
+        u32 HardEnd = HardStart;
+        u32 HardMisses = 0;
+        while(HardEnd < TriangleCount)
+        {
+            u32 Misses = 0;
+            for(u32 Corner = 0;
+                Corner < 3;
+                ++Corner)
+            {
+                u32 Vertex = Indices[HardEnd * 3 + Corner];
+                if(Time - LoadedAt[Vertex] > CacheSize)
+                {
+                    LoadedAt[Vertex] = Time++;
+                    Misses++;
+                }
+            }
+
+            if(Misses == 3 && HardEnd > HardStart)
+            {
+                break;
+            }
+            HardMisses += Misses;
+            HardEnd++;
+        }
+
+        r32 ClusterLimit = Threshold * (r32)HardMisses / (r32)(HardEnd - HardStart);
+
+        // NOTE: Replay with a fresh cache per soft cluster
+        Time += CacheSize + 1;
+        OutClusterStarts[ClusterCount++] = HardStart;
+        u32 SoftStart = HardStart;
+        u32 SoftMisses = 0;
+        for(u32 Triangle = HardStart;
+            Triangle < HardEnd;
+            ++Triangle)
+        {
+            for(u32 Corner = 0;
+                Corner < 3;
+                ++Corner)
+            {
+                u32 Vertex = Indices[Triangle * 3 + Corner];
+                if(Time - LoadedAt[Vertex] > CacheSize)
+                {
+                    LoadedAt[Vertex] = Time++;
+                    SoftMisses++;
+                }
+            }
+
+            if(Triangle + 1 < HardEnd && (r32)SoftMisses / (r32)(Triangle + 1 - SoftStart) <= ClusterLimit)
+            {
+                OutClusterStarts[ClusterCount++] = Triangle + 1;
+                SoftStart = Triangle + 1;
+                SoftMisses = 0;
+                Time += CacheSize + 1;
+            }
+        }
+
+        HardStart = HardEnd;
+        Time += CacheSize + 1;
+    }
+
+    Free(LoadedAt, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    return ClusterCount;
+}
+
+void MeshOptimizeOverdraw(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                          u32 CacheSize, r32 Threshold, u32* OutIndices)
+{
+    u32 TriangleCount = IndexCount / 3;
+    if(TriangleCount == 0)
+    {
+        return;
+    }
+
+    u32* ClusterStarts = Allocate(sizeof(u32) * (TriangleCount + 1), MEMORY_TAG_ARRAY);
+    u32 ClusterCount = FindClusters(Indices, IndexCount, VertexCount, CacheSize, Threshold, ClusterStarts);
+    ClusterStarts[ClusterCount] = TriangleCount;
+
+    // NOTE: Area weighted centroids, of the mesh and of each cluster, and area weighted cluster normals
+    r32* Keys = Allocate(sizeof(r32) * ClusterCount, MEMORY_TAG_ARRAY);
+    v3* Centroids = Allocate(sizeof(v3) * ClusterCount, MEMORY_TAG_ARRAY);
+    v3* Normals = Allocate(sizeof(v3) * ClusterCount, MEMORY_TAG_ARRAY);
+    v3 MeshCentroid = V3Zero();
+    r32 MeshArea = 0.0f;
+    for(u32 Cluster = 0;
+        Cluster < ClusterCount;
+        ++Cluster)
+    {
+        v3 Centroid = V3Zero();
+        v3 Normal = V3Zero();
+        r32 Area = 0.0f;
+        for(u32 Triangle = ClusterStarts[Cluster];
+            Triangle < ClusterStarts[Cluster + 1];
+            ++Triangle)
+        {
+            const r32* a = (const r32*)((const u8*)Vertices + (u64)Indices[Triangle * 3 + 0] * VertexSize);
+            const r32* b = (const r32*)((const u8*)Vertices + (u64)Indices[Triangle * 3 + 1] * VertexSize);
+            const r32* c = (const r32*)((const u8*)Vertices + (u64)Indices[Triangle * 3 + 2] * VertexSize);
+            v3 p0 = V3(a[0], a[1], a[2]);
+            v3 p1 = V3(b[0], b[1], b[2]);
+            v3 p2 = V3(c[0], c[1], c[2]);
+            v3 Cross = CrossV3(SubV3(p1, p0), SubV3(p2, p0));
+            r32 TriangleArea = SquareRoot(LengthSquaredV3(Cross));
+            r32 Weight = TriangleArea / 3.0f;
+            Centroid = AddV3(Centroid, MulV3(AddV3(AddV3(p0, p1), p2), V3(Weight, Weight, Weight)));
+            Normal = AddV3(Normal, Cross);
+            Area += TriangleArea;
+        }
+
+        MeshCentroid = AddV3(MeshCentroid, Centroid);
+        MeshArea += Area;
+        r32 InvArea = Area > 0.0f ? 1.0f / Area : 0.0f;
+        Centroids[Cluster] = MulV3(Centroid, V3(InvArea, InvArea, InvArea));
+        Normals[Cluster] = Normal;
+    }
+
+    r32 InvMeshArea = MeshArea > 0.0f ? 1.0f / MeshArea : 0.0f;
+    MeshCentroid = MulV3(MeshCentroid, V3(InvMeshArea, InvMeshArea, InvMeshArea));
+
+    // NOTE: Clusters far out along their own normal face away from the rest of the mesh, they go first
+    u32* Order = Allocate(sizeof(u32) * ClusterCount, MEMORY_TAG_ARRAY);
+    for(u32 Cluster = 0;
+        Cluster < ClusterCount;
+        ++Cluster)
+    {
+        r32 Length = SquareRoot(LengthSquaredV3(Normals[Cluster]));
+        Keys[Cluster] = Length > 0.0f ? InnerV3(SubV3(Centroids[Cluster], MeshCentroid), Normals[Cluster]) / Length : 0.0f;
+        Order[Cluster] = Cluster;
+    }
+
+    // NOTE: Bottom up merge sort, descending and stable
+    u32* SortTemp = Allocate(sizeof(u32) * ClusterCount, MEMORY_TAG_ARRAY);
+    u32* Source = Order;
+    u32* Dest = SortTemp;
+    for(u32 Width = 1;
+        Width < ClusterCount;
+        Width *= 2)
+    {
+        for(u32 Start = 0;
+            Start < ClusterCount;
+            Start += 2 * Width)
+        {
+            u32 Middle = Start + Width < ClusterCount ? Start + Width : ClusterCount;
+            u32 End = Start + 2 * Width < ClusterCount ? Start + 2 * Width : ClusterCount;
+            u32 Left = Start;
+            u32 Right = Middle;
+            for(u32 At = Start;
+                At < End;
+                ++At)
+            {
+                if(Left < Middle && (Right >= End || Keys[Source[Left]] >= Keys[Source[Right]]))
+                {
+                    Dest[At] = Source[Left++];
+                }
+                else
+                {
+                    Dest[At] = Source[Right++];
+                }
+            }
+        }
+
+        u32* Temp = Source;
+        Source = Dest;
+        Dest = Temp;
+    }
+
+    u32 OutCount = 0;
+    for(u32 Index = 0;
+        Index < ClusterCount;
+        ++Index)
+    {
+        u32 Cluster = Source[Index];
+        u32 First = ClusterStarts[Cluster] * 3;
+        u32 Count = ClusterStarts[Cluster + 1] * 3 - First;
+        CopyMemory(OutIndices + OutCount, Indices + First, sizeof(u32) * Count);
+        OutCount += Count;
+    }
+
+    Free(ClusterStarts, sizeof(u32) * (TriangleCount + 1), MEMORY_TAG_ARRAY);
+    Free(Keys, sizeof(r32) * ClusterCount, MEMORY_TAG_ARRAY);
+    Free(Centroids, sizeof(v3) * ClusterCount, MEMORY_TAG_ARRAY);
+    Free(Normals, sizeof(v3) * ClusterCount, MEMORY_TAG_ARRAY);
+    Free(Order, sizeof(u32) * ClusterCount, MEMORY_TAG_ARRAY);
+    Free(SortTemp, sizeof(u32) * ClusterCount, MEMORY_TAG_ARRAY);
+}
+
+u32 MeshOptimizeVertexFetch(const void* Vertices, u32 VertexSize, u32 VertexCount, u32* Indices, u32 IndexCount, void* OutVertices)
+{
+    u32* Remap = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    SetMemory(Remap, 0xFF, sizeof(u32) * VertexCount);
+
+    u32 NextVertex = 0;
+    for(u32 Index = 0;
+        Index < IndexCount;
+        ++Index)
+    {
+        u32 Vertex = Indices[Index];
+        if(Remap[Vertex] == INVALID_ID)
+        {
+            Remap[Vertex] = NextVertex;
+            CopyMemory((u8*)OutVertices + (u64)NextVertex * VertexSize, (const u8*)Vertices + (u64)Vertex * VertexSize, VertexSize);
+            NextVertex++;
+        }
+        Indices[Index] = Remap[Vertex];
+    }
+
+    Free(Remap, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    return NextVertex;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: Post transform cache size the orderings aim for. Real hardware is not a FIFO of this size, but
+// orderings made for a small FIFO hold up well across GPUs.
+#define MESH_VERTEX_CACHE_SIZE 16
+
+// NOTE: ACMR is transformed vertices per triangle (0.5 is the limit for large regular grids, 3 the worst case),
+// ATVR is transformed vertices per referenced vertex (1 is ideal).
+typedef struct mesh_cache_stats
+{
+    u32 VerticesTransformed;
+    u32 TriangleCount;
+    u32 VertexCount;
+    r32 ACMR;
+    r32 ATVR;
+} mesh_cache_stats;
+
+// NOTE: Runs the indices through a FIFO cache of CacheSize entries
+VENG_API mesh_cache_stats MeshAnalyzeVertexCache(const u32* Indices, u32 IndexCount, u32 VertexCount, u32 CacheSize);
+
+// NOTE: Merges bit identical vertices in place, keeping the first of each and their order, and rewrites Indices.
+// Returns the new vertex count.
+VENG_API u32 MeshRemoveDuplicateVertices(void* Vertices, u32 VertexSize, u32 VertexCount, u32* Indices, u32 IndexCount);
+
+// NOTE: Tipsify (Sander, Nehab, Barczak 2007). Reorders triangles to reuse recently transformed vertices,
+// linear in the triangle count. OutIndices may not alias Indices.
+VENG_API void MeshOptimizeVertexCache(const u32* Indices, u32 IndexCount, u32 VertexCount, u32 CacheSize, u32* OutIndices);
+
+// NOTE: Splits vertex cache ordered indices into clusters wherever the cache would restart anyway, or where a split
+// costs less than Threshold times the cluster's cache efficiency (1.05 keeps the ACMR within about 5%), then
+// draws outward facing clusters first so they occlude the rest. Vertices start with 3 float positions.
+// OutIndices may not alias Indices.
+VENG_API void MeshOptimizeOverdraw(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                                   u32 CacheSize, r32 Threshold, u32* OutIndices);
+
+// NOTE: Writes the vertices to OutVertices in the order the indices first use them, drops unused ones and rewrites
+// Indices. Returns the new vertex count. OutVertices may not alias Vertices.
+VENG_API u32 MeshOptimizeVertexFetch(const void* Vertices, u32 VertexSize, u32 VertexCount, u32* Indices, u32 IndexCount, void* OutVertices);
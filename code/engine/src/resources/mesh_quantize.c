@@ -0,0 +1,87 @@
+#include "mesh_quantize.h"
+
+u16 MeshQuantizeHalf(r32 Value)
+{
+    union { r32 F; u32 U; } Bits;
+    Bits.F = Value;
+
+    u32 Sign = Bits.U & 0x80000000u;
+    Bits.U ^= Sign;
+
+    u32 Result;
+    if(Bits.U >= (127 + 16) << 23)
+    {
+        // NOTE: Infinity or NaN, large finite values overflow to infinity
+        Result = Bits.U > 255u << 23 ? 0x7E00 : 0x7C00;
+    }
+    else if(Bits.U < 113 << 23)
+    {
+        // NOTE: Half subnormal, the float add does the shift and the rounding
+        union { r32 F; u32 U; } Magic;
+        Magic.U = ((127 - 15) + (23 - 10) + 1) << 23;
+        Bits.F += Magic.F;
+        Result = Bits.U - Magic.U;
+    }
+    else
+    {
+        u32 MantissaOdd = (Bits.U >> 13) & 1;
+        Bits.U += ((u32)(15 - 127) << 23) + 0xFFF;
+        Bits.U += MantissaOdd;
+        Result = Bits.U >> 13;
+    }
+
+    return (u16)(Result | (Sign >> 16));
+}
+
+static u16 QuantizeUnorm16(r32 Value, r32 Min, r32 Size)
+{
+    if(Size <= 0.0f)
+    {
+        return 0;
+    }
+
+    r32 Normalized = (Value - Min) / Size;
+    Normalized = Normalized < 0.0f ? 0.0f : (Normalized > 1.0f ? 1.0f : Normalized);
+    return (u16)(Normalized * 65535.0f + 0.5f);
+}
+
+extents_3d MeshPackVertices(const vertex_3d* Vertices, u32 VertexCount, vertex_3d_packed* OutVertices)
+{
+    extents_3d Extents = {};
+    if(VertexCount == 0)
+    {
+        return Extents;
+    }
+
+    Extents.Min = Vertices[0].Position;
+    Extents.Max = Vertices[0].Position;
+    for(u32 Index = 1;
+        Index < VertexCount;
+        ++Index)
+    {
+        v3 P = Vertices[Index].Position;
+        Extents.Min.x = P.x < Extents.Min.x ? P.x : Extents.Min.x;
+        Extents.Min.y = P.y < Extents.Min.y ? P.y : Extents.Min.y;
+        Extents.Min.z = P.z < Extents.Min.z ? P.z : Extents.Min.z;
+        Extents.Max.x = P.x > Extents.Max.x ? P.x : Extents.Max.x;
+        Extents.Max.y = P.y > Extents.Max.y ? P.y : Extents.Max.y;
+        Extents.Max.z = P.z > Extents.Max.z ? P.z : Extents.Max.z;
+    }
+
+    v3 Size = {{Extents.Max.x - Extents.Min.x, Extents.Max.y - Extents.Min.y, Extents.Max.z - Extents.Min.z}};
+    for(u32 Index = 0;
+        Index < VertexCount;
+        ++Index)
+    {
+        const vertex_3d* In = Vertices + Index;
+        vertex_3d_packed* Out = OutVertices + Index;
+        Out->Position[0] = QuantizeUnorm16(In->Position.x, Extents.Min.x, Size.x);
+        Out->Position[1] = QuantizeUnorm16(In->Position.y, Extents.Min.y, Size.y);
+        Out->Position[2] = QuantizeUnorm16(In->Position.z, Extents.Min.z, Size.z);
+        Out->Padding = 0;
+        Out->TexCoord[0] = MeshQuantizeHalf(In->TexCoord.x);
+        Out->TexCoord[1] = MeshQuantizeHalf(In->TexCoord.y);
+    }
+
+    return Extents;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+
+// NOTE: Round to nearest even, values past the half range become infinity
+VENG_API u16 MeshQuantizeHalf(r32 Value);
+
+// NOTE: Packs the vertices against the bounds of their positions and returns those bounds, the renderer needs them to
+// unpack the positions. Position error is at most 1/131070 of the bounds per axis, texture coordinates keep 11
+// significant bits, so heavily tiled coordinates lose precision.
+VENG_API extents_3d MeshPackVertices(const vertex_3d* Vertices, u32 VertexCount, vertex_3d_packed* OutVertices);
@@ -0,0 +1,668 @@
+#include "mesh_simplify.h"
+
+#include "core/vmemory.h"
+#include "math/vmath.h"
+
+// NOTE: Border planes get this much more weight than the surface, which keeps open edges from shrinking
+#define MESH_SIMPLIFY_BORDER_WEIGHT 10.0f
+#define MESH_SIMPLIFY_MAX_PASSES 64
+// NOTE: Squared cosine of the largest normal change a collapse may cause, about 75 degrees
+#define MESH_SIMPLIFY_MIN_NORMAL_COS2 0.0625f
+
+typedef enum vertex_kind
+{
+    VERTEX_KIND_MANIFOLD,
+    VERTEX_KIND_BORDER,
+    VERTEX_KIND_LOCKED,
+} vertex_kind;
+
+// NOTE: Symmetric 4x4 plane quadric summed over Weight, Error / Weight is a mean squared distance
+typedef struct quadric
+{
+    r32 a2, b2, c2, d2;
+    r32 ab, ac, ad;
+    r32 bc, bd, cd;
+    r32 Weight;
+} quadric;
+
+typedef struct collapse
+{
+    u32 From;
+    u32 To;
+    r32 Cost;
+} collapse;
+
+typedef struct simplify_scratch
+{
+    u32 VertexCount;
+    u32 IndexCount;
+    u32 EdgeCapacity;
+
+    // NOTE: Per vertex, indexed by the first vertex sharing the position
+    u32* Group;
+    u8* Seam;
+    u8* Kind;
+    u8* Touched;
+    u32* Redirect;
+    u32* OpenEdges;
+    quadric* Quadrics;
+
+    // NOTE: Triangles around each position, rebuilt every pass
+    u32* AdjacencyOffsets;
+    u32* Adjacency;
+
+    // NOTE: Open addressed set of directed edges between groups
+    u64* EdgeKeys;
+    u32* EdgeCounts;
+
+    collapse* Collapses;
+    collapse* SortTemp;
+} simplify_scratch;
+
+static v3 GetPosition(const void* Vertices, u32 VertexSize, u32 Vertex)
+{
+    const r32* Position = (const r32*)((const u8*)Vertices + (u64)Vertex * VertexSize);
+    return V3(Position[0], Position[1], Position[2]);
+}
+
+static u32 HashU32(u32 Value)
+{
+    Value ^= Value >> 16;
+    Value *= 0x7FEB352D;
+    Value ^= Value >> 15;
+    Value *= 0x846CA68B;
+    Value ^= Value >> 16;
+    return Value;
+}
+
+static void QuadricFromPlane(quadric* Q, v3 Normal, r32 Distance, r32 Weight)
+{
+    Q->a2 = Weight * Normal.x * Normal.x;
+    Q->b2 = Weight * Normal.y * Normal.y;
+    Q->c2 = Weight * Normal.z * Normal.z;
+    Q->d2 = Weight * Distance * Distance;
+    Q->ab = Weight * Normal.x * Normal.y;
+    Q->ac = Weight * Normal.x * Normal.z;
+    Q->ad = Weight * Normal.x * Distance;
+    Q->bc = Weight * Normal.y * Normal.z;
+    Q->bd = Weight * Normal.y * Distance;
+    Q->cd = Weight * Normal.z * Distance;
+    Q->Weight = Weight;
+}
+
+static void QuadricAdd(quadric* Dest, const quadric* Source)
+{
+    Dest->a2 += Source->a2;
+    Dest->b2 += Source->b2;
+    Dest->c2 += Source->c2;
+    Dest->d2 += Source->d2;
+    Dest->ab += Source->ab;
+    Dest->ac += Source->ac;
+    Dest->ad += Source->ad;
+    Dest->bc += Source->bc;
+    Dest->bd += Source->bd;
+    Dest->cd += Source->cd;
+    Dest->Weight += Source->Weight;
+}
+
+static r32 QuadricError(const quadric* Q, v3 P)
+{
+    r32 rx = Q->a2 * P.x + Q->ab * P.y + Q->ac * P.z + Q->ad;
+    r32 ry = Q->ab * P.x + Q->b2 * P.y + Q->bc * P.z + Q->bd;
+    r32 rz = Q->ac * P.x + Q->bc * P.y + Q->c2 * P.z + Q->cd;
+    r32 Error = P.x * rx + P.y * ry + P.z * rz + Q->ad * P.x + Q->bd * P.y + Q->cd * P.z + Q->d2;
+    Error = Error < 0.0f ? -Error : Error;
+    return Q->Weight > 0.0f ? Error / Q->Weight : Error;
+}
+
+static u32 EdgeFind(simplify_scratch* Scratch, u32 From, u32 To)
+{
+    u64 Key = ((u64)From << 32) | To;
+    u32 Mask = Scratch->EdgeCapacity - 1;
+    u32 Slot = HashU32(From * 0x9E3779B1 + HashU32(To)) & Mask;
+    while(Scratch->EdgeKeys[Slot] != Key && Scratch->EdgeKeys[Slot] != (u64)-1)
+    {
+        Slot = (Slot + 1) & Mask;
+    }
+    return Slot;
+}
+
+static u32 EdgeCount(simplify_scratch* Scratch, u32 From, u32 To)
+{
+    u32 Slot = EdgeFind(Scratch, From, To);
+    return Scratch->EdgeKeys[Slot] == (u64)-1 ? 0 : Scratch->EdgeCounts[Slot];
+}
+
+static void CreateScratch(simplify_scratch* Scratch, u32 VertexCount, u32 IndexCount)
+{
+    Scratch->VertexCount = VertexCount;
+    Scratch->IndexCount  = IndexCount;
+    Scratch->EdgeCapacity = 16;
+    while(Scratch->EdgeCapacity < IndexCount * 2)
+    {
+        Scratch->EdgeCapacity *= 2;
+    }
+
+    Scratch->Group     = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->Seam      = Allocate(VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->Kind      = Allocate(VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->Touched   = Allocate(VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->Redirect  = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->OpenEdges = Allocate(sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->Quadrics  = Allocate(sizeof(quadric) * VertexCount, MEMORY_TAG_ARRAY);
+    Scratch->AdjacencyOffsets = Allocate(sizeof(u32) * (VertexCount + 1), MEMORY_TAG_ARRAY);
+    Scratch->Adjacency  = Allocate(sizeof(u32) * IndexCount, MEMORY_TAG_ARRAY);
+    Scratch->EdgeKeys   = Allocate(sizeof(u64) * Scratch->EdgeCapacity, MEMORY_TAG_ARRAY);
+    Scratch->EdgeCounts = Allocate(sizeof(u32) * Scratch->EdgeCapacity, MEMORY_TAG_ARRAY);
+    Scratch->Collapses  = Allocate(sizeof(collapse) * IndexCount, MEMORY_TAG_ARRAY);
+    Scratch->SortTemp   = Allocate(sizeof(collapse) * IndexCount, MEMORY_TAG_ARRAY);
+}
+
+static void DestroyScratch(simplify_scratch* Scratch)
+{
+    u32 VertexCount = Scratch->VertexCount;
+    u32 IndexCount  = Scratch->IndexCount;
+    Free(Scratch->Group, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->Seam, VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->Kind, VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->Touched, VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->Redirect, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->OpenEdges, sizeof(u32) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->Quadrics, sizeof(quadric) * VertexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->AdjacencyOffsets, sizeof(u32) * (VertexCount + 1), MEMORY_TAG_ARRAY);
+    Free(Scratch->Adjacency, sizeof(u32) * IndexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->EdgeKeys, sizeof(u64) * Scratch->EdgeCapacity, MEMORY_TAG_ARRAY);
+    Free(Scratch->EdgeCounts, sizeof(u32) * Scratch->EdgeCapacity, MEMORY_TAG_ARRAY);
+    Free(Scratch->Collapses, sizeof(collapse) * IndexCount, MEMORY_TAG_ARRAY);
+    Free(Scratch->SortTemp, sizeof(collapse) * IndexCount, MEMORY_TAG_ARRAY);
+}
+
+// NOTE: Vertices with bit identical positions form a group, named after its first vertex. A group whose vertices
+// also carry different attributes is a seam.
+static void BuildGroups(simplify_scratch* Scratch, const void* Vertices, u32 VertexSize, u32 VertexCount)
+{
+    u32 TableSize = 16;
+    while(TableSize < VertexCount * 2)
+    {
+        TableSize *= 2;
+    }
+
+    u32* Table = Allocate(sizeof(u32) * TableSize, MEMORY_TAG_ARRAY);
+    SetMemory(Table, 0xFF, sizeof(u32) * TableSize);
+
+    for(u32 Vertex = 0;
+        Vertex < VertexCount;
+        ++Vertex)
+    {
+        const u32* Bits = (const u32*)((const u8*)Vertices + (u64)Vertex * VertexSize);
+        u32 Slot = HashU32(Bits[0] ^ HashU32(Bits[1] ^ HashU32(Bits[2]))) & (TableSize - 1);
+        for(;;)
+        {
+            u32 Other = Table[Slot];
+            if(Other == INVALID_ID)
+            {
+                Table[Slot] = Vertex;
+                Scratch->Group[Vertex] = Vertex;
+                Scratch->Seam[Vertex] = false;
+                break;
+            }
+
+            const u32* OtherBits = (const u32*)((const u8*)Vertices + (u64)Other * VertexSize);
+            if(OtherBits[0] == Bits[0] && OtherBits[1] == Bits[1] && OtherBits[2] == Bits[2])
+            {
+                Scratch->Group[Vertex] = Other;
+                const u8* A = (const u8*)Bits;
+                const u8* B = (const u8*)OtherBits;
+                for(u32 Byte = 12;
+                    Byte < VertexSize;
+                    ++Byte)
+                {
+                    if(A[Byte] != B[Byte])
+                    {
+                        Scratch->Seam[Other] = true;
+                        break;
+                    }
+                }
+                break;
+            }
+            Slot = (Slot + 1) & (TableSize - 1);
+        }
+    }
+
+    Free(Table, sizeof(u32) * TableSize, MEMORY_TAG_ARRAY);
+}
+
+static b8 CanCollapse(simplify_scratch* Scratch, u32 From, u32 To)
+{
+    if(Scratch->Kind[From] == VERTEX_KIND_LOCKED || Scratch->Seam[To])
+    {
+        return false;
+    }
+
+    // NOTE: Border vertices slide along the border only
+    if(Scratch->Kind[From] == VERTEX_KIND_BORDER)
+    {
+        return Scratch->Kind[To] != VERTEX_KIND_MANIFOLD &&
+               (EdgeCount(Scratch, From, To) == 0 || EdgeCount(Scratch, To, From) == 0);
+    }
+
+    return true;
+}
+
+// NOTE: Collapsing must not turn any remaining triangle around From over, or tilt it far enough to become a sliver
+static b8 CollapseFlips(simplify_scratch* Scratch, const void* Vertices, u32 VertexSize, const u32* Indices, u32 From, u32 To)
+{
+    v3 Target = GetPosition(Vertices, VertexSize, To);
+    for(u32 At = Scratch->AdjacencyOffsets[From];
+        At < Scratch->AdjacencyOffsets[From + 1];
+        ++At)
+    {
+        const u32* Triangle = Indices + Scratch->Adjacency[At] * 3;
+        u32 a = Scratch->Group[Triangle[0]];
+        u32 b = Scratch->Group[Triangle[1]];
+        u32 c = Scratch->Group[Triangle[2]];
+        if(a == To || b == To || c == To)
+        {
+            continue;
+        }
+
+        v3 p0 = GetPosition(Vertices, VertexSize, a);
+        v3 p1 = GetPosition(Vertices, VertexSize, b);
+        v3 p2 = GetPosition(Vertices, VertexSize, c);
+        v3 Before = CrossV3(SubV3(p1, p0), SubV3(p2, p0));
+        if(a == From) p0 = Target;
+        if(b == From) p1 = Target;
+        if(c == From) p2 = Target;
+        v3 After = CrossV3(SubV3(p1, p0), SubV3(p2, p0));
+        r32 Dot = InnerV3(Before, After);
+        if(Dot <= 0.0f || Dot * Dot < MESH_SIMPLIFY_MIN_NORMAL_COS2 * LengthSquaredV3(Before) * LengthSquaredV3(After))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// NOTE: Three pass radix sort on the float bits of the cost, costs are never negative
+static void SortCollapses(simplify_scratch* Scratch, u32 Count)
+{
+    collapse* Source = Scratch->Collapses;
+    collapse* Dest   = Scratch->SortTemp;
+    for(u32 Shift = 0;
+        Shift < 32;
+        Shift += 11)
+    {
+        u32 Histogram[2048];
+        ZeroMemory(Histogram, sizeof(Histogram));
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            u32 Bits = *(u32*)&Source[Index].Cost;
+            Histogram[(Bits >> Shift) & 2047]++;
+        }
+
+        u32 Sum = 0;
+        for(u32 Bucket = 0;
+            Bucket < 2048;
+            ++Bucket)
+        {
+            u32 BucketCount = Histogram[Bucket];
+            Histogram[Bucket] = Sum;
+            Sum += BucketCount;
+        }
+
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            u32 Bits = *(u32*)&Source[Index].Cost;
+            Dest[Histogram[(Bits >> Shift) & 2047]++] = Source[Index];
+        }
+
+        collapse* Temp = Source;
+        Source = Dest;
+        Dest = Temp;
+    }
+
+    if(Source != Scratch->Collapses)
+    {
+        CopyMemory(Scratch->Collapses, Source, sizeof(collapse) * Count);
+    }
+}
+
+u32 MeshSimplify(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                 u32 TargetIndexCount, r32 TargetError, u32* OutIndices, r32* OutError)
+{
+    IndexCount -= IndexCount % 3;
+    if(OutError)
+    {
+        *OutError = 0.0f;
+    }
+    if(IndexCount == 0 || VertexCount == 0)
+    {
+        return 0;
+    }
+
+    simplify_scratch Scratch;
+    CreateScratch(&Scratch, VertexCount, IndexCount);
+    BuildGroups(&Scratch, Vertices, VertexSize, VertexCount);
+
+    // NOTE: Vertices outside seams are replaced by their group so collapses only have to move one index
+    u32 Count = 0;
+    for(u32 Index = 0;
+        Index < IndexCount;
+        ++Index)
+    {
+        u32 Vertex = Indices[Index] < VertexCount ? Indices[Index] : 0;
+        u32 Group  = Scratch.Group[Vertex];
+        OutIndices[Count++] = Scratch.Seam[Group] ? Vertex : Group;
+    }
+
+    for(u32 Vertex = 0;
+        Vertex < VertexCount;
+        ++Vertex)
+    {
+        Scratch.Redirect[Vertex] = Vertex;
+    }
+    ZeroMemory(Scratch.Quadrics, sizeof(quadric) * VertexCount);
+
+    // NOTE: Surface quadrics weighted by triangle area
+    for(u32 Index = 0;
+        Index < Count;
+        Index += 3)
+    {
+        u32 a = Scratch.Group[OutIndices[Index + 0]];
+        u32 b = Scratch.Group[OutIndices[Index + 1]];
+        u32 c = Scratch.Group[OutIndices[Index + 2]];
+        v3 p0 = GetPosition(Vertices, VertexSize, a);
+        v3 Normal = CrossV3(SubV3(GetPosition(Vertices, VertexSize, b), p0), SubV3(GetPosition(Vertices, VertexSize, c), p0));
+        r32 Length = SquareRoot(LengthSquaredV3(Normal));
+        if(Length <= 0.0f)
+        {
+            continue;
+        }
+
+        Normal = MulV3(Normal, V3(1.0f / Length, 1.0f / Length, 1.0f / Length));
+        quadric Q;
+        QuadricFromPlane(&Q, Normal, -InnerV3(Normal, p0), 0.5f * Length);
+        QuadricAdd(&Scratch.Quadrics[a], &Q);
+        QuadricAdd(&Scratch.Quadrics[b], &Q);
+        QuadricAdd(&Scratch.Quadrics[c], &Q);
+    }
+
+    r32 MaxCost = 0.0f;
+    r32 CostLimit = TargetError * TargetError;
+    for(u32 Pass = 0;
+        Pass < MESH_SIMPLIFY_MAX_PASSES;
+        ++Pass)
+    {
+        // NOTE: Drop triangles the last pass collapsed
+        u32 Kept = 0;
+        for(u32 Index = 0;
+            Index < Count;
+            Index += 3)
+        {
+            u32 a = Scratch.Group[OutIndices[Index + 0]];
+            u32 b = Scratch.Group[OutIndices[Index + 1]];
+            u32 c = Scratch.Group[OutIndices[Index + 2]];
+            if(a != b && b != c && c != a)
+            {
+                OutIndices[Kept + 0] = OutIndices[Index + 0];
+                OutIndices[Kept + 1] = OutIndices[Index + 1];
+                OutIndices[Kept + 2] = OutIndices[Index + 2];
+                Kept += 3;
+            }
+        }
+        Count = Kept;
+
+        if(Count <= TargetIndexCount)
+        {
+            break;
+        }
+
+        SetMemory(Scratch.EdgeKeys, 0xFF, sizeof(u64) * Scratch.EdgeCapacity);
+        ZeroMemory(Scratch.OpenEdges, sizeof(u32) * VertexCount);
+        ZeroMemory(Scratch.Touched, VertexCount);
+        ZeroMemory(Scratch.AdjacencyOffsets, sizeof(u32) * (VertexCount + 1));
+
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            u32 From = Scratch.Group[OutIndices[Index]];
+            u32 To   = Scratch.Group[OutIndices[Index - Index % 3 + (Index + 1) % 3]];
+            u32 Slot = EdgeFind(&Scratch, From, To);
+            if(Scratch.EdgeKeys[Slot] == (u64)-1)
+            {
+                Scratch.EdgeKeys[Slot] = ((u64)From << 32) | To;
+                Scratch.EdgeCounts[Slot] = 0;
+            }
+            Scratch.EdgeCounts[Slot]++;
+            Scratch.AdjacencyOffsets[From]++;
+        }
+
+        // NOTE: Offsets become range ends here and range starts once the triangles are filled in
+        u32 AdjacencySum = 0;
+        for(u32 Vertex = 0;
+            Vertex < VertexCount;
+            ++Vertex)
+        {
+            AdjacencySum += Scratch.AdjacencyOffsets[Vertex];
+            Scratch.AdjacencyOffsets[Vertex] = AdjacencySum;
+            Scratch.Kind[Vertex] = Scratch.Seam[Vertex] ? VERTEX_KIND_LOCKED : VERTEX_KIND_MANIFOLD;
+        }
+
+        Scratch.AdjacencyOffsets[VertexCount] = AdjacencySum;
+
+        // NOTE: Classify, an edge without its reverse is open. Non manifold edges and vertices on more than
+        // one border loop are locked.
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            u32 From = Scratch.Group[OutIndices[Index]];
+            u32 To   = Scratch.Group[OutIndices[Index - Index % 3 + (Index + 1) % 3]];
+            Scratch.Adjacency[--Scratch.AdjacencyOffsets[From]] = Index / 3;
+
+            if(EdgeCount(&Scratch, From, To) > 1 || EdgeCount(&Scratch, To, From) > 1)
+            {
+                Scratch.Kind[From] = VERTEX_KIND_LOCKED;
+                Scratch.Kind[To]   = VERTEX_KIND_LOCKED;
+            }
+            else if(EdgeCount(&Scratch, To, From) == 0)
+            {
+                Scratch.OpenEdges[From]++;
+                Scratch.OpenEdges[To]++;
+            }
+        }
+
+        for(u32 Vertex = 0;
+            Vertex < VertexCount;
+            ++Vertex)
+        {
+            if(Scratch.Kind[Vertex] == VERTEX_KIND_MANIFOLD && Scratch.OpenEdges[Vertex])
+            {
+                Scratch.Kind[Vertex] = Scratch.OpenEdges[Vertex] == 2 ? VERTEX_KIND_BORDER : VERTEX_KIND_LOCKED;
+            }
+        }
+
+        // NOTE: Planes standing on the open edges of the input hold the border in place
+        if(Pass == 0)
+        {
+            for(u32 Index = 0;
+                Index < Count;
+                ++Index)
+            {
+                u32 Base = Index - Index % 3;
+                u32 From = Scratch.Group[OutIndices[Index]];
+                u32 To   = Scratch.Group[OutIndices[Base + (Index + 1) % 3]];
+                u32 Opposite = Scratch.Group[OutIndices[Base + (Index + 2) % 3]];
+                if(EdgeCount(&Scratch, To, From) != 0)
+                {
+                    continue;
+                }
+
+                v3 p0 = GetPosition(Vertices, VertexSize, From);
+                v3 Edge = SubV3(GetPosition(Vertices, VertexSize, To), p0);
+                v3 Normal = CrossV3(Edge, SubV3(GetPosition(Vertices, VertexSize, Opposite), p0));
+                v3 PlaneNormal = CrossV3(Edge, Normal);
+                r32 Length = SquareRoot(LengthSquaredV3(PlaneNormal));
+                if(Length <= 0.0f)
+                {
+                    continue;
+                }
+
+                PlaneNormal = MulV3(PlaneNormal, V3(1.0f / Length, 1.0f / Length, 1.0f / Length));
+                quadric Q;
+                QuadricFromPlane(&Q, PlaneNormal, -InnerV3(PlaneNormal, p0), LengthSquaredV3(Edge) * MESH_SIMPLIFY_BORDER_WEIGHT);
+                QuadricAdd(&Scratch.Quadrics[From], &Q);
+                QuadricAdd(&Scratch.Quadrics[To], &Q);
+            }
+        }
+
+        // NOTE: Each edge once, in the cheaper allowed direction
+        u32 CollapseCount = 0;
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            u32 a = Scratch.Group[OutIndices[Index]];
+            u32 b = Scratch.Group[OutIndices[Index - Index % 3 + (Index + 1) % 3]];
+            if(a > b && EdgeCount(&Scratch, b, a) > 0)
+            {
+                continue;
+            }
+
+            quadric Q = Scratch.Quadrics[a];
+            QuadricAdd(&Q, &Scratch.Quadrics[b]);
+
+            collapse Best = {INVALID_ID, INVALID_ID, INFINITY};
+            if(CanCollapse(&Scratch, a, b))
+            {
+                Best.From = a;
+                Best.To   = b;
+                Best.Cost = QuadricError(&Q, GetPosition(Vertices, VertexSize, b));
+            }
+            if(CanCollapse(&Scratch, b, a))
+            {
+                r32 Cost = QuadricError(&Q, GetPosition(Vertices, VertexSize, a));
+                if(Cost < Best.Cost)
+                {
+                    Best.From = b;
+                    Best.To   = a;
+                    Best.Cost = Cost;
+                }
+            }
+
+            if(Best.From != INVALID_ID && Best.Cost <= CostLimit)
+            {
+                Scratch.Collapses[CollapseCount++] = Best;
+            }
+        }
+
+        SortCollapses(&Scratch, CollapseCount);
+
+        // NOTE: Cheapest first. Everything around a collapse is frozen for the rest of the pass so the flip
+        // checks stay valid.
+        u32 TrianglesLeft = Count / 3;
+        u32 TargetTriangles = TargetIndexCount / 3;
+        u32 Applied = 0;
+        for(u32 Index = 0;
+            Index < CollapseCount && TrianglesLeft > TargetTriangles;
+            ++Index)
+        {
+            collapse* Collapse = &Scratch.Collapses[Index];
+            if(Scratch.Touched[Collapse->From] || Scratch.Touched[Collapse->To])
+            {
+                continue;
+            }
+
+            if(CollapseFlips(&Scratch, Vertices, VertexSize, OutIndices, Collapse->From, Collapse->To))
+            {
+                continue;
+            }
+
+            Scratch.Redirect[Collapse->From] = Collapse->To;
+            QuadricAdd(&Scratch.Quadrics[Collapse->To], &Scratch.Quadrics[Collapse->From]);
+
+            for(u32 At = Scratch.AdjacencyOffsets[Collapse->From];
+                At < Scratch.AdjacencyOffsets[Collapse->From + 1];
+                ++At)
+            {
+                const u32* Triangle = OutIndices + Scratch.Adjacency[At] * 3;
+                Scratch.Touched[Scratch.Group[Triangle[0]]] = true;
+                Scratch.Touched[Scratch.Group[Triangle[1]]] = true;
+                Scratch.Touched[Scratch.Group[Triangle[2]]] = true;
+            }
+
+            u32 Removed = Scratch.Kind[Collapse->From] == VERTEX_KIND_BORDER ? 1 : 2;
+            TrianglesLeft = TrianglesLeft > Removed ? TrianglesLeft - Removed : 0;
+            MaxCost = Collapse->Cost > MaxCost ? Collapse->Cost : MaxCost;
+            Applied++;
+        }
+
+        if(Applied == 0)
+        {
+            break;
+        }
+
+        for(u32 Index = 0;
+            Index < Count;
+            ++Index)
+        {
+            OutIndices[Index] = Scratch.Redirect[OutIndices[Index]];
+        }
+    }
+
+    DestroyScratch(&Scratch);
+
+    if(OutError)
+    {
+        *OutError = SquareRoot(MaxCost);
+    }
+    return Count;
+}
+
+u32 MeshBuildLods(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                  u32 LodCount, r32 Ratio, r32 MaxError, u32* OutIndices, u32* OutLodIndexCounts, r32* OutLodErrors)
+{
+    if(LodCount == 0)
+    {
+        return 0;
+    }
+
+    IndexCount -= IndexCount % 3;
+    CopyMemory(OutIndices, Indices, sizeof(u32) * IndexCount);
+    OutLodIndexCounts[0] = IndexCount;
+    OutLodErrors[0] = 0.0f;
+
+    u32 Offset = 0;
+    u32 Produced = 1;
+    for(u32 Lod = 1;
+        Lod < LodCount;
+        ++Lod)
+    {
+        u32 SourceCount = OutLodIndexCounts[Lod - 1];
+        u32 Target = (u32)((r32)SourceCount * Ratio);
+        Target -= Target % 3;
+
+        r32 Error = 0.0f;
+        u32* Dest = OutIndices + Offset + SourceCount;
+        u32 Count = MeshSimplify(Vertices, VertexSize, VertexCount, OutIndices + Offset, SourceCount, Target, MaxError, Dest, &Error);
+
+        // NOTE: A LOD that barely saves anything is not worth its index range
+        if(Count == 0 || (u64)Count * 8 > (u64)SourceCount * 7)
+        {
+            break;
+        }
+
+        Offset += SourceCount;
+        OutLodIndexCounts[Lod] = Count;
+        OutLodErrors[Lod] = OutLodErrors[Lod - 1] + Error;
+        Produced++;
+    }
+
+    return Produced;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "defines.h"
+
+// NOTE: Quadric error edge collapse simplifier. Only the index data changes: every collapse moves a vertex onto a
+// neighbour that already exists, so all LODs of a mesh share one vertex range. Vertices are VertexSize bytes and
+// start with 3 float positions. Open borders only collapse along themselves and attribute seams (same position,
+// different vertex data) are kept, so UVs and normals do not tear.
+// Errors are object space distances, the root mean square over the planes around each collapsed vertex, so
+// single points may move a few times further than the error says.
+
+// NOTE: Simplifies until TargetIndexCount is reached or the next collapse would move the surface by more than
+// TargetError. OutIndices needs room for IndexCount indices and may not alias Indices. Returns the index count.
+VENG_API u32 MeshSimplify(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                          u32 TargetIndexCount, r32 TargetError, u32* OutIndices, r32* OutError);
+
+// NOTE: Writes up to LodCount index ranges back to back into OutIndices, LOD 0 is a copy of Indices and every next
+// one aims for Ratio of the previous index count. Errors add up along the chain. OutIndices needs room for
+// IndexCount * LodCount indices. Returns how many LODs were made, fewer when the mesh stops simplifying.
+VENG_API u32 MeshBuildLods(const void* Vertices, u32 VertexSize, u32 VertexCount, const u32* Indices, u32 IndexCount,
+                           u32 LodCount, r32 Ratio, r32 MaxError, u32* OutIndices, u32* OutLodIndexCounts, r32* OutLodErrors);
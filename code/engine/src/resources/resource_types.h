@@ -5,6 +5,7 @@
 #define TEXTURE_NAME_MAX_LENGHT  512
 #define MATERIAL_NAME_MAX_LENGTH 256
 #define GEOMETRY_NAME_MAX_LENGTH 256
+#define GEOMETRY_MAX_LODS 4
 
 typedef enum resource_type
 {
@@ -84,6 +85,39 @@ typedef struct material_config
     char DiffuseMapName[TEXTURE_NAME_MAX_LENGHT];
 } material_config;
 
+typedef struct geometry_config
+{
+    vertex_format VertexFormat;
+    u32 VertexSize;
+    u32 VertexCount;
+    void* Vertices;
+
+    u32 IndexSize;
+    u32 IndexCount;
+    void* Indices;
+
+    // NOTE: With LodCount > 0, Indices holds the levels back to back from full detail down and
+    // LodIndexCounts add up to IndexCount. 0 makes the whole index range the only level.
+    u32 LodCount;
+    u32 LodIndexCounts[GEOMETRY_MAX_LODS];
+    r32 LodErrors[GEOMETRY_MAX_LODS];
+
+    // NOTE: Only read for VERTEX_FORMAT_3D_PACKED vertices, the box their unorm positions span
+    extents_3d PositionExtents;
+
+    char Name[GEOMETRY_NAME_MAX_LENGTH];
+    char MaterialName[MATERIAL_NAME_MAX_LENGTH];
+} geometry_config;
+
+// NOTE: One level of detail, a range of the geometry's index data. All levels share the vertices.
+typedef struct geometry_lod
+{
+    u32 FirstIndex;
+    u32 IndexCount;
+    // NOTE: Object space distance the level can be off from the full mesh, 0 for level 0
+    r32 Error;
+} geometry_lod;
+
 typedef struct geometry
 {
     u32 ID;
@@ -91,5 +125,25 @@ typedef struct geometry
     u32 Generation;
     char Name[GEOMETRY_NAME_MAX_LENGTH];
     material* Material;
+
+    // NOTE: Local space bounds of the vertex positions, the sphere is centered on the box
+    extents_3d Extents;
+    v3 Center;
+    r32 Radius;
+
+    // NOTE: Level 0 is the full mesh, coarser levels follow
+    u32 LodCount;
+    geometry_lod Lods[GEOMETRY_MAX_LODS];
 } geometry;
 
+// NOTE: A cooked .vsm mesh, one config per submesh. The vertex and index pointers point into the loaded file,
+// so acquire the geometries before unloading the resource.
+typedef struct static_mesh_resource_data
+{
+    extents_3d Extents;
+    u32 GeometryCount;
+    geometry_config* Configs;
+
+    void* FileData;
+    u64 FileDataSize;
+} static_mesh_resource_data;
@@ -3,8 +3,13 @@
 #include "core/logger.h"
 #include "core/vmemory.h"
 #include "core/vstring.h"
+#include "math/vmath.h"
 #include "systems/material_system.h"
 #include "renderer/renderer_frontend.h"
+#include "resources/mesh_simplify.h"
+#include "resources/mesh_optimize.h"
+#include "resources/mesh_quantize.h"
+#include "resources/mesh_generate.h"
 
 typedef struct geometry_reference
 {
@@ -24,6 +29,123 @@ typedef struct geometry_system_state
 static geometry_system_state* StatePtr = 0;
 
 b8 CreateDefaultGeometries(geometry_system_state* State);
+
+// NOTE: Every vertex format starts with its position, vertex_2d positions get z = 0
+static void ComputeBounds(geometry* Geometry, vertex_format VertexFormat, u32 VertexSize, u32 VertexCount, const void* Vertices)
+{
+    b8 Is2d = VertexFormat == VERTEX_FORMAT_2D;
+    extents_3d Extents = {{{INFINITY, INFINITY, INFINITY}}, {{-INFINITY, -INFINITY, -INFINITY}}};
+    for(u32 Index = 0;
+        Index < VertexCount;
+        ++Index)
+    {
+        const r32* Position = (const r32*)((const u8*)Vertices + (u64)Index * VertexSize);
+        v3 P = V3(Position[0], Position[1], Is2d ? 0.0f : Position[2]);
+        Extents.Min = V3(P.x < Extents.Min.x ? P.x : Extents.Min.x, P.y < Extents.Min.y ? P.y : Extents.Min.y, P.z < Extents.Min.z ? P.z : Extents.Min.z);
+        Extents.Max = V3(P.x > Extents.Max.x ? P.x : Extents.Max.x, P.y > Extents.Max.y ? P.y : Extents.Max.y, P.z > Extents.Max.z ? P.z : Extents.Max.z);
+    }
+
+    if(VertexCount == 0)
+    {
+        Extents.Min = V3Zero();
+        Extents.Max = V3Zero();
+    }
+
+    // NOTE: The sphere is centered on the box, the radius reaches the farthest vertex, not the box corner
+    v3 Center = MulV3(AddV3(Extents.Min, Extents.Max), V3(0.5f, 0.5f, 0.5f));
+    r32 RadiusSquared = 0.0f;
+    for(u32 Index = 0;
+        Index < VertexCount;
+        ++Index)
+    {
+        const r32* Position = (const r32*)((const u8*)Vertices + (u64)Index * VertexSize);
+        v3 Offset = SubV3(V3(Position[0], Position[1], Is2d ? 0.0f : Position[2]), Center);
+        r32 DistanceSquared = LengthSquaredV3(Offset);
+        RadiusSquared = DistanceSquared > RadiusSquared ? DistanceSquared : RadiusSquared;
+    }
+
+    Geometry->Extents = Extents;
+    Geometry->Center  = Center;
+    Geometry->Radius  = SquareRoot(RadiusSquared);
+}
+
+// NOTE: Packed positions span the extents they were quantized against, the box is taken as is
+static void SetPackedBounds(geometry* Geometry, extents_3d Extents)
+{
+    Geometry->Extents = Extents;
+    Geometry->Center  = MulV3(AddV3(Extents.Min, Extents.Max), V3(0.5f, 0.5f, 0.5f));
+    Geometry->Radius  = SquareRoot(LengthSquaredV3(SubV3(Extents.Max, Geometry->Center)));
+}
+// NOTE: Lays the levels out back to back, a config without levels or with counts that do not add up gets one level
+static void SetLods(geometry* Geometry, u32 IndexCount, u32 LodCount, const u32* LodIndexCounts, const r32* LodErrors)
+{
+    u32 Total = 0;
+    for(u32 Lod = 0;
+        Lod < LodCount && Lod < GEOMETRY_MAX_LODS;
+        ++Lod)
+    {
+        Total += LodIndexCounts[Lod];
+    }
+
+    if(LodCount == 0 || LodCount > GEOMETRY_MAX_LODS || Total != IndexCount)
+    {
+        if(LodCount > 0)
+        {
+            VENG_WARN("Geometry '%s' has invalid LODs (%u levels, %u of %u indices), using the full mesh only.", Geometry->Name, LodCount, Total, IndexCount);
+        }
+
+        Geometry->LodCount = 1;
+        Geometry->Lods[0].FirstIndex = 0;
+        Geometry->Lods[0].IndexCount = IndexCount;
+        Geometry->Lods[0].Error = 0.0f;
+        return;
+    }
+
+    u32 FirstIndex = 0;
+    Geometry->LodCount = LodCount;
+    for(u32 Lod = 0;
+        Lod < LodCount;
+        ++Lod)
+    {
+        Geometry->Lods[Lod].FirstIndex = FirstIndex;
+        Geometry->Lods[Lod].IndexCount = LodIndexCounts[Lod];
+        Geometry->Lods[Lod].Error = LodErrors[Lod];
+        FirstIndex += LodIndexCounts[Lod];
+    }
+}
+
+// NOTE: Meshes small enough for 16 bit indices get them, half the index memory and bandwidth. Returns 0 when the
+// config indices go up as they are, otherwise a MEMORY_TAG_ARRAY copy of IndexCount u16s.
+static u16* NarrowIndices(const geometry_config* Config)
+{
+    if(Config->IndexSize != sizeof(u32) || !Config->Indices || Config->VertexCount > 65536)
+    {
+        return 0;
+    }
+
+    u16* Narrow = Allocate(sizeof(u16) * Config->IndexCount, MEMORY_TAG_ARRAY);
+    for(u32 Index = 0;
+        Index < Config->IndexCount;
+        ++Index)
+    {
+        Narrow[Index] = (u16)((u32*)Config->Indices)[Index];
+    }
+
+    return Narrow;
+}
+
+static void SetBounds(geometry* Geometry, const geometry_config* Config)
+{
+    if(Config->VertexFormat == VERTEX_FORMAT_3D_PACKED)
+    {
+        SetPackedBounds(Geometry, Config->PositionExtents);
+    }
+    else
+    {
+        ComputeBounds(Geometry, Config->VertexFormat, Config->VertexSize, Config->VertexCount, Config->Vertices);
+    }
+}
+
 b8 CreateGeometry(geometry_system_state* State, geometry_config Config, geometry* Geometry);
 void DestroyGeometry(geometry_system_state* State, geometry* Geometry);
 
@@ -151,6 +273,40 @@ void GeometrySystemRelease(geometry* Geometry)
     VENG_WARN("GeometrySystemRelease cannot load invalid geometry id. Nothing was done.");
 }
 
+b8 GeometrySystemUpdate(geometry* Geometry, geometry_config Config)
+{
+    if(!Geometry || Geometry->ID == INVALID_ID || !Config.Vertices)
+    {
+        VENG_WARN("GeometrySystemUpdate cannot update invalid geometry or without vertices. Nothing was done.");
+        return false;
+    }
+
+    // NOTE: Narrowed the same way as on creation so the index layout matches the upload
+    u16* Narrow = NarrowIndices(&Config);
+
+    b8 Updated = Narrow ?
+        RendererUpdateGeometry(Geometry, Config.VertexFormat, Config.VertexSize, Config.VertexCount, Config.Vertices, sizeof(u16), Config.IndexCount, Narrow) :
+        RendererUpdateGeometry(Geometry, Config.VertexFormat, Config.VertexSize, Config.VertexCount, Config.Vertices, Config.IndexSize, Config.IndexCount, Config.Indices);
+
+    if(Narrow)
+    {
+        Free(Narrow, sizeof(u16) * Config.IndexCount, MEMORY_TAG_ARRAY);
+    }
+
+    if(!Updated)
+    {
+        return false;
+    }
+
+    SetBounds(Geometry, &Config);
+    if(Config.Indices)
+    {
+        SetLods(Geometry, Config.IndexCount, Config.LodCount, Config.LodIndexCounts, Config.LodErrors);
+    }
+
+    return true;
+}
+
 geometry* GeometrySystemGetDefault()
 {
     if(StatePtr)
@@ -175,7 +331,18 @@ geometry* GeometrySystemGetDefault2d()
 
 b8 CreateGeometry(geometry_system_state* State, geometry_config Config, geometry* Geometry)
 {
-    if(!RendererCreateGeometry(Geometry, Config.VertexSize, Config.VertexCount, Config.Vertices, Config.VertexSize, Config.IndexCount, Config.Indices))
+    u16* Narrow = NarrowIndices(&Config);
+
+    b8 Created = Narrow ?
+        RendererCreateGeometry(Geometry, Config.VertexFormat, Config.VertexSize, Config.VertexCount, Config.Vertices, sizeof(u16), Config.IndexCount, Narrow) :
+        RendererCreateGeometry(Geometry, Config.VertexFormat, Config.VertexSize, Config.VertexCount, Config.Vertices, Config.IndexSize, Config.IndexCount, Config.Indices);
+
+    if(Narrow)
+    {
+        Free(Narrow, sizeof(u16) * Config.IndexCount, MEMORY_TAG_ARRAY);
+    }
+
+    if(!Created)
     {
         State->RegisteredGeometries[Geometry->ID].ReferenceCount = 0;
         State->RegisteredGeometries[Geometry->ID].AutoRelease = false;
@@ -187,6 +354,9 @@ b8 CreateGeometry(geometry_system_state* State, geometry_config Config, geometry
         return false;
     }
 
+    SetBounds(Geometry, &Config);
+    SetLods(Geometry, Config.IndexCount, Config.LodCount, Config.LodIndexCounts, Config.LodErrors);
+
     if(StringLength(Config.MaterialName) > 0)
     {
         Geometry->Material = MaterialSystemAcquire(Config.MaterialName);
@@ -243,12 +413,14 @@ b8 CreateDefaultGeometries(geometry_system_state* State)
 
     u32 Indices[6] = {0, 1, 2, 0, 3, 1};
 
-    if(!RendererCreateGeometry(&State->DefaultGeometry, sizeof(vertex_3d), 4, Verts, sizeof(u32), 6, Indices))
+    if(!RendererCreateGeometry(&State->DefaultGeometry, VERTEX_FORMAT_3D, sizeof(vertex_3d), 4, Verts, sizeof(u32), 6, Indices))
     {
         VENG_FATAL("Failed to create default 3d geometry. Application cannot continue.");
         return false;
     }
 
+    ComputeBounds(&State->DefaultGeometry, VERTEX_FORMAT_3D, sizeof(vertex_3d), 4, Verts);
+    SetLods(&State->DefaultGeometry, 6, 0, 0, 0);
     State->DefaultGeometry.Material = MaterialSystemGetDefault();
 
     vertex_2d Verts2d[4];
@@ -276,17 +448,123 @@ b8 CreateDefaultGeometries(geometry_system_state* State)
 
     u32 Indices2d[6] = {2, 1, 0, 3, 0, 1};
 
-    if(!RendererCreateGeometry(&State->DefaultGeometry2d, sizeof(vertex_2d), 4, Verts2d, sizeof(u32), 6, Indices2d))
+    if(!RendererCreateGeometry(&State->DefaultGeometry2d, VERTEX_FORMAT_2D, sizeof(vertex_2d), 4, Verts2d, sizeof(u32), 6, Indices2d))
     {
         VENG_FATAL("Failed to create default 2d geometry. Application cannot continue.");
         return false;
     }
 
+    ComputeBounds(&State->DefaultGeometry2d, VERTEX_FORMAT_2D, sizeof(vertex_2d), 4, Verts2d);
+    SetLods(&State->DefaultGeometry2d, 6, 0, 0, 0);
     State->DefaultGeometry2d.Material = MaterialSystemGetDefault();
 
     return true;
 }
 
+b8 GeometrySystemGenerateLods(geometry_config* Config, u32 LodCount, r32 Ratio, r32 MaxError)
+{
+    if(Config->IndexSize != sizeof(u32) || Config->VertexFormat != VERTEX_FORMAT_3D || !Config->Indices || !Config->Vertices)
+    {
+        VENG_ERROR("GeometrySystemGenerateLods - needs unpacked 3d vertices and 32 bit indices.");
+        return false;
+    }
+
+    if(LodCount > GEOMETRY_MAX_LODS)
+    {
+        LodCount = GEOMETRY_MAX_LODS;
+    }
+
+    u64 ScratchSize = sizeof(u32) * (u64)Config->IndexCount * LodCount;
+    u32* Scratch = Allocate(ScratchSize, MEMORY_TAG_ARRAY);
+    u32 Made = MeshBuildLods(Config->Vertices, Config->VertexSize, Config->VertexCount, Config->Indices, Config->IndexCount,
+                             LodCount, Ratio, MaxError, Scratch, Config->LodIndexCounts, Config->LodErrors);
+
+    u32 Total = 0;
+    for(u32 Lod = 0;
+        Lod < Made;
+        ++Lod)
+    {
+        Total += Config->LodIndexCounts[Lod];
+    }
+
+    Free(Config->Indices, sizeof(u32) * Config->IndexCount, MEMORY_TAG_ARRAY);
+    Config->Indices = Allocate(sizeof(u32) * Total, MEMORY_TAG_ARRAY);
+    CopyMemory(Config->Indices, Scratch, sizeof(u32) * Total);
+    Free(Scratch, ScratchSize, MEMORY_TAG_ARRAY);
+
+    Config->IndexCount = Total;
+    Config->LodCount = Made;
+    return true;
+}
+
+b8 GeometrySystemOptimizeConfig(geometry_config* Config)
+{
+    if(Config->IndexSize != sizeof(u32) || Config->VertexFormat != VERTEX_FORMAT_3D || !Config->Indices || !Config->Vertices)
+    {
+        VENG_ERROR("GeometrySystemOptimizeConfig - needs unpacked 3d vertices and 32 bit indices.");
+        return false;
+    }
+
+    u32* Indices = (u32*)Config->Indices;
+    u32 Lod0IndexCount = Config->LodCount > 0 ? Config->LodIndexCounts[0] : Config->IndexCount;
+    mesh_cache_stats Before = MeshAnalyzeVertexCache(Indices, Lod0IndexCount, Config->VertexCount, MESH_VERTEX_CACHE_SIZE);
+
+    u32 OldVertexCount = Config->VertexCount;
+    u32 VertexCount = MeshRemoveDuplicateVertices(Config->Vertices, Config->VertexSize, Config->VertexCount, Indices, Config->IndexCount);
+
+    // NOTE: Every level is ordered on its own, they are drawn separately
+    u32* Scratch = Allocate(sizeof(u32) * Config->IndexCount, MEMORY_TAG_ARRAY);
+    u32 LodCount = Config->LodCount > 0 ? Config->LodCount : 1;
+    u32 FirstIndex = 0;
+    for(u32 Lod = 0;
+        Lod < LodCount;
+        ++Lod)
+    {
+        u32 Count = Config->LodCount > 0 ? Config->LodIndexCounts[Lod] : Config->IndexCount;
+        MeshOptimizeVertexCache(Indices + FirstIndex, Count, VertexCount, MESH_VERTEX_CACHE_SIZE, Scratch);
+        MeshOptimizeOverdraw(Config->Vertices, Config->VertexSize, VertexCount, Scratch, Count, MESH_VERTEX_CACHE_SIZE, 1.05f, Indices + FirstIndex);
+        FirstIndex += Count;
+    }
+    Free(Scratch, sizeof(u32) * Config->IndexCount, MEMORY_TAG_ARRAY);
+
+    void* Vertices = Allocate((u64)Config->VertexSize * VertexCount, MEMORY_TAG_ARRAY);
+    u32 UsedVertexCount = MeshOptimizeVertexFetch(Config->Vertices, Config->VertexSize, VertexCount, Indices, Config->IndexCount, Vertices);
+    if(UsedVertexCount != VertexCount)
+    {
+        void* Trimmed = Allocate((u64)Config->VertexSize * UsedVertexCount, MEMORY_TAG_ARRAY);
+        CopyMemory(Trimmed, Vertices, (u64)Config->VertexSize * UsedVertexCount);
+        Free(Vertices, (u64)Config->VertexSize * VertexCount, MEMORY_TAG_ARRAY);
+        Vertices = Trimmed;
+    }
+
+    Free(Config->Vertices, (u64)Config->VertexSize * OldVertexCount, MEMORY_TAG_ARRAY);
+    Config->Vertices = Vertices;
+    Config->VertexCount = UsedVertexCount;
+
+    mesh_cache_stats After = MeshAnalyzeVertexCache(Indices, Lod0IndexCount, Config->VertexCount, MESH_VERTEX_CACHE_SIZE);
+    VENG_INFO("Geometry '%s' optimized: %u -> %u vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+              Config->Name, OldVertexCount, Config->VertexCount, Before.ACMR, After.ACMR, Before.ATVR, After.ATVR);
+    return true;
+}
+
+b8 GeometrySystemPackConfig(geometry_config* Config)
+{
+    if(Config->VertexFormat != VERTEX_FORMAT_3D || !Config->Vertices)
+    {
+        VENG_ERROR("GeometrySystemPackConfig - needs unpacked 3d vertices.");
+        return false;
+    }
+
+    vertex_3d_packed* Packed = Allocate(sizeof(vertex_3d_packed) * Config->VertexCount, MEMORY_TAG_ARRAY);
+    Config->PositionExtents = MeshPackVertices(Config->Vertices, Config->VertexCount, Packed);
+
+    Free(Config->Vertices, sizeof(vertex_3d) * Config->VertexCount, MEMORY_TAG_ARRAY);
+    Config->Vertices = Packed;
+    Config->VertexFormat = VERTEX_FORMAT_3D_PACKED;
+    Config->VertexSize = sizeof(vertex_3d_packed);
+    return true;
+}
+
 geometry_config GeometrySystemGeneratePlaneConfig(r32 Width, r32 Height, u32 SegmentCountX, u32 SegmentCountY, r32 TileX, r32 TileY, const char* Name, const char* MaterialName)
 {
     if(Width == 0)
@@ -319,72 +597,20 @@ geometry_config GeometrySystemGeneratePlaneConfig(r32 Width, r32 Height, u32 Seg
         TileY = 1.0f;
     }
 
+    mesh_generate_size Size = MeshPlaneSize(SegmentCountX, SegmentCountY);
+
     geometry_config Config;
+    Config.VertexFormat = VERTEX_FORMAT_3D;
     Config.VertexSize = sizeof(vertex_3d);
-    Config.VertexCount = SegmentCountX * SegmentCountY * 4;
+    Config.VertexCount = Size.VertexCount;
     Config.Vertices = Allocate(sizeof(vertex_3d) * Config.VertexCount, MEMORY_TAG_ARRAY);
 
     Config.IndexSize = sizeof(u32);
-    Config.IndexCount = SegmentCountX * SegmentCountY * 6;
+    Config.IndexCount = Size.IndexCount;
     Config.Indices = Allocate(sizeof(u32) * Config.IndexCount, MEMORY_TAG_ARRAY);
+    Config.LodCount = 0;
 
-    r32 SegmentWidth  = Width / SegmentCountX;
-    r32 SegmentHeight = Height / SegmentCountY;
-    r32 HalfWidth = 0.5f * SegmentWidth;
-    r32 HalfHeight = 0.5f * SegmentHeight;
-    for(u32 y = 0;
-        y < SegmentCountY;
-        ++y)
-    {
-        for(u32 x = 0;
-            x < SegmentCountX;
-            ++x)
-        {
-            r32 MinX = (x * SegmentWidth) - HalfWidth;
-            r32 MinY = (y * SegmentHeight) - HalfHeight;
-            r32 MaxX = MinX + SegmentWidth;
-            r32 MaxY = MinY + SegmentHeight;
-
-            r32 MinCoordX = (x / (r32)SegmentCountX) * TileX;
-            r32 MinCoordY = (y / (r32)SegmentCountY) * TileY;
-            r32 MaxCoordX = ((x+1) / (r32)SegmentCountX) * TileX;
-            r32 MaxCoordY = ((y+1) / (r32)SegmentCountY) * TileY;
-
-            u32 OffsetV = ((y * SegmentCountY) + x) * 4;
-            vertex_3d* v0 = &((vertex_3d*)Config.Vertices)[OffsetV + 0];
-            vertex_3d* v1 = &((vertex_3d*)Config.Vertices)[OffsetV + 1];
-            vertex_3d* v2 = &((vertex_3d*)Config.Vertices)[OffsetV + 2];
-            vertex_3d* v3 = &((vertex_3d*)Config.Vertices)[OffsetV + 3];
-
-            v0->Position.x = MinX;
-            v0->Position.y = MinY;
-            v0->TexCoord.x = MinCoordX;
-            v0->TexCoord.y = MinCoordY;
-
-            v1->Position.x = MaxX;
-            v1->Position.y = MaxY;
-            v1->TexCoord.x = MaxCoordX;
-            v1->TexCoord.y = MaxCoordY;
-
-            v2->Position.x = MinX;
-            v2->Position.y = MaxY;
-            v2->TexCoord.x = MinCoordX;
-            v2->TexCoord.y = MaxCoordY;
-
-            v3->Position.x = MaxX;
-            v3->Position.y = MinY;
-            v3->TexCoord.x = MaxCoordX;
-            v3->TexCoord.y = MinCoordY;
-
-            u32 IndexOffset = ((y * SegmentCountX) + x) * 6;
-            ((u32*)Config.Indices)[IndexOffset + 0] = OffsetV + 0;
-            ((u32*)Config.Indices)[IndexOffset + 1] = OffsetV + 1;
-            ((u32*)Config.Indices)[IndexOffset + 2] = OffsetV + 2;
-            ((u32*)Config.Indices)[IndexOffset + 3] = OffsetV + 0;
-            ((u32*)Config.Indices)[IndexOffset + 4] = OffsetV + 3;
-            ((u32*)Config.Indices)[IndexOffset + 5] = OffsetV + 1;
-        }
-    }
+    MeshGeneratePlane(Width, Height, SegmentCountX, SegmentCountY, TileX, TileY, Config.Vertices, Config.Indices);
 
     if(Name && StringLength(Name) > 0)
     {
@@ -10,25 +10,28 @@ typedef struct geometry_system_config
     u32 MaxGeometryCount;
 } geometry_system_config;
 
-typedef struct geometry_config
-{
-    u32 VertexSize;
-    u32 VertexCount;
-    void* Vertices;
-
-    u32 IndexSize;
-    u32 IndexCount;
-    void* Indices;
-
-    char Name[GEOMETRY_NAME_MAX_LENGTH];
-    char MaterialName[MATERIAL_NAME_MAX_LENGTH];
-} geometry_config;
-
 b8 GeometrySystemInitialize(u64* MemoryRequirement, void* State, geometry_system_config Config);
 void GeometrySystemShutdown(void* State);
 geometry* GeometrySystemAcquireByID(u32 ID);
 geometry* GeometrySystemAcquireFromConfig(geometry_config Config, b8 AutoRelease);
 void GeometrySystemRelease(geometry* Geometry);
+// NOTE: Rewrites the vertices, and the indices unless Config.Indices is 0, of a dynamic mesh in place and refreshes its
+// bounds. Sizes and counts must match the config it was acquired from, anything else has to be acquired again.
+b8 GeometrySystemUpdate(geometry* Geometry, geometry_config Config);
+// NOTE: Replaces Config->Indices with a chain of up to LodCount simplified levels, each with about Ratio of the
+// previous triangles and at most MaxError object space error per step. Indices must be a MEMORY_TAG_ARRAY block of
+// IndexCount u32s like the generated configs use, it is freed and the new one is freed the same way.
+b8 GeometrySystemGenerateLods(geometry_config* Config, u32 LodCount, r32 Ratio, r32 MaxError);
+// NOTE: Import time optimization: merges duplicate vertices, orders each LOD for the vertex cache and for overdraw,
+// then orders the vertices by first use. Logs the ACMR and ATVR of level 0 before and after. Same memory
+// rules as GeometrySystemGenerateLods, the vertex array is replaced too.
+b8 GeometrySystemOptimizeConfig(geometry_config* Config);
+// NOTE: Replaces the vertex_3d array with vertex_3d_packed, 12 bytes instead of 20, and sets VertexFormat and
+// PositionExtents. Do it last, the LOD and optimize steps need float positions. Same memory rules as
+// GeometrySystemGenerateLods.
+b8 GeometrySystemPackConfig(geometry_config* Config);
+// NOTE: Heap allocated MEMORY_TAG_ARRAY arrays, ready for the LOD, optimize and pack steps. To build a mesh without
+// heap traffic, size and fill it with the generators in resources/mesh_generate.h straight into arena memory.
 geometry_config GeometrySystemGeneratePlaneConfig(r32 Width, r32 Height, u32 SegmentCountX, u32 SegmentCountY, r32 TileX, r32 TileY, const char* Name, const char* MaterialName);
 geometry* GeometrySystemGetDefault();
 geometry* GeometrySystemGetDefault2d();
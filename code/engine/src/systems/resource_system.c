@@ -7,6 +7,7 @@
 #include "resources/loaders/material_loader.h"
 #include "resources/loaders/binary_loader.h"
 #include "resources/loaders/text_loader.h"
+#include "resources/loaders/mesh_loader.h"
 
 typedef struct resource_system_state
 {
@@ -52,6 +53,7 @@ b8 ResourceSystemInitialize(u64* MemoryRequirement, void* State, resource_system
     ResourceSystemRegisterLoader(MaterialResourceLoaderCreate());
     ResourceSystemRegisterLoader(BinaryResourceLoaderCreate());
     ResourceSystemRegisterLoader(TextResourceLoaderCreate());
+    ResourceSystemRegisterLoader(StaticMeshResourceLoaderCreate());
 
     return true;
 }
@@ -0,0 +1,428 @@
+#include "transform_system.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "math/vmath.h"
+
+typedef struct transform_node
+{
+    v3 Position;
+    quat Rotation;
+    v3 Scale;
+
+    u32 Parent;
+    u32 FirstChild;
+    u32 NextSibling;
+    u32 PrevSibling;
+
+    b8 InUse;
+    // NOTE: LocalDirty: position, rotation or scale changed. Dirty: the world matrix of the node and 
+    // its subtree is stale, the node is in the dirty list. Dirty stays set on destroyed nodes until the next
+    // update drops their entry, so a slot reused in the same frame is never listed twice.
+    b8 LocalDirty;
+    b8 Dirty;
+} transform_node;
+
+typedef struct transform_system_state
+{
+    transform_system_config Config;
+
+    transform_node* Nodes;
+    mat4* Local;
+    mat4* World;
+
+    u32* FreeList;
+    u32 FreeCount;
+
+    u32* DirtyList;
+    u32 DirtyCount;
+} transform_system_state;
+
+static transform_system_state* StatePtr = 0;
+
+static b8 IsValidTransform(u32 ID)
+{
+    if(!StatePtr || ID >= StatePtr->Config.MaxTransformCount || !StatePtr->Nodes[ID].InUse)
+    {
+        VENG_WARN("Transform system - invalid transform id %u.", ID);
+        return false;
+    }
+
+    return true;
+}
+
+static void MarkDirty(u32 ID, b8 LocalChanged)
+{
+    transform_node* Node = &StatePtr->Nodes[ID];
+    Node->LocalDirty |= LocalChanged;
+    if(!Node->Dirty)
+    {
+        if(StatePtr->DirtyCount >= StatePtr->Config.MaxTransformCount)
+        {
+            VENG_ERROR("Transform system - dirty list overflow on transform %u.", ID);
+            return;
+        }
+
+        Node->Dirty = true;
+        StatePtr->DirtyList[StatePtr->DirtyCount++] = ID;
+    }
+}
+
+b8 TransformSystemInitialize(u64* MemoryRequirement, void* State, transform_system_config Config)
+{
+    if(Config.MaxTransformCount == 0)
+    {
+        VENG_FATAL("TransformSystemInitialize - Config.MaxTransformCount should be > 0");
+        return false;
+    }
+
+    *MemoryRequirement = sizeof(transform_system_state);
+    if(!State)
+    {
+        return true;
+    }
+
+    StatePtr = State;
+    ZeroMemory(StatePtr, sizeof(transform_system_state));
+    StatePtr->Config = Config;
+
+    u32 Count = Config.MaxTransformCount;
+    StatePtr->Nodes     = Allocate(sizeof(transform_node) * Count, MEMORY_TAG_TRANSFORM);
+    StatePtr->Local     = Allocate(sizeof(mat4) * Count, MEMORY_TAG_TRANSFORM);
+    StatePtr->World     = Allocate(sizeof(mat4) * Count, MEMORY_TAG_TRANSFORM);
+    StatePtr->FreeList  = Allocate(sizeof(u32) * Count, MEMORY_TAG_TRANSFORM);
+    StatePtr->DirtyList = Allocate(sizeof(u32) * Count, MEMORY_TAG_TRANSFORM);
+
+    // NOTE: Lowest IDs are handed out first
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        StatePtr->FreeList[Index] = Count - 1 - Index;
+    }
+    StatePtr->FreeCount = Count;
+
+    return true;
+}
+
+void TransformSystemShutdown(void* State)
+{
+    if(StatePtr)
+    {
+        u32 Count = StatePtr->Config.MaxTransformCount;
+        Free(StatePtr->Nodes, sizeof(transform_node) * Count, MEMORY_TAG_TRANSFORM);
+        Free(StatePtr->Local, sizeof(mat4) * Count, MEMORY_TAG_TRANSFORM);
+        Free(StatePtr->World, sizeof(mat4) * Count, MEMORY_TAG_TRANSFORM);
+        Free(StatePtr->FreeList, sizeof(u32) * Count, MEMORY_TAG_TRANSFORM);
+        Free(StatePtr->DirtyList, sizeof(u32) * Count, MEMORY_TAG_TRANSFORM);
+    }
+
+    StatePtr = 0;
+}
+
+// NOTE: Same matrix as MulMat4(MulMat4(Scale(S), QuatToMat4(R)), Translation(P))
+static void ComposeLocal(transform_node* Node, mat4* Out)
+{
+    quat q = NormalizeQuat(Node->Rotation);
+    r32* o = Out->E;
+    o[0]  = Node->Scale.x * (1.0f - 2.0f * q.y * q.y - 2.0f * q.z * q.z);
+    o[1]  = Node->Scale.x * (2.0f * q.x * q.y - 2.0f * q.z * q.w);
+    o[2]  = Node->Scale.x * (2.0f * q.x * q.z + 2.0f * q.y * q.w);
+    o[3]  = 0.0f;
+    o[4]  = Node->Scale.y * (2.0f * q.x * q.y + 2.0f * q.z * q.w);
+    o[5]  = Node->Scale.y * (1.0f - 2.0f * q.x * q.x - 2.0f * q.z * q.z);
+    o[6]  = Node->Scale.y * (2.0f * q.y * q.z - 2.0f * q.x * q.w);
+    o[7]  = 0.0f;
+    o[8]  = Node->Scale.z * (2.0f * q.x * q.z - 2.0f * q.y * q.w);
+    o[9]  = Node->Scale.z * (2.0f * q.y * q.z + 2.0f * q.x * q.w);
+    o[10] = Node->Scale.z * (1.0f - 2.0f * q.x * q.x - 2.0f * q.y * q.y);
+    o[11] = 0.0f;
+    o[12] = Node->Position.x;
+    o[13] = Node->Position.y;
+    o[14] = Node->Position.z;
+    o[15] = 1.0f;
+}
+
+// NOTE: Pre-order walk over the subtree through the sibling links, so every parent is done before its children
+static void UpdateSubtree(u32 Root)
+{
+    u32 Current = Root;
+    while(Current != INVALID_ID)
+    {
+        transform_node* Node = &StatePtr->Nodes[Current];
+        if(Node->LocalDirty)
+        {
+            ComposeLocal(Node, &StatePtr->Local[Current]);
+            Node->LocalDirty = false;
+        }
+
+        if(Node->Parent == INVALID_ID)
+        {
+            StatePtr->World[Current] = StatePtr->Local[Current];
+        }
+        else
+        {
+            StatePtr->World[Current] = MulMat4(StatePtr->Local[Current], StatePtr->World[Node->Parent]);
+        }
+        Node->Dirty = false;
+
+        if(Node->FirstChild != INVALID_ID)
+        {
+            Current = Node->FirstChild;
+            continue;
+        }
+
+        while(Current != Root && StatePtr->Nodes[Current].NextSibling == INVALID_ID)
+        {
+            Current = StatePtr->Nodes[Current].Parent;
+        }
+
+        Current = Current == Root ? INVALID_ID : StatePtr->Nodes[Current].NextSibling;
+    }
+}
+
+static b8 HasDirtyAncestor(u32 ID)
+{
+    u32 Ancestor = StatePtr->Nodes[ID].Parent;
+    while(Ancestor != INVALID_ID)
+    {
+        if(StatePtr->Nodes[Ancestor].Dirty)
+        {
+            return true;
+        }
+        Ancestor = StatePtr->Nodes[Ancestor].Parent;
+    }
+
+    return false;
+}
+
+void TransformSystemUpdate()
+{
+    if(!StatePtr)
+    {
+        return;
+    }
+
+    // NOTE: Only the topmost dirty node of each changed subtree starts a walk, the walk cleans everything below
+    // it. Entries already cleaned by an earlier walk are skipped, entries of destroyed nodes are dropped.
+    for(u32 DirtyIndex = 0;
+        DirtyIndex < StatePtr->DirtyCount;
+        ++DirtyIndex)
+    {
+        u32 ID = StatePtr->DirtyList[DirtyIndex];
+        transform_node* Node = &StatePtr->Nodes[ID];
+        if(!Node->InUse)
+        {
+            Node->Dirty = false;
+        }
+        else if(Node->Dirty && !HasDirtyAncestor(ID))
+        {
+            UpdateSubtree(ID);
+        }
+    }
+
+    StatePtr->DirtyCount = 0;
+}
+
+static void Unlink(u32 ID)
+{
+    transform_node* Node = &StatePtr->Nodes[ID];
+    if(Node->PrevSibling != INVALID_ID)
+    {
+        StatePtr->Nodes[Node->PrevSibling].NextSibling = Node->NextSibling;
+    }
+    else if(Node->Parent != INVALID_ID)
+    {
+        StatePtr->Nodes[Node->Parent].FirstChild = Node->NextSibling;
+    }
+
+    if(Node->NextSibling != INVALID_ID)
+    {
+        StatePtr->Nodes[Node->NextSibling].PrevSibling = Node->PrevSibling;
+    }
+
+    Node->Parent      = INVALID_ID;
+    Node->NextSibling = INVALID_ID;
+    Node->PrevSibling = INVALID_ID;
+}
+
+u32 TransformCreate(v3 Position, quat Rotation, v3 Scale)
+{
+    if(!StatePtr || StatePtr->FreeCount == 0)
+    {
+        VENG_ERROR("TransformCreate - no free transform slots.");
+        return INVALID_ID;
+    }
+
+    u32 ID = StatePtr->FreeList[--StatePtr->FreeCount];
+    transform_node* Node = &StatePtr->Nodes[ID];
+    Node->Position    = Position;
+    Node->Rotation    = Rotation;
+    Node->Scale       = Scale;
+    Node->Parent      = INVALID_ID;
+    Node->FirstChild  = INVALID_ID;
+    Node->NextSibling = INVALID_ID;
+    Node->PrevSibling = INVALID_ID;
+    Node->InUse       = true;
+    Node->LocalDirty  = false;
+
+    // NOTE: Dirty is left alone, a slot destroyed this frame is still in the dirty list
+    MarkDirty(ID, true);
+    return ID;
+}
+
+// NOTE: Children of a destroyed transform become roots, keeping their local transform
+void TransformDestroy(u32 ID)
+{
+    if(!IsValidTransform(ID))
+    {
+        return;
+    }
+
+    transform_node* Node = &StatePtr->Nodes[ID];
+    while(Node->FirstChild != INVALID_ID)
+    {
+        u32 Child = Node->FirstChild;
+        Unlink(Child);
+        MarkDirty(Child, false);
+    }
+
+    Unlink(ID);
+    Node->InUse = false;
+    StatePtr->FreeList[StatePtr->FreeCount++] = ID;
+}
+
+b8 TransformSetParent(u32 ID, u32 ParentID)
+{
+    if(!IsValidTransform(ID) || (ParentID != INVALID_ID && !IsValidTransform(ParentID)))
+    {
+        return false;
+    }
+
+    for(u32 Ancestor = ParentID;
+        Ancestor != INVALID_ID;
+        Ancestor = StatePtr->Nodes[Ancestor].Parent)
+    {
+        if(Ancestor == ID)
+        {
+            VENG_ERROR("TransformSetParent - parenting %u to %u would create a cycle.", ID, ParentID);
+            return false;
+        }
+    }
+
+    Unlink(ID);
+    if(ParentID != INVALID_ID)
+    {
+        transform_node* Node   = &StatePtr->Nodes[ID];
+        transform_node* Parent = &StatePtr->Nodes[ParentID];
+        Node->Parent      = ParentID;
+        Node->NextSibling = Parent->FirstChild;
+        if(Parent->FirstChild != INVALID_ID)
+        {
+            StatePtr->Nodes[Parent->FirstChild].PrevSibling = ID;
+        }
+        Parent->FirstChild = ID;
+    }
+
+    MarkDirty(ID, false);
+    return true;
+}
+
+u32 TransformGetParent(u32 ID)
+{
+    return IsValidTransform(ID) ? StatePtr->Nodes[ID].Parent : INVALID_ID;
+}
+
+void TransformSetPosition(u32 ID, v3 Position)
+{
+    if(IsValidTransform(ID))
+    {
+        StatePtr->Nodes[ID].Position = Position;
+        MarkDirty(ID, true);
+    }
+}
+
+void TransformSetRotation(u32 ID, quat Rotation)
+{
+    if(IsValidTransform(ID))
+    {
+        StatePtr->Nodes[ID].Rotation = Rotation;
+        MarkDirty(ID, true);
+    }
+}
+
+void TransformSetScale(u32 ID, v3 Scale)
+{
+    if(IsValidTransform(ID))
+    {
+        StatePtr->Nodes[ID].Scale = Scale;
+        MarkDirty(ID, true);
+    }
+}
+
+void TransformSetPositionRotationScale(u32 ID, v3 Position, quat Rotation, v3 Scale)
+{
+    if(IsValidTransform(ID))
+    {
+        StatePtr->Nodes[ID].Position = Position;
+        StatePtr->Nodes[ID].Rotation = Rotation;
+        StatePtr->Nodes[ID].Scale    = Scale;
+        MarkDirty(ID, true);
+    }
+}
+
+void TransformTranslate(u32 ID, v3 Translation)
+{
+    if(IsValidTransform(ID))
+    {
+        StatePtr->Nodes[ID].Position = AddV3(StatePtr->Nodes[ID].Position, Translation);
+        MarkDirty(ID, true);
+    }
+}
+
+v3 TransformGetPosition(u32 ID)
+{
+    return IsValidTransform(ID) ? StatePtr->Nodes[ID].Position : V3Zero();
+}
+
+quat TransformGetRotation(u32 ID)
+{
+    return IsValidTransform(ID) ? StatePtr->Nodes[ID].Rotation : IdentityQuat();
+}
+
+v3 TransformGetScale(u32 ID)
+{
+    return IsValidTransform(ID) ? StatePtr->Nodes[ID].Scale : V3One();
+}
+
+mat4 TransformGetLocal(u32 ID)
+{
+    if(!IsValidTransform(ID))
+    {
+        return Identity();
+    }
+
+    transform_node* Node = &StatePtr->Nodes[ID];
+    if(Node->LocalDirty)
+    {
+        ComposeLocal(Node, &StatePtr->Local[ID]);
+        Node->LocalDirty = false;
+    }
+
+    return StatePtr->Local[ID];
+}
+
+mat4 TransformGetWorld(u32 ID)
+{
+    if(!IsValidTransform(ID))
+    {
+        return Identity();
+    }
+
+    if(StatePtr->Nodes[ID].Dirty || HasDirtyAncestor(ID))
+    {
+        TransformSystemUpdate();
+    }
+
+    return StatePtr->World[ID];
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "defines.h"
+#include "math/math_types.h"
+
+typedef struct transform_system_config
+{
+    u32 MaxTransformCount;
+} transform_system_config;
+
+VENG_API b8 TransformSystemInitialize(u64* MemoryRequirement, void* State, transform_system_config Config);
+VENG_API void TransformSystemShutdown(void* State);
+
+// NOTE: Recomputes the world matrices of every subtree changed since the last call, parents before children.
+// Called by the application once per frame after the game update.
+VENG_API void TransformSystemUpdate();
+
+// NOTE: Transforms are referenced by ID, INVALID_ID as parent makes a root
+VENG_API u32  TransformCreate(v3 Position, quat Rotation, v3 Scale);
+VENG_API void TransformDestroy(u32 ID);
+VENG_API b8   TransformSetParent(u32 ID, u32 ParentID);
+VENG_API u32  TransformGetParent(u32 ID);
+
+VENG_API void TransformSetPosition(u32 ID, v3 Position);
+VENG_API void TransformSetRotation(u32 ID, quat Rotation);
+VENG_API void TransformSetScale(u32 ID, v3 Scale);
+VENG_API void TransformSetPositionRotationScale(u32 ID, v3 Position, quat Rotation, v3 Scale);
+VENG_API void TransformTranslate(u32 ID, v3 Translation);
+
+VENG_API v3   TransformGetPosition(u32 ID);
+VENG_API quat TransformGetRotation(u32 ID);
+VENG_API v3   TransformGetScale(u32 ID);
+
+VENG_API mat4 TransformGetLocal(u32 ID);
+// NOTE: Brings the transform up to date first if it or one of its parents changed since the last update
+VENG_API mat4 TransformGetWorld(u32 ID);
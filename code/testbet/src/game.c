@@ -16,7 +16,7 @@ void RecalculateView(game_state* State)
         mat4 RotationRes = EulerXYZ(State->CameraRotation);
 
         State->View = MulMat4(RotationRes, TranslationRes);
-        State->View = Inverse(State->View);
+        State->View = InverseRigid(State->View);
 
         State->CameraViewDirty = false;
     }
@@ -47,7 +47,7 @@ b8 Initialize(struct game* GameInst)
     GameState->CameraRotation = V3Zero();
 
     GameState->View = Translation(GameState->CameraPosition);
-    GameState->View = Inverse(GameState->View);
+    GameState->View = InverseRigid(GameState->View);
     GameState->CameraViewDirty = true;
 
     return true;
@@ -0,0 +1,411 @@
+#include "aabb_tree_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <containers/aabb_tree.h>
+#include <core/vmemory.h>
+#include <core/clock.h>
+#include <math/vrandom.h>
+
+#define AABB_TEST_BOX_COUNT       10000
+#define AABB_TEST_QUERY_COUNT     64
+#define AABB_BENCHMARK_BOX_COUNT  100000
+#define AABB_BENCHMARK_QUERY_COUNT 1000
+#define AABB_TEST_WORLD_SIZE      1000.0f
+
+// NOTE: Leaves carry their box index + 1 as user data. Brute force runs over the boxes the tree stores, so
+// margins and refits give both sides the same answer.
+typedef struct aabb_test_state
+{
+    aabb_tree Tree;
+    u32 Count;
+    u32* Proxies;
+    b8* Alive;
+    u8* Seen;
+    u32 SeenCount;
+    r32 ClosestHit;
+    u32 ClosestIndex;
+} aabb_test_state;
+
+static extents_3d RandomBox(random_xoshiro* Random)
+{
+    v3 Center = V3(RandomXoshiroR32InRange(Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                   RandomXoshiroR32InRange(Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                   RandomXoshiroR32InRange(Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE));
+    v3 Half = V3(RandomXoshiroR32InRange(Random, 0.25f, 2.5f), 
+                 RandomXoshiroR32InRange(Random, 0.25f, 2.5f), 
+                 RandomXoshiroR32InRange(Random, 0.25f, 2.5f));
+    extents_3d Result;
+    Result.Min = SubV3(Center, Half);
+    Result.Max = AddV3(Center, Half);
+    return Result;
+}
+
+static extents_3d RandomQueryBox(random_xoshiro* Random)
+{
+    extents_3d Result = RandomBox(Random);
+    v3 Grow = V3(RandomXoshiroR32InRange(Random, 10.0f, 100.0f), 
+                 RandomXoshiroR32InRange(Random, 10.0f, 100.0f), 
+                 RandomXoshiroR32InRange(Random, 10.0f, 100.0f));
+    Result.Min = SubV3(Result.Min, Grow);
+    Result.Max = AddV3(Result.Max, Grow);
+    return Result;
+}
+
+static void Setup(aabb_test_state* State, u32 Count, r32 Margin, u64 Seed)
+{
+    State->Count   = Count;
+    State->Proxies = Allocate(sizeof(u32) * Count, MEMORY_TAG_APPLICATION);
+    State->Alive   = Allocate(sizeof(b8) * Count, MEMORY_TAG_APPLICATION);
+    State->Seen    = Allocate(sizeof(u8) * Count, MEMORY_TAG_APPLICATION);
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, Seed);
+
+    AABBTreeCreate(16, Margin, &State->Tree);
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        State->Proxies[Index] = AABBTreeInsert(&State->Tree, RandomBox(&Random), (void*)(u64)(Index + 1));
+        State->Alive[Index] = true;
+    }
+}
+
+static void Teardown(aabb_test_state* State)
+{
+    AABBTreeDestroy(&State->Tree);
+    Free(State->Proxies, sizeof(u32) * State->Count, MEMORY_TAG_APPLICATION);
+    Free(State->Alive, sizeof(b8) * State->Count, MEMORY_TAG_APPLICATION);
+    Free(State->Seen, sizeof(u8) * State->Count, MEMORY_TAG_APPLICATION);
+}
+
+static b8 OnQuery(void* Context, u32 Proxy, void* UserData)
+{
+    aabb_test_state* State = Context;
+    u32 Index = (u32)(u64)UserData - 1;
+    State->Seen[Index]++;
+    State->SeenCount++;
+    return true;
+}
+
+static r32 OnRayCast(void* Context, u32 Proxy, void* UserData, v3 Origin, v3 Direction, r32 MaxDistance)
+{
+    aabb_test_state* State = Context;
+    v3 InvDirection = V3(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+    r32 Distance;
+    if(RayIntersectsExtents(Origin, InvDirection, MaxDistance, AABBTreeGetBox(&State->Tree, Proxy), &Distance) &&
+       Distance < State->ClosestHit)
+    {
+        State->ClosestHit   = Distance;
+        State->ClosestIndex = (u32)(u64)UserData - 1;
+        return Distance;
+    }
+    return MaxDistance;
+}
+
+static void ClearSeen(aabb_test_state* State)
+{
+    ZeroMemory(State->Seen, sizeof(u8) * State->Count);
+    State->SeenCount = 0;
+}
+
+// NOTE: Every live box overlapping Query reported exactly once, nothing else
+static b8 QueryMatchesBruteForce(aabb_test_state* State, extents_3d Query)
+{
+    ClearSeen(State);
+    AABBTreeQueryBox(&State->Tree, Query, OnQuery, State);
+
+    for(u32 Index = 0;
+        Index < State->Count;
+        ++Index)
+    {
+        b8 Expected = State->Alive[Index] && ExtentsOverlap(AABBTreeGetBox(&State->Tree, State->Proxies[Index]), Query);
+        if(State->Seen[Index] != (Expected ? 1 : 0))
+        {
+            VENG_ERROR("AABB tree query reported box %u %u times, expected %u.", Index, State->Seen[Index], Expected);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static b8 AllQueriesMatchBruteForce(aabb_test_state* State, u64 Seed)
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, Seed);
+    for(u32 Query = 0;
+        Query < AABB_TEST_QUERY_COUNT;
+        ++Query)
+    {
+        if(!QueryMatchesBruteForce(State, RandomQueryBox(&Random)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+u8 AABBTreeQueriesShouldMatchBruteForce()
+{
+    aabb_test_state State;
+    Setup(&State, AABB_TEST_BOX_COUNT, 0.5f, 43);
+
+    // NOTE: Inserts are balanced with rotations, the height stays logarithmic
+    ExpectToBeTrue(AABBTreeGetHeight(&State.Tree) <= 40);
+    ExpectToBeTrue(AllQueriesMatchBruteForce(&State, 1));
+
+    for(u32 Index = 0;
+        Index < AABB_TEST_BOX_COUNT;
+        Index += 2)
+    {
+        AABBTreeRemove(&State.Tree, State.Proxies[Index]);
+        State.Alive[Index] = false;
+    }
+    ExpectToBeTrue(AllQueriesMatchBruteForce(&State, 2));
+
+    // NOTE: Proxy IDs survive a rebuild
+    AABBTreeRebuild(&State.Tree);
+    ExpectToBeTrue(AABBTreeGetHeight(&State.Tree) <= 40);
+    ExpectToBeTrue(AllQueriesMatchBruteForce(&State, 3));
+
+    Teardown(&State);
+    return true;
+}
+
+u8 AABBTreeShouldTrackMovedBoxes()
+{
+    aabb_test_state State;
+    Setup(&State, AABB_TEST_BOX_COUNT, 0.5f, 4343);
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 4);
+
+    // NOTE: Moves inside the margin leave the tree alone, the others reinsert
+    u32 Reinserted = 0;
+    for(u32 Index = 0;
+        Index < AABB_TEST_BOX_COUNT;
+        ++Index)
+    {
+        extents_3d Box = AABBTreeGetBox(&State.Tree, State.Proxies[Index]);
+        v3 Offset = (Index & 1) ? V3(0.1f, 0.0f, 0.0f) : V3(RandomXoshiroR32InRange(&Random, -50.0f, 50.0f), 0.0f, 0.0f);
+        Box.Min = AddV3(AddV3(Box.Min, V3(0.5f, 0.5f, 0.5f)), Offset);
+        Box.Max = AddV3(SubV3(Box.Max, V3(0.5f, 0.5f, 0.5f)), Offset);
+        b8 Moved = AABBTreeMove(&State.Tree, State.Proxies[Index], Box);
+        if(Index & 1)
+        {
+            ExpectToBeFalse(Moved);
+        }
+        Reinserted += Moved;
+        ExpectToBeTrue(ExtentsContains(AABBTreeGetBox(&State.Tree, State.Proxies[Index]), Box));
+    }
+    ExpectToBeTrue(Reinserted > 0);
+    ExpectToBeTrue(AllQueriesMatchBruteForce(&State, 5));
+
+    // NOTE: Refits set the exact box and only grow or shrink the ancestors
+    for(u32 Index = 0;
+        Index < AABB_TEST_BOX_COUNT;
+        Index += 3)
+    {
+        AABBTreeRefit(&State.Tree, State.Proxies[Index], RandomBox(&Random));
+    }
+    ExpectToBeTrue(AllQueriesMatchBruteForce(&State, 6));
+
+    Teardown(&State);
+    return true;
+}
+
+u8 AABBTreeFrustumQueryShouldMatchBruteForce()
+{
+    aabb_test_state State;
+    Setup(&State, AABB_TEST_BOX_COUNT, 0.0f, 434343);
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 7);
+    mat4 Projection = Perspective(DegToRad(60.0f), 16.0f / 9.0f, 0.1f, 800.0f);
+    for(u32 Query = 0;
+        Query < AABB_TEST_QUERY_COUNT;
+        ++Query)
+    {
+        v3 Position = V3(RandomXoshiroR32InRange(&Random, -500.0f, 500.0f), 0.0f, RandomXoshiroR32InRange(&Random, -500.0f, 500.0f));
+        v3 Target = V3(RandomXoshiroR32InRange(&Random, -500.0f, 500.0f), 10.0f, RandomXoshiroR32InRange(&Random, -500.0f, 500.0f));
+        frustum Frustum = FrustumFromMatrix(MulMat4(LookAt(Position, Target, V3(0.0f, 1.0f, 0.0f)), Projection));
+
+        ClearSeen(&State);
+        AABBTreeQueryFrustum(&State.Tree, &Frustum, OnQuery, &State);
+
+        // NOTE: Subtrees fully inside are reported without testing their leaves, the leaves are inside as well
+        for(u32 Index = 0;
+            Index < AABB_TEST_BOX_COUNT;
+            ++Index)
+        {
+            b8 Expected = FrustumTestExtents(&Frustum, AABBTreeGetBox(&State.Tree, State.Proxies[Index])) != FRUSTUM_OUTSIDE;
+            ExpectShouldBe(Expected ? 1 : 0, State.Seen[Index]);
+        }
+    }
+
+    Teardown(&State);
+    return true;
+}
+
+u8 AABBTreeRayCastShouldFindClosestHit()
+{
+    aabb_test_state State;
+    Setup(&State, AABB_TEST_BOX_COUNT, 0.0f, 43434343);
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 8);
+    u32 Hits = 0;
+    for(u32 Ray = 0;
+        Ray < AABB_TEST_QUERY_COUNT * 4;
+        ++Ray)
+    {
+        v3 Origin = V3(RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                       RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                       RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE));
+        v3 Direction = V3(RandomXoshiroR32InRange(&Random, -1.0f, 1.0f), 
+                          RandomXoshiroR32InRange(&Random, -1.0f, 1.0f), 
+                          RandomXoshiroR32InRange(&Random, -1.0f, 1.0f));
+        r32 MaxDistance = 2000.0f;
+
+        State.ClosestHit = MaxDistance;
+        State.ClosestIndex = INVALID_ID;
+        AABBTreeRayCast(&State.Tree, Origin, Direction, MaxDistance, OnRayCast, &State);
+
+        r32 Closest = MaxDistance;
+        v3 InvDirection = V3(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+        for(u32 Index = 0;
+            Index < AABB_TEST_BOX_COUNT;
+            ++Index)
+        {
+            r32 Distance;
+            if(RayIntersectsExtents(Origin, InvDirection, MaxDistance, AABBTreeGetBox(&State.Tree, State.Proxies[Index]), &Distance) &&
+               Distance < Closest)
+            {
+                Closest = Distance;
+            }
+        }
+
+        ExpectFloatToBe(Closest, State.ClosestHit, 0.0f);
+        Hits += State.ClosestIndex != INVALID_ID;
+    }
+    ExpectToBeTrue(Hits > 0);
+
+    Teardown(&State);
+    return true;
+}
+
+// NOTE: Not a pass / fail test, logs build and query times against brute force loops over the same boxes
+u8 AABBTreeBenchmark()
+{
+    aabb_test_state State;
+    clock Clock;
+
+    ClockStart(&Clock);
+    Setup(&State, AABB_BENCHMARK_BOX_COUNT, 0.1f, 100000);
+    ClockUpdate(&Clock);
+    r64 InsertTime = Clock.Elapsed;
+    u32 InsertHeight = AABBTreeGetHeight(&State.Tree);
+
+    ClockStart(&Clock);
+    AABBTreeRebuild(&State.Tree);
+    ClockUpdate(&Clock);
+    r64 RebuildTime = Clock.Elapsed;
+
+    extents_3d* Boxes = Allocate(sizeof(extents_3d) * AABB_BENCHMARK_BOX_COUNT, MEMORY_TAG_APPLICATION);
+    extents_3d* Queries = Allocate(sizeof(extents_3d) * AABB_BENCHMARK_QUERY_COUNT, MEMORY_TAG_APPLICATION);
+    for(u32 Index = 0; Index < AABB_BENCHMARK_BOX_COUNT; ++Index)
+    {
+        Boxes[Index] = AABBTreeGetBox(&State.Tree, State.Proxies[Index]);
+    }
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 9);
+    for(u32 Query = 0; Query < AABB_BENCHMARK_QUERY_COUNT; ++Query)
+    {
+        Queries[Query] = RandomQueryBox(&Random);
+    }
+
+    ClearSeen(&State);
+    ClockStart(&Clock);
+    for(u32 Query = 0; Query < AABB_BENCHMARK_QUERY_COUNT; ++Query)
+    {
+        AABBTreeQueryBox(&State.Tree, Queries[Query], OnQuery, &State);
+    }
+    ClockUpdate(&Clock);
+    r64 TreeQueryTime = Clock.Elapsed;
+    u32 TreeFound = State.SeenCount;
+
+    u32 BruteFound = 0;
+    ClockStart(&Clock);
+    for(u32 Query = 0; Query < AABB_BENCHMARK_QUERY_COUNT; ++Query)
+    {
+        for(u32 Index = 0; Index < AABB_BENCHMARK_BOX_COUNT; ++Index)
+        {
+            BruteFound += ExtentsOverlap(Boxes[Index], Queries[Query]);
+        }
+    }
+    ClockUpdate(&Clock);
+    r64 BruteQueryTime = Clock.Elapsed;
+    ExpectShouldBe(BruteFound, TreeFound);
+
+    u32 TreeHits = 0;
+    u32 BruteHits = 0;
+    r64 TreeRayTime = 0.0;
+    r64 BruteRayTime = 0.0;
+    for(u32 Ray = 0; Ray < AABB_BENCHMARK_QUERY_COUNT; ++Ray)
+    {
+        v3 Origin = V3(RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                       RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE), 
+                       RandomXoshiroR32InRange(&Random, -AABB_TEST_WORLD_SIZE, AABB_TEST_WORLD_SIZE));
+        v3 Direction = V3(RandomXoshiroR32InRange(&Random, -1.0f, 1.0f), 
+                          RandomXoshiroR32InRange(&Random, -1.0f, 1.0f), 
+                          RandomXoshiroR32InRange(&Random, -1.0f, 1.0f));
+
+        State.ClosestHit = 2000.0f;
+        State.ClosestIndex = INVALID_ID;
+        ClockStart(&Clock);
+        AABBTreeRayCast(&State.Tree, Origin, Direction, 2000.0f, OnRayCast, &State);
+        ClockUpdate(&Clock);
+        TreeRayTime += Clock.Elapsed;
+        TreeHits += State.ClosestIndex != INVALID_ID;
+
+        r32 Closest = 2000.0f;
+        v3 InvDirection = V3(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+        ClockStart(&Clock);
+        for(u32 Index = 0; Index < AABB_BENCHMARK_BOX_COUNT; ++Index)
+        {
+            r32 Distance;
+            if(RayIntersectsExtents(Origin, InvDirection, Closest, Boxes[Index], &Distance) && Distance < Closest)
+            {
+                Closest = Distance;
+            }
+        }
+        ClockUpdate(&Clock);
+        BruteRayTime += Clock.Elapsed;
+        BruteHits += Closest < 2000.0f;
+    }
+    ExpectShouldBe(BruteHits, TreeHits);
+
+    VENG_INFO("AABB tree, %u boxes: insert %.2f ms (height %u), SAH rebuild %.2f ms (height %u)", 
+              AABB_BENCHMARK_BOX_COUNT, InsertTime * SEC_TO_MS, InsertHeight, RebuildTime * SEC_TO_MS, AABBTreeGetHeight(&State.Tree));
+    VENG_INFO("  box query: %.2f us, brute force %.2f us (%u found)", 
+              TreeQueryTime * 1e6 / AABB_BENCHMARK_QUERY_COUNT, BruteQueryTime * 1e6 / AABB_BENCHMARK_QUERY_COUNT, TreeFound);
+    VENG_INFO("  ray cast:  %.2f us, brute force %.2f us (%u hits)", 
+              TreeRayTime * 1e6 / AABB_BENCHMARK_QUERY_COUNT, BruteRayTime * 1e6 / AABB_BENCHMARK_QUERY_COUNT, TreeHits);
+
+    Free(Boxes, sizeof(extents_3d) * AABB_BENCHMARK_BOX_COUNT, MEMORY_TAG_APPLICATION);
+    Free(Queries, sizeof(extents_3d) * AABB_BENCHMARK_QUERY_COUNT, MEMORY_TAG_APPLICATION);
+    Teardown(&State);
+    return true;
+}
+
+void AABBTreeRegisterTests()
+{
+    TestManagerRegisterTest(AABBTreeQueriesShouldMatchBruteForce, "AABB tree box queries should match brute force through removes and rebuilds");
+    TestManagerRegisterTest(AABBTreeShouldTrackMovedBoxes, "AABB tree should track moved and refitted boxes");
+    TestManagerRegisterTest(AABBTreeFrustumQueryShouldMatchBruteForce, "AABB tree frustum queries should match brute force");
+    TestManagerRegisterTest(AABBTreeRayCastShouldFindClosestHit, "AABB tree ray casts should find the closest hit");
+    TestManagerRegisterTest(AABBTreeBenchmark, "AABB tree benchmark, 100k boxes");
+}
@@ -0,0 +1,239 @@
+#include "event_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <core/event.h>
+#include <core/vmemory.h>
+#include <core/clock.h>
+
+#define EVENT_TEST_LISTENER_COUNT 10000
+#define EVENT_TEST_FIRE_COUNT     1000
+
+typedef struct event_test_state
+{
+    u64 MemoryRequirement;
+    void* EventSystem;
+    u32* CallCounts;
+    event_handle* Handles;
+} event_test_state;
+
+static b8 Setup(event_test_state* State)
+{
+    EventInitialize(&State->MemoryRequirement, 0);
+    State->EventSystem = Allocate(State->MemoryRequirement, MEMORY_TAG_APPLICATION);
+    EventInitialize(&State->MemoryRequirement, State->EventSystem);
+
+    State->CallCounts = Allocate(sizeof(u32) * EVENT_TEST_LISTENER_COUNT, MEMORY_TAG_APPLICATION);
+    State->Handles = Allocate(sizeof(event_handle) * EVENT_TEST_LISTENER_COUNT, MEMORY_TAG_APPLICATION);
+    return State->EventSystem != 0;
+}
+
+static void Teardown(event_test_state* State)
+{
+    EventShutdown(State->EventSystem);
+    Free(State->EventSystem, State->MemoryRequirement, MEMORY_TAG_APPLICATION);
+    Free(State->CallCounts, sizeof(u32) * EVENT_TEST_LISTENER_COUNT, MEMORY_TAG_APPLICATION);
+    Free(State->Handles, sizeof(event_handle) * EVENT_TEST_LISTENER_COUNT, MEMORY_TAG_APPLICATION);
+}
+
+static b8 OnCountEvent(u16 Code, void* Sender, void* ListenerInst, event_context Data)
+{
+    u32* Count = ListenerInst;
+    (*Count)++;
+    return false;
+}
+
+static b8 OnHandledEvent(u16 Code, void* Sender, void* ListenerInst, event_context Data)
+{
+    u32* Count = ListenerInst;
+    (*Count)++;
+    return true;
+}
+
+static u32 SumCounts(event_test_state* State)
+{
+    u32 Sum = 0;
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        Sum += State->CallCounts[Index];
+    }
+    return Sum;
+}
+
+u8 EventShouldRegisterAndFireManyListeners()
+{
+    event_test_state State;
+    ExpectToBeTrue(Setup(&State));
+
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        ExpectToBeTrue(EventRegisterHandle(EVENT_CODE_DEBUG0, &State.CallCounts[Index], OnCountEvent, &State.Handles[Index]));
+    }
+
+    // NOTE: The same listener twice on one code is rejected
+    ExpectToBeFalse(EventRegister(EVENT_CODE_DEBUG0, &State.CallCounts[0], OnCountEvent));
+
+    event_context Context = {};
+    ExpectToBeFalse(EventFire(EVENT_CODE_DEBUG0, 0, Context));
+    ExpectShouldBe(EVENT_TEST_LISTENER_COUNT, SumCounts(&State));
+    ExpectToBeFalse(EventFire(EVENT_CODE_DEBUG1, 0, Context));
+
+    Teardown(&State);
+    return true;
+}
+
+u8 EventShouldUnregisterByHandle()
+{
+    event_test_state State;
+    ExpectToBeTrue(Setup(&State));
+
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        ExpectToBeTrue(EventRegisterHandle(EVENT_CODE_DEBUG0, &State.CallCounts[Index], OnCountEvent, &State.Handles[Index]));
+    }
+
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        Index += 2)
+    {
+        ExpectToBeTrue(EventUnregisterHandle(State.Handles[Index]));
+    }
+
+    // NOTE: Stale handles fail, the generation moved on
+    ExpectToBeFalse(EventUnregisterHandle(State.Handles[0]));
+
+    event_context Context = {};
+    EventFire(EVENT_CODE_DEBUG0, 0, Context);
+    ExpectShouldBe(EVENT_TEST_LISTENER_COUNT / 2, SumCounts(&State));
+    ExpectShouldBe(0, State.CallCounts[0]);
+    ExpectShouldBe(1, State.CallCounts[1]);
+
+    // NOTE: Registering compacts the tombstones, the remaining handles have to stay valid through it
+    ExpectToBeTrue(EventRegister(EVENT_CODE_DEBUG1, &State.CallCounts[0], OnCountEvent));
+    for(u32 Index = 1;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        Index += 2)
+    {
+        ExpectToBeTrue(EventUnregisterHandle(State.Handles[Index]));
+    }
+
+    EventFire(EVENT_CODE_DEBUG0, 0, Context);
+    ExpectShouldBe(EVENT_TEST_LISTENER_COUNT / 2, SumCounts(&State));
+
+    EventFire(EVENT_CODE_DEBUG1, 0, Context);
+    ExpectShouldBe(1, State.CallCounts[0]);
+
+    Teardown(&State);
+    return true;
+}
+
+u8 EventShouldStopAtHandledListener()
+{
+    event_test_state State;
+    ExpectToBeTrue(Setup(&State));
+
+    ExpectToBeTrue(EventRegister(EVENT_CODE_DEBUG2, &State.CallCounts[0], OnCountEvent));
+    ExpectToBeTrue(EventRegister(EVENT_CODE_DEBUG2, &State.CallCounts[1], OnHandledEvent));
+    ExpectToBeTrue(EventRegister(EVENT_CODE_DEBUG2, &State.CallCounts[2], OnCountEvent));
+
+    event_context Context = {};
+    ExpectToBeTrue(EventFire(EVENT_CODE_DEBUG2, 0, Context));
+    ExpectShouldBe(1, State.CallCounts[0]);
+    ExpectShouldBe(1, State.CallCounts[1]);
+    ExpectShouldBe(0, State.CallCounts[2]);
+
+    ExpectToBeTrue(EventUnregister(EVENT_CODE_DEBUG2, &State.CallCounts[1], OnHandledEvent));
+    ExpectToBeFalse(EventFire(EVENT_CODE_DEBUG2, 0, Context));
+    ExpectShouldBe(1, State.CallCounts[2]);
+
+    Teardown(&State);
+    return true;
+}
+
+// NOTE: Not a pass / fail test, logs the cost of a listener call with 10k listeners on one code and spread
+// over every code
+u8 EventDispatchBenchmark()
+{
+    event_test_state State;
+    ExpectToBeTrue(Setup(&State));
+
+    clock Clock;
+    ClockStart(&Clock);
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        EventRegisterHandle(EVENT_CODE_DEBUG0, &State.CallCounts[Index], OnCountEvent, &State.Handles[Index]);
+    }
+    ClockUpdate(&Clock);
+    r64 RegisterTime = Clock.Elapsed;
+
+    event_context Context = {};
+    ClockStart(&Clock);
+    for(u32 Fire = 0;
+        Fire < EVENT_TEST_FIRE_COUNT;
+        ++Fire)
+    {
+        EventFire(EVENT_CODE_DEBUG0, 0, Context);
+    }
+    ClockUpdate(&Clock);
+    r64 SingleCodeTime = Clock.Elapsed;
+    ExpectShouldBe(EVENT_TEST_LISTENER_COUNT * EVENT_TEST_FIRE_COUNT, SumCounts(&State));
+
+    ClockStart(&Clock);
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        EventUnregisterHandle(State.Handles[Index]);
+    }
+    ClockUpdate(&Clock);
+    r64 UnregisterTime = Clock.Elapsed;
+
+    for(u32 Index = 0;
+        Index < EVENT_TEST_LISTENER_COUNT;
+        ++Index)
+    {
+        State.CallCounts[Index] = 0;
+        EventRegister((u16)(Index % (MAX_EVENT_CODE + 1)), &State.CallCounts[Index], OnCountEvent);
+    }
+
+    ClockStart(&Clock);
+    for(u32 Fire = 0;
+        Fire < EVENT_TEST_FIRE_COUNT;
+        ++Fire)
+    {
+        for(u32 Code = 0;
+            Code <= MAX_EVENT_CODE;
+            ++Code)
+        {
+            EventFire((u16)Code, 0, Context);
+        }
+    }
+    ClockUpdate(&Clock);
+    r64 AllCodesTime = Clock.Elapsed;
+    ExpectShouldBe(EVENT_TEST_LISTENER_COUNT * EVENT_TEST_FIRE_COUNT, SumCounts(&State));
+
+    r64 CallCount = (r64)EVENT_TEST_LISTENER_COUNT * EVENT_TEST_FIRE_COUNT;
+    VENG_INFO("Event dispatch, %u listeners: register %.3f ms, unregister %.3f ms", 
+              EVENT_TEST_LISTENER_COUNT, RegisterTime * SEC_TO_MS, UnregisterTime * SEC_TO_MS);
+    VENG_INFO("  one code:  %.2f ns per listener call", SingleCodeTime * 1e9 / CallCount);
+    VENG_INFO("  256 codes: %.2f ns per listener call", AllCodesTime * 1e9 / CallCount);
+
+    Teardown(&State);
+    return true;
+}
+
+void EventRegisterTests()
+{
+    TestManagerRegisterTest(EventShouldRegisterAndFireManyListeners, "Events should register and fire 10k listeners");
+    TestManagerRegisterTest(EventShouldUnregisterByHandle, "Events should unregister by handle and keep handles valid through compaction");
+    TestManagerRegisterTest(EventShouldStopAtHandledListener, "Events should stop dispatching at the first handling listener");
+    TestManagerRegisterTest(EventDispatchBenchmark, "Event dispatch benchmark, 10k listeners");
+}
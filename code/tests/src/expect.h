@@ -0,0 +1,42 @@
+#pragma once
+
+#include <core/logger.h>
+#include <math/vmath.h>
+
+#define ExpectShouldBe(Expected, Actual)                                                                    \
+    if((Actual) != (Expected))                                                                              \
+    {                                                                                                       \
+        VENG_ERROR("--> Expected %lld, but got: %lld. File: %s:%d.", (s64)(Expected), (s64)(Actual),       \
+                   __FILE__, __LINE__);                                                                     \
+        return false;                                                                                       \
+    }
+
+#define ExpectShouldNotBe(Expected, Actual)                                                                 \
+    if((Actual) == (Expected))                                                                              \
+    {                                                                                                       \
+        VENG_ERROR("--> Expected %lld != %lld, but they are equal. File: %s:%d.", (s64)(Expected),         \
+                   (s64)(Actual), __FILE__, __LINE__);                                                      \
+        return false;                                                                                       \
+    }
+
+#define ExpectFloatToBe(Expected, Actual, Tolerance)                                                        \
+    if(Abs((r32)(Expected) - (r32)(Actual)) > (Tolerance))                                                  \
+    {                                                                                                       \
+        VENG_ERROR("--> Expected %f, but got: %f (tolerance %g). File: %s:%d.", (r64)(Expected),           \
+                   (r64)(Actual), (r64)(Tolerance), __FILE__, __LINE__);                                    \
+        return false;                                                                                       \
+    }
+
+#define ExpectToBeTrue(Actual)                                                                              \
+    if((Actual) != true)                                                                                    \
+    {                                                                                                       \
+        VENG_ERROR("--> Expected true, but got: false. File: %s:%d.", __FILE__, __LINE__);                 \
+        return false;                                                                                       \
+    }
+
+#define ExpectToBeFalse(Actual)                                                                             \
+    if((Actual) != false)                                                                                   \
+    {                                                                                                       \
+        VENG_ERROR("--> Expected false, but got: true. File: %s:%d.", __FILE__, __LINE__);                 \
+        return false;                                                                                       \
+    }
@@ -0,0 +1,35 @@
+#include "test_manager.h"
+
+#include <core/logger.h>
+
+#include "core/event_tests.h"
+#include "containers/aabb_tree_tests.h"
+#include "math/vmath_tests.h"
+#include "math/vrandom_tests.h"
+#include "systems/transform_system_tests.h"
+#include "renderer/occlusion_buffer_tests.h"
+#include "resources/mesh_simplify_tests.h"
+#include "resources/mesh_optimize_tests.h"
+#include "resources/mesh_quantize_tests.h"
+#include "resources/mesh_generate_tests.h"
+
+int main()
+{
+    TestManagerInit();
+
+    EventRegisterTests();
+    VMathRegisterTests();
+    RandomRegisterTests();
+    TransformSystemRegisterTests();
+    AABBTreeRegisterTests();
+    OcclusionBufferRegisterTests();
+    MeshSimplifyRegisterTests();
+    MeshOptimizeRegisterTests();
+    MeshQuantizeRegisterTests();
+    MeshGenerateRegisterTests();
+
+    VENG_DEBUG("Starting tests...");
+
+    u32 Failed = TestManagerRunTests();
+    return Failed ? 1 : 0;
+}
@@ -0,0 +1,907 @@
+#include "vmath_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <math/vmath.h>
+#include <math/vrandom.h>
+#include <math/vmath_batch.h>
+#include <core/clock.h>
+
+#include <math.h>
+
+#define VMATH_TEST_COUNT       1024
+#define VMATH_BENCHMARK_ROUNDS 256
+#define VMATH_ERROR_SAMPLES    (1 << 20)
+
+#if VENG_SIMD_AVX2
+#define VMATH_SIMD_PATH "AVX2"
+#elif VENG_SIMD_SSE
+#define VMATH_SIMD_PATH "SSE"
+#elif VENG_SIMD_NEON
+#define VMATH_SIMD_PATH "NEON"
+#else
+#define VMATH_SIMD_PATH "scalar"
+#endif
+
+static mat4 MatricesA[VMATH_TEST_COUNT];
+static mat4 MatricesB[VMATH_TEST_COUNT];
+static mat4 MatricesOut[VMATH_TEST_COUNT];
+static v4 Vectors[VMATH_TEST_COUNT];
+static v4 VectorsOut[VMATH_TEST_COUNT];
+
+// NOTE: The scalar versions the SIMD paths in vmath.h replaced, the reference for results and timings
+static mat4 ScalarMulMat4(mat4 A, mat4 B)
+{
+    mat4 Result;
+    for(u32 r = 0; r < 4; ++r)
+    {
+        for(u32 c = 0; c < 4; ++c)
+        {
+            Result.E[r * 4 + c] = A.E[r * 4 + 0] * B.E[0  + c] + 
+                                  A.E[r * 4 + 1] * B.E[4  + c] + 
+                                  A.E[r * 4 + 2] * B.E[8  + c] + 
+                                  A.E[r * 4 + 3] * B.E[12 + c];
+        }
+    }
+    return Result;
+}
+
+static v4 ScalarMulMat4V4(mat4 M, v4 V)
+{
+    v4 Result;
+    for(u32 Row = 0; Row < 4; ++Row)
+    {
+        Result.E[Row] = M.E[Row] * V.x + M.E[4 + Row] * V.y + M.E[8 + Row] * V.z + M.E[12 + Row] * V.w;
+    }
+    return Result;
+}
+
+static r32 ScalarInnerV4(v4 A, v4 B)
+{
+    return A.x * B.x + A.y * B.y + A.z * B.z + A.w * B.w;
+}
+
+static mat4 ScalarInverse(mat4 A)
+{
+    const r32* m = A.E;
+
+    r32 t0  = m[10] * m[15];
+    r32 t1  = m[14] * m[11];
+    r32 t2  = m[6]  * m[15];
+    r32 t3  = m[14] * m[7];
+    r32 t4  = m[6]  * m[11];
+    r32 t5  = m[10] * m[7];
+    r32 t6  = m[2]  * m[15];
+    r32 t7  = m[14] * m[3];
+    r32 t8  = m[2]  * m[11];
+    r32 t9  = m[10] * m[3];
+    r32 t10 = m[2]  * m[7];
+    r32 t11 = m[6]  * m[3];
+    r32 t12 = m[8]  * m[13];
+    r32 t13 = m[12] * m[9];
+    r32 t14 = m[4]  * m[13];
+    r32 t15 = m[12] * m[5];
+    r32 t16 = m[4]  * m[9];
+    r32 t17 = m[8]  * m[5];
+    r32 t18 = m[0]  * m[13];
+    r32 t19 = m[12] * m[1];
+    r32 t20 = m[0]  * m[9];
+    r32 t21 = m[8]  * m[1];
+    r32 t22 = m[0]  * m[5];
+    r32 t23 = m[4]  * m[1];
+
+    mat4 Result;
+    r32* o = Result.E;
+
+    o[0] = (t0 * m[5] + t3 * m[9] + t4  * m[13]) - (t1 * m[5] + t2 * m[9] + t5  * m[13]);
+    o[1] = (t1 * m[1] + t6 * m[9] + t9  * m[13]) - (t0 * m[1] + t7 * m[9] + t8  * m[13]);
+    o[2] = (t2 * m[1] + t7 * m[5] + t10 * m[13]) - (t3 * m[1] + t6 * m[5] + t11 * m[13]);
+    o[3] = (t5 * m[1] + t8 * m[5] + t11 * m[9] ) - (t4 * m[1] + t9 * m[5] + t10 * m[9] );
+
+    r32 d = 1.0f / (m[0] * o[0] + m[4] * o[1] + m[8] * o[2] + m[12] * o[3]);
+
+    o[0]  = d * o[0];
+    o[1]  = d * o[1];
+    o[2]  = d * o[2];
+    o[3]  = d * o[3];
+    o[4]  = d * ((t1  * m[4]  + t2  * m[8]  + t5  * m[12]) - (t0  * m[4]  + t3  * m[8]  + t4  * m[12]));
+    o[5]  = d * ((t0  * m[0]  + t7  * m[8]  + t8  * m[12]) - (t1  * m[0]  + t6  * m[8]  + t9  * m[12]));
+    o[6]  = d * ((t3  * m[0]  + t6  * m[4]  + t11 * m[12]) - (t2  * m[0]  + t7  * m[4]  + t10 * m[12]));
+    o[7]  = d * ((t4  * m[0]  + t9  * m[4]  + t10 * m[8])  - (t5  * m[0]  + t8  * m[4]  + t11 * m[8]));
+    o[8]  = d * ((t12 * m[7]  + t15 * m[11] + t16 * m[15]) - (t13 * m[7]  + t14 * m[11] + t17 * m[15]));
+    o[9]  = d * ((t13 * m[3]  + t18 * m[11] + t21 * m[15]) - (t12 * m[3]  + t19 * m[11] + t20 * m[15]));
+    o[10] = d * ((t14 * m[3]  + t19 * m[7]  + t22 * m[15]) - (t15 * m[3]  + t18 * m[7]  + t23 * m[15]));
+    o[11] = d * ((t17 * m[3]  + t20 * m[7]  + t23 * m[11]) - (t16 * m[3]  + t21 * m[7]  + t22 * m[11]));
+    o[12] = d * ((t14 * m[10] + t17 * m[14] + t13 * m[6])  - (t16 * m[14] + t12 * m[6]  + t15 * m[10]));
+    o[13] = d * ((t20 * m[14] + t12 * m[2]  + t19 * m[10]) - (t18 * m[10] + t21 * m[14] + t13 * m[2]));
+    o[14] = d * ((t18 * m[6]  + t23 * m[14] + t15 * m[2])  - (t22 * m[14] + t14 * m[2]  + t19 * m[6]));
+    o[15] = d * ((t22 * m[10] + t16 * m[2]  + t21 * m[6])  - (t20 * m[6]  + t23 * m[10] + t17 * m[2]));
+
+    return Result;
+}
+
+// NOTE: Random rotation, scale and translation, well conditioned enough for float inverses
+static mat4 RandomTRS(random_xoshiro* Random)
+{
+    v3 Angles = V3(RandomXoshiroR32InRange(Random, -PI32, PI32), 
+                   RandomXoshiroR32InRange(Random, -PI32, PI32), 
+                   RandomXoshiroR32InRange(Random, -PI32, PI32));
+    v3 Scales = V3(RandomXoshiroR32InRange(Random, 0.5f, 2.0f), 
+                   RandomXoshiroR32InRange(Random, 0.5f, 2.0f), 
+                   RandomXoshiroR32InRange(Random, 0.5f, 2.0f));
+    v3 Offset = V3(RandomXoshiroR32InRange(Random, -100.0f, 100.0f), 
+                   RandomXoshiroR32InRange(Random, -100.0f, 100.0f), 
+                   RandomXoshiroR32InRange(Random, -100.0f, 100.0f));
+    return MulMat4(MulMat4(Scale(Scales), EulerXYZ(Angles)), Translation(Offset));
+}
+
+static mat4 RandomRigid(random_xoshiro* Random)
+{
+    v3 Angles = V3(RandomXoshiroR32InRange(Random, -PI32, PI32), 
+                   RandomXoshiroR32InRange(Random, -PI32, PI32), 
+                   RandomXoshiroR32InRange(Random, -PI32, PI32));
+    v3 Offset = V3(RandomXoshiroR32InRange(Random, -100.0f, 100.0f), 
+                   RandomXoshiroR32InRange(Random, -100.0f, 100.0f), 
+                   RandomXoshiroR32InRange(Random, -100.0f, 100.0f));
+    return MulMat4(EulerXYZ(Angles), Translation(Offset));
+}
+
+static quat RandomRotation(random_xoshiro* Random)
+{
+    v3 Axis = V3(RandomXoshiroR32InRange(Random, -1.0f, 1.0f), 
+                 RandomXoshiroR32InRange(Random, -1.0f, 1.0f), 
+                 RandomXoshiroR32InRange(Random, -1.0f, 1.0f));
+    return QuatFromAxis(NormalizeV3(AddV3(Axis, V3(0.0f, 0.0f, 0.01f))), RandomXoshiroR32InRange(Random, -PI32, PI32), true);
+}
+
+static void FillInputs()
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 1234);
+
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        MatricesA[Index] = RandomTRS(&Random);
+        MatricesB[Index] = RandomTRS(&Random);
+        Vectors[Index] = V4(RandomXoshiroR32InRange(&Random, -10.0f, 10.0f), 
+                            RandomXoshiroR32InRange(&Random, -10.0f, 10.0f), 
+                            RandomXoshiroR32InRange(&Random, -10.0f, 10.0f), 1.0f);
+    }
+}
+
+static r32 MaxDifferenceMat4(mat4 A, mat4 B)
+{
+    r32 Max = 0.0f;
+    for(u32 Index = 0; Index < 16; ++Index)
+    {
+        r32 Difference = Abs(A.E[Index] - B.E[Index]);
+        Max = Difference > Max ? Difference : Max;
+    }
+    return Max;
+}
+
+u8 VMathSimdShouldMatchScalar()
+{
+    FillInputs();
+
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        mat4 A = MatricesA[Index];
+        mat4 B = MatricesB[Index];
+        v4 V = Vectors[Index];
+
+        // NOTE: Translations and products of the test matrices reach a few hundred, FMA and the order of the
+        // sums differ in the last bits
+        ExpectFloatToBe(0.0f, MaxDifferenceMat4(MulMat4(A, B), ScalarMulMat4(A, B)), 1e-3f);
+        ExpectFloatToBe(0.0f, MaxDifferenceMat4(Inverse(A), ScalarInverse(A)), 1e-3f);
+
+        v4 Transformed = MulMat4V4(A, V);
+        v4 Reference   = ScalarMulMat4V4(A, V);
+        for(u32 Component = 0; Component < 4; ++Component)
+        {
+            ExpectFloatToBe(Reference.E[Component], Transformed.E[Component], 1e-3f);
+        }
+
+        ExpectFloatToBe(ScalarInnerV4(V, V), InnerV4(V, V), 1e-3f);
+
+        v4 Sum = AddV4(V, Reference);
+        v4 Product = MulV4(V, Reference);
+        for(u32 Component = 0; Component < 4; ++Component)
+        {
+            ExpectFloatToBe(V.E[Component] + Reference.E[Component], Sum.E[Component], 0.0f);
+            ExpectFloatToBe(V.E[Component] * Reference.E[Component], Product.E[Component], 0.0f);
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Differences relative to the magnitude of the expected entry, absolute below 1
+static r32 MaxRelativeDifferenceMat4(mat4 Actual, mat4 Expected)
+{
+    r32 Max = 0.0f;
+    for(u32 Index = 0; Index < 16; ++Index)
+    {
+        r32 Magnitude  = Abs(Expected.E[Index]);
+        r32 Difference = Abs(Actual.E[Index] - Expected.E[Index]) / (Magnitude > 1.0f ? Magnitude : 1.0f);
+        Max = Difference > Max ? Difference : Max;
+    }
+    return Max;
+}
+
+u8 VMathInverseShouldGiveIdentity()
+{
+    FillInputs();
+
+    mat4 I = Identity();
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        ExpectFloatToBe(0.0f, MaxDifferenceMat4(MulMat4(MatricesA[Index], Inverse(MatricesA[Index])), I), 1e-4f);
+    }
+
+    return true;
+}
+
+u8 VMathInverseRigidShouldMatchInverse()
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 39);
+
+    mat4 I = Identity();
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        mat4 A = RandomRigid(&Random);
+        mat4 Inv = InverseRigid(A);
+        ExpectFloatToBe(0.0f, MaxRelativeDifferenceMat4(Inv, Inverse(A)), 1e-5f);
+        ExpectFloatToBe(0.0f, MaxDifferenceMat4(MulMat4(A, Inv), I), 1e-4f);
+    }
+
+    return true;
+}
+
+u8 VMathInverseAffineShouldMatchInverse()
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 3939);
+
+    mat4 I = Identity();
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        // NOTE: A rotation after a non uniform scale adds shear, the product covers every affine part
+        mat4 A = MulMat4(RandomTRS(&Random), RandomTRS(&Random));
+        mat4 Inv = InverseAffine(A);
+        ExpectFloatToBe(0.0f, MaxRelativeDifferenceMat4(Inv, Inverse(A)), 1e-4f);
+        ExpectFloatToBe(0.0f, MaxDifferenceMat4(MulMat4(A, Inv), I), 1e-4f);
+        ExpectFloatToBe(0.0f, Inv.E[3], 0.0f);
+        ExpectFloatToBe(0.0f, Inv.E[7], 0.0f);
+        ExpectFloatToBe(0.0f, Inv.E[11], 0.0f);
+        ExpectFloatToBe(1.0f, Inv.E[15], 0.0f);
+    }
+
+    return true;
+}
+
+u8 VMathViewBuildersShouldMatchInverse()
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 393939);
+
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        v3 Position = V3(RandomXoshiroR32InRange(&Random, -100.0f, 100.0f), 
+                         RandomXoshiroR32InRange(&Random, -100.0f, 100.0f), 
+                         RandomXoshiroR32InRange(&Random, -100.0f, 100.0f));
+        quat Rotation = RandomRotation(&Random);
+        v3 Scales = V3(RandomXoshiroR32InRange(&Random, 0.5f, 2.0f), 
+                       RandomXoshiroR32InRange(&Random, 0.5f, 2.0f), 
+                       RandomXoshiroR32InRange(&Random, 0.5f, 2.0f));
+
+        mat4 World = MulMat4(MulMat4(Scale(Scales), QuatToMat4(Rotation)), Translation(Position));
+        ExpectFloatToBe(0.0f, MaxRelativeDifferenceMat4(ViewFromTRS(Position, Rotation, Scales), Inverse(World)), 1e-4f);
+
+        // NOTE: LookAt is rigid, so the cheap inverse gives back the camera, placed at Position
+        v3 Target = AddV3(Position, V3(RandomXoshiroR32InRange(&Random, -10.0f, 10.0f), 
+                                       RandomXoshiroR32InRange(&Random, -10.0f, 10.0f), 
+                                       10.0f));
+        mat4 View = LookAt(Position, Target, V3(0.0f, 1.0f, 0.0f));
+        mat4 Camera = InverseRigid(View);
+        ExpectFloatToBe(0.0f, MaxRelativeDifferenceMat4(Camera, Inverse(View)), 1e-5f);
+        ExpectFloatToBe(Position.x, Camera.E[12], 1e-4f);
+        ExpectFloatToBe(Position.y, Camera.E[13], 1e-4f);
+        ExpectFloatToBe(Position.z, Camera.E[14], 1e-4f);
+    }
+
+    return true;
+}
+
+// NOTE: Not a pass / fail test, logs Inverse against the affine and rigid versions
+u8 VMathInverseBenchmark()
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 39);
+    for(u32 Index = 0;
+        Index < VMATH_TEST_COUNT;
+        ++Index)
+    {
+        MatricesA[Index] = RandomRigid(&Random);
+    }
+
+    clock Clock;
+    r32 Sink = 0.0f;
+    r64 Ops = (r64)VMATH_TEST_COUNT * VMATH_BENCHMARK_ROUNDS;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = Inverse(MatricesA[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 InverseTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = InverseAffine(MatricesA[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 AffineTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = InverseRigid(MatricesA[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 RigidTime = Clock.Elapsed;
+
+    VENG_INFO("vmath %s inverses, ns per call (checksum %f):", VMATH_SIMD_PATH, (r64)Sink);
+    VENG_INFO("  Inverse       %6.2f", InverseTime * 1e9 / Ops);
+    VENG_INFO("  InverseAffine %6.2f (%.2fx)", AffineTime * 1e9 / Ops, InverseTime / AffineTime);
+    VENG_INFO("  InverseRigid  %6.2f (%.2fx)", RigidTime * 1e9 / Ops, InverseTime / RigidTime);
+
+    return true;
+}
+
+// NOTE: Distance from the double precision result in units of the float spacing around it
+static r64 UlpError(r32 Approx, r64 Exact)
+{
+    s32 Exponent;
+    frexp(Exact, &Exponent);
+    r64 Ulp = ldexp(1.0, (Exponent - 24 < -149) ? -149 : Exponent - 24);
+    return fabs((r64)Approx - Exact) / Ulp;
+}
+
+static r32 SampleInRange(u32 Index, r32 Min, r32 Max)
+{
+    return Min + (Max - Min) * ((r32)Index / (r32)(VMATH_ERROR_SAMPLES - 1));
+}
+
+// NOTE: The bounds are the ones documented in vmath.h, every sweep includes both ends of its range
+u8 VMathFastSinCosShouldStayInErrorBounds()
+{
+    r64 MaxError = 0.0;
+    r64 MaxFarError = 0.0;
+    for(u32 Index = 0;
+        Index < VMATH_ERROR_SAMPLES;
+        ++Index)
+    {
+        r32 X = SampleInRange(Index, -8192.0f, 8192.0f);
+        r32 s, c;
+        FastSinCos(X, &s, &c);
+        r64 Error = fabs(s - sin(X));
+        Error = fmax(Error, fabs(c - cos(X)));
+        Error = fmax(Error, fabs(FastSin(X) - sin(X)));
+        Error = fmax(Error, fabs(FastCos(X) - cos(X)));
+        MaxError = fmax(MaxError, Error);
+
+        r32 FarX = SampleInRange(Index, -65536.0f, 65536.0f);
+        FastSinCos(FarX, &s, &c);
+        MaxFarError = fmax(MaxFarError, fmax(fabs(s - sin(FarX)), fabs(c - cos(FarX))));
+    }
+
+    VENG_DEBUG("FastSinCos max error %g for |X| <= 8192, %g up to 65536", MaxError, MaxFarError);
+    ExpectToBeTrue(MaxError <= 1e-7);
+    ExpectToBeTrue(MaxFarError <= 1e-6);
+    return true;
+}
+
+u8 VMathFastTanAtanShouldStayInErrorBounds()
+{
+    r64 MaxTanUlp = 0.0;
+    r64 MaxAtanUlp = 0.0;
+    r32 HalfPi = 0.5f * PI32;
+    for(u32 Index = 0;
+        Index < VMATH_ERROR_SAMPLES;
+        ++Index)
+    {
+        // NOTE: The open interval, (r32)(pi / 2) is just below pi / 2 but tan would still overflow the samples
+        r32 X = SampleInRange(Index, -HalfPi * 0.99999f, HalfPi * 0.99999f);
+        MaxTanUlp = fmax(MaxTanUlp, UlpError(FastTan(X), tan(X)));
+
+        r32 Small = SampleInRange(Index, -4.0f, 4.0f);
+        r32 Large = SampleInRange(Index, -1e6f, 1e6f);
+        MaxAtanUlp = fmax(MaxAtanUlp, UlpError(FastAtan(Small), atan(Small)));
+        MaxAtanUlp = fmax(MaxAtanUlp, UlpError(FastAtan(Large), atan(Large)));
+    }
+
+    VENG_DEBUG("FastTan max error %.2f ulp, FastAtan %.2f ulp", MaxTanUlp, MaxAtanUlp);
+    ExpectToBeTrue(MaxTanUlp <= 4.0);
+    ExpectToBeTrue(MaxAtanUlp <= 3.0);
+    return true;
+}
+
+u8 VMathFastRootsAndArcCosShouldStayInErrorBounds()
+{
+    r64 MaxArcCosError = 0.0;
+    r64 MaxInverseSquareRootError = 0.0;
+    for(u32 Index = 0;
+        Index < VMATH_ERROR_SAMPLES;
+        ++Index)
+    {
+        r32 X = SampleInRange(Index, -1.0f, 1.0f);
+        MaxArcCosError = fmax(MaxArcCosError, fabs(FastArcCos(X) - acos(X)));
+
+        // NOTE: Spread over many binades, the estimates repeat every power of four
+        r32 Positive = ldexpf(SampleInRange(Index, 1.0f, 4.0f), (s32)(Index % 64) - 32);
+        r64 Exact = 1.0 / sqrt(Positive);
+        MaxInverseSquareRootError = fmax(MaxInverseSquareRootError, fabs(FastInverseSquareRoot(Positive) - Exact) / Exact);
+        ExpectFloatToBe(sqrtf(Positive), FastSquareRoot(Positive), 0.0f);
+    }
+
+    VENG_DEBUG("FastArcCos max error %g, FastInverseSquareRoot %g relative", MaxArcCosError, MaxInverseSquareRootError);
+    ExpectToBeTrue(MaxArcCosError <= 3e-7);
+    ExpectToBeTrue(MaxInverseSquareRootError <= 3e-7);
+    return true;
+}
+
+u8 VMathBatchShouldMatchFastErrorBounds()
+{
+    static r32 X[VMATH_TEST_COUNT];
+    static r32 Sines[VMATH_TEST_COUNT];
+    static r32 Cosines[VMATH_TEST_COUNT];
+    static r32 Tangents[VMATH_TEST_COUNT];
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 40);
+
+    for(u32 Round = 0;
+        Round < 64;
+        ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            X[Index] = RandomXoshiroR32InRange(&Random, -8192.0f, 8192.0f);
+        }
+
+        // NOTE: Odd counts leave a scalar remainder after the SIMD groups
+        u64 Count = VMATH_TEST_COUNT - (Round & 7);
+        BatchSinCos(X, Sines, Cosines, Count);
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            ExpectToBeTrue(fabs(Sines[Index] - sin(X[Index])) <= 1e-7);
+            ExpectToBeTrue(fabs(Cosines[Index] - cos(X[Index])) <= 1e-7);
+        }
+
+        BatchSin(X, Sines, Count);
+        BatchCos(X, Cosines, Count);
+        BatchAtan(X, Tangents, Count);
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            ExpectToBeTrue(fabs(Sines[Index] - sin(X[Index])) <= 1e-7);
+            ExpectToBeTrue(fabs(Cosines[Index] - cos(X[Index])) <= 1e-7);
+            ExpectToBeTrue(UlpError(Tangents[Index], atan(X[Index])) <= 3.0);
+        }
+
+        // NOTE: In place, the outputs may alias the input
+        BatchSin(X, X, Count);
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            ExpectFloatToBe(Sines[Index], X[Index], 0.0f);
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Not a pass / fail test, logs the compiled SIMD path against the scalar reference
+u8 VMathSimdBenchmark()
+{
+    FillInputs();
+
+    clock Clock;
+    r32 Sink = 0.0f;
+    r64 Ops = (r64)VMATH_TEST_COUNT * VMATH_BENCHMARK_ROUNDS;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = MulMat4(MatricesA[Index], MatricesB[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 MulTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = ScalarMulMat4(MatricesA[Index], MatricesB[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 ScalarMulTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = Inverse(MatricesA[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 InverseTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            MatricesOut[Index] = ScalarInverse(MatricesA[Index]);
+        }
+        Sink += MatricesOut[Round].E[Round & 15];
+    }
+    ClockUpdate(&Clock);
+    r64 ScalarInverseTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            VectorsOut[Index] = MulMat4V4(MatricesA[Index], Vectors[Index]);
+        }
+        Sink += VectorsOut[Round].E[Round & 3];
+    }
+    ClockUpdate(&Clock);
+    r64 TransformTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            VectorsOut[Index] = ScalarMulMat4V4(MatricesA[Index], Vectors[Index]);
+        }
+        Sink += VectorsOut[Round].E[Round & 3];
+    }
+    ClockUpdate(&Clock);
+    r64 ScalarTransformTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            Sink += InnerV4(Vectors[Index], VectorsOut[Index]);
+        }
+    }
+    ClockUpdate(&Clock);
+    r64 InnerTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    for(u32 Round = 0; Round < VMATH_BENCHMARK_ROUNDS; ++Round)
+    {
+        for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+        {
+            Sink += ScalarInnerV4(Vectors[Index], VectorsOut[Index]);
+        }
+    }
+    ClockUpdate(&Clock);
+    r64 ScalarInnerTime = Clock.Elapsed;
+
+    VENG_INFO("vmath %s against scalar, ns per call (checksum %f):", VMATH_SIMD_PATH, (r64)Sink);
+    VENG_INFO("  MulMat4    %6.2f / %6.2f (%.2fx)", MulTime * 1e9 / Ops, ScalarMulTime * 1e9 / Ops, ScalarMulTime / MulTime);
+    VENG_INFO("  Inverse    %6.2f / %6.2f (%.2fx)", InverseTime * 1e9 / Ops, ScalarInverseTime * 1e9 / Ops, ScalarInverseTime / InverseTime);
+    VENG_INFO("  MulMat4V4  %6.2f / %6.2f (%.2fx)", TransformTime * 1e9 / Ops, ScalarTransformTime * 1e9 / Ops, ScalarTransformTime / TransformTime);
+    VENG_INFO("  InnerV4    %6.2f / %6.2f (%.2fx)", InnerTime * 1e9 / Ops, ScalarInnerTime * 1e9 / Ops, ScalarInnerTime / InnerTime);
+
+    return true;
+}
+
+// NOTE: Lengths that leave every possible remainder for the 4 and 8 wide paths, plus one long odd run
+static const u32 BatchCounts[] = {1, 2, 3, 4, 5, 7, 8, 9, 13, VMATH_TEST_COUNT - 3};
+#define VMATH_BATCH_COUNT_COUNT (sizeof(BatchCounts) / sizeof(BatchCounts[0]))
+
+static r32 BatchX[VMATH_TEST_COUNT];
+static r32 BatchY[VMATH_TEST_COUNT];
+static r32 BatchZ[VMATH_TEST_COUNT];
+static r32 BatchW[VMATH_TEST_COUNT];
+static r32 BatchOutX[VMATH_TEST_COUNT];
+static r32 BatchOutY[VMATH_TEST_COUNT];
+static r32 BatchOutZ[VMATH_TEST_COUNT];
+
+u8 VMathBatchTransformPointsShouldMatchMulMat4V4()
+{
+    FillInputs();
+
+    for(u32 CountIndex = 0; CountIndex < VMATH_BATCH_COUNT_COUNT; ++CountIndex)
+    {
+        u32 Count = BatchCounts[CountIndex];
+        mat4 M = MatricesA[CountIndex];
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            BatchX[Index] = Vectors[Index].x;
+            BatchY[Index] = Vectors[Index].y;
+            BatchZ[Index] = Vectors[Index].z;
+        }
+
+        // NOTE: Poison one past the end so a tail that runs over is caught
+        BatchOutX[Count] = -12345.0f;
+        BatchTransformPoints(M, BatchX, BatchY, BatchZ, BatchOutX, BatchOutY, BatchOutZ, Count);
+        ExpectFloatToBe(-12345.0f, BatchOutX[Count], 0.0f);
+
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            v4 Reference = ScalarMulMat4V4(M, V4(BatchX[Index], BatchY[Index], BatchZ[Index], 1.0f));
+            ExpectFloatToBe(Reference.x, BatchOutX[Index], 1e-3f);
+            ExpectFloatToBe(Reference.y, BatchOutY[Index], 1e-3f);
+            ExpectFloatToBe(Reference.z, BatchOutZ[Index], 1e-3f);
+        }
+    }
+
+    return true;
+}
+
+u8 VMathBatchMulMat4ShouldMatchMulMat4()
+{
+    FillInputs();
+
+    for(u32 CountIndex = 0; CountIndex < VMATH_BATCH_COUNT_COUNT; ++CountIndex)
+    {
+        u32 Count = BatchCounts[CountIndex];
+        mat4 Parent = MatricesB[CountIndex];
+        MatricesOut[Count].E[0] = -12345.0f;
+        BatchMulMat4(MatricesA, Parent, MatricesOut, Count);
+        ExpectFloatToBe(-12345.0f, MatricesOut[Count].E[0], 0.0f);
+
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            ExpectFloatToBe(0.0f, MaxDifferenceMat4(MatricesOut[Index], ScalarMulMat4(MatricesA[Index], Parent)), 1e-3f);
+        }
+    }
+
+    return true;
+}
+
+u8 VMathBatchComposeTRSShouldMatchMulMat4()
+{
+    static r32 RotationX[VMATH_TEST_COUNT];
+    static r32 RotationY[VMATH_TEST_COUNT];
+    static r32 RotationZ[VMATH_TEST_COUNT];
+    static r32 RotationW[VMATH_TEST_COUNT];
+    static r32 ScaleX[VMATH_TEST_COUNT];
+    static r32 ScaleY[VMATH_TEST_COUNT];
+    static r32 ScaleZ[VMATH_TEST_COUNT];
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 37);
+    for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+    {
+        // NOTE: Rotations are scaled off unit length, the kernel has to normalize them like the reference does
+        quat Rotation = RandomRotation(&Random);
+        r32 Length = RandomXoshiroR32InRange(&Random, 0.5f, 2.0f);
+        RotationX[Index] = Rotation.x * Length;
+        RotationY[Index] = Rotation.y * Length;
+        RotationZ[Index] = Rotation.z * Length;
+        RotationW[Index] = Rotation.w * Length;
+        ScaleX[Index] = RandomXoshiroR32InRange(&Random, 0.5f, 2.0f);
+        ScaleY[Index] = RandomXoshiroR32InRange(&Random, 0.5f, 2.0f);
+        ScaleZ[Index] = RandomXoshiroR32InRange(&Random, 0.5f, 2.0f);
+        BatchX[Index] = RandomXoshiroR32InRange(&Random, -100.0f, 100.0f);
+        BatchY[Index] = RandomXoshiroR32InRange(&Random, -100.0f, 100.0f);
+        BatchZ[Index] = RandomXoshiroR32InRange(&Random, -100.0f, 100.0f);
+    }
+
+    trs_soa Input;
+    Input.PositionX = BatchX;
+    Input.PositionY = BatchY;
+    Input.PositionZ = BatchZ;
+    Input.RotationX = RotationX;
+    Input.RotationY = RotationY;
+    Input.RotationZ = RotationZ;
+    Input.RotationW = RotationW;
+    Input.ScaleX = ScaleX;
+    Input.ScaleY = ScaleY;
+    Input.ScaleZ = ScaleZ;
+
+    for(u32 CountIndex = 0; CountIndex < VMATH_BATCH_COUNT_COUNT; ++CountIndex)
+    {
+        u32 Count = BatchCounts[CountIndex];
+        MatricesOut[Count].E[0] = -12345.0f;
+        BatchComposeTRS(&Input, MatricesOut, Count);
+        ExpectFloatToBe(-12345.0f, MatricesOut[Count].E[0], 0.0f);
+
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            quat Rotation = NormalizeQuat(V4(RotationX[Index], RotationY[Index], RotationZ[Index], RotationW[Index]));
+            mat4 Reference = MulMat4(MulMat4(Scale(V3(ScaleX[Index], ScaleY[Index], ScaleZ[Index])), QuatToMat4(Rotation)), 
+                                     Translation(V3(BatchX[Index], BatchY[Index], BatchZ[Index])));
+            ExpectFloatToBe(0.0f, MaxDifferenceMat4(MatricesOut[Index], Reference), 1e-4f);
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Smallest distance from the sphere's surface to one of the planes, results this close to a plane may differ
+// in the last bit between the SIMD and scalar sums
+static r32 SphereMarginToFrustum(const frustum* Frustum, v3 Center, r32 Radius)
+{
+    r32 Margin = 1e30f;
+    for(u32 PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        const plane_3d* Plane = &Frustum->Planes[PlaneIndex];
+        r32 Distance = Abs(InnerV3(Plane->Normal, Center) + Plane->Distance + Radius);
+        Margin = Distance < Margin ? Distance : Margin;
+    }
+    return Margin;
+}
+
+u8 VMathBatchCullSpheresShouldMatchFrustumIntersectsSphere()
+{
+    static u8 Visible[VMATH_TEST_COUNT];
+
+    mat4 View = LookAt(V3(3.0f, 2.0f, 10.0f), V3(0.0f, 0.0f, 0.0f), V3(0.0f, 1.0f, 0.0f));
+    frustum Frustum = FrustumFromMatrix(MulMat4(View, Perspective(DegToRad(60.0f), 16.0f / 9.0f, 0.1f, 50.0f)));
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 3742);
+    for(u32 Index = 0; Index < VMATH_TEST_COUNT; ++Index)
+    {
+        BatchX[Index] = RandomXoshiroR32InRange(&Random, -40.0f, 40.0f);
+        BatchY[Index] = RandomXoshiroR32InRange(&Random, -40.0f, 40.0f);
+        BatchZ[Index] = RandomXoshiroR32InRange(&Random, -50.0f, 20.0f);
+        BatchW[Index] = RandomXoshiroR32InRange(&Random, 0.1f, 5.0f);
+    }
+
+    u32 VisibleCount = 0;
+    for(u32 CountIndex = 0; CountIndex < VMATH_BATCH_COUNT_COUNT; ++CountIndex)
+    {
+        u32 Count = BatchCounts[CountIndex];
+        Visible[Count] = 0xCD;
+        BatchCullSpheres(&Frustum, BatchX, BatchY, BatchZ, BatchW, Visible, Count);
+        ExpectShouldBe(0xCD, Visible[Count]);
+
+        VisibleCount = 0;
+        for(u32 Index = 0; Index < Count; ++Index)
+        {
+            v3 Center = V3(BatchX[Index], BatchY[Index], BatchZ[Index]);
+            ExpectToBeTrue(Visible[Index] <= 1);
+            VisibleCount += Visible[Index];
+            if(SphereMarginToFrustum(&Frustum, Center, BatchW[Index]) > 1e-4f)
+            {
+                ExpectShouldBe(FrustumIntersectsSphere(&Frustum, Center, BatchW[Index]), Visible[Index]);
+            }
+        }
+    }
+
+    // NOTE: Both outcomes have to be exercised for the comparison to mean anything
+    ExpectToBeTrue(VisibleCount > 0);
+    ExpectToBeTrue(VisibleCount < VMATH_TEST_COUNT - 3);
+    return true;
+}
+
+// NOTE: Camera at (10, 0, 0) looking down -z with a 90 degree square frustum from 1 to 100, so the side planes are
+// x - 10 = +-z and y = +-z. The camera is off the origin so a View and Projection swapped in the product shows up.
+typedef struct known_sphere
+{
+    v3 Center;
+    r32 Radius;
+    b8 Visible;
+} known_sphere;
+
+static const known_sphere KnownSpheres[] = 
+{
+    {{10.0f,  0.0f,   -10.0f}, 1.0f, true},   // centered in front
+    {{10.0f,  0.0f,    10.0f}, 1.0f, false},  // behind the camera
+    {{10.0f,  0.0f,  -150.0f}, 1.0f, false},  // past the far plane
+    {{10.0f,  0.0f,  -100.5f}, 1.0f, true},   // straddles the far plane
+    {{-2.0f,  0.0f,   -10.0f}, 1.0f, false},  // 1.41 outside the left plane
+    {{-2.0f,  0.0f,   -10.0f}, 2.0f, true},   // the same center, now reaching in
+    {{10.0f, 15.0f,   -10.0f}, 1.0f, false},  // above the top plane
+    {{10.0f,  0.0f,    -0.5f}, 0.6f, true},   // straddles the near plane
+    {{10.0f,  0.0f,    -0.5f}, 0.4f, false},  // in front of the near plane
+    {{ 0.0f,  0.0f,   -10.0f}, 0.1f, true},   // inside, close to the left plane
+    {{-10.0f, 0.0f,     0.0f}, 1.0f, false},  // where an untranslated camera would see it
+};
+#define KNOWN_SPHERE_COUNT (sizeof(KnownSpheres) / sizeof(KnownSpheres[0]))
+
+u8 VMathFrustumShouldCullKnownSpheres()
+{
+    mat4 View = LookAt(V3(10.0f, 0.0f, 0.0f), V3(10.0f, 0.0f, -1.0f), V3(0.0f, 1.0f, 0.0f));
+    mat4 Projection = Perspective(DegToRad(90.0f), 1.0f, 1.0f, 100.0f);
+    frustum Frustum = FrustumFromMatrix(MulMat4(View, Projection));
+
+    // NOTE: Normalized planes facing inward, a point in the middle of the frustum is in front of all of them
+    for(u32 PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        const plane_3d* Plane = &Frustum.Planes[PlaneIndex];
+        ExpectFloatToBe(1.0f, LengthSquaredV3(Plane->Normal), 1e-5f);
+        ExpectToBeTrue(InnerV3(Plane->Normal, V3(10.0f, 0.0f, -50.0f)) + Plane->Distance > 0.0f);
+    }
+
+    r32 X[KNOWN_SPHERE_COUNT];
+    r32 Y[KNOWN_SPHERE_COUNT];
+    r32 Z[KNOWN_SPHERE_COUNT];
+    r32 Radius[KNOWN_SPHERE_COUNT];
+    u8 Visible[KNOWN_SPHERE_COUNT];
+    for(u32 Index = 0; Index < KNOWN_SPHERE_COUNT; ++Index)
+    {
+        const known_sphere* Sphere = &KnownSpheres[Index];
+        ExpectShouldBe(Sphere->Visible, FrustumIntersectsSphere(&Frustum, Sphere->Center, Sphere->Radius));
+        X[Index] = Sphere->Center.x;
+        Y[Index] = Sphere->Center.y;
+        Z[Index] = Sphere->Center.z;
+        Radius[Index] = Sphere->Radius;
+    }
+
+    // NOTE: The SoA cull the renderer uses has to agree, the count leaves a SIMD remainder
+    BatchCullSpheres(&Frustum, X, Y, Z, Radius, Visible, KNOWN_SPHERE_COUNT);
+    for(u32 Index = 0; Index < KNOWN_SPHERE_COUNT; ++Index)
+    {
+        ExpectShouldBe(KnownSpheres[Index].Visible, Visible[Index]);
+    }
+
+    return true;
+}
+
+void VMathRegisterTests()
+{
+    TestManagerRegisterTest(VMathSimdShouldMatchScalar, "vmath SIMD paths should match the scalar code");
+    TestManagerRegisterTest(VMathInverseShouldGiveIdentity, "vmath Inverse times the matrix should be the identity");
+    TestManagerRegisterTest(VMathSimdBenchmark, "vmath SIMD against scalar benchmark");
+    TestManagerRegisterTest(VMathInverseRigidShouldMatchInverse, "vmath InverseRigid should match Inverse on rigid matrices");
+    TestManagerRegisterTest(VMathInverseAffineShouldMatchInverse, "vmath InverseAffine should match Inverse on affine matrices");
+    TestManagerRegisterTest(VMathViewBuildersShouldMatchInverse, "vmath ViewFromTRS and LookAt should match Inverse");
+    TestManagerRegisterTest(VMathInverseBenchmark, "vmath inverse benchmark");
+    TestManagerRegisterTest(VMathFastSinCosShouldStayInErrorBounds, "vmath FastSin, FastCos and FastSinCos should stay in their error bounds");
+    TestManagerRegisterTest(VMathFastTanAtanShouldStayInErrorBounds, "vmath FastTan and FastAtan should stay in their error bounds");
+    TestManagerRegisterTest(VMathFastRootsAndArcCosShouldStayInErrorBounds, "vmath FastArcCos and the square roots should stay in their error bounds");
+    TestManagerRegisterTest(VMathBatchTransformPointsShouldMatchMulMat4V4, "vmath BatchTransformPoints should match MulMat4V4 including the tail");
+    TestManagerRegisterTest(VMathBatchMulMat4ShouldMatchMulMat4, "vmath BatchMulMat4 should match MulMat4 including the tail");
+    TestManagerRegisterTest(VMathBatchComposeTRSShouldMatchMulMat4, "vmath BatchComposeTRS should match the composed TRS matrices including the tail");
+    TestManagerRegisterTest(VMathBatchCullSpheresShouldMatchFrustumIntersectsSphere, "vmath BatchCullSpheres should match FrustumIntersectsSphere including the tail");
+    TestManagerRegisterTest(VMathFrustumShouldCullKnownSpheres, "vmath frustum from MulMat4(View, Projection) should cull known spheres");
+    TestManagerRegisterTest(VMathBatchShouldMatchFastErrorBounds, "vmath batch transcendentals should stay in the Fast error bounds");
+}
@@ -0,0 +1,128 @@
+#include "vrandom_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <math/vrandom.h>
+
+// NOTE: 8 full groups and a partial one, the fill functions have to drop the rest of the last group
+#define RANDOM_FILL_COUNT (8 * 8 + 5)
+#define RANDOM_FILL_GROUPS ((RANDOM_FILL_COUNT + 7) / 8)
+
+u8 RandomXoshiroShouldMatchReferenceSequence()
+{
+    // NOTE: Outputs of the reference xoshiro256** for the state {1, 2, 3, 4}
+    random_xoshiro Random = {{1, 2, 3, 4}};
+    ExpectToBeTrue(RandomXoshiroNext(&Random) == 11520ull);
+    ExpectToBeTrue(RandomXoshiroNext(&Random) == 0ull);
+    ExpectToBeTrue(RandomXoshiroNext(&Random) == 1509978240ull);
+    ExpectToBeTrue(RandomXoshiroNext(&Random) == 1215971899390074240ull);
+
+    // NOTE: The reference jump polynomial applied to the same state
+    random_xoshiro Jumped = {{1, 2, 3, 4}};
+    RandomXoshiroJump(&Jumped);
+    ExpectToBeTrue(RandomXoshiroNext(&Jumped) == 0xBBD2F312298443D8ull);
+    ExpectToBeTrue(RandomXoshiroNext(&Jumped) == 0x62E57DB2D5706577ull);
+
+    // NOTE: SplitMix64 from seed 1234567 is the reference seeding sequence
+    u64 Seed = 1234567;
+    ExpectToBeTrue(RandomSplitMix64(&Seed) == 0x599ED017FB08FC85ull);
+    ExpectToBeTrue(RandomSplitMix64(&Seed) == 0x2C73F08458540FA5ull);
+
+    // NOTE: Seeding goes through SplitMix64, these pin the whole path from a u64 seed
+    static const u64 Seeded42[] = {0x15780B2E0C2EC716ull, 0x6104D9866D113A7Eull, 0xAE17533239E499A1ull, 
+                                   0xECB8AD4703B360A1ull, 0xFDE6DC7FE2EC5E64ull, 0xC50DA53101795238ull};
+    RandomXoshiroSeed(&Random, 42);
+    for(u32 Index = 0; Index < 6; ++Index)
+    {
+        ExpectToBeTrue(RandomXoshiroNext(&Random) == Seeded42[Index]);
+    }
+    return true;
+}
+
+u8 RandomPCGShouldMatchReferenceSequence()
+{
+    // NOTE: The pcg32-demo output for initstate 42 and initseq 54
+    static const u32 Expected[] = {0xA15C02B7, 0x7B47F409, 0xBA1D3330, 0x83D2F293, 0xBFA4784B, 0xCBED606E};
+
+    random_pcg Random;
+    RandomPCGSeed(&Random, 42, 54);
+    for(u32 Index = 0; Index < 6; ++Index)
+    {
+        ExpectShouldBe(Expected[Index], RandomPCGNext(&Random));
+    }
+
+    // NOTE: Another stream of the same seed is a different sequence
+    random_pcg Other;
+    RandomPCGSeed(&Other, 42, 55);
+    RandomPCGSeed(&Random, 42, 54);
+    ExpectShouldNotBe(RandomPCGNext(&Random), RandomPCGNext(&Other));
+    return true;
+}
+
+// NOTE: What a random_stream4 must produce, built from the scalar generator: lane n is the seed jumped n times and
+// gives values 2n (low half) and 2n + 1 (high half) of every group of 8
+static void ScalarStream4(u64 Seed, u32 GroupCount, u32* Out)
+{
+    random_xoshiro Lanes[4];
+    RandomXoshiroSeed(&Lanes[0], Seed);
+    for(u32 Lane = 1; Lane < 4; ++Lane)
+    {
+        Lanes[Lane] = Lanes[Lane - 1];
+        RandomXoshiroJump(&Lanes[Lane]);
+    }
+
+    for(u32 Group = 0; Group < GroupCount; ++Group)
+    {
+        for(u32 Lane = 0; Lane < 4; ++Lane)
+        {
+            u64 Value = RandomXoshiroNext(&Lanes[Lane]);
+            Out[Group * 8 + Lane * 2 + 0] = (u32)Value;
+            Out[Group * 8 + Lane * 2 + 1] = (u32)(Value >> 32);
+        }
+    }
+}
+
+u8 RandomFillShouldMatchScalarLanes()
+{
+    u32 Expected[RANDOM_FILL_GROUPS * 2 * 8];
+    ScalarStream4(777, RANDOM_FILL_GROUPS * 2, Expected);
+
+    // NOTE: The SIMD path handles the full groups and the scalar one the partial group, both must line up with
+    // the scalar lanes bit for bit. The second call starts at the next whole group.
+    random_stream4 Stream;
+    RandomStream4Seed(&Stream, 777);
+    u32 Values[RANDOM_FILL_COUNT + 1];
+    Values[RANDOM_FILL_COUNT] = 0xDEADBEEF;
+    RandomFillU32(&Stream, Values, RANDOM_FILL_COUNT);
+    ExpectShouldBe(0xDEADBEEF, Values[RANDOM_FILL_COUNT]);
+    for(u32 Index = 0; Index < RANDOM_FILL_COUNT; ++Index)
+    {
+        ExpectShouldBe(Expected[Index], Values[Index]);
+    }
+
+    RandomFillU32(&Stream, Values, RANDOM_FILL_COUNT);
+    for(u32 Index = 0; Index < RANDOM_FILL_COUNT; ++Index)
+    {
+        ExpectShouldBe(Expected[RANDOM_FILL_GROUPS * 8 + Index], Values[Index]);
+    }
+
+    // NOTE: Floats are the top 24 bits of the same values. The paths may differ in the last bit where the scalar
+    // multiply and add get fused, hence a tolerance of one ulp of the range.
+    r32 Floats[RANDOM_FILL_COUNT];
+    RandomStream4Seed(&Stream, 777);
+    RandomFillR32(&Stream, Floats, RANDOM_FILL_COUNT, -4.0f, 4.0f);
+    for(u32 Index = 0; Index < RANDOM_FILL_COUNT; ++Index)
+    {
+        r32 Reference = -4.0f + (r32)(Expected[Index] >> 8) * (1.0f / 16777216.0f) * 8.0f;
+        ExpectFloatToBe(Reference, Floats[Index], 8.0f / 8388608.0f);
+        ExpectToBeTrue(Floats[Index] >= -4.0f && Floats[Index] < 4.0f);
+    }
+    return true;
+}
+
+void RandomRegisterTests()
+{
+    TestManagerRegisterTest(RandomXoshiroShouldMatchReferenceSequence, "Random xoshiro256** should match the reference sequence");
+    TestManagerRegisterTest(RandomPCGShouldMatchReferenceSequence, "Random PCG32 should match the reference sequence");
+    TestManagerRegisterTest(RandomFillShouldMatchScalarLanes, "Random batch fills should match the scalar generator lane by lane");
+}
@@ -0,0 +1,230 @@
+#include "occlusion_buffer_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <renderer/occlusion_buffer.h>
+
+// NOTE: With an identity view projection world x, y and z are NDC, so pixel coverage is easy to predict
+static const r32 QuadPositions[] = 
+{
+    -1.0f, -1.0f, 0.0f,
+     1.0f, -1.0f, 0.0f,
+     1.0f,  1.0f, 0.0f,
+    -1.0f,  1.0f, 0.0f,
+};
+static const u32 QuadIndices[] = {0, 1, 2, 0, 2, 3};
+
+// NOTE: The unit quad scaled to HalfSize and moved to Center
+static mat4 QuadModel(v3 Center, r32 HalfSize)
+{
+    return MulMat4(Scale(V3(HalfSize, HalfSize, 1.0f)), Translation(Center));
+}
+
+static extents_3d Box(v3 Min, v3 Max)
+{
+    extents_3d Result;
+    Result.Min = Min;
+    Result.Max = Max;
+    return Result;
+}
+
+u8 OcclusionBufferShouldBuildMaxDepthPyramid()
+{
+    occlusion_buffer Buffer;
+    OcclusionBufferCreate(100, 60, &Buffer);
+
+    // NOTE: Levels halve rounding up down to 1x1
+    ExpectShouldBe(8, Buffer.LevelCount);
+    ExpectShouldBe(100, Buffer.LevelWidth[0]);
+    ExpectShouldBe(60, Buffer.LevelHeight[0]);
+    ExpectShouldBe(13, Buffer.LevelWidth[3]);
+    ExpectShouldBe(8, Buffer.LevelHeight[3]);
+    ExpectShouldBe(1, Buffer.LevelWidth[7]);
+    ExpectShouldBe(1, Buffer.LevelHeight[7]);
+    ExpectShouldBe(Buffer.LevelOffset[7] + 1, Buffer.DepthCount);
+
+    OcclusionBufferBegin(&Buffer, Identity());
+    for(u32 y = 0; y < Buffer.Height; ++y)
+    {
+        for(u32 x = 0; x < Buffer.Width; ++x)
+        {
+            Buffer.Depth[y * Buffer.Width + x] = (r32)((x * 7 + y * 13) % 97) / 97.0f;
+        }
+    }
+    OcclusionBufferBuildPyramid(&Buffer);
+
+    // NOTE: A texel of level L holds the farthest depth of the 2^L x 2^L level 0 pixels it covers
+    for(u32 Level = 1; Level < Buffer.LevelCount; ++Level)
+    {
+        for(u32 y = 0; y < Buffer.LevelHeight[Level]; ++y)
+        {
+            for(u32 x = 0; x < Buffer.LevelWidth[Level]; ++x)
+            {
+                r32 Expected = 0.0f;
+                for(u32 SourceY = y << Level; SourceY < ((y + 1) << Level) && SourceY < Buffer.Height; ++SourceY)
+                {
+                    for(u32 SourceX = x << Level; SourceX < ((x + 1) << Level) && SourceX < Buffer.Width; ++SourceX)
+                    {
+                        r32 Sample = Buffer.Depth[SourceY * Buffer.Width + SourceX];
+                        Expected = Sample > Expected ? Sample : Expected;
+                    }
+                }
+
+                r32 Actual = Buffer.Depth[Buffer.LevelOffset[Level] + y * Buffer.LevelWidth[Level] + x];
+                ExpectFloatToBe(Expected, Actual, 0.0f);
+            }
+        }
+    }
+
+    OcclusionBufferDestroy(&Buffer);
+    return true;
+}
+
+u8 OcclusionBufferShouldRasterizeCoveredPixels()
+{
+    occlusion_buffer Buffer;
+    OcclusionBufferCreate(64, 64, &Buffer);
+    OcclusionBufferBegin(&Buffer, Identity());
+
+    // NOTE: NDC -0.5..0.5 spans pixels 16..48, the centers 16.5..47.5 are inside. Both triangles cover the diagonal.
+    OcclusionBufferRasterize(&Buffer, QuadModel(V3(0.0f, 0.0f, 0.5f), 0.5f), QuadPositions, sizeof(r32) * 3, 4, QuadIndices, 6);
+    ExpectShouldBe(2, Buffer.OccluderTriangleCount);
+
+    for(u32 y = 0; y < 64; ++y)
+    {
+        for(u32 x = 0; x < 64; ++x)
+        {
+            b8 Inside = x >= 16 && x < 48 && y >= 16 && y < 48;
+            ExpectFloatToBe(Inside ? 0.5f : 1.0f, Buffer.Depth[y * 64 + x], 1e-6f);
+        }
+    }
+
+    // NOTE: Farther occluders never overwrite nearer ones
+    OcclusionBufferRasterize(&Buffer, QuadModel(V3(0.0f, 0.0f, 0.75f), 1.0f), QuadPositions, sizeof(r32) * 3, 4, QuadIndices, 6);
+    ExpectFloatToBe(0.5f, Buffer.Depth[32 * 64 + 32], 1e-6f);
+    ExpectFloatToBe(0.75f, Buffer.Depth[0], 1e-6f);
+
+    OcclusionBufferDestroy(&Buffer);
+    return true;
+}
+
+u8 OcclusionBufferShouldStoreConservativeDepth()
+{
+    occlusion_buffer Buffer;
+    OcclusionBufferCreate(64, 64, &Buffer);
+    OcclusionBufferBegin(&Buffer, Identity());
+
+    // NOTE: Depth runs from 0.2 on the left to 0.8 on the right, 0.6 / 64 per pixel
+    const r32 Positions[] = 
+    {
+        -1.0f, -1.0f, 0.2f,
+         1.0f, -1.0f, 0.8f,
+         1.0f,  1.0f, 0.8f,
+    };
+    const u32 Indices[] = {0, 1, 2};
+    OcclusionBufferRasterize(&Buffer, Identity(), Positions, sizeof(r32) * 3, 3, Indices, 3);
+
+    u32 Covered = 0;
+    for(u32 y = 0; y < 64; ++y)
+    {
+        for(u32 x = 0; x < 64; ++x)
+        {
+            r32 Depth = Buffer.Depth[y * 64 + x];
+            if(Depth == 1.0f)
+            {
+                continue;
+            }
+
+            // NOTE: Every stored sample is at least as far as the triangle anywhere in its pixel
+            r32 FarthestInPixel = 0.2f + 0.6f * (r32)(x + 1) / 64.0f;
+            ExpectToBeTrue(Depth >= (FarthestInPixel < 0.8f ? FarthestInPixel : 0.8f) - 1e-5f);
+            ExpectToBeTrue(Depth <= 0.8f);
+            ++Covered;
+        }
+    }
+
+    // NOTE: Centers on or right of the diagonal, 64 * 65 / 2
+    ExpectShouldBe(2080, Covered);
+
+    OcclusionBufferDestroy(&Buffer);
+    return true;
+}
+
+u8 OcclusionBufferShouldCullBoxesBehindOccluders()
+{
+    occlusion_buffer Buffer;
+    OcclusionBufferCreate(64, 64, &Buffer);
+
+    // NOTE: Without occluders everything is visible
+    OcclusionBufferBegin(&Buffer, Identity());
+    OcclusionBufferBuildPyramid(&Buffer);
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.1f, -0.1f, 0.9f), V3(0.1f, 0.1f, 0.95f))));
+
+    OcclusionBufferRasterize(&Buffer, QuadModel(V3(0.0f, 0.0f, 0.2f), 0.8f), QuadPositions, sizeof(r32) * 3, 4, QuadIndices, 6);
+    OcclusionBufferBuildPyramid(&Buffer);
+
+    ExpectToBeFalse(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.05f, -0.05f, 0.5f), V3(0.05f, 0.05f, 0.6f))));
+    ExpectToBeFalse(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.3f, 0.1f, 0.5f), V3(-0.1f, 0.3f, 0.6f))));
+
+    // NOTE: Large boxes are tested on a coarse level, whose texels here reach past the occluder's edge. The
+    // answer is conservative, the box stays visible until an occluder covers those texels too.
+    extents_3d Large = Box(V3(-0.7f, -0.7f, 0.5f), V3(0.7f, 0.7f, 0.6f));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Large));
+
+    // NOTE: In front of it, poking out at the side, straddling its depth, off screen and through the near plane
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.1f, -0.1f, 0.05f), V3(0.1f, 0.1f, 0.1f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(0.7f, -0.1f, 0.5f), V3(0.95f, 0.1f, 0.6f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.1f, -0.1f, 0.1f), V3(0.1f, 0.1f, 0.6f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(1.5f, 1.5f, 0.5f), V3(2.0f, 2.0f, 0.6f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.1f, -0.1f, -2.0f), V3(0.1f, 0.1f, 0.6f))));
+
+    OcclusionBufferRasterize(&Buffer, QuadModel(V3(0.0f, 0.0f, 0.3f), 1.0f), QuadPositions, sizeof(r32) * 3, 4, QuadIndices, 6);
+    OcclusionBufferBuildPyramid(&Buffer);
+    ExpectToBeFalse(OcclusionBufferTestExtents(&Buffer, Large));
+
+    OcclusionBufferDestroy(&Buffer);
+    return true;
+}
+
+u8 OcclusionBufferShouldCullWithPerspective()
+{
+    occlusion_buffer Buffer;
+    OcclusionBufferCreate(128, 72, &Buffer);
+
+    mat4 View = LookAt(V3(0.0f, 0.0f, 0.0f), V3(0.0f, 0.0f, -1.0f), V3(0.0f, 1.0f, 0.0f));
+    mat4 Projection = Perspective(DegToRad(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    OcclusionBufferBegin(&Buffer, MulMat4(View, Projection));
+
+    // NOTE: A 4x4 wall 10 units in front of the camera, given as vertex_3d so the stride skips the texture coordinates
+    vertex_3d Wall[4];
+    for(u32 Corner = 0; Corner < 4; ++Corner)
+    {
+        Wall[Corner].Position = V3(QuadPositions[Corner * 3 + 0] * 2.0f, QuadPositions[Corner * 3 + 1] * 2.0f, -10.0f);
+        Wall[Corner].TexCoord = V2(0.0f, 0.0f);
+    }
+    OcclusionBufferRasterize(&Buffer, Identity(), Wall, sizeof(vertex_3d), 4, QuadIndices, 6);
+    ExpectShouldBe(2, Buffer.OccluderTriangleCount);
+
+    // NOTE: Triangles behind the camera are dropped instead of clipped
+    OcclusionBufferRasterize(&Buffer, Translation(V3(0.0f, 0.0f, 20.0f)), Wall, sizeof(vertex_3d), 4, QuadIndices, 6);
+    ExpectShouldBe(2, Buffer.OccluderTriangleCount);
+    OcclusionBufferBuildPyramid(&Buffer);
+
+    ExpectToBeFalse(OcclusionBufferTestExtents(&Buffer, Box(V3(-1.0f, -1.0f, -30.0f), V3(1.0f, 1.0f, -20.0f))));
+    ExpectToBeFalse(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.5f, -0.5f, -11.0f), V3(0.5f, 0.5f, -10.5f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-0.5f, -0.5f, -9.0f), V3(0.5f, 0.5f, -8.0f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(6.0f, -0.5f, -30.0f), V3(8.0f, 0.5f, -20.0f))));
+    ExpectToBeTrue(OcclusionBufferTestExtents(&Buffer, Box(V3(-3.0f, -3.0f, -30.0f), V3(3.0f, 3.0f, -20.0f))));
+
+    OcclusionBufferDestroy(&Buffer);
+    return true;
+}
+
+void OcclusionBufferRegisterTests()
+{
+    TestManagerRegisterTest(OcclusionBufferShouldBuildMaxDepthPyramid, "Occlusion buffer should build a max depth pyramid");
+    TestManagerRegisterTest(OcclusionBufferShouldRasterizeCoveredPixels, "Occlusion buffer should rasterize exactly the covered pixels");
+    TestManagerRegisterTest(OcclusionBufferShouldStoreConservativeDepth, "Occlusion buffer should store conservative depth for sloped triangles");
+    TestManagerRegisterTest(OcclusionBufferShouldCullBoxesBehindOccluders, "Occlusion buffer should cull only boxes behind occluders");
+    TestManagerRegisterTest(OcclusionBufferShouldCullWithPerspective, "Occlusion buffer should cull with a perspective camera");
+}
@@ -0,0 +1,295 @@
+#include "mesh_generate_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <resources/mesh_generate.h>
+#include <core/vmemory.h>
+#include <core/clock.h>
+#include <math/vmath.h>
+#include <math/vrandom.h>
+
+#define GENERATE_SENTINEL 0xDEADBEEF
+#define GENERATE_BENCHMARK_SAMPLES 1025
+#define GENERATE_BENCHMARK_TILE_SAMPLES 65
+#define GENERATE_BENCHMARK_TILE_RUNS 100
+
+typedef struct generated_mesh
+{
+    mesh_generate_size Size;
+    vertex_3d* Vertices;
+    u32* Indices;
+} generated_mesh;
+
+// NOTE: One spare element past each array holds a sentinel, generators that write past their size clobber it
+static void AllocateMesh(generated_mesh* Mesh, mesh_generate_size Size)
+{
+    Mesh->Size = Size;
+    Mesh->Vertices = Allocate(sizeof(vertex_3d) * (Size.VertexCount + 1), MEMORY_TAG_APPLICATION);
+    Mesh->Indices = Allocate(sizeof(u32) * (Size.IndexCount + 1), MEMORY_TAG_APPLICATION);
+    Mesh->Vertices[Size.VertexCount].Position = V3(-1234.0f, -1234.0f, -1234.0f);
+    Mesh->Indices[Size.IndexCount] = GENERATE_SENTINEL;
+}
+
+static void FreeMesh(generated_mesh* Mesh)
+{
+    Free(Mesh->Vertices, sizeof(vertex_3d) * (Mesh->Size.VertexCount + 1), MEMORY_TAG_APPLICATION);
+    Free(Mesh->Indices, sizeof(u32) * (Mesh->Size.IndexCount + 1), MEMORY_TAG_APPLICATION);
+}
+
+static b8 AreBytesEqual(const void* A, const void* B, u64 Size)
+{
+    const u8* ByteA = (const u8*)A;
+    const u8* ByteB = (const u8*)B;
+    for(u64 Index = 0; Index < Size; ++Index)
+    {
+        if(ByteA[Index] != ByteB[Index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static v3 TriangleNormal(const generated_mesh* Mesh, u32 Triangle)
+{
+    v3 A = Mesh->Vertices[Mesh->Indices[Triangle * 3 + 0]].Position;
+    v3 B = Mesh->Vertices[Mesh->Indices[Triangle * 3 + 1]].Position;
+    v3 C = Mesh->Vertices[Mesh->Indices[Triangle * 3 + 2]].Position;
+    return CrossV3(SubV3(B, A), SubV3(C, A));
+}
+
+// NOTE: Sentinels intact, every index in range and no triangle with less than MinArea twice over
+static b8 IsMeshSound(const generated_mesh* Mesh, r32 MinArea)
+{
+    if(Mesh->Indices[Mesh->Size.IndexCount] != GENERATE_SENTINEL || 
+       Mesh->Vertices[Mesh->Size.VertexCount].Position.x != -1234.0f || Mesh->Size.IndexCount % 3 != 0)
+    {
+        return false;
+    }
+
+    for(u32 Index = 0; Index < Mesh->Size.IndexCount; ++Index)
+    {
+        if(Mesh->Indices[Index] >= Mesh->Size.VertexCount)
+        {
+            return false;
+        }
+    }
+
+    for(u32 Triangle = 0; Triangle < Mesh->Size.IndexCount / 3; ++Triangle)
+    {
+        if(LengthV3(TriangleNormal(Mesh, Triangle)) <= 2.0f * MinArea)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+u8 MeshGenerateSphereShouldHaveNoDegenerateTriangles()
+{
+    const u32 Shapes[][2] = {{2, 3}, {3, 4}, {5, 7}, {16, 32}, {1, 1}};
+    for(u32 Shape = 0; Shape < sizeof(Shapes) / sizeof(Shapes[0]); ++Shape)
+    {
+        u32 RingCount = Shapes[Shape][0] < 2 ? 2 : Shapes[Shape][0];
+        u32 SegmentCount = Shapes[Shape][1] < 3 ? 3 : Shapes[Shape][1];
+
+        generated_mesh Mesh;
+        AllocateMesh(&Mesh, MeshSphereSize(Shapes[Shape][0], Shapes[Shape][1]));
+        ExpectShouldBe((RingCount + 1) * (SegmentCount + 1), Mesh.Size.VertexCount);
+        ExpectShouldBe((RingCount - 1) * SegmentCount * 6, Mesh.Size.IndexCount);
+
+        MeshGenerateSphere(2.0f, Shapes[Shape][0], Shapes[Shape][1], Mesh.Vertices, Mesh.Indices);
+        ExpectToBeTrue(IsMeshSound(&Mesh, 1e-5f));
+
+        for(u32 Index = 0; Index < Mesh.Size.VertexCount; ++Index)
+        {
+            ExpectFloatToBe(2.0f, LengthV3(Mesh.Vertices[Index].Position), 1e-4f);
+        }
+
+        // NOTE: Counter clockwise seen from outside, the normal points away from the center
+        for(u32 Triangle = 0; Triangle < Mesh.Size.IndexCount / 3; ++Triangle)
+        {
+            v3 Normal = TriangleNormal(&Mesh, Triangle);
+            v3 Corner = Mesh.Vertices[Mesh.Indices[Triangle * 3]].Position;
+            ExpectToBeTrue(Normal.x * Corner.x + Normal.y * Corner.y + Normal.z * Corner.z > 0.0f);
+        }
+
+        FreeMesh(&Mesh);
+    }
+
+    return true;
+}
+
+u8 MeshGeneratePlaneAndCubeShouldMatchTheirSizes()
+{
+    generated_mesh Plane;
+    AllocateMesh(&Plane, MeshPlaneSize(7, 3));
+    ExpectShouldBe(8 * 4, Plane.Size.VertexCount);
+    ExpectShouldBe(7 * 3 * 6, Plane.Size.IndexCount);
+    MeshGeneratePlane(7.0f, 3.0f, 7, 3, 1.0f, 1.0f, Plane.Vertices, Plane.Indices);
+    ExpectToBeTrue(IsMeshSound(&Plane, 0.49f));
+    for(u32 Triangle = 0; Triangle < Plane.Size.IndexCount / 3; ++Triangle)
+    {
+        ExpectToBeTrue(TriangleNormal(&Plane, Triangle).z > 0.0f);
+    }
+    FreeMesh(&Plane);
+
+    generated_mesh Cube;
+    AllocateMesh(&Cube, MeshCubeSize());
+    MeshGenerateCube(V3(1.0f, 2.0f, 3.0f), 1.0f, 1.0f, Cube.Vertices, Cube.Indices);
+    ExpectToBeTrue(IsMeshSound(&Cube, 0.49f));
+    for(u32 Triangle = 0; Triangle < Cube.Size.IndexCount / 3; ++Triangle)
+    {
+        v3 Normal = TriangleNormal(&Cube, Triangle);
+        v3 Corner = Cube.Vertices[Cube.Indices[Triangle * 3]].Position;
+        ExpectToBeTrue(Normal.x * Corner.x + Normal.y * Corner.y + Normal.z * Corner.z > 0.0f);
+    }
+    FreeMesh(&Cube);
+
+    return true;
+}
+
+// NOTE: Large enough to take the threaded path, the bands have to land where the single threaded fill puts them
+u8 MeshGenerateTerrainThreadsShouldMatchSingleThread()
+{
+    mesh_terrain_desc Desc = {};
+    Desc.SampleCountX = 613;
+    Desc.SampleCountY = 509;
+    Desc.CellSize = 0.5f;
+    Desc.HeightScale = 3.0f;
+    Desc.TileX = 8.0f;
+    Desc.TileY = 4.0f;
+
+    u64 SampleCount = (u64)Desc.SampleCountX * Desc.SampleCountY;
+    r32* Heights = Allocate(sizeof(r32) * SampleCount, MEMORY_TAG_APPLICATION);
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 49);
+    for(u64 Index = 0; Index < SampleCount; ++Index)
+    {
+        Heights[Index] = RandomXoshiroR32InRange(&Random, -1.0f, 1.0f);
+    }
+    Desc.Heights = Heights;
+
+    generated_mesh Threaded;
+    generated_mesh Single;
+    AllocateMesh(&Threaded, MeshTerrainSize(&Desc));
+    AllocateMesh(&Single, MeshTerrainSize(&Desc));
+    ExpectToBeTrue(Threaded.Size.VertexCount >= MESH_GENERATE_PARALLEL_VERTEX_COUNT);
+    ExpectShouldBe(SampleCount, Threaded.Size.VertexCount);
+    ExpectShouldBe((Desc.SampleCountX - 1) * (Desc.SampleCountY - 1) * 6, Threaded.Size.IndexCount);
+
+    MeshGenerateTerrain(&Desc, Threaded.Vertices, Threaded.Indices);
+    MeshGenerateTerrainRows(&Desc, 0, Desc.SampleCountY, Single.Vertices, Single.Indices);
+    ExpectToBeTrue(IsMeshSound(&Threaded, 0.0f));
+    ExpectToBeTrue(IsMeshSound(&Single, 0.0f));
+    ExpectToBeTrue(AreBytesEqual(Threaded.Vertices, Single.Vertices, sizeof(vertex_3d) * SampleCount));
+    ExpectToBeTrue(AreBytesEqual(Threaded.Indices, Single.Indices, sizeof(u32) * Threaded.Size.IndexCount));
+
+    // NOTE: Heights along +y, so the triangles face up
+    for(u32 Triangle = 0; Triangle < Threaded.Size.IndexCount / 3; ++Triangle)
+    {
+        ExpectToBeTrue(TriangleNormal(&Threaded, Triangle).y > 0.0f);
+    }
+
+    FreeMesh(&Threaded);
+    FreeMesh(&Single);
+    Free(Heights, sizeof(r32) * SampleCount, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+// NOTE: The plain quad loop the vectorized grid fill replaces
+static void ReferenceTerrainIndices(u32 SampleCountX, u32 SampleCountY, u32* OutIndices)
+{
+    u32* Out = OutIndices;
+    for(u32 y = 0; y + 1 < SampleCountY; ++y)
+    {
+        for(u32 x = 0; x + 1 < SampleCountX; ++x)
+        {
+            u32 A = y * SampleCountX + x;
+            u32 B = A + 1;
+            u32 C = A + SampleCountX;
+            u32 D = C + 1;
+            *Out++ = A; *Out++ = C; *Out++ = D;
+            *Out++ = A; *Out++ = D; *Out++ = B;
+        }
+    }
+}
+
+// NOTE: Not a pass / fail test, logs terrain fill times single threaded, threaded and for a small tile, and the
+// index fill against the plain loop
+u8 MeshGenerateBenchmark()
+{
+    mesh_terrain_desc Desc = {};
+    Desc.SampleCountX = GENERATE_BENCHMARK_SAMPLES;
+    Desc.SampleCountY = GENERATE_BENCHMARK_SAMPLES;
+    Desc.CellSize = 1.0f;
+    Desc.HeightScale = 10.0f;
+    Desc.TileX = 16.0f;
+    Desc.TileY = 16.0f;
+
+    u64 SampleCount = (u64)Desc.SampleCountX * Desc.SampleCountY;
+    r32* Heights = Allocate(sizeof(r32) * SampleCount, MEMORY_TAG_APPLICATION);
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 1025);
+    for(u64 Index = 0; Index < SampleCount; ++Index)
+    {
+        Heights[Index] = RandomXoshiroR32(&Random);
+    }
+    Desc.Heights = Heights;
+
+    generated_mesh Mesh;
+    AllocateMesh(&Mesh, MeshTerrainSize(&Desc));
+    u32* Reference = Allocate(sizeof(u32) * Mesh.Size.IndexCount, MEMORY_TAG_APPLICATION);
+
+    // NOTE: First touch of the pages is not what is measured
+    MeshGenerateTerrainRows(&Desc, 0, Desc.SampleCountY, Mesh.Vertices, Mesh.Indices);
+    ReferenceTerrainIndices(Desc.SampleCountX, Desc.SampleCountY, Reference);
+
+    clock Clock;
+    ClockStart(&Clock);
+    MeshGenerateTerrainRows(&Desc, 0, Desc.SampleCountY, Mesh.Vertices, Mesh.Indices);
+    ClockUpdate(&Clock);
+    r64 SingleTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    MeshGenerateTerrain(&Desc, Mesh.Vertices, Mesh.Indices);
+    ClockUpdate(&Clock);
+    r64 ThreadedTime = Clock.Elapsed;
+
+    ClockStart(&Clock);
+    ReferenceTerrainIndices(Desc.SampleCountX, Desc.SampleCountY, Reference);
+    ClockUpdate(&Clock);
+    r64 ReferenceTime = Clock.Elapsed;
+
+    ExpectToBeTrue(IsMeshSound(&Mesh, 0.0f));
+    ExpectToBeTrue(AreBytesEqual(Reference, Mesh.Indices, sizeof(u32) * Mesh.Size.IndexCount));
+
+    Desc.SampleCountX = GENERATE_BENCHMARK_TILE_SAMPLES;
+    Desc.SampleCountY = GENERATE_BENCHMARK_TILE_SAMPLES;
+    ClockStart(&Clock);
+    for(u32 Run = 0; Run < GENERATE_BENCHMARK_TILE_RUNS; ++Run)
+    {
+        MeshGenerateTerrain(&Desc, Mesh.Vertices, Mesh.Indices);
+    }
+    ClockUpdate(&Clock);
+    r64 TileTime = Clock.Elapsed / GENERATE_BENCHMARK_TILE_RUNS;
+
+    VENG_INFO("Terrain %ux%u: one thread %.2f ms, %u threads %.2f ms, plain index loop alone %.2f ms", 
+              GENERATE_BENCHMARK_SAMPLES, GENERATE_BENCHMARK_SAMPLES, SingleTime * SEC_TO_MS, MESH_GENERATE_MAX_THREADS, 
+              ThreadedTime * SEC_TO_MS, ReferenceTime * SEC_TO_MS);
+    VENG_INFO("  %ux%u tile: %.2f us", GENERATE_BENCHMARK_TILE_SAMPLES, GENERATE_BENCHMARK_TILE_SAMPLES, TileTime * 1e6);
+
+    Free(Reference, sizeof(u32) * Mesh.Size.IndexCount, MEMORY_TAG_APPLICATION);
+    FreeMesh(&Mesh);
+    Free(Heights, sizeof(r32) * SampleCount, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void MeshGenerateRegisterTests()
+{
+    TestManagerRegisterTest(MeshGenerateSphereShouldHaveNoDegenerateTriangles, "Mesh generate sphere has no zero area pole triangles");
+    TestManagerRegisterTest(MeshGeneratePlaneAndCubeShouldMatchTheirSizes, "Mesh generate plane and cube fill what their sizes say");
+    TestManagerRegisterTest(MeshGenerateTerrainThreadsShouldMatchSingleThread, "Mesh generate threaded terrain matches the single threaded fill");
+    TestManagerRegisterTest(MeshGenerateBenchmark, "Mesh generate benchmark, 1025x1025 terrain");
+}
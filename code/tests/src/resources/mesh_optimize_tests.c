@@ -0,0 +1,296 @@
+#include "mesh_optimize_tests.h"
+#include "mesh_test_utils.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <resources/mesh_optimize.h>
+#include <core/logger.h>
+#include <math/vmath.h>
+#include <math/vrandom.h>
+
+#define OPTIMIZE_GRID_CELLS 32
+#define OPTIMIZE_GRID_VERTEX_COUNT ((OPTIMIZE_GRID_CELLS + 1) * (OPTIMIZE_GRID_CELLS + 1))
+#define OPTIMIZE_GRID_INDEX_COUNT (OPTIMIZE_GRID_CELLS * OPTIMIZE_GRID_CELLS * 6)
+#define OPTIMIZE_OVERDRAW_THRESHOLD 1.05f
+
+// NOTE: Triangles as sortable keys, rotated so the smallest index comes first which keeps the winding
+static void TriangleKeys(const u32* Indices, u32 IndexCount, u64* OutKeys)
+{
+    for(u32 Index = 0; Index < IndexCount; Index += 3)
+    {
+        u32 a = Indices[Index + 0];
+        u32 b = Indices[Index + 1];
+        u32 c = Indices[Index + 2];
+        if(b < a && b < c)
+        {
+            u32 t = a; a = b; b = c; c = t;
+        }
+        else if(c < a && c < b)
+        {
+            u32 t = c; c = b; b = a; a = t;
+        }
+        OutKeys[Index / 3] = ((u64)a << 42) | ((u64)b << 21) | (u64)c;
+    }
+
+    u32 Count = IndexCount / 3;
+    for(u32 Gap = Count / 2; Gap > 0; Gap /= 2)
+    {
+        for(u32 i = Gap; i < Count; ++i)
+        {
+            u64 Key = OutKeys[i];
+            u32 j = i;
+            for(; j >= Gap && OutKeys[j - Gap] > Key; j -= Gap)
+            {
+                OutKeys[j] = OutKeys[j - Gap];
+            }
+            OutKeys[j] = Key;
+        }
+    }
+}
+
+// NOTE: True when both index lists hold the same triangles with the same winding, in any order
+static b8 SameTriangles(const u32* A, const u32* B, u32 IndexCount)
+{
+    u64 KeysA[OPTIMIZE_GRID_INDEX_COUNT / 3];
+    u64 KeysB[OPTIMIZE_GRID_INDEX_COUNT / 3];
+    TriangleKeys(A, IndexCount, KeysA);
+    TriangleKeys(B, IndexCount, KeysB);
+    for(u32 Triangle = 0; Triangle < IndexCount / 3; ++Triangle)
+    {
+        if(KeysA[Triangle] != KeysB[Triangle])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// NOTE: Worst case input for the cache, the grid's triangles in random order
+static void ShuffleTriangles(u32* Indices, u32 IndexCount, u64 Seed)
+{
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, Seed);
+    for(u32 Triangle = IndexCount / 3 - 1; Triangle > 0; --Triangle)
+    {
+        u32 Other = (u32)RandomXoshiroS32InRange(&Random, 0, (s32)Triangle);
+        for(u32 Corner = 0; Corner < 3; ++Corner)
+        {
+            u32 t = Indices[Triangle * 3 + Corner];
+            Indices[Triangle * 3 + Corner] = Indices[Other * 3 + Corner];
+            Indices[Other * 3 + Corner] = t;
+        }
+    }
+}
+
+// NOTE: Bumps facing every way, so overdraw ordering has clusters to sort
+static r32 BumpHeight(r32 X, r32 Z)
+{
+    return 0.2f * Sin(12.0f * X) * Cos(12.0f * Z);
+}
+
+static b8 SameVertex(const vertex_3d* A, const vertex_3d* B)
+{
+    return A->Position.x == B->Position.x && A->Position.y == B->Position.y && A->Position.z == B->Position.z &&
+           A->TexCoord.x == B->TexCoord.x && A->TexCoord.y == B->TexCoord.y;
+}
+
+u8 MeshOptimizeShouldAnalyzeVertexCache()
+{
+    // NOTE: A lone triangle transforms every vertex once
+    u32 Triangle[] = {0, 1, 2};
+    mesh_cache_stats Stats = MeshAnalyzeVertexCache(Triangle, 3, 3, MESH_VERTEX_CACHE_SIZE);
+    ExpectShouldBe(3, Stats.VerticesTransformed);
+    ExpectShouldBe(1, Stats.TriangleCount);
+    ExpectShouldBe(3, Stats.VertexCount);
+    ExpectFloatToBe(3.0f, Stats.ACMR, 0.0f);
+    ExpectFloatToBe(1.0f, Stats.ATVR, 0.0f);
+
+    // NOTE: Drawing the same triangles again hits the cache while it is big enough, a 3 entry FIFO has already
+    // pushed them out by then
+    u32 Repeated[] = {0, 1, 2, 3, 4, 5, 0, 1, 2};
+    Stats = MeshAnalyzeVertexCache(Repeated, 9, 6, MESH_VERTEX_CACHE_SIZE);
+    ExpectShouldBe(6, Stats.VerticesTransformed);
+    ExpectFloatToBe(2.0f, Stats.ACMR, 0.0f);
+    ExpectFloatToBe(1.0f, Stats.ATVR, 0.0f);
+
+    Stats = MeshAnalyzeVertexCache(Repeated, 9, 6, 3);
+    ExpectShouldBe(9, Stats.VerticesTransformed);
+    ExpectFloatToBe(3.0f, Stats.ACMR, 0.0f);
+    ExpectFloatToBe(1.5f, Stats.ATVR, 0.0f);
+
+    // NOTE: Unreferenced vertices do not count against the ATVR
+    Stats = MeshAnalyzeVertexCache(Triangle, 3, 10, MESH_VERTEX_CACHE_SIZE);
+    ExpectShouldBe(3, Stats.VertexCount);
+    ExpectFloatToBe(1.0f, Stats.ATVR, 0.0f);
+    return true;
+}
+
+u8 MeshOptimizeShouldRemoveDuplicateVertices()
+{
+    // NOTE: Unrolling the grid gives every index its own vertex, merging has to find the shared grid points again
+    vertex_3d Grid[OPTIMIZE_GRID_VERTEX_COUNT];
+    u32 GridIndices[OPTIMIZE_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(OPTIMIZE_GRID_CELLS, 0.0f, 1.0f, 0.0f, 0, Grid, GridIndices, 0);
+
+    static vertex_3d Unrolled[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 Indices[OPTIMIZE_GRID_INDEX_COUNT];
+    for(u32 Index = 0; Index < OPTIMIZE_GRID_INDEX_COUNT; ++Index)
+    {
+        Unrolled[Index] = Grid[GridIndices[Index]];
+        Indices[Index] = Index;
+    }
+
+    u32 Count = MeshRemoveDuplicateVertices(Unrolled, sizeof(vertex_3d), OPTIMIZE_GRID_INDEX_COUNT, Indices, OPTIMIZE_GRID_INDEX_COUNT);
+    ExpectShouldBe(OPTIMIZE_GRID_VERTEX_COUNT, Count);
+    ExpectToBeTrue(MeshTestIndicesValid(Indices, OPTIMIZE_GRID_INDEX_COUNT, Count));
+    for(u32 Index = 0; Index < OPTIMIZE_GRID_INDEX_COUNT; ++Index)
+    {
+        ExpectToBeTrue(SameVertex(&Grid[GridIndices[Index]], &Unrolled[Indices[Index]]));
+    }
+
+    // NOTE: The first copy of each vertex is kept in order, so the first triangle still uses 0, 1 and 2
+    ExpectShouldBe(0, Indices[0]);
+    ExpectShouldBe(1, Indices[1]);
+    ExpectShouldBe(2, Indices[2]);
+
+    // NOTE: Nothing left to merge the second time around
+    ExpectShouldBe(Count, MeshRemoveDuplicateVertices(Unrolled, sizeof(vertex_3d), Count, Indices, OPTIMIZE_GRID_INDEX_COUNT));
+    return true;
+}
+
+u8 MeshOptimizeShouldImproveVertexCache()
+{
+    vertex_3d Vertices[OPTIMIZE_GRID_VERTEX_COUNT];
+    u32 Indices[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 Optimized[OPTIMIZE_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(OPTIMIZE_GRID_CELLS, 0.0f, 1.0f, 0.0f, 0, Vertices, Indices, 0);
+    ShuffleTriangles(Indices, OPTIMIZE_GRID_INDEX_COUNT, 0x5EED);
+
+    mesh_cache_stats Before = MeshAnalyzeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+    MeshOptimizeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE, Optimized);
+    mesh_cache_stats After = MeshAnalyzeVertexCache(Optimized, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+
+    // NOTE: Shuffled triangles miss almost every time, Tipsify should get a regular grid well under 1 vertex per triangle
+    ExpectToBeTrue(SameTriangles(Indices, Optimized, OPTIMIZE_GRID_INDEX_COUNT));
+    ExpectToBeTrue(Before.ACMR > 2.0f);
+    ExpectToBeTrue(After.ACMR < 0.8f);
+    ExpectToBeTrue(After.ATVR < 1.5f);
+    return true;
+}
+
+u8 MeshOptimizeShouldKeepCacheWithinOverdrawThreshold()
+{
+    vertex_3d Vertices[OPTIMIZE_GRID_VERTEX_COUNT];
+    u32 Indices[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 CacheOrdered[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 Optimized[OPTIMIZE_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(OPTIMIZE_GRID_CELLS, 0.0f, 1.0f, 0.0f, BumpHeight, Vertices, Indices, 0);
+    ShuffleTriangles(Indices, OPTIMIZE_GRID_INDEX_COUNT, 0x0D);
+    MeshOptimizeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE, CacheOrdered);
+    MeshOptimizeOverdraw(Vertices, sizeof(vertex_3d), OPTIMIZE_GRID_VERTEX_COUNT, CacheOrdered, OPTIMIZE_GRID_INDEX_COUNT, 
+                         MESH_VERTEX_CACHE_SIZE, OPTIMIZE_OVERDRAW_THRESHOLD, Optimized);
+
+    mesh_cache_stats Before = MeshAnalyzeVertexCache(CacheOrdered, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+    mesh_cache_stats After = MeshAnalyzeVertexCache(Optimized, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+
+    // NOTE: Reordering clusters costs a little cache efficiency at their edges. The threshold is applied per cluster,
+    // so the whole mesh gets a hundredth of slack on top.
+    VENG_INFO("Overdraw ordering: ACMR %.3f -> %.3f", Before.ACMR, After.ACMR);
+    ExpectToBeTrue(SameTriangles(CacheOrdered, Optimized, OPTIMIZE_GRID_INDEX_COUNT));
+    ExpectToBeTrue(After.ACMR <= Before.ACMR * OPTIMIZE_OVERDRAW_THRESHOLD + 0.01f);
+
+    b8 Reordered = false;
+    for(u32 Index = 0; Index < OPTIMIZE_GRID_INDEX_COUNT; ++Index)
+    {
+        Reordered |= CacheOrdered[Index] != Optimized[Index];
+    }
+    ExpectToBeTrue(Reordered);
+    return true;
+}
+
+u8 MeshOptimizeShouldOrderVertexFetch()
+{
+    vertex_3d Grid[OPTIMIZE_GRID_VERTEX_COUNT];
+    u32 GridIndices[OPTIMIZE_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(OPTIMIZE_GRID_CELLS, 0.0f, 1.0f, 0.0f, 0, Grid, GridIndices, 0);
+
+    // NOTE: Scatter the grid across a buffer twice its size, the unused slots hold junk that has to be dropped
+    static vertex_3d Vertices[OPTIMIZE_GRID_VERTEX_COUNT * 2];
+    static vertex_3d Fetched[OPTIMIZE_GRID_VERTEX_COUNT * 2];
+    u32 Indices[OPTIMIZE_GRID_INDEX_COUNT];
+    for(u32 Vertex = 0; Vertex < OPTIMIZE_GRID_VERTEX_COUNT * 2; ++Vertex)
+    {
+        Vertices[Vertex].Position = V3(-1.0f, -1.0f, -1.0f);
+        Vertices[Vertex].TexCoord = V2(-1.0f, -1.0f);
+    }
+    for(u32 Vertex = 0; Vertex < OPTIMIZE_GRID_VERTEX_COUNT; ++Vertex)
+    {
+        Vertices[(Vertex * 7919) % (OPTIMIZE_GRID_VERTEX_COUNT * 2)] = Grid[Vertex];
+    }
+    for(u32 Index = 0; Index < OPTIMIZE_GRID_INDEX_COUNT; ++Index)
+    {
+        Indices[Index] = (GridIndices[Index] * 7919) % (OPTIMIZE_GRID_VERTEX_COUNT * 2);
+    }
+
+    u32 Count = MeshOptimizeVertexFetch(Vertices, sizeof(vertex_3d), OPTIMIZE_GRID_VERTEX_COUNT * 2, Indices, 
+                                        OPTIMIZE_GRID_INDEX_COUNT, Fetched);
+    ExpectShouldBe(OPTIMIZE_GRID_VERTEX_COUNT, Count);
+
+    // NOTE: Every index is either a vertex seen before or the next one in the buffer, and still points at the same data
+    u32 Next = 0;
+    for(u32 Index = 0; Index < OPTIMIZE_GRID_INDEX_COUNT; ++Index)
+    {
+        ExpectToBeTrue(Indices[Index] <= Next);
+        if(Indices[Index] == Next)
+        {
+            ++Next;
+        }
+        ExpectToBeTrue(SameVertex(&Grid[GridIndices[Index]], &Fetched[Indices[Index]]));
+    }
+    ExpectShouldBe(Count, Next);
+    return true;
+}
+
+u8 MeshOptimizeShouldReportPipeline()
+{
+    vertex_3d Vertices[OPTIMIZE_GRID_VERTEX_COUNT];
+    vertex_3d Fetched[OPTIMIZE_GRID_VERTEX_COUNT];
+    u32 Indices[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 CacheOrdered[OPTIMIZE_GRID_INDEX_COUNT];
+    u32 Optimized[OPTIMIZE_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(OPTIMIZE_GRID_CELLS, 0.0f, 1.0f, 0.0f, BumpHeight, Vertices, Indices, 0);
+
+    mesh_cache_stats Grid = MeshAnalyzeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+    ShuffleTriangles(Indices, OPTIMIZE_GRID_INDEX_COUNT, 0xACE);
+    mesh_cache_stats Shuffled = MeshAnalyzeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+
+    MeshOptimizeVertexCache(Indices, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE, CacheOrdered);
+    mesh_cache_stats Cache = MeshAnalyzeVertexCache(CacheOrdered, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+
+    MeshOptimizeOverdraw(Vertices, sizeof(vertex_3d), OPTIMIZE_GRID_VERTEX_COUNT, CacheOrdered, OPTIMIZE_GRID_INDEX_COUNT, 
+                         MESH_VERTEX_CACHE_SIZE, OPTIMIZE_OVERDRAW_THRESHOLD, Optimized);
+    mesh_cache_stats Overdraw = MeshAnalyzeVertexCache(Optimized, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+
+    // NOTE: Fetch ordering only renames vertices, the cache behaviour must not change
+    MeshOptimizeVertexFetch(Vertices, sizeof(vertex_3d), OPTIMIZE_GRID_VERTEX_COUNT, Optimized, OPTIMIZE_GRID_INDEX_COUNT, Fetched);
+    mesh_cache_stats Fetch = MeshAnalyzeVertexCache(Optimized, OPTIMIZE_GRID_INDEX_COUNT, OPTIMIZE_GRID_VERTEX_COUNT, MESH_VERTEX_CACHE_SIZE);
+    ExpectShouldBe(Overdraw.VerticesTransformed, Fetch.VerticesTransformed);
+
+    VENG_INFO("Mesh optimize, %u triangles, %u entry cache:", Grid.TriangleCount, MESH_VERTEX_CACHE_SIZE);
+    VENG_INFO("  row order:     ACMR %.3f ATVR %.3f", Grid.ACMR, Grid.ATVR);
+    VENG_INFO("  shuffled:      ACMR %.3f ATVR %.3f", Shuffled.ACMR, Shuffled.ATVR);
+    VENG_INFO("  vertex cache:  ACMR %.3f ATVR %.3f", Cache.ACMR, Cache.ATVR);
+    VENG_INFO("  overdraw:      ACMR %.3f ATVR %.3f", Overdraw.ACMR, Overdraw.ATVR);
+    VENG_INFO("  vertex fetch:  ACMR %.3f ATVR %.3f", Fetch.ACMR, Fetch.ATVR);
+    return true;
+}
+
+void MeshOptimizeRegisterTests()
+{
+    TestManagerRegisterTest(MeshOptimizeShouldAnalyzeVertexCache, "Mesh optimize counts FIFO cache misses");
+    TestManagerRegisterTest(MeshOptimizeShouldRemoveDuplicateVertices, "Mesh optimize merges duplicate vertices");
+    TestManagerRegisterTest(MeshOptimizeShouldImproveVertexCache, "Mesh optimize vertex cache ordering beats shuffled triangles");
+    TestManagerRegisterTest(MeshOptimizeShouldKeepCacheWithinOverdrawThreshold, "Mesh optimize overdraw ordering stays within its cache threshold");
+    TestManagerRegisterTest(MeshOptimizeShouldOrderVertexFetch, "Mesh optimize vertex fetch follows first use and drops unused vertices");
+    TestManagerRegisterTest(MeshOptimizeShouldReportPipeline, "Mesh optimize before and after report");
+}
@@ -0,0 +1,158 @@
+#include "mesh_quantize_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <resources/mesh_quantize.h>
+#include <core/logger.h>
+#include <math/vmath.h>
+#include <math/vrandom.h>
+
+#define QUANTIZE_VERTEX_COUNT 257
+
+// NOTE: What the material shader does with a packed vertex
+static r32 UnpackUnorm16(u16 Value, r32 Min, r32 Max)
+{
+    return Min + ((r32)Value / 65535.0f) * (Max - Min);
+}
+
+static r32 UnpackHalf(u16 Value)
+{
+    u32 Sign = (u32)(Value & 0x8000) << 16;
+    u32 Exponent = (Value >> 10) & 0x1F;
+    u32 Mantissa = Value & 0x3FF;
+
+    union { r32 F; u32 U; } Bits;
+    if(Exponent == 0)
+    {
+        Bits.F = (r32)Mantissa * (1.0f / 16777216.0f);
+        Bits.U |= Sign;
+    }
+    else if(Exponent == 31)
+    {
+        Bits.U = Sign | 0x7F800000u | (Mantissa << 13);
+    }
+    else
+    {
+        Bits.U = Sign | ((Exponent + 127 - 15) << 23) | (Mantissa << 13);
+    }
+    return Bits.F;
+}
+
+u8 MeshQuantizeShouldRoundTripPositions()
+{
+    static vertex_3d Vertices[QUANTIZE_VERTEX_COUNT];
+    static vertex_3d_packed Packed[QUANTIZE_VERTEX_COUNT];
+
+    random_xoshiro Random;
+    RandomXoshiroSeed(&Random, 48);
+    for(u32 Index = 0; Index < QUANTIZE_VERTEX_COUNT; ++Index)
+    {
+        Vertices[Index].Position = V3(RandomXoshiroR32InRange(&Random, -50.0f, 30.0f), 
+                                      RandomXoshiroR32InRange(&Random, 0.0f, 5.0f),
+                                      RandomXoshiroR32InRange(&Random, -1.0f, 1.0f));
+        Vertices[Index].TexCoord = V2(RandomXoshiroR32InRange(&Random, -4.0f, 4.0f), 
+                                      RandomXoshiroR32InRange(&Random, 0.0f, 1.0f));
+    }
+
+    extents_3d Expected = {Vertices[0].Position, Vertices[0].Position};
+    for(u32 Index = 1; Index < QUANTIZE_VERTEX_COUNT; ++Index)
+    {
+        extents_3d Point = {Vertices[Index].Position, Vertices[Index].Position};
+        Expected = ExtentsUnion(Expected, Point);
+    }
+
+    extents_3d Extents = MeshPackVertices(Vertices, QUANTIZE_VERTEX_COUNT, Packed);
+    ExpectFloatToBe(Expected.Min.x, Extents.Min.x, 0.0f);
+    ExpectFloatToBe(Expected.Min.y, Extents.Min.y, 0.0f);
+    ExpectFloatToBe(Expected.Min.z, Extents.Min.z, 0.0f);
+    ExpectFloatToBe(Expected.Max.x, Extents.Max.x, 0.0f);
+    ExpectFloatToBe(Expected.Max.y, Extents.Max.y, 0.0f);
+    ExpectFloatToBe(Expected.Max.z, Extents.Max.z, 0.0f);
+
+    // NOTE: Half a quantization step per axis, plus float slack for the unpack itself
+    r32 Tolerance[3];
+    for(u32 Axis = 0; Axis < 3; ++Axis)
+    {
+        r32 Size = Extents.Max.E[Axis] - Extents.Min.E[Axis];
+        Tolerance[Axis] = Size / 131070.0f + Size * 1e-6f;
+    }
+
+    for(u32 Index = 0; Index < QUANTIZE_VERTEX_COUNT; ++Index)
+    {
+        const vertex_3d* In = Vertices + Index;
+        const vertex_3d_packed* Out = Packed + Index;
+        ExpectShouldBe(0, Out->Padding);
+        for(u32 Axis = 0; Axis < 3; ++Axis)
+        {
+            r32 Unpacked = UnpackUnorm16(Out->Position[Axis], Extents.Min.E[Axis], Extents.Max.E[Axis]);
+            ExpectFloatToBe(In->Position.E[Axis], Unpacked, Tolerance[Axis]);
+        }
+
+        // NOTE: 11 significant bits, so the error is at most half of 2^-10 relative
+        for(u32 Axis = 0; Axis < 2; ++Axis)
+        {
+            r32 Value = In->TexCoord.E[Axis];
+            r32 Unpacked = UnpackHalf(Out->TexCoord[Axis]);
+            ExpectFloatToBe(Value, Unpacked, Abs(Value) * (1.0f / 2048.0f) + 1e-7f);
+        }
+    }
+
+    return true;
+}
+
+u8 MeshQuantizeShouldKeepFlatAxes()
+{
+    vertex_3d Vertices[3] = {};
+    Vertices[0].Position = V3(-1.0f, 2.0f, 7.0f);
+    Vertices[1].Position = V3( 3.0f, 2.0f, 7.0f);
+    Vertices[2].Position = V3( 1.0f, 2.0f, 7.0f);
+
+    vertex_3d_packed Packed[3];
+    extents_3d Extents = MeshPackVertices(Vertices, 3, Packed);
+    ExpectShouldBe(0, Packed[0].Position[0]);
+    ExpectShouldBe(65535, Packed[1].Position[0]);
+    ExpectShouldBe(32768, Packed[2].Position[0]);
+    for(u32 Index = 0; Index < 3; ++Index)
+    {
+        ExpectShouldBe(0, Packed[Index].Position[1]);
+        ExpectShouldBe(0, Packed[Index].Position[2]);
+        ExpectFloatToBe(2.0f, UnpackUnorm16(Packed[Index].Position[1], Extents.Min.y, Extents.Max.y), 0.0f);
+        ExpectFloatToBe(7.0f, UnpackUnorm16(Packed[Index].Position[2], Extents.Min.z, Extents.Max.z), 0.0f);
+    }
+
+    return true;
+}
+
+u8 MeshQuantizeHalfShouldMatchKnownValues()
+{
+    ExpectShouldBe(0x0000, MeshQuantizeHalf(0.0f));
+    ExpectShouldBe(0x8000, MeshQuantizeHalf(-0.0f));
+    ExpectShouldBe(0x3C00, MeshQuantizeHalf(1.0f));
+    ExpectShouldBe(0x3800, MeshQuantizeHalf(0.5f));
+    ExpectShouldBe(0xC000, MeshQuantizeHalf(-2.0f));
+    ExpectShouldBe(0x7BFF, MeshQuantizeHalf(65504.0f));
+    ExpectShouldBe(0x7C00, MeshQuantizeHalf(1e6f));
+    ExpectShouldBe(0xFC00, MeshQuantizeHalf(-1e6f));
+    ExpectShouldBe(0x0001, MeshQuantizeHalf(1.0f / 16777216.0f));
+    ExpectShouldBe(0x0400, MeshQuantizeHalf(1.0f / 16384.0f));
+
+    // NOTE: Halfway between 1 and the next half rounds to the even mantissa, just past it rounds up
+    ExpectShouldBe(0x3C00, MeshQuantizeHalf(1.0f + 1.0f / 2048.0f));
+    ExpectShouldBe(0x3C02, MeshQuantizeHalf(1.0f + 3.0f / 2048.0f));
+    ExpectShouldBe(0x3C01, MeshQuantizeHalf(1.0f + 1.0f / 2048.0f + 1.0f / 65536.0f));
+
+    for(u32 Value = 0; Value < 0x7C00; ++Value)
+    {
+        ExpectShouldBe(Value, MeshQuantizeHalf(UnpackHalf((u16)Value)));
+        ExpectShouldBe(Value | 0x8000, MeshQuantizeHalf(UnpackHalf((u16)(Value | 0x8000))));
+    }
+
+    return true;
+}
+
+void MeshQuantizeRegisterTests()
+{
+    TestManagerRegisterTest(MeshQuantizeShouldRoundTripPositions, "Mesh quantize packed vertices unpack within a quantization step");
+    TestManagerRegisterTest(MeshQuantizeShouldKeepFlatAxes, "Mesh quantize flat axes unpack to their exact position");
+    TestManagerRegisterTest(MeshQuantizeHalfShouldMatchKnownValues, "Mesh quantize half floats round to nearest even and round trip");
+}
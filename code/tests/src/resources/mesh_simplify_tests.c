@@ -0,0 +1,237 @@
+#include "mesh_simplify_tests.h"
+#include "mesh_test_utils.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <resources/mesh_simplify.h>
+#include <core/vmemory.h>
+#include <core/logger.h>
+#include <math/vmath.h>
+
+#define SIMPLIFY_GRID_CELLS 32
+#define SIMPLIFY_GRID_VERTEX_COUNT ((SIMPLIFY_GRID_CELLS + 1) * (SIMPLIFY_GRID_CELLS + 1))
+#define SIMPLIFY_GRID_INDEX_COUNT (SIMPLIFY_GRID_CELLS * SIMPLIFY_GRID_CELLS * 6)
+#define SIMPLIFY_LOD_COUNT 6
+
+static r32 WaveHeight(r32 X, r32 Z)
+{
+    return 0.05f * Sin(6.0f * X) * Sin(6.0f * Z);
+}
+
+// NOTE: Height of the simplified surface under (X, Z), the simplified grid is still a heightfield so exactly one
+// triangle covers the point up to edges. Returns false when nothing covers it, i.e. the border moved.
+static b8 SurfaceHeight(const vertex_3d* Vertices, const u32* Indices, u32 IndexCount, r32 X, r32 Z, r32* OutHeight)
+{
+    for(u32 Index = 0; Index < IndexCount; Index += 3)
+    {
+        v3 A = Vertices[Indices[Index + 0]].Position;
+        v3 B = Vertices[Indices[Index + 1]].Position;
+        v3 C = Vertices[Indices[Index + 2]].Position;
+        r32 Denominator = (B.z - C.z) * (A.x - C.x) + (C.x - B.x) * (A.z - C.z);
+        if(Abs(Denominator) < 1e-12f)
+        {
+            continue;
+        }
+
+        r32 WA = ((B.z - C.z) * (X - C.x) + (C.x - B.x) * (Z - C.z)) / Denominator;
+        r32 WB = ((C.z - A.z) * (X - C.x) + (A.x - C.x) * (Z - C.z)) / Denominator;
+        r32 WC = 1.0f - WA - WB;
+        if(WA >= -1e-5f && WB >= -1e-5f && WC >= -1e-5f)
+        {
+            *OutHeight = WA * A.y + WB * B.y + WC * C.y;
+            return true;
+        }
+    }
+    return false;
+}
+
+// NOTE: Root mean square vertical distance from the original grid vertices to the simplified surface, -1 when one
+// of them is no longer covered
+static r32 RmsVerticalDeviation(const vertex_3d* Vertices, const u32* Indices, u32 IndexCount, r32* OutMaxDeviation)
+{
+    r32 Sum = 0.0f;
+    *OutMaxDeviation = 0.0f;
+    for(u32 Vertex = 0; Vertex < SIMPLIFY_GRID_VERTEX_COUNT; ++Vertex)
+    {
+        v3 Position = Vertices[Vertex].Position;
+        r32 Height = 0.0f;
+        if(!SurfaceHeight(Vertices, Indices, IndexCount, Position.x, Position.z, &Height))
+        {
+            return -1.0f;
+        }
+
+        r32 Deviation = Abs(Height - Position.y);
+        *OutMaxDeviation = Deviation > *OutMaxDeviation ? Deviation : *OutMaxDeviation;
+        Sum += Deviation * Deviation;
+    }
+    return SquareRoot(Sum / (r32)SIMPLIFY_GRID_VERTEX_COUNT);
+}
+
+u8 MeshSimplifyShouldCollapsePlanarGrid()
+{
+    vertex_3d Vertices[SIMPLIFY_GRID_VERTEX_COUNT];
+    u32 Indices[SIMPLIFY_GRID_INDEX_COUNT];
+    u32 Simplified[SIMPLIFY_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(SIMPLIFY_GRID_CELLS, 0.0f, 1.0f, 0.0f, 0, Vertices, Indices, 0);
+
+    r32 Error = -1.0f;
+    u32 Count = MeshSimplify(Vertices, sizeof(vertex_3d), SIMPLIFY_GRID_VERTEX_COUNT, Indices, SIMPLIFY_GRID_INDEX_COUNT,
+                             SIMPLIFY_GRID_INDEX_COUNT / 10, 1e-3f, Simplified, &Error);
+
+    // NOTE: A flat grid collapses for free, only the target stops it. Borders stay put so the covered area is exact
+    ExpectToBeTrue(Count <= SIMPLIFY_GRID_INDEX_COUNT / 10);
+    ExpectToBeTrue(Count > 0);
+    ExpectToBeTrue(MeshTestIndicesValid(Simplified, Count, SIMPLIFY_GRID_VERTEX_COUNT));
+    ExpectFloatToBe(0.0f, Error, 1e-5f);
+    ExpectFloatToBe(MeshTestSignedAreaXZ(Vertices, Indices, SIMPLIFY_GRID_INDEX_COUNT),
+                    MeshTestSignedAreaXZ(Vertices, Simplified, Count), 1e-4f);
+
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        ExpectFloatToBe(0.0f, Vertices[Simplified[Index]].Position.y, 0.0f);
+    }
+    return true;
+}
+
+u8 MeshSimplifyShouldKeepAttributeSeams()
+{
+    // NOTE: Two half grids meet at x = 0.5 with matching positions but their own UVs, like a texture seam
+    vertex_3d Vertices[SIMPLIFY_GRID_VERTEX_COUNT * 2];
+    u32 Indices[SIMPLIFY_GRID_INDEX_COUNT * 2];
+    u32 Simplified[SIMPLIFY_GRID_INDEX_COUNT * 2];
+    MeshTestMakeGrid(SIMPLIFY_GRID_CELLS, 0.0f, 0.5f, 0.0f, WaveHeight, Vertices, Indices, 0);
+    MeshTestMakeGrid(SIMPLIFY_GRID_CELLS, 0.5f, 1.0f, 10.0f, WaveHeight, Vertices + SIMPLIFY_GRID_VERTEX_COUNT,
+                     Indices + SIMPLIFY_GRID_INDEX_COUNT, SIMPLIFY_GRID_VERTEX_COUNT);
+
+    u32 IndexCount = SIMPLIFY_GRID_INDEX_COUNT * 2;
+    u32 VertexCount = SIMPLIFY_GRID_VERTEX_COUNT * 2;
+    r32 Error = 0.0f;
+    u32 Count = MeshSimplify(Vertices, sizeof(vertex_3d), VertexCount, Indices, IndexCount, IndexCount / 8, 1.0f,
+                             Simplified, &Error);
+    ExpectToBeTrue(Count < IndexCount / 2);
+    ExpectToBeTrue(MeshTestIndicesValid(Simplified, Count, VertexCount));
+
+    // NOTE: No triangle may mix the two UV sets and neither side may grow into or pull back from the seam
+    u32 LeftIndices[SIMPLIFY_GRID_INDEX_COUNT * 2];
+    u32 RightIndices[SIMPLIFY_GRID_INDEX_COUNT * 2];
+    u32 LeftCount = 0;
+    u32 RightCount = 0;
+    for(u32 Index = 0; Index < Count; Index += 3)
+    {
+        b8 Left = Simplified[Index] < SIMPLIFY_GRID_VERTEX_COUNT;
+        ExpectShouldBe(Left, Simplified[Index + 1] < SIMPLIFY_GRID_VERTEX_COUNT);
+        ExpectShouldBe(Left, Simplified[Index + 2] < SIMPLIFY_GRID_VERTEX_COUNT);
+
+        u32* Side = Left ? LeftIndices + LeftCount : RightIndices + RightCount;
+        Side[0] = Simplified[Index + 0];
+        Side[1] = Simplified[Index + 1];
+        Side[2] = Simplified[Index + 2];
+        if(Left)
+        {
+            LeftCount += 3;
+        }
+        else
+        {
+            RightCount += 3;
+        }
+    }
+
+    r32 HalfArea = MeshTestSignedAreaXZ(Vertices, Indices, SIMPLIFY_GRID_INDEX_COUNT);
+    ExpectFloatToBe(HalfArea, MeshTestSignedAreaXZ(Vertices, LeftIndices, LeftCount), 1e-4f);
+    ExpectFloatToBe(HalfArea, MeshTestSignedAreaXZ(Vertices, RightIndices, RightCount), 1e-4f);
+
+    // NOTE: Seam vertices on both sides must still line up, otherwise the halves would crack apart
+    for(u32 Row = 0; Row <= SIMPLIFY_GRID_CELLS; ++Row)
+    {
+        r32 Z = (r32)Row / (r32)SIMPLIFY_GRID_CELLS;
+        r32 LeftHeight = 0.0f;
+        r32 RightHeight = 0.0f;
+        ExpectToBeTrue(SurfaceHeight(Vertices, LeftIndices, LeftCount, 0.5f, Z, &LeftHeight));
+        ExpectToBeTrue(SurfaceHeight(Vertices, RightIndices, RightCount, 0.5f, Z, &RightHeight));
+        ExpectFloatToBe(LeftHeight, RightHeight, 1e-5f);
+    }
+    return true;
+}
+
+u8 MeshSimplifyShouldRespectTargetError()
+{
+    vertex_3d Vertices[SIMPLIFY_GRID_VERTEX_COUNT];
+    u32 Indices[SIMPLIFY_GRID_INDEX_COUNT];
+    u32 Fine[SIMPLIFY_GRID_INDEX_COUNT];
+    u32 Coarse[SIMPLIFY_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(SIMPLIFY_GRID_CELLS, 0.0f, 1.0f, 0.0f, WaveHeight, Vertices, Indices, 0);
+
+    r32 FineError = 0.0f;
+    r32 CoarseError = 0.0f;
+    u32 FineCount = MeshSimplify(Vertices, sizeof(vertex_3d), SIMPLIFY_GRID_VERTEX_COUNT, Indices, 
+                                 SIMPLIFY_GRID_INDEX_COUNT, 0, 1e-4f, Fine, &FineError);
+    u32 CoarseCount = MeshSimplify(Vertices, sizeof(vertex_3d), SIMPLIFY_GRID_VERTEX_COUNT, Indices, 
+                                   SIMPLIFY_GRID_INDEX_COUNT, 0, 5e-3f, Coarse, &CoarseError);
+
+    ExpectToBeTrue(FineError <= 1e-4f);
+    ExpectToBeTrue(CoarseError <= 5e-3f);
+    ExpectToBeTrue(FineCount < SIMPLIFY_GRID_INDEX_COUNT);
+    ExpectToBeTrue(CoarseCount < FineCount);
+    ExpectToBeTrue(MeshTestIndicesValid(Fine, FineCount, SIMPLIFY_GRID_VERTEX_COUNT));
+    ExpectToBeTrue(MeshTestIndicesValid(Coarse, CoarseCount, SIMPLIFY_GRID_VERTEX_COUNT));
+
+    // NOTE: The reported error is a root mean square distance, so it should match how far the surface moved on
+    // average. Single vertices can end up several times further off, which is only logged.
+    r32 FineMax = 0.0f;
+    r32 CoarseMax = 0.0f;
+    r32 FineDeviation = RmsVerticalDeviation(Vertices, Fine, FineCount, &FineMax);
+    r32 CoarseDeviation = RmsVerticalDeviation(Vertices, Coarse, CoarseCount, &CoarseMax);
+    VENG_INFO("Simplify: %u -> %u indices at error %f (rms %f, max %f), %u at error %f (rms %f, max %f)", 
+              SIMPLIFY_GRID_INDEX_COUNT, FineCount, FineError, FineDeviation, FineMax, 
+              CoarseCount, CoarseError, CoarseDeviation, CoarseMax);
+    ExpectToBeTrue(FineDeviation >= 0.0f);
+    ExpectToBeTrue(CoarseDeviation >= 0.0f);
+    ExpectToBeTrue(FineDeviation <= 1.5f * 1e-4f);
+    ExpectToBeTrue(CoarseDeviation <= 1.5f * 5e-3f);
+    return true;
+}
+
+u8 MeshSimplifyShouldBuildLodChain()
+{
+    vertex_3d Vertices[SIMPLIFY_GRID_VERTEX_COUNT];
+    u32 Indices[SIMPLIFY_GRID_INDEX_COUNT];
+    MeshTestMakeGrid(SIMPLIFY_GRID_CELLS, 0.0f, 1.0f, 0.0f, WaveHeight, Vertices, Indices, 0);
+
+    u32* Lods = Allocate(sizeof(u32) * SIMPLIFY_GRID_INDEX_COUNT * SIMPLIFY_LOD_COUNT, MEMORY_TAG_APPLICATION);
+    u32 LodIndexCounts[SIMPLIFY_LOD_COUNT];
+    r32 LodErrors[SIMPLIFY_LOD_COUNT];
+    u32 LodCount = MeshBuildLods(Vertices, sizeof(vertex_3d), SIMPLIFY_GRID_VERTEX_COUNT, Indices, 
+                                 SIMPLIFY_GRID_INDEX_COUNT, SIMPLIFY_LOD_COUNT, 0.5f, 1.0f, Lods, LodIndexCounts, LodErrors);
+    ExpectToBeTrue(LodCount > 1);
+    ExpectToBeTrue(LodCount <= SIMPLIFY_LOD_COUNT);
+
+    // NOTE: LOD 0 is the input untouched
+    ExpectShouldBe(SIMPLIFY_GRID_INDEX_COUNT, LodIndexCounts[0]);
+    ExpectFloatToBe(0.0f, LodErrors[0], 0.0f);
+    for(u32 Index = 0; Index < SIMPLIFY_GRID_INDEX_COUNT; ++Index)
+    {
+        ExpectShouldBe(Indices[Index], Lods[Index]);
+    }
+
+    // NOTE: Ranges are back to back, every LOD is smaller than the one before and errors only add up
+    u32* Lod = Lods + LodIndexCounts[0];
+    for(u32 Level = 1; Level < LodCount; ++Level)
+    {
+        VENG_INFO("Simplify LOD %u: %u indices, error %f", Level, LodIndexCounts[Level], LodErrors[Level]);
+        ExpectToBeTrue(LodIndexCounts[Level] < LodIndexCounts[Level - 1]);
+        ExpectToBeTrue(LodErrors[Level] >= LodErrors[Level - 1]);
+        ExpectToBeTrue(MeshTestIndicesValid(Lod, LodIndexCounts[Level], SIMPLIFY_GRID_VERTEX_COUNT));
+        Lod += LodIndexCounts[Level];
+    }
+
+    Free(Lods, sizeof(u32) * SIMPLIFY_GRID_INDEX_COUNT * SIMPLIFY_LOD_COUNT, MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void MeshSimplifyRegisterTests()
+{
+    TestManagerRegisterTest(MeshSimplifyShouldCollapsePlanarGrid, "Mesh simplify collapses a planar grid without moving its border");
+    TestManagerRegisterTest(MeshSimplifyShouldKeepAttributeSeams, "Mesh simplify keeps attribute seams closed");
+    TestManagerRegisterTest(MeshSimplifyShouldRespectTargetError, "Mesh simplify stops at the target error");
+    TestManagerRegisterTest(MeshSimplifyShouldBuildLodChain, "Mesh simplify LOD chain shrinks with growing error");
+}
@@ -0,0 +1,67 @@
+#include "mesh_test_utils.h"
+
+#include <math/vmath.h>
+
+void MeshTestMakeGrid(u32 Cells, r32 X0, r32 X1, r32 UOffset, PFN_MeshTestHeight Height, 
+                      vertex_3d* OutVertices, u32* OutIndices, u32 BaseVertex)
+{
+    u32 Side = Cells + 1;
+    for(u32 j = 0; j < Side; ++j)
+    {
+        for(u32 i = 0; i < Side; ++i)
+        {
+            r32 x = X0 + (X1 - X0) * (r32)i / (r32)Cells;
+            r32 z = (r32)j / (r32)Cells;
+            vertex_3d* Vertex = &OutVertices[j * Side + i];
+            Vertex->Position = V3(x, Height ? Height(x, z) : 0.0f, z);
+            Vertex->TexCoord = V2(x + UOffset, z);
+        }
+    }
+
+    u32* Index = OutIndices;
+    for(u32 j = 0; j < Cells; ++j)
+    {
+        for(u32 i = 0; i < Cells; ++i)
+        {
+            u32 v00 = BaseVertex + j * Side + i;
+            u32 v10 = v00 + 1;
+            u32 v01 = v00 + Side;
+            u32 v11 = v01 + 1;
+            *Index++ = v00; *Index++ = v01; *Index++ = v10;
+            *Index++ = v10; *Index++ = v01; *Index++ = v11;
+        }
+    }
+}
+
+r32 MeshTestSignedAreaXZ(const vertex_3d* Vertices, const u32* Indices, u32 IndexCount)
+{
+    r32 Area = 0.0f;
+    for(u32 Index = 0; Index + 2 < IndexCount; Index += 3)
+    {
+        v3 A = Vertices[Indices[Index + 0]].Position;
+        v3 B = Vertices[Indices[Index + 1]].Position;
+        v3 C = Vertices[Indices[Index + 2]].Position;
+        Area += 0.5f * ((B.z - A.z) * (C.x - A.x) - (B.x - A.x) * (C.z - A.z));
+    }
+    return Area;
+}
+
+b8 MeshTestIndicesValid(const u32* Indices, u32 IndexCount, u32 VertexCount)
+{
+    if(IndexCount % 3)
+    {
+        return false;
+    }
+
+    for(u32 Index = 0; Index < IndexCount; Index += 3)
+    {
+        u32 A = Indices[Index + 0];
+        u32 B = Indices[Index + 1];
+        u32 C = Indices[Index + 2];
+        if(A >= VertexCount || B >= VertexCount || C >= VertexCount || A == B || B == C || A == C)
+        {
+            return false;
+        }
+    }
+    return true;
+}
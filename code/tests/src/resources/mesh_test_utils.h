@@ -0,0 +1,17 @@
+#pragma once
+
+#include <defines.h>
+#include <math/math_types.h>
+
+// NOTE: Test meshes shared by the resources tests. Grids lie in the xz plane over [X0, X1] x [0, 1] with
+// TexCoord.u = x + UOffset, Height displaces y. Index and vertex counts are (Cells * Cells * 6) and
+// (Cells + 1)^2, the caller owns the arrays.
+typedef r32 (*PFN_MeshTestHeight)(r32 X, r32 Z);
+
+void MeshTestMakeGrid(u32 Cells, r32 X0, r32 X1, r32 UOffset, PFN_MeshTestHeight Height, 
+                      vertex_3d* OutVertices, u32* OutIndices, u32 BaseVertex);
+
+// NOTE: Sum of the triangles' areas projected on the xz plane, signed so flipped triangles subtract
+r32 MeshTestSignedAreaXZ(const vertex_3d* Vertices, const u32* Indices, u32 IndexCount);
+
+b8 MeshTestIndicesValid(const u32* Indices, u32 IndexCount, u32 VertexCount);
@@ -0,0 +1,215 @@
+#include "transform_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <systems/transform_system.h>
+#include <core/vmemory.h>
+
+typedef struct transform_test_state
+{
+    u64 MemoryRequirement;
+    void* TransformSystem;
+} transform_test_state;
+
+static b8 Setup(transform_test_state* State, u32 MaxTransformCount)
+{
+    transform_system_config Config;
+    Config.MaxTransformCount = MaxTransformCount;
+    TransformSystemInitialize(&State->MemoryRequirement, 0, Config);
+    State->TransformSystem = Allocate(State->MemoryRequirement, MEMORY_TAG_APPLICATION);
+    return TransformSystemInitialize(&State->MemoryRequirement, State->TransformSystem, Config);
+}
+
+static void Teardown(transform_test_state* State)
+{
+    TransformSystemShutdown(State->TransformSystem);
+    Free(State->TransformSystem, State->MemoryRequirement, MEMORY_TAG_APPLICATION);
+}
+
+static r32 MaxDifferenceMat4(mat4 A, mat4 B)
+{
+    r32 Max = 0.0f;
+    for(u32 Index = 0; Index < 16; ++Index)
+    {
+        r32 Difference = Abs(A.E[Index] - B.E[Index]);
+        Max = Difference > Max ? Difference : Max;
+    }
+    return Max;
+}
+
+static u32 CreateAt(v3 Position)
+{
+    return TransformCreate(Position, IdentityQuat(), V3One());
+}
+
+u8 TransformShouldUpdateParentsBeforeChildren()
+{
+    transform_test_state State;
+    ExpectToBeTrue(Setup(&State, 16));
+
+    // NOTE: Children get lower IDs than their parents, so ID order is not a valid update order
+    u32 GrandChild = CreateAt(V3(0.0f, 0.0f, 3.0f));
+    u32 Child      = CreateAt(V3(0.0f, 2.0f, 0.0f));
+    u32 Root       = CreateAt(V3(1.0f, 0.0f, 0.0f));
+    ExpectToBeTrue(TransformSetParent(Child, Root));
+    ExpectToBeTrue(TransformSetParent(GrandChild, Child));
+    ExpectShouldBe(Child, TransformGetParent(GrandChild));
+    ExpectShouldBe(INVALID_ID, TransformGetParent(Root));
+
+    TransformSystemUpdate();
+    mat4 World = TransformGetWorld(GrandChild);
+    ExpectFloatToBe(1.0f, World.E[12], 1e-6f);
+    ExpectFloatToBe(2.0f, World.E[13], 1e-6f);
+    ExpectFloatToBe(3.0f, World.E[14], 1e-6f);
+
+    // NOTE: Changes to the root reach the whole subtree on the next update
+    TransformSetRotation(Root, QuatFromAxis(V3(0.0f, 0.0f, 1.0f), 0.5f * PI32, true));
+    TransformSetScale(Root, V3(2.0f, 2.0f, 2.0f));
+    TransformTranslate(Child, V3(0.0f, 1.0f, 0.0f));
+    TransformSystemUpdate();
+
+    mat4 RootWorld  = TransformGetLocal(Root);
+    mat4 ChildWorld = MulMat4(TransformGetLocal(Child), RootWorld);
+    mat4 Expected   = MulMat4(TransformGetLocal(GrandChild), ChildWorld);
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(RootWorld, TransformGetWorld(Root)), 1e-5f);
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(ChildWorld, TransformGetWorld(Child)), 1e-5f);
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(Expected, TransformGetWorld(GrandChild)), 1e-5f);
+
+    // NOTE: TransformGetWorld brings a stale transform up to date without an explicit update
+    TransformSetPosition(Root, V3(5.0f, 0.0f, 0.0f));
+    ChildWorld = MulMat4(TransformGetLocal(Child), TransformGetLocal(Root));
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(ChildWorld, TransformGetWorld(Child)), 1e-5f);
+
+    Teardown(&State);
+    return true;
+}
+
+u8 TransformShouldFollowNewParent()
+{
+    transform_test_state State;
+    ExpectToBeTrue(Setup(&State, 16));
+
+    u32 ParentA = CreateAt(V3(10.0f, 0.0f, 0.0f));
+    u32 ParentB = CreateAt(V3(0.0f, 20.0f, 0.0f));
+    u32 Child   = CreateAt(V3(1.0f, 1.0f, 1.0f));
+    u32 Sibling = CreateAt(V3(0.0f, 0.0f, 0.0f));
+    ExpectToBeTrue(TransformSetParent(Child, ParentA));
+    ExpectToBeTrue(TransformSetParent(Sibling, ParentA));
+    TransformSystemUpdate();
+
+    mat4 World = TransformGetWorld(Child);
+    ExpectFloatToBe(11.0f, World.E[12], 1e-6f);
+    ExpectFloatToBe(1.0f, World.E[13], 1e-6f);
+
+    ExpectToBeTrue(TransformSetParent(Child, ParentB));
+    ExpectShouldBe(ParentB, TransformGetParent(Child));
+    TransformSystemUpdate();
+    World = TransformGetWorld(Child);
+    ExpectFloatToBe(1.0f, World.E[12], 1e-6f);
+    ExpectFloatToBe(21.0f, World.E[13], 1e-6f);
+
+    // NOTE: The old parent no longer moves the child, its other child still follows it
+    TransformSetPosition(ParentA, V3(-10.0f, 0.0f, 0.0f));
+    TransformSystemUpdate();
+    ExpectFloatToBe(1.0f, TransformGetWorld(Child).E[12], 1e-6f);
+    ExpectFloatToBe(-10.0f, TransformGetWorld(Sibling).E[12], 1e-6f);
+
+    ExpectToBeTrue(TransformSetParent(Child, INVALID_ID));
+    TransformSystemUpdate();
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(TransformGetLocal(Child), TransformGetWorld(Child)), 1e-6f);
+
+    // NOTE: Children of a destroyed transform become roots that keep their local transform
+    ExpectToBeTrue(TransformSetParent(Child, ParentB));
+    TransformDestroy(ParentB);
+    ExpectShouldBe(INVALID_ID, TransformGetParent(Child));
+    ExpectFloatToBe(0.0f, MaxDifferenceMat4(TransformGetLocal(Child), TransformGetWorld(Child)), 1e-6f);
+
+    Teardown(&State);
+    return true;
+}
+
+u8 TransformShouldRejectCycles()
+{
+    transform_test_state State;
+    ExpectToBeTrue(Setup(&State, 16));
+
+    u32 Root       = CreateAt(V3(1.0f, 0.0f, 0.0f));
+    u32 Child      = CreateAt(V3(0.0f, 1.0f, 0.0f));
+    u32 GrandChild = CreateAt(V3(0.0f, 0.0f, 1.0f));
+    ExpectToBeTrue(TransformSetParent(Child, Root));
+    ExpectToBeTrue(TransformSetParent(GrandChild, Child));
+
+    ExpectToBeFalse(TransformSetParent(Root, GrandChild));
+    ExpectToBeFalse(TransformSetParent(Root, Child));
+    ExpectToBeFalse(TransformSetParent(Child, Child));
+    ExpectToBeFalse(TransformSetParent(Child, 15));
+
+    // NOTE: A rejected parent leaves the hierarchy as it was
+    ExpectShouldBe(INVALID_ID, TransformGetParent(Root));
+    ExpectShouldBe(Root, TransformGetParent(Child));
+    ExpectShouldBe(Child, TransformGetParent(GrandChild));
+
+    mat4 World = TransformGetWorld(GrandChild);
+    ExpectFloatToBe(1.0f, World.E[12], 1e-6f);
+    ExpectFloatToBe(1.0f, World.E[13], 1e-6f);
+    ExpectFloatToBe(1.0f, World.E[14], 1e-6f);
+
+    Teardown(&State);
+    return true;
+}
+
+u8 TransformShouldSurviveDestroyCreateChurn()
+{
+    transform_test_state State;
+    ExpectToBeTrue(Setup(&State, 8));
+
+    u32 IDs[8];
+    for(u32 Index = 0; Index < 8; ++Index)
+    {
+        IDs[Index] = CreateAt(V3((r32)Index, 0.0f, 0.0f));
+        ExpectShouldNotBe(INVALID_ID, IDs[Index]);
+    }
+    ExpectShouldBe(INVALID_ID, CreateAt(V3Zero()));
+    TransformSystemUpdate();
+
+    // NOTE: Every slot is destroyed and reused many times in one frame, the dirty list holds each slot once
+    for(u32 Round = 0; Round < 100; ++Round)
+    {
+        u32 Slot = Round % 8;
+        TransformDestroy(IDs[Slot]);
+        IDs[Slot] = CreateAt(V3((r32)Round, 1.0f, 0.0f));
+        ExpectShouldNotBe(INVALID_ID, IDs[Slot]);
+        if(Slot > 0)
+        {
+            ExpectToBeTrue(TransformSetParent(IDs[Slot], IDs[Slot - 1]));
+        }
+    }
+
+    // NOTE: Destroying a parent in the loop made its children roots, link the whole chain 0 <- 1 <- ... <- 7
+    for(u32 Slot = 1; Slot < 8; ++Slot)
+    {
+        ExpectToBeTrue(TransformSetParent(IDs[Slot], IDs[Slot - 1]));
+    }
+    TransformSystemUpdate();
+
+    // NOTE: The last round through each slot set x to the round: 96..99 for slots 0..3, 92..95 for slots 4..7
+    r32 ExpectedX = 0.0f;
+    for(u32 Slot = 0; Slot < 8; ++Slot)
+    {
+        ExpectedX += (r32)(Slot < 4 ? 96 + Slot : 88 + Slot);
+        mat4 World = TransformGetWorld(IDs[Slot]);
+        ExpectFloatToBe(ExpectedX, World.E[12], 1e-4f);
+        ExpectFloatToBe((r32)(Slot + 1), World.E[13], 1e-4f);
+    }
+
+    Teardown(&State);
+    return true;
+}
+
+void TransformSystemRegisterTests()
+{
+    TestManagerRegisterTest(TransformShouldUpdateParentsBeforeChildren, "Transforms should update parents before children");
+    TestManagerRegisterTest(TransformShouldFollowNewParent, "Transforms should follow a new parent after reparenting");
+    TestManagerRegisterTest(TransformShouldRejectCycles, "Transforms should reject parents that would create a cycle");
+    TestManagerRegisterTest(TransformShouldSurviveDestroyCreateChurn, "Transforms should survive destroy and create in the same frame");
+}
@@ -0,0 +1,79 @@
+#include "test_manager.h"
+
+#include <containers/darray.h>
+#include <core/logger.h>
+#include <core/vstring.h>
+#include <core/clock.h>
+
+typedef struct test_entry
+{
+    PFN_Test Func;
+    char* Description;
+} test_entry;
+
+static test_entry* Tests;
+
+void TestManagerInit()
+{
+    Tests = DArrayCreate(test_entry);
+}
+
+void TestManagerRegisterTest(PFN_Test Test, char* Description)
+{
+    test_entry Entry;
+    Entry.Func = Test;
+    Entry.Description = Description;
+    DArrayPush(Tests, Entry);
+}
+
+u32 TestManagerRunTests()
+{
+    u32 Passed  = 0;
+    u32 Failed  = 0;
+    u32 Skipped = 0;
+
+    u32 Count = (u32)DArrayLength(Tests);
+
+    clock TotalTime;
+    ClockStart(&TotalTime);
+
+    for(u32 Index = 0;
+        Index < Count;
+        ++Index)
+    {
+        clock TestTime;
+        ClockStart(&TestTime);
+        u8 Result = Tests[Index].Func();
+        ClockUpdate(&TestTime);
+
+        if(Result == true)
+        {
+            ++Passed;
+        }
+        else if(Result == BYPASS)
+        {
+            VENG_WARN("[SKIPPED]: %s", Tests[Index].Description);
+            ++Skipped;
+        }
+        else
+        {
+            VENG_ERROR("[FAILED]: %s", Tests[Index].Description);
+            ++Failed;
+        }
+
+        char Status[32];
+        StringFormat(Status, Failed ? "*** %u FAILED ***" : "SUCCESS", Failed);
+        ClockUpdate(&TotalTime);
+        VENG_INFO("Executed %u of %u (skipped %u) %s (%.6f sec / %.6f sec total)", 
+                  Index + 1, Count, Skipped, Status, TestTime.Elapsed, TotalTime.Elapsed);
+    }
+
+    ClockStop(&TotalTime);
+
+    VENG_INFO("Results: %u passed, %u failed, %u skipped.", Passed, Failed, Skipped);
+
+    DArrayDestroy(Tests);
+    Tests = 0;
+
+    return Failed;
+}
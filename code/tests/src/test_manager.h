@@ -0,0 +1,13 @@
+#pragma once
+
+#include <defines.h>
+
+// NOTE: Tests return true on success, false on failure and BYPASS when they were skipped
+#define BYPASS 2
+
+typedef u8 (*PFN_Test)();
+
+void TestManagerInit();
+void TestManagerRegisterTest(PFN_Test Test, char* Description);
+// NOTE: Returns the number of failed tests
+u32 TestManagerRunTests();
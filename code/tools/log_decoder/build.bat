@@ -0,0 +1,19 @@
+@echo off
+if not defined DevEnvDir (
+   call vcvarsall amd64
+)
+
+setlocal EnableDelayedExpansion
+
+set cFileNames=
+for /R %%f in (*.c) do (
+    set cFileNames=!cFileNames! %%f
+)
+
+set Assembly=log_decoder
+set CompilerFlags=-g
+set IncludeFlags=-Isrc -I../../engine/src
+set LinkerFlags=
+set Defines=-D_MBCS -D_DEBUG=1 -D_CRT_SECURE_NO_WARNINGS
+
+clang %cFileNames% %CompilerFlags% -o ../../../build/%Assembly%.exe %Defines% %IncludeFlags% %LinkerFlags%
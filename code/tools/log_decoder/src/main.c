@@ -0,0 +1,323 @@
+#include <core/binary_log.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE: Turns console.bin written by OutputLogBinary back into text.
+// Usage: log_decoder [console.bin] [output.log], writes to stdout without an output path.
+
+typedef struct decoded_format
+{
+    u8 ArgCount;
+    u8 ArgTypes[BINARY_LOG_MAX_ARGS];
+    const char* Format;
+} decoded_format;
+
+static const char* LevelStrings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: ", "[TRACE]: "};
+
+typedef struct arg_value
+{
+    u8 Type;
+    u64 Integer;
+    r64 Real;
+    char String[512];
+} arg_value;
+
+static b8 ReadArg(u8 Type, const u8** At, const u8* End, arg_value* Out)
+{
+    Out->Type = Type;
+    switch(Type)
+    {
+        case BINARY_LOG_ARG_I32:
+        case BINARY_LOG_ARG_U32:
+        {
+            if(*At + 4 > End) return false;
+            u32 Value;
+            memcpy(&Value, *At, 4);
+            Out->Integer = Type == BINARY_LOG_ARG_I32 ? (u64)(s64)(s32)Value : Value;
+            *At += 4;
+        } break;
+        case BINARY_LOG_ARG_I64:
+        case BINARY_LOG_ARG_U64:
+        case BINARY_LOG_ARG_POINTER:
+        {
+            if(*At + 8 > End) return false;
+            memcpy(&Out->Integer, *At, 8);
+            *At += 8;
+        } break;
+        case BINARY_LOG_ARG_R64:
+        {
+            if(*At + 8 > End) return false;
+            memcpy(&Out->Real, *At, 8);
+            *At += 8;
+        } break;
+        case BINARY_LOG_ARG_STRING:
+        {
+            if(*At + 2 > End) return false;
+            u16 Length;
+            memcpy(&Length, *At, 2);
+            *At += 2;
+            if(*At + Length > End) return false;
+            Length = Length < sizeof(Out->String) - 1 ? Length : sizeof(Out->String) - 1;
+            memcpy(Out->String, *At, Length);
+            Out->String[Length] = 0;
+            *At += Length;
+        } break;
+        default:
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Rebuilds one conversion with '*' replaced by the stored values and the length modifier
+// replaced by ll (every integer is decoded to 64 bits), then formats the value with it.
+static void FormatSpec(FILE* Out, const char* Format, binary_log_spec* Spec, arg_value* Args, u32 ArgCount)
+{
+    char Rebuilt[64];
+    u32 Length = 0;
+    u32 ArgIndex = 0;
+    for(u32 At = Spec->Start;
+        At < Spec->Start + Spec->Length - 1 && Length < sizeof(Rebuilt) - 24;
+        ++At)
+    {
+        char c = Format[At];
+        if(c == '*')
+        {
+            s32 Value = ArgIndex < ArgCount ? (s32)Args[ArgIndex].Integer : 0;
+            ArgIndex++;
+            if(Length > 0 && Rebuilt[Length - 1] == '.')
+            {
+                // NOTE: A negative precision counts as if none was given
+                if(Value < 0)
+                {
+                    Length--;
+                }
+                else
+                {
+                    Length += snprintf(Rebuilt + Length, sizeof(Rebuilt) - Length, "%d", Value);
+                }
+            }
+            else
+            {
+                // NOTE: A negative width is the '-' flag followed by the magnitude
+                if(Value < 0)
+                {
+                    Rebuilt[Length++] = '-';
+                }
+                Length += snprintf(Rebuilt + Length, sizeof(Rebuilt) - Length, "%u", Value < 0 ? 0u - (u32)Value : (u32)Value);
+            }
+        }
+        else if(c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L')
+        {
+        }
+        else if(c == 'I' && (Format[At + 1] == '6' || Format[At + 1] == '3'))
+        {
+            At += 2;
+        }
+        else
+        {
+            Rebuilt[Length++] = c;
+        }
+    }
+
+    if(ArgIndex >= ArgCount)
+    {
+        fputs("<?>", Out);
+        return;
+    }
+
+    arg_value* Value = &Args[ArgIndex];
+    switch(Value->Type)
+    {
+        case BINARY_LOG_ARG_I32:
+        case BINARY_LOG_ARG_I64:
+        case BINARY_LOG_ARG_U32:
+        case BINARY_LOG_ARG_U64:
+        {
+            if(Spec->Conversion == 'c')
+            {
+                Rebuilt[Length++] = 'c';
+                Rebuilt[Length] = 0;
+                fprintf(Out, Rebuilt, (int)Value->Integer);
+                break;
+            }
+            Rebuilt[Length++] = 'l';
+            Rebuilt[Length++] = 'l';
+            Rebuilt[Length++] = Spec->Conversion;
+            Rebuilt[Length] = 0;
+            fprintf(Out, Rebuilt, (unsigned long long)Value->Integer);
+        } break;
+        case BINARY_LOG_ARG_R64:
+        {
+            Rebuilt[Length++] = Spec->Conversion;
+            Rebuilt[Length] = 0;
+            fprintf(Out, Rebuilt, Value->Real);
+        } break;
+        case BINARY_LOG_ARG_POINTER:
+        {
+            fprintf(Out, "0x%016llx", (unsigned long long)Value->Integer);
+        } break;
+        case BINARY_LOG_ARG_STRING:
+        {
+            Rebuilt[Length++] = 's';
+            Rebuilt[Length] = 0;
+            fprintf(Out, Rebuilt, Value->String);
+        } break;
+    }
+}
+
+static void DecodeMessage(FILE* Out, u8 Level, decoded_format* Format, const u8* Payload, const u8* End)
+{
+    fputs(LevelStrings[Level < 6 ? Level : 5], Out);
+
+    u32 Cursor = 0;
+    u32 Printed = 0;
+    u32 TypeIndex = 0;
+    binary_log_spec Spec;
+    while(BinaryLogNextSpec(Format->Format, &Cursor, &Spec))
+    {
+        fwrite(Format->Format + Printed, 1, Spec.Start - Printed, Out);
+        Printed = Spec.Start + Spec.Length;
+
+        if(Spec.Conversion == '%')
+        {
+            fputc('%', Out);
+            continue;
+        }
+
+        arg_value Args[3];
+        u32 ArgCount = 0;
+        for(u32 ArgIndex = 0;
+            ArgIndex < Spec.ArgCount && TypeIndex < Format->ArgCount;
+            ++ArgIndex, ++TypeIndex)
+        {
+            if(ReadArg(Format->ArgTypes[TypeIndex], &Payload, End, &Args[ArgCount]))
+            {
+                ArgCount++;
+            }
+        }
+
+        if(ArgCount < Spec.ArgCount)
+        {
+            fputs("<?>", Out);
+            continue;
+        }
+
+        FormatSpec(Out, Format->Format, &Spec, Args, ArgCount);
+    }
+
+    fputs(Format->Format + Printed, Out);
+    fputc('\n', Out);
+}
+
+int main(int ArgCount, char** Args)
+{
+    const char* InputPath  = ArgCount > 1 ? Args[1] : "console.bin";
+    const char* OutputPath = ArgCount > 2 ? Args[2] : 0;
+
+    FILE* Input = fopen(InputPath, "rb");
+    if(!Input)
+    {
+        fprintf(stderr, "Unable to open '%s'.\n", InputPath);
+        return 1;
+    }
+
+    fseek(Input, 0, SEEK_END);
+    long Size = ftell(Input);
+    fseek(Input, 0, SEEK_SET);
+
+    u8* Data = (u8*)malloc(Size > 0 ? Size : 1);
+    if(fread(Data, 1, Size, Input) != (size_t)Size)
+    {
+        fprintf(stderr, "Unable to read '%s'.\n", InputPath);
+        return 1;
+    }
+    fclose(Input);
+
+    binary_log_file_header FileHeader;
+    if(Size < (long)sizeof(FileHeader))
+    {
+        fprintf(stderr, "'%s' is not a binary log.\n", InputPath);
+        return 1;
+    }
+
+    memcpy(&FileHeader, Data, sizeof(FileHeader));
+    if(FileHeader.Magic != BINARY_LOG_MAGIC || FileHeader.Version != BINARY_LOG_VERSION)
+    {
+        fprintf(stderr, "'%s' is not a version %d binary log.\n", InputPath, BINARY_LOG_VERSION);
+        return 1;
+    }
+
+    FILE* Out = stdout;
+    if(OutputPath)
+    {
+        Out = fopen(OutputPath, "w");
+        if(!Out)
+        {
+            fprintf(stderr, "Unable to open '%s' for writing.\n", OutputPath);
+            return 1;
+        }
+    }
+
+    // NOTE: Formats can come after the messages that use them, so they are collected in a first pass
+    u32 FormatCapacity = 1024;
+    decoded_format* Formats = (decoded_format*)calloc(FormatCapacity, sizeof(decoded_format));
+    for(u32 Pass = 0;
+        Pass < 2;
+        ++Pass)
+    {
+        const u8* At  = Data + sizeof(FileHeader);
+        const u8* End = Data + Size;
+        while(At + sizeof(binary_log_record_header) <= End)
+        {
+            binary_log_record_header Header;
+            memcpy(&Header, At, sizeof(Header));
+            const u8* Payload = At + sizeof(Header);
+            const u8* PayloadEnd = Payload + Header.Size;
+            if(PayloadEnd > End)
+            {
+                fprintf(stderr, "Truncated record at offset %lld.\n", (long long)(At - Data));
+                break;
+            }
+            At = PayloadEnd;
+
+            if(Pass == 0 && Header.Type == BINARY_LOG_RECORD_FORMAT && Header.Size > 0)
+            {
+                while(Header.FormatID >= FormatCapacity)
+                {
+                    Formats = (decoded_format*)realloc(Formats, FormatCapacity * 2 * sizeof(decoded_format));
+                    memset(Formats + FormatCapacity, 0, FormatCapacity * sizeof(decoded_format));
+                    FormatCapacity *= 2;
+                }
+
+                decoded_format* Format = &Formats[Header.FormatID];
+                Format->ArgCount = Payload[0] < BINARY_LOG_MAX_ARGS ? Payload[0] : BINARY_LOG_MAX_ARGS;
+                memcpy(Format->ArgTypes, Payload + 1, Format->ArgCount);
+                Format->Format = (const char*)(Payload + 1 + Payload[0]);
+            }
+            else if(Pass == 1 && Header.Type == BINARY_LOG_RECORD_MESSAGE)
+            {
+                if(Header.FormatID >= FormatCapacity || !Formats[Header.FormatID].Format)
+                {
+                    fprintf(Out, "%s<unknown format %u>\n", LevelStrings[Header.Level < 6 ? Header.Level : 5], Header.FormatID);
+                    continue;
+                }
+
+                DecodeMessage(Out, Header.Level, &Formats[Header.FormatID], Payload, PayloadEnd);
+            }
+        }
+    }
+
+    if(Out != stdout)
+    {
+        fclose(Out);
+    }
+
+    free(Formats);
+    free(Data);
+    return 0;
+}
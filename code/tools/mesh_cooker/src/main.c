@@ -0,0 +1,536 @@
+#include <resources/mesh_format.h>
+#include <resources/mesh_optimize.h>
+#include <resources/mesh_simplify.h>
+#include <resources/mesh_quantize.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// NOTE: Cooks a Wavefront OBJ into the .vsm static mesh the engine's static mesh loader reads.
+// Usage: mesh_cooker input.obj output.vsm [lod count] [lod error] [packed]
+// Every object or group and material pair becomes a submesh using the engine material of the same name. Faces with
+// more than 3 corners are fanned, normals are dropped since vertex_3d has none. Each submesh gets up to lod count
+// levels (default GEOMETRY_MAX_LODS) of half the triangles each, every step may move the surface by at most lod error
+// times the submesh radius (default 0.01), and every level is ordered for the vertex cache and overdraw. "packed"
+// writes vertex_3d_packed vertices quantized against each submesh's bounds.
+
+typedef struct obj_corner
+{
+    u32 Position;
+    // NOTE: 0 when the face has no texture coordinates, 1 based otherwise
+    u32 TexCoord;
+} obj_corner;
+
+typedef struct obj_submesh
+{
+    char Name[GEOMETRY_NAME_MAX_LENGTH];
+    char MaterialName[MATERIAL_NAME_MAX_LENGTH];
+    obj_corner* Corners;
+    u32 CornerCount;
+    u32 CornerCapacity;
+} obj_submesh;
+
+typedef struct obj_data
+{
+    v3* Positions;
+    u32 PositionCount;
+    u32 PositionCapacity;
+
+    v2* TexCoords;
+    u32 TexCoordCount;
+    u32 TexCoordCapacity;
+
+    obj_submesh* Submeshes;
+    u32 SubmeshCount;
+    u32 SubmeshCapacity;
+} obj_data;
+
+typedef struct cooked_submesh
+{
+    mesh_file_submesh File;
+    vertex_3d* Vertices;
+    vertex_3d_packed* PackedVertices;
+    u32* Indices;
+} cooked_submesh;
+
+static void* Reserve(void* Array, u32 ElementSize, u32 Count, u32* Capacity)
+{
+    if(Count < *Capacity)
+    {
+        return Array;
+    }
+
+    *Capacity = *Capacity ? *Capacity * 2 : 64;
+    void* Grown = realloc(Array, (size_t)ElementSize * *Capacity);
+    if(!Grown)
+    {
+        fprintf(stderr, "Out of memory.\n");
+        exit(1);
+    }
+    return Grown;
+}
+
+static void CopyName(char* Dest, const char* Source, u32 Capacity)
+{
+    u32 Length = 0;
+    while(Source[Length] && Source[Length] != '\r' && Source[Length] != '\n' && Length + 1 < Capacity)
+    {
+        Dest[Length] = Source[Length];
+        Length++;
+    }
+
+    while(Length > 0 && (Dest[Length - 1] == ' ' || Dest[Length - 1] == '\t'))
+    {
+        Length--;
+    }
+    Dest[Length] = 0;
+}
+
+static obj_submesh* FindSubmesh(obj_data* Obj, const char* Name, const char* MaterialName)
+{
+    for(u32 Index = 0;
+        Index < Obj->SubmeshCount;
+        ++Index)
+    {
+        obj_submesh* Submesh = Obj->Submeshes + Index;
+        if(strcmp(Submesh->Name, Name) == 0 && strcmp(Submesh->MaterialName, MaterialName) == 0)
+        {
+            return Submesh;
+        }
+    }
+
+    Obj->Submeshes = Reserve(Obj->Submeshes, sizeof(obj_submesh), Obj->SubmeshCount, &Obj->SubmeshCapacity);
+    obj_submesh* Submesh = Obj->Submeshes + Obj->SubmeshCount++;
+    memset(Submesh, 0, sizeof(obj_submesh));
+    CopyName(Submesh->Name, Name, GEOMETRY_NAME_MAX_LENGTH);
+    CopyName(Submesh->MaterialName, MaterialName, MATERIAL_NAME_MAX_LENGTH);
+    return Submesh;
+}
+
+// NOTE: Reads "p", "p/t", "p//n" or "p/t/n", negative indices count back from the last element
+static b8 ParseCorner(char** At, const obj_data* Obj, obj_corner* OutCorner)
+{
+    char* End;
+    long Position = strtol(*At, &End, 10);
+    if(End == *At)
+    {
+        return false;
+    }
+    *At = End;
+
+    long TexCoord = 0;
+    if(**At == '/')
+    {
+        (*At)++;
+        if(**At != '/')
+        {
+            TexCoord = strtol(*At, &End, 10);
+            *At = End;
+        }
+
+        if(**At == '/')
+        {
+            (*At)++;
+            strtol(*At, &End, 10);
+            *At = End;
+        }
+    }
+
+    Position = Position < 0 ? (long)Obj->PositionCount + Position + 1 : Position;
+    TexCoord = TexCoord < 0 ? (long)Obj->TexCoordCount + TexCoord + 1 : TexCoord;
+    if(Position < 1 || Position > (long)Obj->PositionCount || TexCoord < 0 || TexCoord > (long)Obj->TexCoordCount)
+    {
+        return false;
+    }
+
+    OutCorner->Position = (u32)Position;
+    OutCorner->TexCoord = (u32)TexCoord;
+    return true;
+}
+
+static b8 ParseObj(char* Text, const char* DefaultName, obj_data* Obj)
+{
+    char ObjectName[GEOMETRY_NAME_MAX_LENGTH];
+    char MaterialName[MATERIAL_NAME_MAX_LENGTH] = "";
+    CopyName(ObjectName, DefaultName, GEOMETRY_NAME_MAX_LENGTH);
+    obj_submesh* Current = 0;
+
+    u32 LineNumber = 0;
+    char* Line = Text;
+    while(Line && *Line)
+    {
+        char* Next = strchr(Line, '\n');
+        if(Next)
+        {
+            *Next++ = 0;
+        }
+        LineNumber++;
+
+        while(*Line == ' ' || *Line == '\t')
+        {
+            Line++;
+        }
+
+        if(strncmp(Line, "v ", 2) == 0)
+        {
+            Obj->Positions = Reserve(Obj->Positions, sizeof(v3), Obj->PositionCount, &Obj->PositionCapacity);
+            v3* P = Obj->Positions + Obj->PositionCount++;
+            char* At = Line + 2;
+            P->x = strtof(At, &At);
+            P->y = strtof(At, &At);
+            P->z = strtof(At, &At);
+        }
+        else if(strncmp(Line, "vt ", 3) == 0)
+        {
+            Obj->TexCoords = Reserve(Obj->TexCoords, sizeof(v2), Obj->TexCoordCount, &Obj->TexCoordCapacity);
+            v2* T = Obj->TexCoords + Obj->TexCoordCount++;
+            char* At = Line + 3;
+            T->x = strtof(At, &At);
+            T->y = strtof(At, &At);
+        }
+        else if(strncmp(Line, "f ", 2) == 0)
+        {
+            if(!Current)
+            {
+                Current = FindSubmesh(Obj, ObjectName, MaterialName);
+            }
+
+            obj_corner First, Previous, Corner;
+            u32 CornerCount = 0;
+            char* At = Line + 2;
+            for(;;)
+            {
+                while(*At == ' ' || *At == '\t')
+                {
+                    At++;
+                }
+
+                if(*At == 0 || *At == '\r' || *At == '#')
+                {
+                    break;
+                }
+
+                if(!ParseCorner(&At, Obj, &Corner))
+                {
+                    fprintf(stderr, "Line %u: invalid face corner.\n", LineNumber);
+                    return false;
+                }
+
+                if(CornerCount == 0)
+                {
+                    First = Corner;
+                }
+                else if(CornerCount >= 2)
+                {
+                    Current->Corners = Reserve(Current->Corners, sizeof(obj_corner), Current->CornerCount + 2, &Current->CornerCapacity);
+                    Current->Corners[Current->CornerCount++] = First;
+                    Current->Corners[Current->CornerCount++] = Previous;
+                    Current->Corners[Current->CornerCount++] = Corner;
+                }
+                Previous = Corner;
+                CornerCount++;
+            }
+
+            if(CornerCount < 3)
+            {
+                fprintf(stderr, "Line %u: face with %u corners skipped.\n", LineNumber, CornerCount);
+            }
+        }
+        else if(strncmp(Line, "o ", 2) == 0 || strncmp(Line, "g ", 2) == 0)
+        {
+            CopyName(ObjectName, Line + 2, GEOMETRY_NAME_MAX_LENGTH);
+            Current = 0;
+        }
+        else if(strncmp(Line, "usemtl ", 7) == 0)
+        {
+            CopyName(MaterialName, Line + 7, MATERIAL_NAME_MAX_LENGTH);
+            Current = 0;
+        }
+
+        Line = Next;
+    }
+
+    return true;
+}
+
+static extents_3d ComputeExtents(const vertex_3d* Vertices, u32 VertexCount)
+{
+    extents_3d Extents = {{{INFINITY, INFINITY, INFINITY}}, {{-INFINITY, -INFINITY, -INFINITY}}};
+    for(u32 Index = 0;
+        Index < VertexCount;
+        ++Index)
+    {
+        v3 P = Vertices[Index].Position;
+        Extents.Min.x = P.x < Extents.Min.x ? P.x : Extents.Min.x;
+        Extents.Min.y = P.y < Extents.Min.y ? P.y : Extents.Min.y;
+        Extents.Min.z = P.z < Extents.Min.z ? P.z : Extents.Min.z;
+        Extents.Max.x = P.x > Extents.Max.x ? P.x : Extents.Max.x;
+        Extents.Max.y = P.y > Extents.Max.y ? P.y : Extents.Max.y;
+        Extents.Max.z = P.z > Extents.Max.z ? P.z : Extents.Max.z;
+    }
+    return Extents;
+}
+
+// NOTE: Same steps as GeometrySystemGenerateLods followed by GeometrySystemOptimizeConfig, done once here instead
+// of on every load
+static void CookSubmesh(const obj_data* Obj, const obj_submesh* Source, u32 LodCount, r32 LodError, cooked_submesh* Out)
+{
+    memset(Out, 0, sizeof(cooked_submesh));
+    CopyName(Out->File.Name, Source->Name, GEOMETRY_NAME_MAX_LENGTH);
+    CopyName(Out->File.MaterialName, Source->MaterialName, MATERIAL_NAME_MAX_LENGTH);
+
+    u32 IndexCount = Source->CornerCount;
+    vertex_3d* Vertices = malloc(sizeof(vertex_3d) * IndexCount);
+    u32* Indices = malloc(sizeof(u32) * IndexCount);
+    for(u32 Index = 0;
+        Index < IndexCount;
+        ++Index)
+    {
+        obj_corner Corner = Source->Corners[Index];
+        memset(Vertices + Index, 0, sizeof(vertex_3d));
+        Vertices[Index].Position = Obj->Positions[Corner.Position - 1];
+        if(Corner.TexCoord)
+        {
+            Vertices[Index].TexCoord = Obj->TexCoords[Corner.TexCoord - 1];
+        }
+        Indices[Index] = Index;
+    }
+
+    u32 VertexCount = MeshRemoveDuplicateVertices(Vertices, sizeof(vertex_3d), IndexCount, Indices, IndexCount);
+    Out->File.Extents = ComputeExtents(Vertices, VertexCount);
+
+    v3 Size = {{Out->File.Extents.Max.x - Out->File.Extents.Min.x,
+                Out->File.Extents.Max.y - Out->File.Extents.Min.y,
+                Out->File.Extents.Max.z - Out->File.Extents.Min.z}};
+    r32 Radius = 0.5f * sqrtf(Size.x * Size.x + Size.y * Size.y + Size.z * Size.z);
+
+    u32* LodIndices = malloc(sizeof(u32) * (size_t)IndexCount * LodCount);
+    u32 Made = MeshBuildLods(Vertices, sizeof(vertex_3d), VertexCount, Indices, IndexCount, LodCount, 0.5f, LodError * Radius,
+                             LodIndices, Out->File.LodIndexCounts, Out->File.LodErrors);
+    free(Indices);
+
+    u32 Total = 0;
+    u32* Scratch = malloc(sizeof(u32) * IndexCount);
+    for(u32 Lod = 0;
+        Lod < Made;
+        ++Lod)
+    {
+        u32 Count = Out->File.LodIndexCounts[Lod];
+        MeshOptimizeVertexCache(LodIndices + Total, Count, VertexCount, MESH_VERTEX_CACHE_SIZE, Scratch);
+        MeshOptimizeOverdraw(Vertices, sizeof(vertex_3d), VertexCount, Scratch, Count, MESH_VERTEX_CACHE_SIZE, 1.05f, LodIndices + Total);
+        Total += Count;
+    }
+    free(Scratch);
+
+    Out->Vertices = malloc(sizeof(vertex_3d) * (VertexCount ? VertexCount : 1));
+    Out->File.VertexCount = MeshOptimizeVertexFetch(Vertices, sizeof(vertex_3d), VertexCount, LodIndices, Total, Out->Vertices);
+    free(Vertices);
+
+    Out->Indices = LodIndices;
+    Out->File.IndexCount = Total;
+    Out->File.IndexSize = Out->File.VertexCount <= 65536 ? sizeof(u16) : sizeof(u32);
+    Out->File.LodCount = Made;
+
+    mesh_cache_stats Stats = MeshAnalyzeVertexCache(LodIndices, Out->File.LodIndexCounts[0], Out->File.VertexCount, MESH_VERTEX_CACHE_SIZE);
+    printf("  %s (%s): %u vertices, %u triangles, %u LODs, ACMR %.3f\n", Out->File.Name, Out->File.MaterialName,
+           Out->File.VertexCount, Out->File.LodIndexCounts[0] / 3, Made, Stats.ACMR);
+}
+
+static void WritePadding(FILE* Out, u64* Offset)
+{
+    static const u8 Zeros[MESH_FILE_ALIGNMENT] = {0};
+    u64 Aligned = MeshFileAlign(*Offset);
+    fwrite(Zeros, 1, (size_t)(Aligned - *Offset), Out);
+    *Offset = Aligned;
+}
+
+int main(int ArgCount, char** Args)
+{
+    if(ArgCount < 3)
+    {
+        fprintf(stderr, "Usage: mesh_cooker input.obj output%s [lod count] [lod error] [packed]\n", MESH_FILE_EXTENSION);
+        return 1;
+    }
+
+    const char* InputPath  = Args[1];
+    const char* OutputPath = Args[2];
+    u32 LodCount = ArgCount > 3 ? (u32)atoi(Args[3]) : GEOMETRY_MAX_LODS;
+    r32 LodError = ArgCount > 4 ? (r32)atof(Args[4]) : 0.01f;
+    b8 Packed = ArgCount > 5 && strcmp(Args[5], "packed") == 0;
+    LodCount = LodCount < 1 ? 1 : (LodCount > GEOMETRY_MAX_LODS ? GEOMETRY_MAX_LODS : LodCount);
+
+    FILE* Input = fopen(InputPath, "rb");
+    if(!Input)
+    {
+        fprintf(stderr, "Unable to open '%s'.\n", InputPath);
+        return 1;
+    }
+
+    fseek(Input, 0, SEEK_END);
+    long Size = ftell(Input);
+    fseek(Input, 0, SEEK_SET);
+
+    char* Text = malloc(Size > 0 ? Size + 1 : 1);
+    if(fread(Text, 1, Size, Input) != (size_t)Size)
+    {
+        fprintf(stderr, "Unable to read '%s'.\n", InputPath);
+        return 1;
+    }
+    Text[Size > 0 ? Size : 0] = 0;
+    fclose(Input);
+
+    // NOTE: Submeshes before any o or g line are named after the file
+    const char* BaseName = InputPath;
+    for(const char* At = InputPath; *At; ++At)
+    {
+        if(*At == '/' || *At == '\\')
+        {
+            BaseName = At + 1;
+        }
+    }
+
+    char DefaultName[GEOMETRY_NAME_MAX_LENGTH];
+    CopyName(DefaultName, BaseName, GEOMETRY_NAME_MAX_LENGTH);
+    char* Extension = strrchr(DefaultName, '.');
+    if(Extension)
+    {
+        *Extension = 0;
+    }
+
+    obj_data Obj;
+    memset(&Obj, 0, sizeof(Obj));
+    if(!ParseObj(Text, DefaultName, &Obj))
+    {
+        return 1;
+    }
+
+    u32 SubmeshCount = 0;
+    cooked_submesh* Cooked = malloc(sizeof(cooked_submesh) * (Obj.SubmeshCount ? Obj.SubmeshCount : 1));
+    printf("%s: %u positions, %u texture coordinates\n", InputPath, Obj.PositionCount, Obj.TexCoordCount);
+    for(u32 Index = 0;
+        Index < Obj.SubmeshCount;
+        ++Index)
+    {
+        if(Obj.Submeshes[Index].CornerCount > 0)
+        {
+            cooked_submesh* Submesh = Cooked + SubmeshCount++;
+            CookSubmesh(&Obj, Obj.Submeshes + Index, LodCount, LodError, Submesh);
+            if(Packed)
+            {
+                // NOTE: The loader unpacks against the submesh extents, so they have to be the quantization bounds
+                Submesh->PackedVertices = malloc(sizeof(vertex_3d_packed) * Submesh->File.VertexCount);
+                Submesh->File.Extents = MeshPackVertices(Submesh->Vertices, Submesh->File.VertexCount, Submesh->PackedVertices);
+            }
+        }
+    }
+
+    if(SubmeshCount == 0)
+    {
+        fprintf(stderr, "'%s' has no faces.\n", InputPath);
+        return 1;
+    }
+
+    // NOTE: Lay out the vertex arrays, then the index arrays
+    mesh_file_header Header;
+    memset(&Header, 0, sizeof(Header));
+    Header.Magic = MESH_FILE_MAGIC;
+    Header.Version = MESH_FILE_VERSION;
+    Header.VertexFormat = Packed ? VERTEX_FORMAT_3D_PACKED : VERTEX_FORMAT_3D;
+    Header.VertexSize = Packed ? sizeof(vertex_3d_packed) : sizeof(vertex_3d);
+    Header.SubmeshCount = SubmeshCount;
+    Header.Extents = Cooked[0].File.Extents;
+
+    u64 Offset = sizeof(mesh_file_header) + sizeof(mesh_file_submesh) * (u64)SubmeshCount;
+    for(u32 Index = 0;
+        Index < SubmeshCount;
+        ++Index)
+    {
+        mesh_file_submesh* File = &Cooked[Index].File;
+        Offset = MeshFileAlign(Offset);
+        File->VertexOffset = Offset;
+        Offset += (u64)Header.VertexSize * File->VertexCount;
+
+        extents_3d* E = &Header.Extents;
+        E->Min.x = File->Extents.Min.x < E->Min.x ? File->Extents.Min.x : E->Min.x;
+        E->Min.y = File->Extents.Min.y < E->Min.y ? File->Extents.Min.y : E->Min.y;
+        E->Min.z = File->Extents.Min.z < E->Min.z ? File->Extents.Min.z : E->Min.z;
+        E->Max.x = File->Extents.Max.x > E->Max.x ? File->Extents.Max.x : E->Max.x;
+        E->Max.y = File->Extents.Max.y > E->Max.y ? File->Extents.Max.y : E->Max.y;
+        E->Max.z = File->Extents.Max.z > E->Max.z ? File->Extents.Max.z : E->Max.z;
+    }
+
+    for(u32 Index = 0;
+        Index < SubmeshCount;
+        ++Index)
+    {
+        mesh_file_submesh* File = &Cooked[Index].File;
+        Offset = MeshFileAlign(Offset);
+        File->IndexOffset = Offset;
+        Offset += (u64)File->IndexSize * File->IndexCount;
+    }
+    Header.FileSize = Offset;
+
+    FILE* Out = fopen(OutputPath, "wb");
+    if(!Out)
+    {
+        fprintf(stderr, "Unable to open '%s' for writing.\n", OutputPath);
+        return 1;
+    }
+
+    Offset = 0;
+    fwrite(&Header, sizeof(Header), 1, Out);
+    Offset += sizeof(Header);
+    for(u32 Index = 0;
+        Index < SubmeshCount;
+        ++Index)
+    {
+        fwrite(&Cooked[Index].File, sizeof(mesh_file_submesh), 1, Out);
+        Offset += sizeof(mesh_file_submesh);
+    }
+
+    for(u32 Index = 0;
+        Index < SubmeshCount;
+        ++Index)
+    {
+        WritePadding(Out, &Offset);
+        const void* Vertices = Packed ? (const void*)Cooked[Index].PackedVertices : (const void*)Cooked[Index].Vertices;
+        fwrite(Vertices, Header.VertexSize, Cooked[Index].File.VertexCount, Out);
+        Offset += (u64)Header.VertexSize * Cooked[Index].File.VertexCount;
+    }
+
+    for(u32 Index = 0;
+        Index < SubmeshCount;
+        ++Index)
+    {
+        mesh_file_submesh* File = &Cooked[Index].File;
+        WritePadding(Out, &Offset);
+        if(File->IndexSize == sizeof(u16))
+        {
+            for(u32 I = 0;
+                I < File->IndexCount;
+                ++I)
+            {
+                u16 Narrow = (u16)Cooked[Index].Indices[I];
+                fwrite(&Narrow, sizeof(u16), 1, Out);
+            }
+        }
+        else
+        {
+            fwrite(Cooked[Index].Indices, sizeof(u32), File->IndexCount, Out);
+        }
+        Offset += (u64)File->IndexSize * File->IndexCount;
+    }
+
+    b8 Failed = ferror(Out) != 0;
+    fclose(Out);
+    if(Failed)
+    {
+        fprintf(stderr, "Unable to write '%s'.\n", OutputPath);
+        return 1;
+    }
+
+    printf("Wrote %u submeshes, %llu bytes to '%s'.\n", SubmeshCount, (unsigned long long)Offset, OutputPath);
+    return 0;
+}